@@ -0,0 +1,34 @@
+/**
+ * @file AllocationCounter.hpp
+ * @brief Process-wide heap allocation counter for the benchmarks
+ *
+ * AllocationCounter.cpp replaces the global operator new/delete family with
+ * versions that forward to malloc()/free() and count every allocation. It is
+ * linked into the benchmark executable only, so the library code is
+ * unchanged; Benchmark::run() reads the counter around each timed call to
+ * report allocations per operation.
+ *
+ * @author Student Project - Cryptographic Systems Course
+ * @date December 2025
+ */
+
+#ifndef ALLOCATION_COUNTER_HPP
+#define ALLOCATION_COUNTER_HPP
+
+#include <cstddef>
+
+namespace AllocationCounter {
+
+/**
+ * @brief Get the number of operator new calls since program start (all threads)
+ */
+size_t allocations();
+
+/**
+ * @brief Get the number of bytes requested through operator new since program start
+ */
+size_t bytesAllocated();
+
+} // namespace AllocationCounter
+
+#endif // ALLOCATION_COUNTER_HPP
@@ -1,32 +1,474 @@
 #include "Benchmark.hpp"
+#include "AllocationCounter.hpp"
+#include "PerfCounters.hpp"
 #include <iostream>
 #include <iomanip>
 #include <algorithm>
 #include <numeric>
 #include <cmath>
 #include <random>
+#include <utility>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <string>
+#include <sstream>
 
-Benchmark::Result Benchmark::run(std::function<void()> func, size_t iterations) {
-    std::vector<double> times;
-    times.reserve(iterations);
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace {
+
+std::atomic<bool> perfCountersEnabled{true};
+
+} // namespace
+
+Benchmark::Result Benchmark::run(std::function<void()> func, size_t iterations,
+                                 size_t warmupIterations) {
+    if (iterations == 0) {
+        iterations = 1;
+    }
+    if (warmupIterations == AUTO_WARMUP) {
+        warmupIterations = std::max<size_t>(1, iterations / 10);
+    }
 
-    for (size_t i = 0; i < iterations; ++i) {
-        auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < warmupIterations; ++i) {
         func();
-        auto end = std::chrono::high_resolution_clock::now();
+    }
+
+    return measure(func, iterations, 0.0, warmupIterations);
+}
+
+Benchmark::Result Benchmark::runFor(std::function<void()> func, double seconds,
+                                    size_t warmupIterations) {
+    if (warmupIterations == AUTO_WARMUP) {
+        // Warm up for a tenth of the budget, at least once
+        warmupIterations = 0;
+        auto warmupEnd = std::chrono::steady_clock::now()
+                       + std::chrono::duration<double>(seconds / 10.0);
+        do {
+            func();
+            ++warmupIterations;
+        } while (std::chrono::steady_clock::now() < warmupEnd);
+    } else {
+        for (size_t i = 0; i < warmupIterations; ++i) {
+            func();
+        }
+    }
+
+    return measure(func, static_cast<size_t>(-1), seconds, warmupIterations);
+}
 
-        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-        times.push_back(duration.count() / 1000.0); // Convert to milliseconds
+Benchmark::Result Benchmark::measure(const std::function<void()>& func, size_t maxIterations,
+                                     double seconds, size_t warmupIterations) {
+    std::vector<double> times;
+    std::vector<double> cycles;
+    if (seconds <= 0.0) {
+        times.reserve(maxIterations);
+        cycles.reserve(maxIterations);
     }
+    size_t allocations = 0;
+    const double budgetMs = seconds * 1000.0;
+    double elapsedMs = 0.0;
 
+    // Opened before the loop: perf_event_open() and the file descriptors
+    // stay out of the timed iterations
+    PerfCounters counters(perfCountersEnabled.load(std::memory_order_relaxed));
+    counters.start();
+    for (size_t i = 0; i < maxIterations; ++i) {
+        size_t allocationsBefore = AllocationCounter::allocations();
+        uint64_t cyclesStart = readCycleCounter();
+        auto start = std::chrono::steady_clock::now();
+        func();
+        auto end = std::chrono::steady_clock::now();
+        uint64_t cyclesEnd = readCycleCounter();
+        allocations += AllocationCounter::allocations() - allocationsBefore;
+
+        // Nanosecond resolution, stored in milliseconds
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        times.push_back(ms);
+        cycles.push_back(static_cast<double>(cyclesEnd - cyclesStart));
+
+        elapsedMs += ms;
+        if (budgetMs > 0.0 && elapsedMs >= budgetMs) {
+            break;
+        }
+    }
+    counters.stop();
+    size_t iterations = times.size();
     // Calculate statistics
     double sum = std::accumulate(times.begin(), times.end(), 0.0);
     double mean = sum / times.size();
-    double minTime = *std::min_element(times.begin(), times.end());
-    double maxTime = *std::max_element(times.begin(), times.end());
     double stdDev = calculateStdDev(times, mean);
+    double allocationsPerIteration = static_cast<double>(allocations) / iterations;
+
+    std::vector<double> sorted(times);
+    std::sort(sorted.begin(), sorted.end());
+    std::sort(cycles.begin(), cycles.end());
+    double averageCycles = std::accumulate(cycles.begin(), cycles.end(), 0.0) / cycles.size();
+
+    Result result;
+    result.averageTime = mean;
+    result.minTime = sorted.front();
+    result.maxTime = sorted.back();
+    result.stdDev = stdDev;
+    result.iterations = iterations;
+    result.allocations = allocationsPerIteration;
+    result.medianTime = percentile(sorted, 50.0);
+    result.p90Time = percentile(sorted, 90.0);
+    result.p99Time = percentile(sorted, 99.0);
+    result.p999Time = percentile(sorted, 99.9);
+    result.averageCycles = averageCycles;
+    result.medianCycles = percentile(cycles, 50.0);
+    result.warmupIterations = warmupIterations;
+    result.samples = std::move(times);
+    result.coreCycles = counters.count(PerfCounters::CoreCycles) / iterations;
+    result.instructions = counters.count(PerfCounters::Instructions) / iterations;
+    result.l1dMisses = counters.count(PerfCounters::L1DMisses) / iterations;
+    result.llcMisses = counters.count(PerfCounters::LLCMisses) / iterations;
+    result.branchMisses = counters.count(PerfCounters::BranchMisses) / iterations;
+    return result;
+}
+
+bool Benchmark::pinCurrentThread(int cpu) {
+#if defined(__linux__)
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+std::vector<int> Benchmark::availableCpus() {
+    std::vector<int> cpus;
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+#endif
+    if (cpus.empty()) {
+        unsigned int count = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned int cpu = 0; cpu < count; ++cpu) {
+            cpus.push_back(static_cast<int>(cpu));
+        }
+    }
+    return cpus;
+}
+
+int Benchmark::numaNodeOfCpu(int cpu) {
+#if defined(__linux__)
+    // /sys/devices/system/cpu/cpuN/nodeM exists for the node M owning cpu N
+    const std::string base = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/node";
+    struct stat info;
+    for (int node = 0; node < 1024; ++node) {
+        if (::stat((base + std::to_string(node)).c_str(), &info) == 0) {
+            return node;
+        }
+    }
+#else
+    (void)cpu;
+#endif
+    return -1;
+}
+
+size_t Benchmark::heapBytesInUse() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    const struct mallinfo2 info = ::mallinfo2();
+    return info.uordblks + info.hblkhd;     // Arena chunks + mmap()ed chunks
+#else
+    return 0;
+#endif
+}
+
+#if defined(__linux__)
+namespace {
+
+constexpr uint8_t STACK_PAINT = 0xA5;
+
+void* runOnPaintedStack(void* func) {
+    try {
+        (*static_cast<const std::function<void()>*>(func))();
+    } catch (...) {
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Stack bytes written by func, including the thread's own overhead
+ */
+size_t usedStackBytes(const std::function<void()>& func, size_t stackBytes) {
+    void* stack = mmap(nullptr, stackBytes, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (stack == MAP_FAILED) {
+        return 0;
+    }
+    std::fill_n(static_cast<uint8_t*>(stack), stackBytes, STACK_PAINT);
+
+    size_t used = 0;
+    pthread_attr_t attr;
+    pthread_t thread;
+    if (pthread_attr_init(&attr) == 0) {
+        if (pthread_attr_setstack(&attr, stack, stackBytes) == 0
+            && pthread_create(&thread, &attr, runOnPaintedStack,
+                              const_cast<std::function<void()>*>(&func)) == 0) {
+            pthread_join(thread, nullptr);
+
+            // The stack grows down: the lowest overwritten byte is the high-water mark
+            const uint8_t* bytes = static_cast<const uint8_t*>(stack);
+            size_t untouched = 0;
+            while (untouched < stackBytes && bytes[untouched] == STACK_PAINT) {
+                ++untouched;
+            }
+            used = stackBytes - untouched;
+        }
+        pthread_attr_destroy(&attr);
+    }
+    munmap(stack, stackBytes);
+    return used;
+}
+
+} // namespace
+#endif
+
+size_t Benchmark::peakStackBytes(const std::function<void()>& func, size_t stackBytes) {
+#if defined(__linux__)
+    // glibc keeps the thread descriptor and static TLS at the top of the stack
+    const size_t baseline = usedStackBytes([]() {}, stackBytes);
+    const size_t used = usedStackBytes(func, stackBytes);
+    return used > baseline ? used - baseline : 0;
+#else
+    (void)func;
+    (void)stackBytes;
+    return 0;
+#endif
+}
+
+Benchmark::ThroughputResult Benchmark::runThroughput(const std::vector<int>& cpus, double seconds,
+                                                     const WorkerSetup& setup) {
+    ThroughputResult result;
+    result.workers.resize(cpus.size());
+    result.operations = 0;
+    result.seconds = 0.0;
+    result.opsPerSecond = 0.0;
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    size_t ready = 0;
+    bool started = false;
+    std::chrono::steady_clock::time_point start;
+
+    std::vector<std::thread> threads;
+    threads.reserve(cpus.size());
+    for (size_t i = 0; i < cpus.size(); ++i) {
+        threads.emplace_back([&, i]() {
+            WorkerThroughput& worker = result.workers[i];
+            worker.cpu = cpus[i];
+            worker.pinned = pinCurrentThread(cpus[i]);
+            worker.numaNode = numaNodeOfCpu(cpus[i]);
+            worker.operations = 0;
+
+            // Allocate and warm up on the pinned thread
+            std::function<void()> operation = setup(i);
+            operation();
+
+            std::chrono::steady_clock::time_point begin;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                ++ready;
+                changed.notify_all();
+                changed.wait(lock, [&]() { return started; });
+                begin = start;
+            }
+
+            const auto deadline = begin + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(seconds));
+            auto now = begin;
+            do {
+                operation();
+                ++worker.operations;
+                now = std::chrono::steady_clock::now();
+            } while (now < deadline);
+
+            worker.seconds = std::chrono::duration<double>(now - begin).count();
+            worker.opsPerSecond = worker.seconds > 0.0 ? worker.operations / worker.seconds : 0.0;
+        });
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [&]() { return ready == cpus.size(); });
+        start = std::chrono::steady_clock::now();
+        started = true;
+    }
+    changed.notify_all();
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    for (const WorkerThroughput& worker : result.workers) {
+        result.operations += worker.operations;
+        result.seconds = std::max(result.seconds, worker.seconds);
+    }
+    result.opsPerSecond = result.seconds > 0.0 ? result.operations / result.seconds : 0.0;
+    return result;
+}
+
+double Benchmark::efficiency(const ThroughputResult& result, double singleCoreOpsPerSecond) {
+    if (result.workers.empty() || singleCoreOpsPerSecond <= 0.0) {
+        return 0.0;
+    }
+    return result.opsPerSecond / (result.workers.size() * singleCoreOpsPerSecond);
+}
 
-    return {mean, minTime, maxTime, stdDev, iterations};
+namespace {
+
+/**
+ * @brief Welch's t-test of two classes, accumulated online (Welford)
+ */
+struct WelchTest {
+    double mean[2] = {0.0, 0.0};
+    double m2[2] = {0.0, 0.0};
+    size_t count[2] = {0, 0};
+
+    void push(double value, int inputClass) {
+        ++count[inputClass];
+        const double delta = value - mean[inputClass];
+        mean[inputClass] += delta / count[inputClass];
+        m2[inputClass] += delta * (value - mean[inputClass]);
+    }
+
+    double t() const {
+        if (count[0] < 2 || count[1] < 2) {
+            return 0.0;
+        }
+        const double variance = m2[0] / (count[0] - 1) / count[0]
+                              + m2[1] / (count[1] - 1) / count[1];
+        return variance > 0.0 ? (mean[0] - mean[1]) / std::sqrt(variance) : 0.0;
+    }
+};
+
+// Cropped sets keep the measurements below 1 - 0.5^(10 (i + 1) / CROPS) of
+// the distribution, from ~7% up to all but 0.1%, as dudect does
+constexpr size_t LEAKAGE_CROPS = 100;
+
+// Cropped sets with fewer measurements per class are too noisy to count
+constexpr size_t LEAKAGE_MIN_CROPPED = 50;
+
+} // namespace
+
+Benchmark::LeakageResult Benchmark::runLeakageTest(const LeakageSetup& setup,
+                                                   const std::function<void()>& operation,
+                                                   size_t samples, uint64_t seed) {
+    LeakageResult result{};
+    result.cycles = hasCycleCounter();
+    samples = std::max<size_t>(samples, 2);
+
+    std::mt19937_64 generator(seed);
+    std::vector<uint8_t> classes(samples);
+    for (uint8_t& inputClass : classes) {
+        inputClass = static_cast<uint8_t>(generator() & 1);
+    }
+    std::vector<double> values(samples);
+
+    const bool cycles = result.cycles;
+    auto ticks = [cycles]() -> uint64_t {
+        if (cycles) {
+            return readCycleCounter();
+        }
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    };
+
+    // Untimed warm-up of both classes
+    const size_t warmup = std::min<size_t>(1000, samples / 10 + 2);
+    for (size_t i = 0; i < warmup; ++i) {
+        setup(static_cast<int>(i & 1), i);
+        operation();
+    }
+
+    for (size_t i = 0; i < samples; ++i) {
+        setup(classes[i], i);
+        const uint64_t start = ticks();
+        operation();
+        const uint64_t end = ticks();
+        values[i] = static_cast<double>(end - start);
+    }
+
+    WelchTest all;
+    for (size_t i = 0; i < samples; ++i) {
+        all.push(values[i], classes[i]);
+    }
+    for (int inputClass = 0; inputClass < 2; ++inputClass) {
+        result.samples[inputClass] = all.count[inputClass];
+        result.mean[inputClass] = all.mean[inputClass];
+    }
+    result.t = all.t();
+    result.maxT = std::fabs(result.t);
+
+    // The cropped sets are nested, so one pass over the sorted measurements
+    // grows each from the previous one
+    std::vector<size_t> order(samples);
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return values[a] < values[b];
+    });
+    result.median = values[order[samples / 2]];
+
+    WelchTest cropped;
+    size_t next = 0;
+    for (size_t crop = 0; crop < LEAKAGE_CROPS; ++crop) {
+        const double keep = 1.0 - std::pow(0.5, 10.0 * (crop + 1) / LEAKAGE_CROPS);
+        const size_t end = static_cast<size_t>(keep * samples);
+        for (; next < end; ++next) {
+            cropped.push(values[order[next]], classes[order[next]]);
+        }
+        if (cropped.count[0] >= LEAKAGE_MIN_CROPPED && cropped.count[1] >= LEAKAGE_MIN_CROPPED) {
+            result.maxT = std::max(result.maxT, std::fabs(cropped.t()));
+        }
+    }
+    return result;
+}
+
+void Benchmark::setPerfCounters(bool enabled) {
+    perfCountersEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool Benchmark::perfCounters() {
+    return perfCountersEnabled.load(std::memory_order_relaxed);
+}
+
+bool Benchmark::hasCycleCounter() {
+#if defined(__x86_64__) || defined(__i386__)
+    return true;
+#else
+    return false;
+#endif
 }
 
 std::vector<uint8_t> Benchmark::generateRandomMessage(size_t size) {
@@ -48,7 +490,25 @@ void Benchmark::printResult(const std::string& name, const Result& result) {
     std::cout << "  Min:     " << result.minTime << " ms\n";
     std::cout << "  Max:     " << result.maxTime << " ms\n";
     std::cout << "  StdDev:  " << result.stdDev << " ms\n";
-    std::cout << "  Iterations: " << result.iterations << "\n\n";
+    std::cout << "  Median:  " << result.medianTime << " ms\n";
+    std::cout << "  p90:     " << result.p90Time << " ms\n";
+    std::cout << "  p99:     " << result.p99Time << " ms\n";
+    std::cout << "  p99.9:   " << result.p999Time << " ms\n";
+    if (hasCycleCounter()) {
+        std::cout << "  Cycles:  " << std::setprecision(0) << result.medianCycles
+                  << " (median)\n" << std::setprecision(3);
+    }
+    if (result.coreCycles > 0.0) {
+        std::cout << std::setprecision(0)
+                  << "  Core cycles: " << result.coreCycles << "\n"
+                  << "  Instructions: " << result.instructions
+                  << " (IPC " << std::setprecision(2) << result.ipc() << ")\n"
+                  << std::setprecision(1)
+                  << "  L1D/LLC misses: " << result.l1dMisses << " / " << result.llcMisses << "\n"
+                  << "  Branch misses: " << result.branchMisses << "\n" << std::setprecision(3);
+    }
+    std::cout << "  Iterations: " << result.iterations << "\n";
+    std::cout << "  Allocations/op: " << result.allocations << "\n\n";
 }
 
 void Benchmark::printTableHeader() {
@@ -95,6 +555,137 @@ void Benchmark::printSeparator() {
               << "+\n";
 }
 
+void Benchmark::printLatencyHeader() {
+    printLatencySeparator();
+    std::cout << "| " << std::setw(10) << std::left << "Message"
+              << " | " << std::setw(8) << "Op"
+              << " | " << std::setw(10) << "Mean (ms)"
+              << " | " << std::setw(10) << "Median"
+              << " | " << std::setw(10) << "p90"
+              << " | " << std::setw(10) << "p99"
+              << " | " << std::setw(10) << "p99.9"
+              << " | " << std::setw(12) << "Cycles (med)"
+              << " |\n";
+    printLatencySeparator();
+}
+
+void Benchmark::printLatencyRow(const std::string& label, const std::string& operation,
+                                const Result& result) {
+    std::cout << std::fixed << std::setprecision(4);
+    std::cout << "| " << std::setw(10) << std::left << label
+              << " | " << std::setw(8) << operation
+              << " | " << std::setw(10) << result.averageTime
+              << " | " << std::setw(10) << result.medianTime
+              << " | " << std::setw(10) << result.p90Time
+              << " | " << std::setw(10) << result.p99Time
+              << " | " << std::setw(10) << result.p999Time
+              << " | " << std::setw(12) << std::setprecision(0) << result.medianCycles
+              << " |\n";
+}
+
+void Benchmark::printLatencySeparator() {
+    std::cout << "+" << std::string(12, '-')
+              << "+" << std::string(10, '-')
+              << "+" << std::string(12, '-')
+              << "+" << std::string(12, '-')
+              << "+" << std::string(12, '-')
+              << "+" << std::string(12, '-')
+              << "+" << std::string(12, '-')
+              << "+" << std::string(14, '-')
+              << "+\n";
+}
+
+void Benchmark::printAllocationHeader() {
+    printAllocationSeparator();
+    std::cout << "| " << std::setw(36) << std::left << "Operation"
+              << " | " << std::setw(12) << "Avg (ms)"
+              << " | " << std::setw(12) << "Allocs/op"
+              << " |\n";
+    printAllocationSeparator();
+}
+
+void Benchmark::printAllocationRow(const std::string& operation, const Result& result) {
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "| " << std::setw(36) << std::left << operation
+              << " | " << std::setw(12) << result.averageTime
+              << " | " << std::setw(12) << std::setprecision(2) << result.allocations
+              << " |\n";
+}
+
+void Benchmark::printAllocationSeparator() {
+    std::cout << "+" << std::string(38, '-')
+              << "+" << std::string(14, '-')
+              << "+" << std::string(14, '-')
+              << "+\n";
+}
+
+void Benchmark::printCounterHeader() {
+    printCounterSeparator();
+    std::cout << "| " << std::setw(36) << std::left << "Operation"
+              << " | " << std::setw(12) << std::right << "Cycles"
+              << " | " << std::setw(12) << "Instructions"
+              << " | " << std::setw(5) << "IPC"
+              << " | " << std::setw(10) << "L1D miss"
+              << " | " << std::setw(10) << "LLC miss"
+              << " | " << std::setw(10) << "Br miss"
+              << " |\n";
+    printCounterSeparator();
+}
+
+void Benchmark::printCounterRow(const std::string& operation, const Result& result) {
+    // Events the CPU does not provide read 0 and are shown as "-"
+    auto count = [](double value, int precision) {
+        std::ostringstream text;
+        if (value > 0.0) {
+            text << std::fixed << std::setprecision(precision) << value;
+        } else {
+            text << "-";
+        }
+        return text.str();
+    };
+    std::cout << "| " << std::setw(36) << std::left << operation
+              << " | " << std::setw(12) << std::right << count(result.coreCycles, 0)
+              << " | " << std::setw(12) << count(result.instructions, 0)
+              << " | " << std::setw(5) << count(result.ipc(), 2)
+              << " | " << std::setw(10) << count(result.l1dMisses, 1)
+              << " | " << std::setw(10) << count(result.llcMisses, 1)
+              << " | " << std::setw(10) << count(result.branchMisses, 1)
+              << " |\n";
+}
+
+void Benchmark::printCounterSeparator() {
+    std::cout << "+" << std::string(38, '-')
+              << "+" << std::string(14, '-')
+              << "+" << std::string(14, '-')
+              << "+" << std::string(7, '-')
+              << "+" << std::string(12, '-')
+              << "+" << std::string(12, '-')
+              << "+" << std::string(12, '-')
+              << "+\n";
+}
+
+double Benchmark::percentile(const std::vector<double>& sorted, double percentile) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    // Nearest rank: smallest value with at least percentile% of samples at or below it
+    double rank = std::ceil(percentile / 100.0 * sorted.size());
+    size_t index = rank < 1.0 ? 0 : static_cast<size_t>(rank) - 1;
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+uint64_t Benchmark::readCycleCounter() {
+#if defined(__x86_64__) || defined(__i386__)
+    // lfence keeps rdtsc from being reordered around the measured code
+    _mm_lfence();
+    uint64_t cycles = __rdtsc();
+    _mm_lfence();
+    return cycles;
+#else
+    return 0;
+#endif
+}
+
 double Benchmark::calculateStdDev(const std::vector<double>& values, double mean) {
     double sumSquaredDiff = 0.0;
     for (double value : values) {
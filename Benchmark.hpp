@@ -5,6 +5,8 @@
 #include <vector>
 #include <string>
 #include <functional>
+#include <cstddef>
+#include <cstdint>
 
 /**
  * @brief Utility class for benchmarking cryptographic operations
@@ -20,15 +22,226 @@ public:
         double maxTime;         // Maximum time in milliseconds
         double stdDev;          // Standard deviation in milliseconds
         size_t iterations;      // Number of iterations run
+        double allocations;     // Average heap allocations per iteration
+        double medianTime;      // 50th percentile in milliseconds
+        double p90Time;         // 90th percentile in milliseconds
+        double p99Time;         // 99th percentile in milliseconds
+        double p999Time;        // 99.9th percentile in milliseconds
+        double averageCycles;   // Average TSC cycles per iteration (0 if unavailable)
+        double medianCycles;    // Median TSC cycles per iteration (0 if unavailable)
+        size_t warmupIterations; // Untimed iterations run before measuring
+        std::vector<double> samples; // Per-iteration times in milliseconds, in run order
+
+        // Hardware counters per iteration (perf_event, calling thread only;
+        // 0 if unavailable), see PerfCounters.hpp
+        double coreCycles;      // Core clock cycles
+        double instructions;    // Instructions retired
+        double l1dMisses;       // L1 data cache load misses
+        double llcMisses;       // Last-level cache misses
+        double branchMisses;    // Mispredicted branches
+
+        /**
+         * @brief Instructions per core cycle (0 if unavailable)
+         */
+        double ipc() const { return coreCycles > 0.0 ? instructions / coreCycles : 0.0; }
     };
 
+    /**
+     * @brief Operations completed by one pinned throughput worker
+     */
+    struct WorkerThroughput {
+        int cpu;                // CPU the worker was pinned to
+        int numaNode;           // NUMA node of that CPU (-1 if unknown)
+        bool pinned;            // The affinity call succeeded
+        size_t operations;      // Operations completed within the time budget
+        double seconds;         // Wall time the worker ran
+        double opsPerSecond;
+    };
+
+    /**
+     * @brief Aggregate of a pinned throughput run
+     */
+    struct ThroughputResult {
+        std::vector<WorkerThroughput> workers;
+        size_t operations;      // Sum over all workers
+        double seconds;         // Wall time from the common start to the last worker
+        double opsPerSecond;    // Aggregate rate
+    };
+
+    /**
+     * @brief Creates the operation of one throughput worker
+     *
+     * Called on the worker thread after it was pinned, so everything the
+     * returned function owns (keys, messages, scratch buffers) is first
+     * touched - and therefore placed - on the worker's NUMA node.
+     */
+    using WorkerSetup = std::function<std::function<void()>(size_t worker)>;
+
+    /**
+     * @brief Outcome of a fixed-vs-random timing leakage test
+     *
+     * Class 0 is the fixed input, class 1 the random one. Measurements are
+     * TSC cycles, or nanoseconds where there is no cycle counter.
+     */
+    struct LeakageResult {
+        size_t samples[2];      // Measurements per class
+        double mean[2];         // Mean measurement per class
+        double median;          // Median over both classes, the performance figure
+        double t;               // Welch's t of all measurements
+        double maxT;            // Largest |t| of all measurements and the cropped sets
+        bool cycles;            // Measurements are cycles rather than nanoseconds
+
+        // |t| above this rejects "both classes take the same time" with high confidence
+        static constexpr double THRESHOLD = 4.5;
+
+        bool leaks() const { return maxT > THRESHOLD; }
+    };
+
+    /**
+     * @brief Prepares the input of one leakage measurement (untimed)
+     * @param inputClass 0: fixed input, 1: random input
+     * @param index Measurement number, e.g. to walk a pool of inputs
+     */
+    using LeakageSetup = std::function<void(int inputClass, size_t index)>;
+
+    // Selects iterations / 10 warm-up runs (at least 1)
+    static constexpr size_t AUTO_WARMUP = static_cast<size_t>(-1);
+
     /**
      * @brief Run a benchmark function multiple times
+     *
+     * Each iteration is timed with std::chrono::steady_clock at nanosecond
+     * resolution and, on x86, with the time-stamp counter. Warm-up runs fill
+     * caches and branch predictors and are not included in the statistics.
+     * Hardware counters run across all timed iterations, so their averages
+     * include the few dozen instructions of the timing code per iteration.
+     *
+     * @param func The function to benchmark
+     * @param iterations Number of timed runs
+     * @param warmupIterations Untimed runs before measuring (AUTO_WARMUP: iterations / 10)
+     * @return Benchmark results
+     */
+    static Result run(std::function<void()> func, size_t iterations = 100,
+                      size_t warmupIterations = AUTO_WARMUP);
+
+    /**
+     * @brief Run a benchmark function for a fixed wall-clock time
+     *
+     * Like run(), but keeps iterating until the time budget is used up
+     * (at least one timed run). AUTO_WARMUP warms up for a tenth of the
+     * budget.
+     *
      * @param func The function to benchmark
-     * @param iterations Number of times to run
+     * @param seconds Time budget for the timed runs
+     * @param warmupIterations Untimed runs before measuring (AUTO_WARMUP: seconds / 10)
      * @return Benchmark results
      */
-    static Result run(std::function<void()> func, size_t iterations = 100);
+    static Result runFor(std::function<void()> func, double seconds,
+                         size_t warmupIterations = AUTO_WARMUP);
+
+    /**
+     * @brief Pin the calling thread to one CPU
+     * @param cpu Zero-based CPU index
+     * @return true if the affinity was set (Linux only)
+     */
+    static bool pinCurrentThread(int cpu);
+
+    /**
+     * @brief Run one pinned worker per CPU for a fixed wall-clock time
+     *
+     * Each worker pins itself, builds its operation with setup(), runs it
+     * once untimed and waits for the others; then all workers start at the
+     * same instant and repeat the operation until the time budget is over.
+     *
+     * @param cpus CPUs to run on, one worker each
+     * @param seconds Time budget
+     * @param setup Builds each worker's operation on the worker thread
+     * @return Per-worker and aggregate operation counts
+     */
+    static ThroughputResult runThroughput(const std::vector<int>& cpus, double seconds,
+                                          const WorkerSetup& setup);
+
+    /**
+     * @brief Per-core efficiency of a throughput run
+     * @param result Multi-core run
+     * @param singleCoreOpsPerSecond Rate of the same operation on one core
+     * @return Aggregate rate / (workers * single-core rate), 1.0 = linear scaling
+     */
+    static double efficiency(const ThroughputResult& result, double singleCoreOpsPerSecond);
+
+    /**
+     * @brief Fixed-vs-random timing leakage test in the style of dudect
+     *
+     * Draws the class of every measurement from a seeded generator, so the
+     * classes interleave and drift in clock speed or cache state hits both
+     * alike. Each measurement runs setup() untimed and then times one call
+     * of operation() with the cycle counter into a preallocated buffer. The
+     * classes are compared with Welch's t-test on all measurements and on
+     * sets cropped at increasing percentiles, which drop the long tail of
+     * interrupted runs; maxT is the largest of these |t| values.
+     *
+     * @param setup Selects the input of the next measurement
+     * @param operation Code under test
+     * @param samples Timed measurements over both classes
+     * @param seed Seed of the class sequence
+     * @return Per-class means and t statistics
+     */
+    static LeakageResult runLeakageTest(const LeakageSetup& setup,
+                                        const std::function<void()>& operation,
+                                        size_t samples, uint64_t seed = 1);
+
+    /**
+     * @brief CPUs the process may run on (sched_getaffinity)
+     */
+    static std::vector<int> availableCpus();
+
+    /**
+     * @brief NUMA node a CPU belongs to (from sysfs)
+     * @return The node, or -1 if unknown
+     */
+    static int numaNodeOfCpu(int cpu);
+
+    /**
+     * @brief Heap bytes currently allocated, including allocator overhead
+     *
+     * Unlike the resident set size this drops again when memory is freed,
+     * so consecutive measurements do not hide reused pages.
+     *
+     * @return Bytes (glibc mallinfo2), or 0 if unknown
+     */
+    static size_t heapBytesInUse();
+
+    /**
+     * @brief Deepest stack use of a function
+     *
+     * Runs func once on a helper thread whose stack is pre-filled with a
+     * pattern and reports how far it was overwritten, minus what an empty
+     * function on the same kind of thread uses.
+     *
+     * @param func Function to measure (runs on another thread)
+     * @param stackBytes Size of the helper thread's stack
+     * @return Bytes of stack used by func, or 0 if unsupported (non-Linux)
+     */
+    static size_t peakStackBytes(const std::function<void()>& func,
+                                 size_t stackBytes = 1 << 20);
+
+    /**
+     * @brief Check if cycle counts are available on this platform (x86 TSC)
+     */
+    static bool hasCycleCounter();
+
+    /**
+     * @brief Switch hardware counter collection in run() and runFor() on or off
+     *
+     * On by default; without perf events (see PerfCounters::available())
+     * the counter fields of Result are always 0.
+     */
+    static void setPerfCounters(bool enabled);
+
+    /**
+     * @brief Check if run() and runFor() collect hardware counters
+     */
+    static bool perfCounters();
 
     /**
      * @brief Generate random message of specified size
@@ -74,7 +287,68 @@ public:
      */
     static void printSeparator();
 
+    /**
+     * @brief Print header of the latency distribution table
+     */
+    static void printLatencyHeader();
+
+    /**
+     * @brief Print one row of the latency distribution table
+     * @param label Row label (e.g. message size)
+     * @param operation Operation name
+     * @param result Benchmark result
+     */
+    static void printLatencyRow(const std::string& label, const std::string& operation,
+                                const Result& result);
+
+    /**
+     * @brief Print separator of the latency distribution table
+     */
+    static void printLatencySeparator();
+
+    /**
+     * @brief Print header of the per-operation time/allocation table
+     */
+    static void printAllocationHeader();
+
+    /**
+     * @brief Print one row of the per-operation time/allocation table
+     * @param operation Operation name
+     * @param result Benchmark result
+     */
+    static void printAllocationRow(const std::string& operation, const Result& result);
+
+    /**
+     * @brief Print separator of the per-operation time/allocation table
+     */
+    static void printAllocationSeparator();
+
+    /**
+     * @brief Print header of the hardware counter table
+     */
+    static void printCounterHeader();
+
+    /**
+     * @brief Print one row of the hardware counter table (per iteration)
+     * @param operation Operation name
+     * @param result Benchmark result
+     */
+    static void printCounterRow(const std::string& operation, const Result& result);
+
+    /**
+     * @brief Print separator of the hardware counter table
+     */
+    static void printCounterSeparator();
+
 private:
+    /**
+     * @brief Timed loop shared by run() and runFor()
+     * @param maxIterations Stop after this many runs
+     * @param seconds Stop once this much time was spent in timed runs (0: no limit)
+     */
+    static Result measure(const std::function<void()>& func, size_t maxIterations,
+                          double seconds, size_t warmupIterations);
+
     /**
      * @brief Calculate standard deviation
      * @param values Vector of values
@@ -82,6 +356,19 @@ private:
      * @return Standard deviation
      */
     static double calculateStdDev(const std::vector<double>& values, double mean);
+
+    /**
+     * @brief Nearest-rank percentile of sorted values
+     * @param sorted Values in ascending order
+     * @param percentile Percentile in [0, 100]
+     * @return The percentile value, 0 for an empty input
+     */
+    static double percentile(const std::vector<double>& sorted, double percentile);
+
+    /**
+     * @brief Read the CPU time-stamp counter (0 where unavailable)
+     */
+    static uint64_t readCycleCounter();
 };
 
 #endif // BENCHMARK_HPP
\ No newline at end of file
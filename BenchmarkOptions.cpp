@@ -0,0 +1,341 @@
+/**
+ * @file BenchmarkOptions.cpp
+ * @brief Command line parsing of dilithium_benchmark
+ */
+
+#include "BenchmarkOptions.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+// "pinned" runs for a fixed wall time per core count and "ct" takes many
+// samples per signing path; both are opt-in
+const char* const ALL_SUITES[] = {"demo", "compare", "api", "sweep", "prehash", "keygen",
+                                  "rng", "keymemory", "scratch", "shake", "keycache",
+                                  "keystore", "startup", "keypool", "composite",
+                                  "throughput", "service", "instrument", "pinned", "ct"};
+
+std::vector<std::string> splitList(const std::string& text) {
+    std::vector<std::string> items;
+    std::istringstream in(text);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        if (!item.empty()) {
+            std::transform(item.begin(), item.end(), item.begin(),
+                           [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+/**
+ * @brief Parse a CPU list such as "0-3,8,10-11"
+ */
+bool parseCpuList(const std::string& text, std::vector<int>& cpus) {
+    cpus.clear();
+    std::istringstream in(text);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        size_t dash = item.find('-');
+        size_t first = 0;
+        size_t last = 0;
+        if (dash == std::string::npos) {
+            if (!parseCount(item, first)) {
+                return false;
+            }
+            last = first;
+        } else if (!parseCount(item.substr(0, dash), first)
+                   || !parseCount(item.substr(dash + 1), last) || last < first) {
+            return false;
+        }
+        for (size_t cpu = first; cpu <= last; ++cpu) {
+            if (std::find(cpus.begin(), cpus.end(), static_cast<int>(cpu)) == cpus.end()) {
+                cpus.push_back(static_cast<int>(cpu));
+            }
+        }
+    }
+    return !cpus.empty();
+}
+
+bool parseNumber(const std::string& text, double& value) {
+    char* end = nullptr;
+    value = std::strtod(text.c_str(), &end);
+    return end != text.c_str() && *end == '\0';
+}
+
+bool parseSeconds(const std::string& text, double& value) {
+    char* end = nullptr;
+    value = std::strtod(text.c_str(), &end);
+    if (end == text.c_str()) {
+        return false;
+    }
+    std::string suffix(end);
+    if (suffix == "m" || suffix == "min") {
+        value *= 60.0;
+    } else if (suffix == "ms") {
+        value /= 1000.0;
+    } else if (!suffix.empty() && suffix != "s") {
+        return false;
+    }
+    return value > 0.0;
+}
+
+} // namespace
+
+bool parseCount(const std::string& text, size_t& value) {
+    if (text.empty() || !std::isdigit(static_cast<unsigned char>(text[0]))) {
+        return false;
+    }
+    char* end = nullptr;
+    unsigned long long parsed = std::strtoull(text.c_str(), &end, 10);
+    if (*end != '\0') {
+        return false;
+    }
+    value = static_cast<size_t>(parsed);
+    return true;
+}
+
+bool parseBytes(const std::string& text, size_t& value) {
+    if (text.empty() || !std::isdigit(static_cast<unsigned char>(text[0]))) {
+        return false;
+    }
+    char* end = nullptr;
+    unsigned long long parsed = std::strtoull(text.c_str(), &end, 10);
+    std::string suffix(end);
+    if (!suffix.empty() && (suffix.back() == 'B' || suffix.back() == 'b')) {
+        suffix.pop_back();
+    }
+    if (suffix.size() == 2 && (suffix[1] == 'i' || suffix[1] == 'I')) {
+        suffix.pop_back();
+    }
+    if (suffix.empty()) {
+        value = static_cast<size_t>(parsed);
+    } else if (suffix == "K" || suffix == "k") {
+        value = static_cast<size_t>(parsed) << 10;
+    } else if (suffix == "M" || suffix == "m") {
+        value = static_cast<size_t>(parsed) << 20;
+    } else if (suffix == "G" || suffix == "g") {
+        value = static_cast<size_t>(parsed) << 30;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool BenchmarkOptions::runs(const std::string& suite) const {
+    return std::find(suites.begin(), suites.end(), suite) != suites.end();
+}
+
+bool BenchmarkOptions::parse(int argc, char** argv, std::string& error) {
+    bool keyGenIterationsSet = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto value = [&](std::string& out) {
+            if (i + 1 >= argc) {
+                error = arg + " needs a value";
+                return false;
+            }
+            out = argv[++i];
+            return true;
+        };
+        std::string text;
+
+        if (arg == "--help" || arg == "-h") {
+            help = true;
+        } else if (arg == "--no-perf") {
+            perfCounters = false;
+        } else if (arg == "--list-schemes") {
+            listSchemes = true;
+        } else if (arg == "--schemes") {
+            if (!value(schemes)) {
+                return false;
+            }
+        } else if (arg == "--operations") {
+            if (!value(text)) {
+                return false;
+            }
+            keyGen = sign = verify = false;
+            for (const std::string& op : splitList(text)) {
+                if (op == "keygen") {
+                    keyGen = true;
+                } else if (op == "sign") {
+                    sign = true;
+                } else if (op == "verify") {
+                    verify = true;
+                } else if (op == "all") {
+                    keyGen = sign = verify = true;
+                } else {
+                    error = "unknown operation '" + op + "' (keygen, sign, verify)";
+                    return false;
+                }
+            }
+        } else if (arg == "--suites") {
+            if (!value(text)) {
+                return false;
+            }
+            suites.clear();
+            for (const std::string& suite : splitList(text)) {
+                if (suite == "all") {
+                    suites.assign(std::begin(ALL_SUITES), std::end(ALL_SUITES));
+                } else if (std::find(std::begin(ALL_SUITES), std::end(ALL_SUITES), suite)
+                           != std::end(ALL_SUITES)) {
+                    suites.push_back(suite);
+                } else {
+                    error = "unknown suite '" + suite + "'";
+                    return false;
+                }
+            }
+        } else if (arg == "--sizes") {
+            if (!value(text)) {
+                return false;
+            }
+            messageSizes.clear();
+            std::istringstream in(text);
+            std::string item;
+            while (std::getline(in, item, ',')) {
+                size_t bytes = 0;
+                if (!parseBytes(item, bytes)) {
+                    error = "invalid message size '" + item + "'";
+                    return false;
+                }
+                messageSizes.push_back(bytes);
+            }
+            if (messageSizes.empty()) {
+                error = "--sizes needs at least one size";
+                return false;
+            }
+        } else if (arg == "--iterations" || arg == "-n") {
+            if (!value(text) || !parseCount(text, iterations) || iterations == 0) {
+                error = error.empty() ? "invalid iteration count '" + text + "'" : error;
+                return false;
+            }
+        } else if (arg == "--keygen-iterations") {
+            if (!value(text) || !parseCount(text, keyGenIterations) || keyGenIterations == 0) {
+                error = error.empty() ? "invalid iteration count '" + text + "'" : error;
+                return false;
+            }
+            keyGenIterationsSet = true;
+        } else if (arg == "--time") {
+            if (!value(text) || !parseSeconds(text, seconds)) {
+                error = error.empty() ? "invalid time budget '" + text + "'" : error;
+                return false;
+            }
+        } else if (arg == "--threads") {
+            if (!value(text) || !parseCount(text, threads) || threads == 0) {
+                error = error.empty() ? "invalid thread count '" + text + "'" : error;
+                return false;
+            }
+        } else if (arg == "--pin") {
+            size_t cpu = 0;
+            if (!value(text) || !parseCount(text, cpu)) {
+                error = error.empty() ? "invalid CPU '" + text + "'" : error;
+                return false;
+            }
+            pinCpu = static_cast<int>(cpu);
+        } else if (arg == "--cpus") {
+            if (!value(text) || !parseCpuList(text, cpus)) {
+                error = error.empty() ? "invalid CPU list '" + text + "'" : error;
+                return false;
+            }
+        } else if (arg == "--ct-samples") {
+            if (!value(text) || !parseCount(text, leakageSamples) || leakageSamples < 100) {
+                error = error.empty() ? "invalid sample count '" + text + "' (at least 100)"
+                                      : error;
+                return false;
+            }
+        } else if (arg == "--format") {
+            if (!value(format)) {
+                return false;
+            }
+            if (format != "table" && format != "json" && format != "csv") {
+                error = "unknown format '" + format + "' (table, json, csv)";
+                return false;
+            }
+        } else if (arg == "--output" || arg == "-o") {
+            if (!value(output)) {
+                return false;
+            }
+        } else if (arg == "--json" || arg == "--csv") {
+            std::string path;
+            if (!value(path)) {
+                return false;
+            }
+            const std::string extension = "." + arg.substr(2);
+            if (path.size() <= extension.size()
+                || path.compare(path.size() - extension.size(), extension.size(), extension) != 0) {
+                path += extension;
+            }
+            reportPaths.push_back(path);
+        } else if (arg == "--compare") {
+            if (i + 2 >= argc) {
+                error = "--compare needs two files";
+                return false;
+            }
+            baselinePath = argv[++i];
+            currentPath = argv[++i];
+        } else if (arg == "--threshold") {
+            if (!value(text) || !parseNumber(text, thresholdPercent) || thresholdPercent < 0.0) {
+                error = error.empty() ? "invalid threshold '" + text + "'" : error;
+                return false;
+            }
+        } else {
+            error = "unknown option '" + arg + "'";
+            return false;
+        }
+    }
+
+    // Key generation is the slow operation: a tenth of the sign/verify runs by default
+    if (!keyGenIterationsSet && iterations != 100) {
+        keyGenIterations = std::max<size_t>(1, iterations / 10);
+    }
+    if (!output.empty() && format == "table") {
+        error = "--output needs --format json or csv";
+        return false;
+    }
+    return true;
+}
+
+void BenchmarkOptions::printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "       " << program << " --compare <baseline> <current> [--threshold <percent>]\n\n"
+              << "Selection:\n"
+              << "  --schemes <list>          Scheme or family names (default: all)\n"
+              << "  --list-schemes            Print the available schemes and exit\n"
+              << "  --operations <list>       keygen, sign, verify (default: all)\n"
+              << "  --suites <list>           demo, compare, api, sweep, prehash, keygen, rng,\n"
+              << "                            keymemory, scratch, shake, keycache, keystore,\n"
+              << "                            startup, keypool, composite, throughput,\n"
+              << "                            service, instrument, pinned, ct\n"
+              << "                            (default: all but pinned and ct; all suites but\n"
+              << "                            compare need Dilithium3 in --schemes)\n\n"
+              << "Measurement:\n"
+              << "  --sizes <list>            Message sizes for compare, e.g. 32,1K,1M (default 1K)\n"
+              << "  -n, --iterations <n>      Timed sign/verify runs (default 100)\n"
+              << "  --keygen-iterations <n>   Timed key generation runs (default iterations / 10)\n"
+              << "  --time <t>                Time budget per benchmark instead of a run count,\n"
+              << "                            e.g. 500ms, 30s, 5m\n"
+              << "  --threads <n>             Maximum engine threads for throughput and\n"
+              << "                            service (default: hardware threads)\n"
+              << "  --pin <cpu>               Pin the benchmark thread to one CPU\n"
+              << "  --cpus <list>             Cores of the pinned suite, e.g. 0-3,8 (default:\n"
+              << "                            all allowed; --time sets its duration, default 2s)\n"
+              << "  --ct-samples <n>          Measurements per test of the ct suite (default 10000)\n"
+              << "  --no-perf                 Do not read the hardware performance counters\n"
+              << "                            (cycles, instructions, cache and branch misses)\n\n"
+              << "Output:\n"
+              << "  --format <fmt>            table (default), json or csv; json/csv replace the\n"
+              << "                            tables with the machine-readable report\n"
+              << "  -o, --output <file>       Write the --format json/csv report to a file\n"
+              << "  --json <file>             Also write the report as JSON\n"
+              << "  --csv <file>              Also write the report as CSV\n\n"
+              << "Compare mode:\n"
+              << "  --compare A B             Compare two result files and exit; the exit code\n"
+              << "                            is 1 if B has a significant slowdown against A\n"
+              << "  --threshold <pct>         Minimum median slowdown (default 5)\n";
+}
@@ -0,0 +1,94 @@
+/**
+ * @file BenchmarkOptions.hpp
+ * @brief Command line options of dilithium_benchmark
+ *
+ * Every option has a default that reproduces the full benchmark, so running
+ * the binary without arguments behaves as before. Capacity tests narrow the
+ * run down, e.g.
+ *
+ * @code
+ * dilithium_benchmark --schemes dilithium3 --operations sign,verify \
+ *     --sizes 1K,1M --time 60 --pin 2 --format json --output run.json
+ * @endcode
+ *
+ * @author Student Project - Cryptographic Systems Course
+ * @date December 2025
+ */
+
+#ifndef BENCHMARK_OPTIONS_HPP
+#define BENCHMARK_OPTIONS_HPP
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+/**
+ * @brief Parsed command line
+ */
+struct BenchmarkOptions {
+    // What to run
+    std::string schemes = "all";            // Scheme/family names, see SchemeRegistry::select()
+    bool keyGen = true;                     // --operations
+    bool sign = true;
+    bool verify = true;
+    std::vector<std::string> suites = {"demo", "compare", "api", "sweep", "prehash", "keygen",
+                                         "rng", "keymemory", "scratch", "shake", "keycache",
+                                         "keystore", "startup", "keypool", "composite",
+                                         "throughput", "service", "instrument"};
+    bool listSchemes = false;
+    bool help = false;
+
+    // How long to run it
+    std::vector<size_t> messageSizes = {1024};
+    size_t iterations = 100;                // Timed sign/verify runs per benchmark
+    size_t keyGenIterations = 10;           // Timed key generation runs per benchmark
+    double seconds = 0.0;                   // Time budget per benchmark, replaces the counts
+    size_t threads = 0;                     // Maximum engine threads (0: hardware threads)
+    int pinCpu = -1;                        // Pin the benchmark thread to this CPU (-1: off)
+    std::vector<int> cpus;                  // Cores of the pinned suite (empty: all allowed)
+    size_t leakageSamples = 10000;          // Measurements per test of the ct suite
+    bool perfCounters = true;               // Hardware counters in Result (--no-perf)
+
+    // Where the results go
+    std::string format = "table";           // table, json or csv
+    std::string output;                     // File for --format json/csv (empty: stdout)
+    std::vector<std::string> reportPaths;   // --json/--csv files, written in addition
+
+    // Compare mode
+    std::string baselinePath;
+    std::string currentPath;
+    double thresholdPercent = 5.0;
+
+    /**
+     * @brief Check whether a suite was selected
+     */
+    bool runs(const std::string& suite) const;
+
+    /**
+     * @brief Parse the command line
+     * @param argc Argument count from main()
+     * @param argv Arguments from main()
+     * @param error Receives a description of the first invalid argument
+     * @return true if all arguments were valid
+     */
+    bool parse(int argc, char** argv, std::string& error);
+
+    /**
+     * @brief Print the option summary
+     */
+    static void printUsage(const char* program);
+};
+
+/**
+ * @brief Parse a non-negative decimal count
+ */
+bool parseCount(const std::string& text, size_t& value);
+
+/**
+ * @brief Parse a byte count such as 4096, 64K, 1M, 1MB or 1MiB (powers of 1024)
+ *
+ * Shared by dilithium_benchmark --sizes and dilithium_sign --read-size.
+ */
+bool parseBytes(const std::string& text, size_t& value);
+
+#endif // BENCHMARK_OPTIONS_HPP
@@ -0,0 +1,807 @@
+/**
+ * @file BenchmarkReport.cpp
+ * @brief JSON/CSV reporters, report loading and regression comparison
+ */
+
+#include "BenchmarkReport.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/utsname.h>
+#include <unistd.h>
+#endif
+
+#ifndef BENCHMARK_BUILD_FLAGS
+#define BENCHMARK_BUILD_FLAGS "unknown"
+#endif
+
+namespace {
+
+// ==================== Host information ====================
+
+std::string detectCpuModel() {
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line)) {
+        if (line.compare(0, 10, "model name") == 0) {
+            size_t colon = line.find(':');
+            if (colon != std::string::npos) {
+                size_t start = line.find_first_not_of(" \t", colon + 1);
+                return start == std::string::npos ? std::string() : line.substr(start);
+            }
+        }
+    }
+    return "unknown";
+}
+
+std::string detectCompiler() {
+#if defined(__clang__)
+    return "clang " __clang_version__;
+#elif defined(__GNUC__)
+    return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+    return "msvc " + std::to_string(_MSC_VER);
+#else
+    return "unknown";
+#endif
+}
+
+std::string utcTimestamp() {
+    std::time_t now = std::time(nullptr);
+    std::tm utc{};
+#if defined(_WIN32)
+    gmtime_s(&utc, &now);
+#else
+    gmtime_r(&now, &utc);
+#endif
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", &utc);
+    return buffer;
+}
+
+// ==================== Writing helpers ====================
+
+std::string jsonEscape(const std::string& text) {
+    std::ostringstream out;
+    for (char c : text) {
+        switch (c) {
+            case '"':  out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\r': out << "\\r"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    out << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+                        << static_cast<int>(c) << std::dec << std::setfill(' ');
+                } else {
+                    out << c;
+                }
+        }
+    }
+    return out.str();
+}
+
+std::string csvField(const std::string& text) {
+    if (text.find_first_of(",\"\n") == std::string::npos) {
+        return text;
+    }
+    std::string quoted = "\"";
+    for (char c : text) {
+        quoted += c;
+        if (c == '"') {
+            quoted += '"';
+        }
+    }
+    return quoted + "\"";
+}
+
+std::string recordKey(const BenchmarkRecord& record) {
+    return record.scheme + "/" + record.parameterSet + "/" + record.backend + "/"
+         + record.operation + "/" + std::to_string(record.messageBytes);
+}
+
+// ==================== Minimal JSON reader ====================
+
+/**
+ * @brief Parsed JSON value (only what the report format needs)
+ */
+struct JsonValue {
+    enum class Type { Null, Bool, Number, String, Array, Object };
+    Type type = Type::Null;
+    bool boolean = false;
+    double number = 0.0;
+    std::string string;
+    std::vector<JsonValue> array;
+    std::vector<std::pair<std::string, JsonValue>> object;
+
+    const JsonValue* find(const std::string& key) const {
+        for (const auto& member : object) {
+            if (member.first == key) {
+                return &member.second;
+            }
+        }
+        return nullptr;
+    }
+
+    std::string stringOr(const std::string& key, const std::string& fallback) const {
+        const JsonValue* value = find(key);
+        return value && value->type == Type::String ? value->string : fallback;
+    }
+
+    double numberOr(const std::string& key, double fallback) const {
+        const JsonValue* value = find(key);
+        return value && value->type == Type::Number ? value->number : fallback;
+    }
+};
+
+class JsonParser {
+public:
+    explicit JsonParser(const std::string& text) : text_(text), pos_(0) {}
+
+    bool parse(JsonValue& value) {
+        if (!parseValue(value)) {
+            return false;
+        }
+        skipWhitespace();
+        return pos_ == text_.size();
+    }
+
+private:
+    const std::string& text_;
+    size_t pos_;
+
+    void skipWhitespace() {
+        while (pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_]))) {
+            ++pos_;
+        }
+    }
+
+    bool consume(char expected) {
+        skipWhitespace();
+        if (pos_ < text_.size() && text_[pos_] == expected) {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+
+    bool parseLiteral(const char* literal) {
+        size_t length = std::char_traits<char>::length(literal);
+        if (text_.compare(pos_, length, literal) != 0) {
+            return false;
+        }
+        pos_ += length;
+        return true;
+    }
+
+    bool parseString(std::string& out) {
+        if (!consume('"')) {
+            return false;
+        }
+        out.clear();
+        while (pos_ < text_.size()) {
+            char c = text_[pos_++];
+            if (c == '"') {
+                return true;
+            }
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (pos_ >= text_.size()) {
+                return false;
+            }
+            char escaped = text_[pos_++];
+            switch (escaped) {
+                case '"':  out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/':  out += '/'; break;
+                case 'n':  out += '\n'; break;
+                case 'r':  out += '\r'; break;
+                case 't':  out += '\t'; break;
+                case 'b':  out += '\b'; break;
+                case 'f':  out += '\f'; break;
+                case 'u': {
+                    // The writer only escapes control characters, keep it ASCII
+                    if (pos_ + 4 > text_.size()) {
+                        return false;
+                    }
+                    unsigned long code = std::strtoul(text_.substr(pos_, 4).c_str(), nullptr, 16);
+                    out += code < 0x80 ? static_cast<char>(code) : '?';
+                    pos_ += 4;
+                    break;
+                }
+                default:
+                    return false;
+            }
+        }
+        return false;
+    }
+
+    bool parseValue(JsonValue& value) {
+        skipWhitespace();
+        if (pos_ >= text_.size()) {
+            return false;
+        }
+
+        char c = text_[pos_];
+        if (c == '{') {
+            ++pos_;
+            value.type = JsonValue::Type::Object;
+            if (consume('}')) {
+                return true;
+            }
+            do {
+                std::string key;
+                JsonValue member;
+                if (!parseString(key) || !consume(':') || !parseValue(member)) {
+                    return false;
+                }
+                value.object.emplace_back(std::move(key), std::move(member));
+            } while (consume(','));
+            return consume('}');
+        }
+        if (c == '[') {
+            ++pos_;
+            value.type = JsonValue::Type::Array;
+            if (consume(']')) {
+                return true;
+            }
+            do {
+                JsonValue element;
+                if (!parseValue(element)) {
+                    return false;
+                }
+                value.array.push_back(std::move(element));
+            } while (consume(','));
+            return consume(']');
+        }
+        if (c == '"') {
+            value.type = JsonValue::Type::String;
+            return parseString(value.string);
+        }
+        if (c == 't' || c == 'f') {
+            value.type = JsonValue::Type::Bool;
+            value.boolean = (c == 't');
+            return parseLiteral(value.boolean ? "true" : "false");
+        }
+        if (c == 'n') {
+            value.type = JsonValue::Type::Null;
+            return parseLiteral("null");
+        }
+
+        const char* start = text_.c_str() + pos_;
+        char* end = nullptr;
+        value.type = JsonValue::Type::Number;
+        value.number = std::strtod(start, &end);
+        if (end == start) {
+            return false;
+        }
+        pos_ += static_cast<size_t>(end - start);
+        return true;
+    }
+};
+
+// ==================== CSV reading ====================
+
+std::vector<std::string> splitCsvLine(const std::string& line) {
+    std::vector<std::string> fields(1);
+    bool quoted = false;
+    for (size_t i = 0; i < line.size(); ++i) {
+        char c = line[i];
+        if (quoted) {
+            if (c == '"' && i + 1 < line.size() && line[i + 1] == '"') {
+                fields.back() += '"';
+                ++i;
+            } else if (c == '"') {
+                quoted = false;
+            } else {
+                fields.back() += c;
+            }
+        } else if (c == '"') {
+            quoted = true;
+        } else if (c == ',') {
+            fields.emplace_back();
+        } else if (c != '\r') {
+            fields.back() += c;
+        }
+    }
+    return fields;
+}
+
+const char* const CSV_COLUMNS[] = {
+    "scheme", "parameter_set", "backend", "operation", "message_bytes",
+    "iterations", "warmup", "mean_ms", "min_ms", "max_ms", "stddev_ms",
+    "median_ms", "p90_ms", "p99_ms", "p999_ms", "mean_cycles", "median_cycles",
+    "core_cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses",
+    "allocations", "samples_ms"
+};
+
+// ==================== Statistics ====================
+
+/**
+ * @brief One-sided Mann-Whitney U test that current is stochastically larger
+ * @return Normal-approximation z score (positive when current is slower)
+ */
+double mannWhitneyZ(const std::vector<double>& baseline, const std::vector<double>& current) {
+    const size_t n1 = baseline.size();
+    const size_t n2 = current.size();
+    if (n1 == 0 || n2 == 0) {
+        return 0.0;
+    }
+
+    // Rank the pooled samples, ties get the average rank
+    std::vector<std::pair<double, int>> pooled;
+    pooled.reserve(n1 + n2);
+    for (double value : baseline) {
+        pooled.emplace_back(value, 0);
+    }
+    for (double value : current) {
+        pooled.emplace_back(value, 1);
+    }
+    std::sort(pooled.begin(), pooled.end());
+
+    double currentRankSum = 0.0;
+    for (size_t i = 0; i < pooled.size();) {
+        size_t j = i;
+        while (j < pooled.size() && pooled[j].first == pooled[i].first) {
+            ++j;
+        }
+        double rank = (i + 1 + j) / 2.0;
+        for (size_t k = i; k < j; ++k) {
+            if (pooled[k].second == 1) {
+                currentRankSum += rank;
+            }
+        }
+        i = j;
+    }
+
+    double u = currentRankSum - n2 * (n2 + 1) / 2.0;
+    double mean = n1 * n2 / 2.0;
+    double sigma = std::sqrt(n1 * n2 * (n1 + n2 + 1) / 12.0);
+    return sigma > 0.0 ? (u - mean) / sigma : 0.0;
+}
+
+/**
+ * @brief Critical z of the standard normal for a one-sided test
+ */
+double criticalZ(double alpha) {
+    if (alpha <= 0.001) {
+        return 3.090;
+    }
+    if (alpha <= 0.01) {
+        return 2.326;
+    }
+    return 1.645;
+}
+
+double medianOf(std::vector<double> values) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    std::sort(values.begin(), values.end());
+    size_t middle = values.size() / 2;
+    return values.size() % 2 ? values[middle] : (values[middle - 1] + values[middle]) / 2.0;
+}
+
+} // namespace
+
+// ==================== HostInfo ====================
+
+HostInfo HostInfo::detect() {
+    HostInfo info;
+    info.hostname = "unknown";
+    info.operatingSystem = "unknown";
+
+#if defined(__unix__) || defined(__APPLE__)
+    char name[256] = {0};
+    if (gethostname(name, sizeof(name) - 1) == 0) {
+        info.hostname = name;
+    }
+    struct utsname uts;
+    if (uname(&uts) == 0) {
+        info.operatingSystem = std::string(uts.sysname) + " " + uts.release + " " + uts.machine;
+    }
+#endif
+
+    info.cpuModel = detectCpuModel();
+    info.logicalCpus = std::thread::hardware_concurrency();
+    info.compiler = detectCompiler();
+    info.buildFlags = BENCHMARK_BUILD_FLAGS;
+    info.timestamp = utcTimestamp();
+    return info;
+}
+
+// ==================== BenchmarkReport ====================
+
+BenchmarkReport::BenchmarkReport()
+    : host_(HostInfo::detect()) {
+}
+
+void BenchmarkReport::add(const std::string& scheme, const std::string& parameterSet,
+                          const std::string& backend, const std::string& operation,
+                          size_t messageBytes, const Benchmark::Result& result) {
+    records_.push_back({scheme, parameterSet, backend, operation, messageBytes, result});
+}
+
+bool BenchmarkReport::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+
+    host_ = HostInfo();
+    records_.clear();
+
+    auto endsWith = [&path](const std::string& suffix) {
+        return path.size() >= suffix.size()
+            && path.compare(path.size() - suffix.size(), suffix.size(), suffix) == 0;
+    };
+    if (endsWith(".csv")) {
+        return loadCsv(buffer.str());
+    }
+    return loadJson(buffer.str());
+}
+
+bool BenchmarkReport::loadJson(const std::string& text) {
+    JsonValue root;
+    if (!JsonParser(text).parse(root) || root.type != JsonValue::Type::Object) {
+        return false;
+    }
+
+    if (const JsonValue* host = root.find("host")) {
+        host_.hostname = host->stringOr("hostname", "");
+        host_.cpuModel = host->stringOr("cpu_model", "");
+        host_.logicalCpus = static_cast<size_t>(host->numberOr("logical_cpus", 0));
+        host_.operatingSystem = host->stringOr("os", "");
+        host_.compiler = host->stringOr("compiler", "");
+        host_.buildFlags = host->stringOr("build_flags", "");
+        host_.timestamp = host->stringOr("timestamp", "");
+    }
+
+    const JsonValue* results = root.find("results");
+    if (!results || results->type != JsonValue::Type::Array) {
+        return false;
+    }
+
+    for (const JsonValue& item : results->array) {
+        BenchmarkRecord record;
+        record.scheme = item.stringOr("scheme", "");
+        record.parameterSet = item.stringOr("parameter_set", "");
+        record.backend = item.stringOr("backend", "");
+        record.operation = item.stringOr("operation", "");
+        record.messageBytes = static_cast<size_t>(item.numberOr("message_bytes", 0));
+
+        Benchmark::Result& r = record.result;
+        r.iterations = static_cast<size_t>(item.numberOr("iterations", 0));
+        r.warmupIterations = static_cast<size_t>(item.numberOr("warmup", 0));
+        r.averageTime = item.numberOr("mean_ms", 0);
+        r.minTime = item.numberOr("min_ms", 0);
+        r.maxTime = item.numberOr("max_ms", 0);
+        r.stdDev = item.numberOr("stddev_ms", 0);
+        r.medianTime = item.numberOr("median_ms", 0);
+        r.p90Time = item.numberOr("p90_ms", 0);
+        r.p99Time = item.numberOr("p99_ms", 0);
+        r.p999Time = item.numberOr("p999_ms", 0);
+        r.averageCycles = item.numberOr("mean_cycles", 0);
+        r.medianCycles = item.numberOr("median_cycles", 0);
+        r.coreCycles = item.numberOr("core_cycles", 0);
+        r.instructions = item.numberOr("instructions", 0);
+        r.l1dMisses = item.numberOr("l1d_misses", 0);
+        r.llcMisses = item.numberOr("llc_misses", 0);
+        r.branchMisses = item.numberOr("branch_misses", 0);
+        r.allocations = item.numberOr("allocations", 0);
+
+        if (const JsonValue* samples = item.find("samples_ms")) {
+            for (const JsonValue& sample : samples->array) {
+                r.samples.push_back(sample.number);
+            }
+        }
+        records_.push_back(std::move(record));
+    }
+    return true;
+}
+
+bool BenchmarkReport::loadCsv(const std::string& text) {
+    std::istringstream in(text);
+    std::string line;
+    std::vector<std::string> header;
+
+    while (std::getline(in, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        if (line[0] == '#') {
+            // "# key=value" host lines
+            size_t equals = line.find('=');
+            if (equals == std::string::npos) {
+                continue;
+            }
+            std::string key = line.substr(2, equals - 2);
+            std::string value = line.substr(equals + 1);
+            if (key == "hostname") host_.hostname = value;
+            else if (key == "cpu_model") host_.cpuModel = value;
+            else if (key == "logical_cpus") host_.logicalCpus = std::strtoul(value.c_str(), nullptr, 10);
+            else if (key == "os") host_.operatingSystem = value;
+            else if (key == "compiler") host_.compiler = value;
+            else if (key == "build_flags") host_.buildFlags = value;
+            else if (key == "timestamp") host_.timestamp = value;
+            continue;
+        }
+        if (header.empty()) {
+            header = splitCsvLine(line);
+            continue;
+        }
+
+        std::vector<std::string> fields = splitCsvLine(line);
+        std::map<std::string, std::string> row;
+        for (size_t i = 0; i < header.size() && i < fields.size(); ++i) {
+            row[header[i]] = fields[i];
+        }
+        auto number = [&row](const char* column) {
+            return std::strtod(row[column].c_str(), nullptr);
+        };
+
+        BenchmarkRecord record;
+        record.scheme = row["scheme"];
+        record.parameterSet = row["parameter_set"];
+        record.backend = row["backend"];
+        record.operation = row["operation"];
+        record.messageBytes = static_cast<size_t>(number("message_bytes"));
+
+        Benchmark::Result& r = record.result;
+        r.iterations = static_cast<size_t>(number("iterations"));
+        r.warmupIterations = static_cast<size_t>(number("warmup"));
+        r.averageTime = number("mean_ms");
+        r.minTime = number("min_ms");
+        r.maxTime = number("max_ms");
+        r.stdDev = number("stddev_ms");
+        r.medianTime = number("median_ms");
+        r.p90Time = number("p90_ms");
+        r.p99Time = number("p99_ms");
+        r.p999Time = number("p999_ms");
+        r.averageCycles = number("mean_cycles");
+        r.medianCycles = number("median_cycles");
+        r.coreCycles = number("core_cycles");
+        r.instructions = number("instructions");
+        r.l1dMisses = number("l1d_misses");
+        r.llcMisses = number("llc_misses");
+        r.branchMisses = number("branch_misses");
+        r.allocations = number("allocations");
+
+        std::istringstream samples(row["samples_ms"]);
+        std::string sample;
+        while (std::getline(samples, sample, ';')) {
+            if (!sample.empty()) {
+                r.samples.push_back(std::strtod(sample.c_str(), nullptr));
+            }
+        }
+        records_.push_back(std::move(record));
+    }
+    return !header.empty();
+}
+
+// ==================== Reporters ====================
+
+bool BenchmarkReporter::writeFile(const BenchmarkReport& report, const std::string& path) const {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        return false;
+    }
+    return write(report, out);
+}
+
+std::unique_ptr<BenchmarkReporter> BenchmarkReporter::forFormat(const std::string& format) {
+    auto matches = [&format](const std::string& name) {
+        if (format == name) {
+            return true;
+        }
+        std::string suffix = "." + name;
+        return format.size() > suffix.size()
+            && format.compare(format.size() - suffix.size(), suffix.size(), suffix) == 0;
+    };
+    if (matches("json")) {
+        return std::unique_ptr<BenchmarkReporter>(new JsonReporter());
+    }
+    if (matches("csv")) {
+        return std::unique_ptr<BenchmarkReporter>(new CsvReporter());
+    }
+    return nullptr;
+}
+
+bool JsonReporter::write(const BenchmarkReport& report, std::ostream& out) const {
+    const HostInfo& host = report.host();
+    out << std::setprecision(9);
+    out << "{\n";
+    out << "  \"schema\": 1,\n";
+    out << "  \"host\": {\n";
+    out << "    \"hostname\": \"" << jsonEscape(host.hostname) << "\",\n";
+    out << "    \"cpu_model\": \"" << jsonEscape(host.cpuModel) << "\",\n";
+    out << "    \"logical_cpus\": " << host.logicalCpus << ",\n";
+    out << "    \"os\": \"" << jsonEscape(host.operatingSystem) << "\",\n";
+    out << "    \"compiler\": \"" << jsonEscape(host.compiler) << "\",\n";
+    out << "    \"build_flags\": \"" << jsonEscape(host.buildFlags) << "\",\n";
+    out << "    \"timestamp\": \"" << jsonEscape(host.timestamp) << "\"\n";
+    out << "  },\n";
+    out << "  \"results\": [";
+
+    const std::vector<BenchmarkRecord>& records = report.records();
+    for (size_t i = 0; i < records.size(); ++i) {
+        const BenchmarkRecord& record = records[i];
+        const Benchmark::Result& r = record.result;
+        out << (i ? ",\n" : "\n");
+        out << "    {\n";
+        out << "      \"scheme\": \"" << jsonEscape(record.scheme) << "\",\n";
+        out << "      \"parameter_set\": \"" << jsonEscape(record.parameterSet) << "\",\n";
+        out << "      \"backend\": \"" << jsonEscape(record.backend) << "\",\n";
+        out << "      \"operation\": \"" << jsonEscape(record.operation) << "\",\n";
+        out << "      \"message_bytes\": " << record.messageBytes << ",\n";
+        out << "      \"iterations\": " << r.iterations << ",\n";
+        out << "      \"warmup\": " << r.warmupIterations << ",\n";
+        out << "      \"mean_ms\": " << r.averageTime << ",\n";
+        out << "      \"min_ms\": " << r.minTime << ",\n";
+        out << "      \"max_ms\": " << r.maxTime << ",\n";
+        out << "      \"stddev_ms\": " << r.stdDev << ",\n";
+        out << "      \"median_ms\": " << r.medianTime << ",\n";
+        out << "      \"p90_ms\": " << r.p90Time << ",\n";
+        out << "      \"p99_ms\": " << r.p99Time << ",\n";
+        out << "      \"p999_ms\": " << r.p999Time << ",\n";
+        out << "      \"mean_cycles\": " << r.averageCycles << ",\n";
+        out << "      \"median_cycles\": " << r.medianCycles << ",\n";
+        out << "      \"core_cycles\": " << r.coreCycles << ",\n";
+        out << "      \"instructions\": " << r.instructions << ",\n";
+        out << "      \"ipc\": " << r.ipc() << ",\n";
+        out << "      \"l1d_misses\": " << r.l1dMisses << ",\n";
+        out << "      \"llc_misses\": " << r.llcMisses << ",\n";
+        out << "      \"branch_misses\": " << r.branchMisses << ",\n";
+        out << "      \"allocations\": " << r.allocations << ",\n";
+        out << "      \"samples_ms\": [";
+        for (size_t j = 0; j < r.samples.size(); ++j) {
+            out << (j ? ", " : "") << r.samples[j];
+        }
+        out << "]\n";
+        out << "    }";
+    }
+    out << (records.empty() ? "]\n" : "\n  ]\n");
+    out << "}\n";
+    return static_cast<bool>(out);
+}
+
+bool CsvReporter::write(const BenchmarkReport& report, std::ostream& out) const {
+    const HostInfo& host = report.host();
+    out << std::setprecision(9);
+    out << "# hostname=" << host.hostname << "\n";
+    out << "# cpu_model=" << host.cpuModel << "\n";
+    out << "# logical_cpus=" << host.logicalCpus << "\n";
+    out << "# os=" << host.operatingSystem << "\n";
+    out << "# compiler=" << host.compiler << "\n";
+    out << "# build_flags=" << host.buildFlags << "\n";
+    out << "# timestamp=" << host.timestamp << "\n";
+
+    bool first = true;
+    for (const char* column : CSV_COLUMNS) {
+        out << (first ? "" : ",") << column;
+        first = false;
+    }
+    out << "\n";
+
+    for (const BenchmarkRecord& record : report.records()) {
+        const Benchmark::Result& r = record.result;
+        out << csvField(record.scheme) << ","
+            << csvField(record.parameterSet) << ","
+            << csvField(record.backend) << ","
+            << csvField(record.operation) << ","
+            << record.messageBytes << ","
+            << r.iterations << ","
+            << r.warmupIterations << ","
+            << r.averageTime << ","
+            << r.minTime << ","
+            << r.maxTime << ","
+            << r.stdDev << ","
+            << r.medianTime << ","
+            << r.p90Time << ","
+            << r.p99Time << ","
+            << r.p999Time << ","
+            << r.averageCycles << ","
+            << r.medianCycles << ","
+            << r.coreCycles << ","
+            << r.instructions << ","
+            << r.l1dMisses << ","
+            << r.llcMisses << ","
+            << r.branchMisses << ","
+            << r.allocations << ",";
+        for (size_t j = 0; j < r.samples.size(); ++j) {
+            out << (j ? ";" : "") << r.samples[j];
+        }
+        out << "\n";
+    }
+    return static_cast<bool>(out);
+}
+
+// ==================== Comparison ====================
+
+std::vector<ComparisonEntry> compareReports(const BenchmarkReport& baseline,
+                                            const BenchmarkReport& current,
+                                            double thresholdPercent, double alpha) {
+    std::map<std::string, const BenchmarkRecord*> baselineByKey;
+    for (const BenchmarkRecord& record : baseline.records()) {
+        baselineByKey[recordKey(record)] = &record;
+    }
+
+    const double zCritical = criticalZ(alpha);
+    std::vector<ComparisonEntry> entries;
+
+    for (const BenchmarkRecord& record : current.records()) {
+        auto match = baselineByKey.find(recordKey(record));
+        if (match == baselineByKey.end()) {
+            continue;
+        }
+        const Benchmark::Result& before = match->second->result;
+        const Benchmark::Result& after = record.result;
+
+        ComparisonEntry entry;
+        entry.key = match->first;
+        entry.baselineMedian = before.samples.empty() ? before.medianTime : medianOf(before.samples);
+        entry.currentMedian = after.samples.empty() ? after.medianTime : medianOf(after.samples);
+        entry.changePercent = entry.baselineMedian > 0.0
+            ? (entry.currentMedian - entry.baselineMedian) / entry.baselineMedian * 100.0
+            : 0.0;
+        entry.zScore = mannWhitneyZ(before.samples, after.samples);
+        entry.significant = entry.zScore > zCritical;
+        entry.regression = entry.significant && entry.changePercent > thresholdPercent;
+        entries.push_back(entry);
+    }
+    return entries;
+}
+
+size_t printComparison(const std::vector<ComparisonEntry>& entries, std::ostream& out) {
+    auto separator = [&out]() {
+        out << "+" << std::string(62, '-') << "+" << std::string(14, '-')
+            << "+" << std::string(14, '-') << "+" << std::string(10, '-')
+            << "+" << std::string(8, '-') << "+" << std::string(12, '-') << "+\n";
+    };
+
+    separator();
+    out << "| " << std::setw(60) << std::left << "Benchmark"
+        << " | " << std::setw(12) << "Base (ms)"
+        << " | " << std::setw(12) << "Curr (ms)"
+        << " | " << std::setw(8) << "Change"
+        << " | " << std::setw(6) << "z"
+        << " | " << std::setw(10) << "Verdict"
+        << " |\n";
+    separator();
+
+    size_t regressions = 0;
+    for (const ComparisonEntry& entry : entries) {
+        const char* verdict = entry.regression ? "REGRESSION"
+                            : entry.zScore < -criticalZ(0.01) ? "faster" : "ok";
+        regressions += entry.regression ? 1 : 0;
+
+        std::ostringstream change;
+        change << std::fixed << std::setprecision(1) << std::showpos << entry.changePercent << "%";
+
+        out << std::fixed << std::setprecision(4);
+        out << "| " << std::setw(60) << std::left << entry.key.substr(0, 60)
+            << " | " << std::setw(12) << entry.baselineMedian
+            << " | " << std::setw(12) << entry.currentMedian
+            << " | " << std::setw(8) << change.str()
+            << " | " << std::setw(6) << std::setprecision(2) << entry.zScore
+            << " | " << std::setw(10) << verdict
+            << " |\n";
+    }
+    separator();
+    return regressions;
+}
@@ -0,0 +1,175 @@
+/**
+ * @file BenchmarkReport.hpp
+ * @brief Machine-readable benchmark results (JSON/CSV) and regression comparison
+ *
+ * A BenchmarkReport collects one record per measured operation together
+ * with a description of the host and build. Reporters serialize a report
+ * to JSON or CSV, including every per-iteration sample, so results can be
+ * fed into dashboards and compared between releases.
+ *
+ * compareReports() matches the records of two reports by scheme, parameter
+ * set, backend, operation and message size and runs a one-sided
+ * Mann-Whitney U test on the samples. A record is flagged as a regression
+ * when the current samples are significantly slower and the median grew by
+ * more than a threshold.
+ *
+ * @author Student Project - Cryptographic Systems Course
+ * @date December 2025
+ */
+
+#ifndef BENCHMARK_REPORT_HPP
+#define BENCHMARK_REPORT_HPP
+
+#include "Benchmark.hpp"
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstddef>
+
+/**
+ * @brief Description of the machine and build that produced a report
+ */
+struct HostInfo {
+    std::string hostname;
+    std::string cpuModel;
+    size_t logicalCpus;
+    std::string operatingSystem;
+    std::string compiler;
+    std::string buildFlags;
+    std::string timestamp;      // UTC, ISO 8601
+
+    /**
+     * @brief Collect the information for the running process
+     */
+    static HostInfo detect();
+};
+
+/**
+ * @brief One measured operation
+ */
+struct BenchmarkRecord {
+    std::string scheme;         // e.g. "Dilithium3", "RSA-2048"
+    std::string parameterSet;   // e.g. "NIST Level 3", "112-bit"
+    std::string backend;        // e.g. "ref", "avx2", "openssl"
+    std::string operation;      // e.g. "keygen", "sign", "verify"
+    size_t messageBytes;
+    Benchmark::Result result;
+};
+
+/**
+ * @brief All records of one benchmark run
+ */
+class BenchmarkReport {
+public:
+    /**
+     * @brief Constructor - fills in the host information of this process
+     */
+    BenchmarkReport();
+
+    /**
+     * @brief Append a record
+     */
+    void add(const std::string& scheme, const std::string& parameterSet,
+             const std::string& backend, const std::string& operation,
+             size_t messageBytes, const Benchmark::Result& result);
+
+    /**
+     * @brief Load a report written by JsonReporter or CsvReporter
+     *
+     * The format is chosen by the file extension (.json or .csv).
+     *
+     * @param path Path of the report file
+     * @return true if the file was read and parsed
+     */
+    bool load(const std::string& path);
+
+    const HostInfo& host() const { return host_; }
+    const std::vector<BenchmarkRecord>& records() const { return records_; }
+
+private:
+    HostInfo host_;
+    std::vector<BenchmarkRecord> records_;
+
+    bool loadJson(const std::string& text);
+    bool loadCsv(const std::string& text);
+};
+
+/**
+ * @brief Serializes a BenchmarkReport in one output format
+ */
+class BenchmarkReporter {
+public:
+    virtual ~BenchmarkReporter() = default;
+
+    /**
+     * @brief Write the report to a stream
+     * @return true if the stream is still good afterwards
+     */
+    virtual bool write(const BenchmarkReport& report, std::ostream& out) const = 0;
+
+    /**
+     * @brief Write the report to a file
+     * @return true if the file was written
+     */
+    bool writeFile(const BenchmarkReport& report, const std::string& path) const;
+
+    /**
+     * @brief Create the reporter for a format name or file extension
+     * @param format "json" or "csv" (a path ending in .json/.csv also works)
+     * @return The reporter, or nullptr for an unknown format
+     */
+    static std::unique_ptr<BenchmarkReporter> forFormat(const std::string& format);
+};
+
+/**
+ * @brief One JSON document with a "host" object and a "results" array
+ */
+class JsonReporter : public BenchmarkReporter {
+public:
+    bool write(const BenchmarkReport& report, std::ostream& out) const override;
+};
+
+/**
+ * @brief "# key=value" host lines, a header row and one row per record
+ *
+ * The samples column holds the per-iteration times separated by ';'.
+ */
+class CsvReporter : public BenchmarkReporter {
+public:
+    bool write(const BenchmarkReport& report, std::ostream& out) const override;
+};
+
+/**
+ * @brief Outcome of comparing one record between two reports
+ */
+struct ComparisonEntry {
+    std::string key;            // scheme/parameter set/backend/operation/size
+    double baselineMedian;      // Milliseconds
+    double currentMedian;       // Milliseconds
+    double changePercent;       // Median change, positive = slower
+    double zScore;              // Mann-Whitney U statistic, positive = current slower
+    bool significant;           // One-sided test rejects "not slower" at the given alpha
+    bool regression;            // significant and changePercent > threshold
+};
+
+/**
+ * @brief Compare the records two reports have in common
+ * @param baseline Earlier report
+ * @param current Report under test
+ * @param thresholdPercent Minimum median slowdown to report as a regression
+ * @param alpha One-sided significance level (0.01, 0.05 or 0.001)
+ * @return One entry per record present in both reports
+ */
+std::vector<ComparisonEntry> compareReports(const BenchmarkReport& baseline,
+                                            const BenchmarkReport& current,
+                                            double thresholdPercent = 5.0,
+                                            double alpha = 0.01);
+
+/**
+ * @brief Print a comparison as a table
+ * @return Number of regressions
+ */
+size_t printComparison(const std::vector<ComparisonEntry>& entries, std::ostream& out);
+
+#endif // BENCHMARK_REPORT_HPP
@@ -0,0 +1,479 @@
+/**
+ * @file BulkSigner.cpp
+ * @brief Implementation of the pipelined bulk file signer
+ */
+
+#include "BulkSigner.hpp"
+#include "DilithiumStream.hpp"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <utility>
+#include <cerrno>
+#include <cstdio>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#define BULK_SIGNER_HAVE_POSIX_IO 1
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double secondsBetween(Clock::time_point start, Clock::time_point end) {
+    return std::chrono::duration<double>(end - start).count();
+}
+
+/**
+ * @brief FIFO between two stages: push() blocks while full, pop() while empty
+ */
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity_(std::max<size_t>(1, capacity)) {}
+
+    /**
+     * @return false if the queue was closed
+     */
+    bool push(T item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notFull_.wait(lock, [this]() { return closed_ || items_.size() < capacity_; });
+        if (closed_) {
+            return false;
+        }
+        items_.push_back(std::move(item));
+        notEmpty_.notify_one();
+        return true;
+    }
+
+    /**
+     * @return false once the queue is closed and drained
+     */
+    bool pop(T& item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notEmpty_.wait(lock, [this]() { return closed_ || !items_.empty(); });
+        if (items_.empty()) {
+            return false;
+        }
+        item = std::move(items_.front());
+        items_.pop_front();
+        notFull_.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief Refuse further pushes; pop() drains what is left
+     */
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        notFull_.notify_all();
+        notEmpty_.notify_all();
+    }
+
+private:
+    const size_t capacity_;
+    std::deque<T> items_;
+    bool closed_ = false;
+    std::mutex mutex_;
+    std::condition_variable notFull_;
+    std::condition_variable notEmpty_;
+};
+
+/**
+ * @brief Sequential reader: read() with POSIX_FADV_SEQUENTIAL, stdio elsewhere
+ */
+class InputFile {
+public:
+    explicit InputFile(const std::string& path) {
+#ifdef BULK_SIGNER_HAVE_POSIX_IO
+        fd_ = ::open(path.c_str(), O_RDONLY);
+#ifdef POSIX_FADV_SEQUENTIAL
+        if (fd_ >= 0) {
+            // Larger kernel read-ahead; the stage itself never reads backwards
+            ::posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+        }
+#endif
+#else
+        file_ = std::fopen(path.c_str(), "rb");
+#endif
+    }
+
+    ~InputFile() {
+#ifdef BULK_SIGNER_HAVE_POSIX_IO
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+#else
+        if (file_) {
+            std::fclose(file_);
+        }
+#endif
+    }
+
+    InputFile(const InputFile&) = delete;
+    InputFile& operator=(const InputFile&) = delete;
+
+    bool isOpen() const {
+#ifdef BULK_SIGNER_HAVE_POSIX_IO
+        return fd_ >= 0;
+#else
+        return file_ != nullptr;
+#endif
+    }
+
+    /**
+     * @brief Fill data with up to length bytes
+     * @param end Set when the end of the file was reached
+     * @return false on a read error
+     */
+    bool read(uint8_t* data, size_t length, size_t& filled, bool& end) {
+        filled = 0;
+        end = false;
+        while (filled < length) {
+#ifdef BULK_SIGNER_HAVE_POSIX_IO
+            const ssize_t n = ::read(fd_, data + filled, length - filled);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n < 0) {
+                return false;
+            }
+#else
+            const size_t n = std::fread(data + filled, 1, length - filled, file_);
+            if (n == 0 && std::ferror(file_)) {
+                return false;
+            }
+#endif
+            if (n == 0) {
+                end = true;
+                return true;
+            }
+            filled += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+private:
+#ifdef BULK_SIGNER_HAVE_POSIX_IO
+    int fd_ = -1;
+#else
+    std::FILE* file_ = nullptr;
+#endif
+};
+
+/**
+ * @brief One file on its way through read and hash
+ *
+ * Its chunks may be popped by different hash threads; turn orders them so
+ * they are absorbed in sequence.
+ */
+template <int Mode>
+struct FileState {
+    FileState(std::string filePath, const PreparedSigningKey<Mode>& key)
+        : path(std::move(filePath)), stream(key) {}
+
+    std::string path;
+    std::mutex mutex;
+    std::condition_variable turn;
+    size_t nextChunk = 0;
+    uint64_t bytes = 0;
+    bool failed = false;
+    SignStream<Mode> stream;
+};
+
+template <int Mode>
+struct Chunk {
+    std::shared_ptr<FileState<Mode>> file;
+    size_t sequence;
+    size_t buffer;          // Index into the chunk buffer pool
+    size_t length;
+    bool last;
+};
+
+struct Digest {
+    std::string path;
+    uint64_t bytes;
+    uint8_t mu[DILITHIUM_MU_BYTES];
+};
+
+/**
+ * @brief Per-thread counters, merged into the stage when the thread ends
+ */
+struct StageCounters {
+    uint64_t items = 0;
+    uint64_t bytes = 0;
+    double busySeconds = 0.0;
+};
+
+void appendHex(std::string& out, const uint8_t* data, size_t length) {
+    static const char DIGITS[] = "0123456789abcdef";
+    for (size_t i = 0; i < length; ++i) {
+        out.push_back(DIGITS[data[i] >> 4]);
+        out.push_back(DIGITS[data[i] & 0x0F]);
+    }
+}
+
+} // namespace
+
+template <int Mode>
+BulkSigner<Mode>::BulkSigner(const PreparedSigningKey<Mode>& key, const Config& config)
+    : key_(key)
+    , config_(config)
+    , stats_() {
+    const size_t hardwareThreads = std::max<unsigned>(1, std::thread::hardware_concurrency());
+    config_.readers = std::max<size_t>(1, config_.readers);
+    config_.hashers = config_.hashers ? config_.hashers : hardwareThreads;
+    config_.signers = config_.signers ? config_.signers : hardwareThreads;
+    config_.readBytes = std::max<size_t>(4096, config_.readBytes);
+    config_.chunks = std::max(config_.chunks ? config_.chunks
+                                             : 2 * (config_.readers + config_.hashers),
+                              config_.readers);
+}
+
+/**
+ * @brief Start all four stages, wait for them and collect their counters
+ *
+ * Each stage closes the queue it feeds when its last thread ends, which lets
+ * the next stage drain and end in turn.
+ */
+template <int Mode>
+bool BulkSigner<Mode>::run(const std::vector<std::string>& roots, std::ostream& manifest,
+                           const std::vector<std::string>& outputs) {
+    stats_ = Stats();
+    if (!key_.isValid()) {
+        return false;
+    }
+
+    const Clock::time_point started = Clock::now();
+    std::vector<std::vector<uint8_t>> buffers;
+    try {
+        buffers.assign(config_.chunks, std::vector<uint8_t>(config_.readBytes));
+    } catch (...) {
+        return false;
+    }
+
+    BoundedQueue<std::string> files(1024);
+    BoundedQueue<Chunk<Mode>> chunks(config_.chunks);
+    BoundedQueue<size_t> freeBuffers(config_.chunks);
+    BoundedQueue<Digest> digests(64 * config_.signers);
+    for (size_t i = 0; i < config_.chunks; ++i) {
+        freeBuffers.push(i);
+    }
+
+    std::mutex statsMutex;
+    StageCounters stageCounters[4];
+    std::vector<std::string> failed;
+    auto merge = [&](size_t stage, const StageCounters& counters) {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        stageCounters[stage].items += counters.items;
+        stageCounters[stage].bytes += counters.bytes;
+        stageCounters[stage].busySeconds += counters.busySeconds;
+    };
+    auto fail = [&](const std::string& path) {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        failed.push_back(path);
+    };
+
+    std::mutex manifestMutex;
+    manifest << "# dilithium" << Mode << " detached signatures\n";
+
+    std::thread walker([&]() {
+        namespace fs = std::filesystem;
+        StageCounters counters;
+        Clock::time_point start = Clock::now();
+        // Overlapping roots reach the same file twice; sign it once
+        std::set<std::string> seen;
+        auto emit = [&](const fs::path& path) {
+            std::error_code pathError;
+            for (const std::string& output : outputs) {
+                if (fs::equivalent(path, output, pathError)) {
+                    return;
+                }
+            }
+            const fs::path canonical = fs::canonical(path, pathError);
+            if (!seen.insert(pathError ? path.lexically_normal().string()
+                                       : canonical.string()).second) {
+                return;
+            }
+            counters.busySeconds += secondsBetween(start, Clock::now());
+            ++counters.items;
+            files.push(path.string());
+            start = Clock::now();
+        };
+        for (const std::string& root : roots) {
+            std::error_code error;
+            const fs::file_status status = fs::status(root, error);
+            if (!error && fs::is_regular_file(status)) {
+                emit(root);
+            } else if (!error && fs::is_directory(status)) {
+                fs::recursive_directory_iterator it(
+                    root, fs::directory_options::skip_permission_denied, error);
+                for (; !error && it != fs::recursive_directory_iterator(); it.increment(error)) {
+                    std::error_code typeError;
+                    if (it->is_regular_file(typeError) && !typeError) {
+                        emit(it->path());
+                    }
+                }
+                if (error) {
+                    fail(root);
+                }
+            } else {
+                fail(root);
+            }
+        }
+        counters.busySeconds += secondsBetween(start, Clock::now());
+        merge(0, counters);
+        files.close();
+    });
+
+    std::vector<std::thread> readers;
+    for (size_t t = 0; t < config_.readers; ++t) {
+        readers.emplace_back([&]() {
+            StageCounters counters;
+            std::string path;
+            while (files.pop(path)) {
+                auto file = std::make_shared<FileState<Mode>>(path, key_);
+                InputFile input(path);
+                bool ok = input.isOpen();
+                bool end = !ok;
+                for (size_t sequence = 0; ; ++sequence) {
+                    size_t buffer = 0;
+                    freeBuffers.pop(buffer);
+                    const Clock::time_point start = Clock::now();
+                    size_t length = 0;
+                    if (ok) {
+                        ok = input.read(buffers[buffer].data(), config_.readBytes, length, end);
+                    }
+                    if (!ok) {
+                        std::lock_guard<std::mutex> lock(file->mutex);
+                        file->failed = true;
+                        end = true;
+                        length = 0;
+                    }
+                    counters.busySeconds += secondsBetween(start, Clock::now());
+                    counters.bytes += length;
+                    chunks.push({file, sequence, buffer, length, end});
+                    if (end) {
+                        break;
+                    }
+                }
+                ++counters.items;
+            }
+            merge(1, counters);
+        });
+    }
+
+    std::vector<std::thread> hashers;
+    for (size_t t = 0; t < config_.hashers; ++t) {
+        hashers.emplace_back([&]() {
+            StageCounters counters;
+            Chunk<Mode> chunk;
+            while (chunks.pop(chunk)) {
+                FileState<Mode>& file = *chunk.file;
+                Digest digest;
+                bool hashed = false;
+                {
+                    std::unique_lock<std::mutex> lock(file.mutex);
+                    file.turn.wait(lock, [&]() { return file.nextChunk == chunk.sequence; });
+                    const Clock::time_point start = Clock::now();
+                    if (!file.failed) {
+                        file.stream.update(buffers[chunk.buffer].data(), chunk.length);
+                        file.bytes += chunk.length;
+                    }
+                    if (chunk.last && !file.failed) {
+                        hashed = file.stream.finalMu(digest.mu);
+                        digest.path = file.path;
+                        digest.bytes = file.bytes;
+                    }
+                    counters.busySeconds += secondsBetween(start, Clock::now());
+                    counters.bytes += chunk.length;
+                    ++file.nextChunk;
+                }
+                file.turn.notify_all();
+                freeBuffers.push(chunk.buffer);
+
+                if (chunk.last) {
+                    ++counters.items;
+                    if (hashed) {
+                        digests.push(std::move(digest));
+                    } else {
+                        fail(file.path);
+                    }
+                }
+                chunk.file.reset();
+            }
+            merge(2, counters);
+        });
+    }
+
+    std::vector<std::thread> signers;
+    for (size_t t = 0; t < config_.signers; ++t) {
+        signers.emplace_back([&]() {
+            StageCounters counters;
+            Digest digest;
+            uint8_t signature[DilithiumParams<Mode>::SIGNATURE_BYTES];
+            std::string line;
+            while (digests.pop(digest)) {
+                const Clock::time_point start = Clock::now();
+                size_t signatureLength = 0;
+                if (!key_.signMu(digest.mu, signature, &signatureLength)) {
+                    fail(digest.path);
+                    continue;
+                }
+                line.clear();
+                appendHex(line, signature, signatureLength);
+                line += "  ";
+                line += digest.path;
+                line += '\n';
+                counters.busySeconds += secondsBetween(start, Clock::now());
+                ++counters.items;
+                counters.bytes += digest.bytes;
+
+                std::lock_guard<std::mutex> lock(manifestMutex);
+                manifest << line;
+            }
+            merge(3, counters);
+        });
+    }
+
+    walker.join();
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+    chunks.close();
+    for (std::thread& hasher : hashers) {
+        hasher.join();
+    }
+    digests.close();
+    for (std::thread& signer : signers) {
+        signer.join();
+    }
+    manifest.flush();
+
+    stats_.seconds = secondsBetween(started, Clock::now());
+    stats_.files = stageCounters[3].items;
+    stats_.bytes = stageCounters[3].bytes;
+    stats_.failed = std::move(failed);
+    std::sort(stats_.failed.begin(), stats_.failed.end());
+    const char* names[] = {"walk", "read", "hash", "sign"};
+    const size_t threads[] = {1, config_.readers, config_.hashers, config_.signers};
+    for (size_t stage = 0; stage < 4; ++stage) {
+        stats_.stages.push_back({names[stage], threads[stage], stageCounters[stage].items,
+                                 stageCounters[stage].bytes, stageCounters[stage].busySeconds});
+    }
+    return stats_.failed.empty() && static_cast<bool>(manifest);
+}
+
+// Mode-independent code: all three modes are instantiated in this one file
+template class BulkSigner<2>;
+template class BulkSigner<3>;
+template class BulkSigner<5>;
@@ -0,0 +1,158 @@
+/**
+ * @file BulkSigner.hpp
+ * @brief Pipelined signing of many files into a detached signature manifest
+ *
+ * Signing a release tree file by file spends most of its time waiting: a
+ * file is read, then hashed, then signed, and only one of the three runs at
+ * any moment. BulkSigner runs them as stages on their own threads, joined
+ * by bounded queues:
+ *
+ *     walk ──files──▶ read ──chunks──▶ hash ──μ──▶ sign ──▶ manifest
+ *
+ * - walk: one thread lists the regular files below every root
+ * - read: large sequential read() calls into a fixed pool of chunk buffers;
+ *   the pool is the only file data in memory, whatever the file sizes
+ * - hash: absorbs each chunk into the file's SignStream, in file order, and
+ *   squeezes μ = CRH(tr || M') after the last one
+ * - sign: PreparedSigningKey::signMu() on μ and one manifest line per file
+ *
+ * A full queue blocks the stage feeding it, so a slow stage slows the ones
+ * before it down instead of letting work pile up. Each stage records how
+ * long its threads were busy; the stage whose threads were busy for most
+ * of the run is the bottleneck (see BulkSignerStats).
+ *
+ * Manifest lines are "<hex signature>  <path>" in completion order, after
+ * a "# dilithium<mode> detached signatures" comment line. Each signature is
+ * a plain signature of the file contents with an empty context, so it
+ * verifies with VerifyStream::verifyFile() or DilithiumWrapper::verify().
+ *
+ * @code
+ * PreparedSigningKey<3> key;
+ * key.load(secretKey);
+ * BulkSigner<3> signer(key, {2, 8, 8, 4u << 20, 0});
+ * std::ofstream manifest("release.sig");
+ * signer.run({"release/"}, manifest);
+ * @endcode
+ *
+ * @author Student Project - Cryptographic Systems Course
+ * @date December 2025
+ */
+
+#ifndef BULK_SIGNER_HPP
+#define BULK_SIGNER_HPP
+
+#include "PreparedKeys.hpp"
+#include <ostream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief Thread counts and buffer sizes of a BulkSigner
+ */
+struct BulkSignerConfig {
+    size_t readers = 2;                 // Read threads
+    size_t hashers = 0;                 // Hash threads, 0 selects the hardware threads
+    size_t signers = 0;                 // Sign threads, 0 selects the hardware threads
+    size_t readBytes = 4u << 20;        // Size of one read() and of one chunk buffer
+    size_t chunks = 0;                  // Chunk buffers, 0 selects 2 per read and hash thread
+};
+
+/**
+ * @brief Work done by one pipeline stage
+ */
+struct BulkSignerStage {
+    const char* name;       // "walk", "read", "hash" or "sign"
+    size_t threads;
+    uint64_t items;         // Files passed through the stage
+    uint64_t bytes;         // File bytes passed through the stage (0 for walk)
+    double busySeconds;     // Summed over the stage's threads, queue waits excluded
+
+    /**
+     * @brief Share of the run the threads were busy, 0..1
+     */
+    double utilization(double seconds) const {
+        return seconds > 0.0 && threads > 0 ? busySeconds / (seconds * threads) : 0.0;
+    }
+
+    /**
+     * @brief Files per second the stage could sustain if it never waited
+     */
+    double capacityFilesPerSecond() const {
+        return busySeconds > 0.0 ? items * static_cast<double>(threads) / busySeconds : 0.0;
+    }
+
+    /**
+     * @brief Bytes per second the stage could sustain if it never waited
+     */
+    double capacityBytesPerSecond() const {
+        return busySeconds > 0.0 ? bytes * static_cast<double>(threads) / busySeconds : 0.0;
+    }
+};
+
+/**
+ * @brief Result of a BulkSigner run
+ */
+struct BulkSignerStats {
+    uint64_t files;                     // Files signed
+    uint64_t bytes;                     // Bytes of the signed files
+    double seconds;                     // Wall time of the run
+    std::vector<std::string> failed;    // Paths that could not be read
+    std::vector<BulkSignerStage> stages;
+
+    double filesPerSecond() const { return seconds > 0.0 ? files / seconds : 0.0; }
+    double bytesPerSecond() const { return seconds > 0.0 ? bytes / seconds : 0.0; }
+};
+
+/**
+ * @brief Signs directory trees with one prepared key
+ * @tparam Mode Dilithium mode (2, 3 or 5)
+ */
+template <int Mode>
+class BulkSigner {
+public:
+    using Config = BulkSignerConfig;
+    using Stats = BulkSignerStats;
+
+    /**
+     * @brief Constructor
+     * @param key Prepared signing key; referenced, must outlive the signer
+     * @param config Thread counts and buffer sizes
+     */
+    explicit BulkSigner(const PreparedSigningKey<Mode>& key, const Config& config = Config());
+
+    /**
+     * @brief Sign every regular file below the roots
+     *
+     * Roots may be files or directories; directories are walked recursively
+     * without following symbolic links to directories. Paths in the manifest
+     * are the root followed by the path below it. A file reached through
+     * several roots is signed once, under the first path found.
+     *
+     * @param roots Files and directories to sign
+     * @param manifest Receives the manifest
+     * @param outputs Files the caller writes during the run (the manifest
+     *                file, a public key); skipped if they are below a root
+     * @return true if every file was signed and the manifest was written
+     */
+    bool run(const std::vector<std::string>& roots, std::ostream& manifest,
+             const std::vector<std::string>& outputs = {});
+
+    /**
+     * @brief Statistics of the last run()
+     */
+    const Stats& stats() const { return stats_; }
+
+private:
+    const PreparedSigningKey<Mode>& key_;
+    Config config_;
+    Stats stats_;
+};
+
+// Mode-independent code, instantiated in BulkSigner.cpp
+extern template class BulkSigner<2>;
+extern template class BulkSigner<3>;
+extern template class BulkSigner<5>;
+
+#endif // BULK_SIGNER_HPP
@@ -0,0 +1,206 @@
+/**
+ * @file CompositeSignature.cpp
+ * @brief Implementation of the composite Dilithium + RSA signer
+ */
+
+#include "CompositeSignature.hpp"
+#include <future>
+#include <cstring>
+#include <openssl/evp.h>
+
+namespace {
+
+constexpr size_t DIGEST_BYTES = 64;     // SHA-512
+
+} // namespace
+
+template <int Mode>
+CompositeSigner<Mode>::CompositeSigner(int rsaBits, ThreadPool* pool)
+    : rsa_(rsaBits),
+      rsaSignatureBytes_(0),
+      label_("composite-dilithium" + std::to_string(Mode) + "-rsa" + std::to_string(rsaBits)
+             + "-sha512"),
+      ownPool_(pool ? std::unique_ptr<ThreadPool>() : std::make_unique<ThreadPool>(1)),
+      pool_(pool ? pool : ownPool_.get()) {}
+
+template <int Mode>
+bool CompositeSigner<Mode>::generateKeys() {
+    if (!dilithium_.generateKeys() || !rsa_.generateKeys()) {
+        return false;
+    }
+    signingKey_ = dilithium_.prepareSigningKey();
+    publicKey_ = dilithium_.preparePublicKey();
+    rsaSignatureBytes_ = rsa_.getSignatureSize();
+    return canSign() && canVerify();
+}
+
+template <int Mode>
+std::vector<uint8_t> CompositeSigner<Mode>::getPublicKey() const {
+    if (!canVerify()) {
+        return {};
+    }
+    try {
+        const std::vector<uint8_t> rsaKey = rsa_.getPublicKey();
+        if (rsaKey.empty()) {
+            return {};
+        }
+        std::vector<uint8_t> key = dilithium_.getPublicKey();
+        key.insert(key.end(), rsaKey.begin(), rsaKey.end());
+        return key;
+    } catch (...) {
+        return {};
+    }
+}
+
+template <int Mode>
+bool CompositeSigner<Mode>::setPublicKey(const std::vector<uint8_t>& publicKey) {
+    signingKey_ = PreparedSigningKey<Mode>();
+    publicKey_ = PreparedPublicKey<Mode>();
+    rsaSignatureBytes_ = 0;
+    try {
+        dilithium_ = Dilithium();
+        if (publicKey.size() <= Dilithium::PUBLIC_KEY_BYTES
+            || !dilithium_.setPublicKey(publicKey.data(), Dilithium::PUBLIC_KEY_BYTES)) {
+            return false;
+        }
+        const std::vector<uint8_t> rsaKey(publicKey.begin() + Dilithium::PUBLIC_KEY_BYTES,
+                                          publicKey.end());
+        if (!rsa_.setPublicKey(rsaKey)) {
+            return false;
+        }
+        publicKey_ = dilithium_.preparePublicKey();
+        rsaSignatureBytes_ = rsa_.getSignatureSize();
+        return canVerify();
+    } catch (...) {
+        return false;
+    }
+}
+
+template <int Mode>
+bool CompositeSigner<Mode>::representative(const std::vector<uint8_t>& message,
+                                           std::vector<uint8_t>& out) const {
+    // label || 0x00 || SHA-512(M)
+    out.assign(label_.begin(), label_.end());
+    out.push_back(0);
+    const size_t prefix = out.size();
+    out.resize(prefix + DIGEST_BYTES);
+    unsigned int digestBytes = 0;
+    return EVP_Digest(message.data(), message.size(), out.data() + prefix, &digestBytes,
+                      EVP_sha512(), nullptr) == 1
+           && digestBytes == DIGEST_BYTES;
+}
+
+template <int Mode>
+bool CompositeSigner<Mode>::signDilithium(const std::vector<uint8_t>& representative,
+                                          uint8_t* signature) const {
+    size_t length = 0;
+    return signingKey_.sign(representative.data(), representative.size(), signature, &length)
+           && length == Dilithium::SIGNATURE_BYTES;
+}
+
+template <int Mode>
+bool CompositeSigner<Mode>::signRsa(const std::vector<uint8_t>& representative,
+                                    uint8_t* signature) {
+    const std::vector<uint8_t> component = rsa_.sign(representative);
+    if (component.size() != rsaSignatureBytes_) {
+        return false;
+    }
+    std::memcpy(signature, component.data(), component.size());
+    return true;
+}
+
+template <int Mode>
+bool CompositeSigner<Mode>::verifyDilithium(const std::vector<uint8_t>& representative,
+                                            const uint8_t* signature) const {
+    return publicKey_.verify(representative.data(), representative.size(),
+                             signature, Dilithium::SIGNATURE_BYTES);
+}
+
+template <int Mode>
+bool CompositeSigner<Mode>::verifyRsa(const std::vector<uint8_t>& representative,
+                                      const uint8_t* signature) {
+    const std::vector<uint8_t> component(signature, signature + rsaSignatureBytes_);
+    return rsa_.verify(representative, component);
+}
+
+template <int Mode>
+std::vector<uint8_t> CompositeSigner<Mode>::sign(const std::vector<uint8_t>& message) {
+    if (!canSign()) {
+        return {};
+    }
+    try {
+        std::vector<uint8_t> rep;
+        std::vector<uint8_t> signature(signatureSize());
+        if (!representative(message, rep)) {
+            return {};
+        }
+
+        // Dilithium on the helper thread, RSA here; the task only touches
+        // rep and signature, which outlive it because get() is always reached
+        std::future<bool> dilithiumSigned = pool_->enqueue([&]() {
+            return signDilithium(rep, signature.data());
+        });
+        bool rsaSigned = false;
+        try {
+            rsaSigned = signRsa(rep, signature.data() + Dilithium::SIGNATURE_BYTES);
+        } catch (...) {
+        }
+        const bool ok = dilithiumSigned.get() && rsaSigned;
+        return ok ? signature : std::vector<uint8_t>();
+    } catch (...) {
+        return {};
+    }
+}
+
+template <int Mode>
+std::vector<uint8_t> CompositeSigner<Mode>::signSequential(const std::vector<uint8_t>& message) {
+    if (!canSign()) {
+        return {};
+    }
+    try {
+        std::vector<uint8_t> rep;
+        std::vector<uint8_t> signature(signatureSize());
+        const bool ok = representative(message, rep)
+                        && signDilithium(rep, signature.data())
+                        && signRsa(rep, signature.data() + Dilithium::SIGNATURE_BYTES);
+        return ok ? signature : std::vector<uint8_t>();
+    } catch (...) {
+        return {};
+    }
+}
+
+template <int Mode>
+bool CompositeSigner<Mode>::verify(const std::vector<uint8_t>& message,
+                                   const std::vector<uint8_t>& signature, VerifyOrder order) {
+    if (!canVerify() || signature.size() != signatureSize()) {
+        return false;
+    }
+    try {
+        std::vector<uint8_t> rep;
+        if (!representative(message, rep)) {
+            return false;
+        }
+        const uint8_t* rsaPart = signature.data() + Dilithium::SIGNATURE_BYTES;
+
+        if (order == VerifyOrder::CheaperFirst) {
+            return verifyRsa(rep, rsaPart) && verifyDilithium(rep, signature.data());
+        }
+
+        std::future<bool> dilithiumValid = pool_->enqueue([&]() {
+            return verifyDilithium(rep, signature.data());
+        });
+        bool rsaValid = false;
+        try {
+            rsaValid = verifyRsa(rep, rsaPart);
+        } catch (...) {
+        }
+        // Both results are awaited: the task reads rep and the signature
+        return dilithiumValid.get() && rsaValid;
+    } catch (...) {
+        return false;
+    }
+}
+
+template class CompositeSigner<2>;
+template class CompositeSigner<3>;
+template class CompositeSigner<5>;
@@ -0,0 +1,200 @@
+/**
+ * @file CompositeSignature.hpp
+ * @brief Composite Dilithium + RSA signatures with concurrent components
+ *
+ * During the migration to post-quantum signatures, a composite signature
+ * carries a Dilithium and an RSA signature of the same message. It is
+ * valid only if both components verify, so it stays secure as long as
+ * either scheme is unbroken and legacy verifiers can still check the RSA
+ * part. Signing both back to back costs the sum of the two latencies;
+ * CompositeSigner runs the Dilithium component on a helper thread while
+ * the calling thread computes the RSA one, so a composite signature costs
+ * about as much as the slower component.
+ *
+ * Both components sign the same representative, modelled on the IETF
+ * composite signature drafts:
+ *
+ *     M' = "composite-dilithium<mode>-rsa<bits>-sha512" || 0x00 || SHA-512(M)
+ *
+ * The label binds each component to the composite, so neither can be
+ * stripped off and passed off as a plain signature of M, and the message
+ * is hashed only once however large it is.
+ *
+ * The encoding is one buffer of fixed size per key pair, Dilithium first
+ * as in the drafts:
+ *
+ *     Dilithium signature of M' (SIGNATURE_BYTES) || RSA signature of M' (modulus bytes)
+ *
+ * Verification checks the cheaper component first by default: RSA
+ * verification with e = 65537 takes a fraction of a Dilithium verification,
+ * so a forged or corrupted RSA part is rejected before Dilithium runs.
+ * VerifyOrder::Parallel checks both at once for the lowest latency on
+ * valid signatures.
+ *
+ * The composite public key is encoded the same way, for verifiers that
+ * never hold the signing keys:
+ *
+ *     Dilithium public key (PUBLIC_KEY_BYTES) || RSA SubjectPublicKeyInfo (DER)
+ *
+ * @code
+ * CompositeSigner<3> signer(3072);
+ * signer.generateKeys();
+ * std::vector<uint8_t> signature = signer.sign(message);
+ *
+ * CompositeSigner<3> verifier(3072);
+ * verifier.setPublicKey(signer.getPublicKey());
+ * bool ok = verifier.verify(message, signature);
+ * @endcode
+ *
+ * @author Student Project - Cryptographic Systems Course
+ * @date December 2025
+ */
+
+#ifndef COMPOSITE_SIGNATURE_HPP
+#define COMPOSITE_SIGNATURE_HPP
+
+#include "Dilithiumwrapper.hpp"
+#include "RSABenchmark.hpp"
+#include "ThreadPool.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief Signs and verifies composite Dilithium + RSA signatures
+ * @tparam Mode Dilithium mode (2, 3 or 5)
+ */
+template <int Mode>
+class CompositeSigner {
+public:
+    using Dilithium = DilithiumWrapper<Mode>;
+
+    /**
+     * @brief How verify() schedules the two components
+     */
+    enum class VerifyOrder {
+        CheaperFirst,   // RSA, then Dilithium only if RSA passed
+        Parallel        // RSA here and Dilithium on the helper thread at once
+    };
+
+    /**
+     * @brief Constructor
+     * @param rsaBits RSA modulus size (2048, 3072 or 4096)
+     * @param pool Thread pool for the Dilithium component; nullptr starts a
+     *             private one-thread pool. Referenced, must outlive the signer.
+     */
+    explicit CompositeSigner(int rsaBits = 3072, ThreadPool* pool = nullptr);
+
+    CompositeSigner(const CompositeSigner&) = delete;
+    CompositeSigner& operator=(const CompositeSigner&) = delete;
+
+    /**
+     * @brief Generate both key pairs and prepare the Dilithium keys
+     * @return true if both key pairs exist
+     */
+    bool generateKeys();
+
+    /**
+     * @brief Export the composite public key (see the file comment)
+     * @return The encoded key, or empty if there is no public key
+     */
+    std::vector<uint8_t> getPublicKey() const;
+
+    /**
+     * @brief Load a composite public key; the signer becomes a verifier
+     *
+     * Signing keys from generateKeys() are dropped.
+     *
+     * @param publicKey Encoded key from getPublicKey() with the same mode and RSA size
+     * @return true if both component keys were loaded
+     */
+    bool setPublicKey(const std::vector<uint8_t>& publicKey);
+
+    /**
+     * @brief Sign a message, both components concurrently
+     * @param message The message to sign
+     * @return The composite signature, or empty on failure
+     */
+    std::vector<uint8_t> sign(const std::vector<uint8_t>& message);
+
+    /**
+     * @brief Sign a message, Dilithium then RSA on the calling thread
+     *
+     * Same signature as sign(); the baseline of the composite benchmark.
+     *
+     * @param message The message to sign
+     * @return The composite signature, or empty on failure
+     */
+    std::vector<uint8_t> signSequential(const std::vector<uint8_t>& message);
+
+    /**
+     * @brief Verify a composite signature
+     * @param message The signed message
+     * @param signature Composite signature from sign()
+     * @param order Cheaper component first (short-circuit) or both at once
+     * @return true if both components are valid
+     */
+    bool verify(const std::vector<uint8_t>& message, const std::vector<uint8_t>& signature,
+                VerifyOrder order = VerifyOrder::CheaperFirst);
+
+    /**
+     * @brief Size of a composite signature in bytes (once keys are loaded)
+     */
+    size_t signatureSize() const { return Dilithium::SIGNATURE_BYTES + rsaSignatureBytes_; }
+
+    /**
+     * @brief Domain label of M', e.g. "composite-dilithium3-rsa3072-sha512"
+     */
+    const std::string& label() const { return label_; }
+
+    /**
+     * @brief Check if both signing keys are present (after generateKeys())
+     */
+    bool canSign() const { return signingKey_.isValid() && rsa_.hasKeys(); }
+
+    /**
+     * @brief Check if both public keys are present (generated or from setPublicKey())
+     */
+    bool canVerify() const { return publicKey_.isValid() && rsa_.hasPublicKey(); }
+
+    /**
+     * @brief The Dilithium component (keys and packed sizes)
+     */
+    const Dilithium& dilithium() const { return dilithium_; }
+
+    /**
+     * @brief The RSA component
+     */
+    RSABenchmark& rsa() { return rsa_; }
+
+private:
+    Dilithium dilithium_;
+    RSABenchmark rsa_;
+    PreparedSigningKey<Mode> signingKey_;
+    PreparedPublicKey<Mode> publicKey_;
+    size_t rsaSignatureBytes_;
+    std::string label_;
+    std::unique_ptr<ThreadPool> ownPool_;
+    ThreadPool* pool_;
+
+    /**
+     * @brief Build M' for a message
+     * @return false if hashing failed
+     */
+    bool representative(const std::vector<uint8_t>& message, std::vector<uint8_t>& out) const;
+
+    bool signDilithium(const std::vector<uint8_t>& representative, uint8_t* signature) const;
+    bool signRsa(const std::vector<uint8_t>& representative, uint8_t* signature);
+    bool verifyDilithium(const std::vector<uint8_t>& representative,
+                         const uint8_t* signature) const;
+    bool verifyRsa(const std::vector<uint8_t>& representative, const uint8_t* signature);
+};
+
+// Mode-independent code, instantiated in CompositeSignature.cpp
+extern template class CompositeSigner<2>;
+extern template class CompositeSigner<3>;
+extern template class CompositeSigner<5>;
+
+#endif // COMPOSITE_SIGNATURE_HPP
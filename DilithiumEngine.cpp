@@ -0,0 +1,78 @@
+/**
+ * @file DilithiumEngine.cpp
+ * @brief Implementation of the multi-threaded Dilithium engine
+ */
+
+#include "DilithiumEngine.hpp"
+#include <memory>
+#include <utility>
+
+template <int Mode>
+DilithiumEngine<Mode>::DilithiumEngine(const DilithiumWrapper<Mode>& keys, size_t threads)
+    : signingKey_(keys.prepareSigningKey())
+    , publicKey_(keys.preparePublicKey())
+    , pool_(threads) {
+}
+
+template <int Mode>
+DilithiumEngine<Mode>::~DilithiumEngine() = default;
+
+template <int Mode>
+std::future<std::vector<uint8_t>> DilithiumEngine<Mode>::submitSign(std::vector<uint8_t> message) {
+    auto shared = std::make_shared<std::vector<uint8_t>>(std::move(message));
+    return pool_.enqueue([this, shared]() {
+        return signJob(*shared);
+    });
+}
+
+template <int Mode>
+void DilithiumEngine<Mode>::submitSign(std::vector<uint8_t> message, SignCallback done) {
+    auto shared = std::make_shared<std::vector<uint8_t>>(std::move(message));
+    pool_.submit([this, shared, done]() {
+        std::vector<uint8_t> signature = signJob(*shared);
+        if (done) {
+            done(std::move(signature));
+        }
+    });
+}
+
+template <int Mode>
+std::future<bool> DilithiumEngine<Mode>::submitVerify(std::vector<uint8_t> message,
+                                                std::vector<uint8_t> signature) {
+    auto shared = std::make_shared<std::pair<std::vector<uint8_t>, std::vector<uint8_t>>>(
+        std::move(message), std::move(signature));
+    return pool_.enqueue([this, shared]() {
+        return verifyJob(shared->first, shared->second);
+    });
+}
+
+template <int Mode>
+void DilithiumEngine<Mode>::submitVerify(std::vector<uint8_t> message,
+                                   std::vector<uint8_t> signature,
+                                   VerifyCallback done) {
+    auto shared = std::make_shared<std::pair<std::vector<uint8_t>, std::vector<uint8_t>>>(
+        std::move(message), std::move(signature));
+    pool_.submit([this, shared, done]() {
+        bool valid = verifyJob(shared->first, shared->second);
+        if (done) {
+            done(valid);
+        }
+    });
+}
+
+template <int Mode>
+std::vector<uint8_t> DilithiumEngine<Mode>::signJob(const std::vector<uint8_t>& message) const {
+    return DilithiumWrapper<Mode>::sign(signingKey_, message);
+}
+
+template <int Mode>
+bool DilithiumEngine<Mode>::verifyJob(const std::vector<uint8_t>& message,
+                                const std::vector<uint8_t>& signature) const {
+    return publicKey_.verify(message.data(), message.size(),
+                             signature.data(), signature.size());
+}
+
+// Mode-independent code: all three modes are instantiated in this one file
+template class DilithiumEngine<2>;
+template class DilithiumEngine<3>;
+template class DilithiumEngine<5>;
@@ -0,0 +1,120 @@
+/**
+ * @file DilithiumEngine.hpp
+ * @brief Multi-threaded Dilithium signing/verification engine
+ *
+ * DilithiumWrapper handles one call at a time. The engine takes the key pair
+ * of a wrapper, prepares it once (see PreparedKeys.hpp) and accepts sign and
+ * verify jobs from any number of producer threads. Jobs run on a
+ * work-stealing ThreadPool sized to the machine; results are delivered
+ * through std::future or a completion callback.
+ *
+ * Prepared keys are only read after construction, so all workers share one
+ * copy without locking. The engine is a template over the Dilithium mode,
+ * instantiated for modes 2, 3 and 5 in DilithiumEngine.cpp.
+ *
+ * @author Student Project - Cryptographic Systems Course
+ * @date December 2025
+ */
+
+#ifndef DILITHIUM_ENGINE_HPP
+#define DILITHIUM_ENGINE_HPP
+
+#include "Dilithiumwrapper.hpp"
+#include "PreparedKeys.hpp"
+#include "ThreadPool.hpp"
+#include <functional>
+#include <future>
+#include <vector>
+#include <cstdint>
+
+/**
+ * @brief Thread-safe front-end for concurrent Dilithium operations
+ * @tparam Mode Dilithium mode (2, 3 or 5)
+ */
+template <int Mode>
+class DilithiumEngine {
+public:
+    using SignCallback = std::function<void(std::vector<uint8_t> signature)>;
+    using VerifyCallback = std::function<void(bool valid)>;
+
+    /**
+     * @brief Constructor - prepares the keys of a wrapper and starts the pool
+     * @param keys Wrapper holding the key pair (generateKeys() or setSecretKey())
+     * @param threads Worker count, 0 selects the number of hardware threads
+     */
+    explicit DilithiumEngine(const DilithiumWrapper<Mode>& keys, size_t threads = 0);
+
+    /**
+     * @brief Destructor - finishes all queued jobs before returning
+     */
+    ~DilithiumEngine();
+
+    DilithiumEngine(const DilithiumEngine&) = delete;
+    DilithiumEngine& operator=(const DilithiumEngine&) = delete;
+
+    /**
+     * @brief Queue a signing job
+     * @param message The message to sign (moved into the job)
+     * @return Future holding the signature, or an empty vector on failure
+     */
+    std::future<std::vector<uint8_t>> submitSign(std::vector<uint8_t> message);
+
+    /**
+     * @brief Queue a signing job with a completion callback
+     * @param message The message to sign (moved into the job)
+     * @param done Invoked on a worker thread with the signature
+     */
+    void submitSign(std::vector<uint8_t> message, SignCallback done);
+
+    /**
+     * @brief Queue a verification job
+     * @param message The original message (moved into the job)
+     * @param signature The signature to verify (moved into the job)
+     * @return Future holding true if the signature is valid
+     */
+    std::future<bool> submitVerify(std::vector<uint8_t> message,
+                                   std::vector<uint8_t> signature);
+
+    /**
+     * @brief Queue a verification job with a completion callback
+     * @param message The original message (moved into the job)
+     * @param signature The signature to verify (moved into the job)
+     * @param done Invoked on a worker thread with the verification result
+     */
+    void submitVerify(std::vector<uint8_t> message,
+                      std::vector<uint8_t> signature,
+                      VerifyCallback done);
+
+    /**
+     * @brief Block until all queued jobs have completed
+     */
+    void waitIdle() { pool_.waitIdle(); }
+
+    /**
+     * @brief Get the number of worker threads
+     */
+    size_t threadCount() const { return pool_.size(); }
+
+    /**
+     * @brief Check if the engine has usable keys
+     * @return true if both prepared keys were built
+     */
+    bool isReady() const {
+        return signingKey_.isValid() && publicKey_.isValid();
+    }
+
+private:
+    PreparedSigningKey<Mode> signingKey_;
+    PreparedPublicKey<Mode> publicKey_;
+    ThreadPool pool_;   // Declared last: joined before the keys are destroyed
+
+    std::vector<uint8_t> signJob(const std::vector<uint8_t>& message) const;
+    bool verifyJob(const std::vector<uint8_t>& message,
+                   const std::vector<uint8_t>& signature) const;
+};
+
+extern template class DilithiumEngine<2>;
+extern template class DilithiumEngine<3>;
+extern template class DilithiumEngine<5>;
+
+#endif // DILITHIUM_ENGINE_HPP
@@ -0,0 +1,199 @@
+/**
+ * @file DilithiumKeyGen.cpp
+ * @brief Implementation of seeded and batched Dilithium key generation
+ *
+ * keyPairFromSeed() is crypto_sign_keypair() from the reference sign.c with
+ * the randombytes() call moved to the caller. This file is compiled once per
+ * parameter set with DILITHIUM_MODE set to 2, 3 or 5.
+ */
+
+#include "DilithiumKeyGen.hpp"
+#include "SecureMemory.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+// The reference headers define short macros (N, K, L, Q, D, ...), so they are
+// included after all C++ standard headers.
+extern "C" {
+#include "params.h"
+#include "packing.h"
+#include "polyvec.h"
+#include "fips202.h"
+#include "randombytes.h"
+}
+
+static_assert(DILITHIUM_SEED_BYTES == SEEDBYTES, "DILITHIUM_SEED_BYTES does not match params.h");
+
+template <int Mode>
+DilithiumKeyBatch<Mode>::~DilithiumKeyBatch() {
+    clear();
+}
+
+template <int Mode>
+DilithiumKeyBatch<Mode>::DilithiumKeyBatch(DilithiumKeyBatch&& other) noexcept
+    : keys_(std::move(other.keys_)), count_(other.count_) {
+    other.keys_.clear();
+    other.count_ = 0;
+}
+
+template <int Mode>
+DilithiumKeyBatch<Mode>& DilithiumKeyBatch<Mode>::operator=(DilithiumKeyBatch&& other) noexcept {
+    if (this != &other) {
+        clear();
+        keys_ = std::move(other.keys_);
+        count_ = other.count_;
+        other.keys_.clear();
+        other.count_ = 0;
+    }
+    return *this;
+}
+
+/**
+ * @brief ML-DSA.KeyGen_internal(ξ)
+ *
+ * 1. (ρ, ρ', K) = H(ξ || k || l)
+ * 2. Â = ExpandA(ρ), (s1, s2) = ExpandS(ρ')
+ * 3. t = A·s1 + s2, (t1, t0) = Power2Round(t)
+ * 4. pk = (ρ, t1), tr = H(pk), sk = (ρ, K, tr, s1, s2, t0)
+ */
+template <int Mode>
+bool DilithiumKeyBatch<Mode>::keyPairFromSeed(const uint8_t* seed, uint8_t* publicKey,
+                                              uint8_t* secretKey) {
+    if (!seed || !publicKey || !secretKey) {
+        return false;
+    }
+
+    uint8_t seedbuf[2 * SEEDBYTES + CRHBYTES];
+    uint8_t tr[TRBYTES];
+    polyvecl mat[K];
+    polyvecl s1, s1hat;
+    polyveck s2, t1, t0;
+
+    std::memcpy(seedbuf, seed, SEEDBYTES);
+    seedbuf[SEEDBYTES + 0] = K;
+    seedbuf[SEEDBYTES + 1] = L;
+    shake256(seedbuf, 2 * SEEDBYTES + CRHBYTES, seedbuf, SEEDBYTES + 2);
+    const uint8_t* rho = seedbuf;
+    const uint8_t* rhoprime = rho + SEEDBYTES;
+    const uint8_t* key = rhoprime + CRHBYTES;
+
+    polyvec_matrix_expand(mat, rho);
+    polyvecl_uniform_eta(&s1, rhoprime, 0);
+    polyveck_uniform_eta(&s2, rhoprime, L);
+
+    s1hat = s1;
+    polyvecl_ntt(&s1hat);
+    polyvec_matrix_pointwise_montgomery(&t1, mat, &s1hat);
+    polyveck_reduce(&t1);
+    polyveck_invntt_tomont(&t1);
+    polyveck_add(&t1, &t1, &s2);
+
+    polyveck_caddq(&t1);
+    polyveck_power2round(&t1, &t0, &t1);
+    pack_pk(publicKey, rho, &t1);
+
+    shake256(tr, TRBYTES, publicKey, CRYPTO_PUBLICKEYBYTES);
+    pack_sk(secretKey, rho, tr, key, &t0, &s1, &s2);
+
+    secureWipe(seedbuf, sizeof(seedbuf));
+    secureWipe(&s1, sizeof(s1));
+    secureWipe(&s1hat, sizeof(s1hat));
+    secureWipe(&s2, sizeof(s2));
+    secureWipe(&t0, sizeof(t0));
+    return true;
+}
+
+template <int Mode>
+bool DilithiumKeyBatch<Mode>::generate(size_t count, size_t threads) {
+    std::vector<uint8_t> seeds;
+    try {
+        seeds.resize(count * SEEDBYTES);
+    } catch (...) {
+        clear();
+        return false;
+    }
+
+    // One getrandom() for the whole batch instead of one per key
+    randombytes(seeds.data(), seeds.size());
+    bool ok = generateFromSeeds(seeds.data(), count, threads);
+    secureWipe(seeds.data(), seeds.size());
+    return ok;
+}
+
+/**
+ * @brief Expand the seeds on up to threads workers
+ *
+ * Worker w handles one contiguous range of records, so the threads never
+ * write to the same cache lines except at the range boundaries.
+ */
+template <int Mode>
+bool DilithiumKeyBatch<Mode>::generateFromSeeds(const uint8_t* seeds, size_t count,
+                                                size_t threads) {
+    clear();
+    if (!seeds || count == 0) {
+        return false;
+    }
+
+    try {
+        keys_.resize(count * RECORD_BYTES);
+
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        threads = std::min(threads, count);
+
+        std::atomic<bool> failed(false);
+        auto expand = [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                uint8_t* record = keys_.data() + i * RECORD_BYTES;
+                if (!keyPairFromSeed(seeds + i * SEEDBYTES, record, record + PUBLIC_KEY_BYTES)) {
+                    failed.store(true, std::memory_order_relaxed);
+                }
+            }
+        };
+
+        std::vector<std::thread> workers;
+        workers.reserve(threads - 1);
+        const size_t chunk = (count + threads - 1) / threads;
+        try {
+            for (size_t first = chunk; first < count; first += chunk) {
+                workers.emplace_back(expand, first, std::min(first + chunk, count));
+            }
+        } catch (...) {
+            // Could not start all threads: the calling thread takes the rest
+            const size_t started = workers.size();
+            for (size_t first = (started + 1) * chunk; first < count; first += chunk) {
+                expand(first, std::min(first + chunk, count));
+            }
+        }
+        expand(0, std::min(chunk, count));
+
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+
+        if (failed.load(std::memory_order_relaxed)) {
+            clear();
+            return false;
+        }
+        count_ = count;
+        return true;
+    } catch (...) {
+        clear();
+        return false;
+    }
+}
+
+template <int Mode>
+void DilithiumKeyBatch<Mode>::clear() {
+    if (!keys_.empty()) {
+        secureWipe(keys_.data(), keys_.size());
+    }
+    keys_.clear();
+    keys_.shrink_to_fit();
+    count_ = 0;
+}
+
+template class DilithiumKeyBatch<DILITHIUM_MODE>;
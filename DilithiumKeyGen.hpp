@@ -0,0 +1,118 @@
+/**
+ * @file DilithiumKeyGen.hpp
+ * @brief Deterministic and batched Dilithium key generation
+ *
+ * A Dilithium key pair is a deterministic function of a 32-byte seed ξ:
+ * (ρ, ρ', K) = H(ξ || k || l), and everything else is expanded from those.
+ * The reference keypair() reads ξ with one getrandom() call per key.
+ * DilithiumKeyBatch instead reads the seeds of a whole batch in one bulk
+ * call and expands them on several threads into one contiguous buffer:
+ *
+ * @code
+ * DilithiumKeyBatch<3> batch;
+ * batch.generate(100000);             // All hardware threads
+ * provision(batch.publicKey(i), batch.secretKey(i));
+ * @endcode
+ *
+ * keyPairFromSeed() gives the same keys as the reference keypair() would
+ * for the same ξ, so a stored seed is enough to re-derive a device key.
+ *
+ * @author Student Project - Cryptographic Systems Course
+ * @date December 2025
+ */
+
+#ifndef DILITHIUM_KEYGEN_HPP
+#define DILITHIUM_KEYGEN_HPP
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "DilithiumParams.hpp"
+
+/**
+ * @brief Many key pairs in one buffer of fixed-size records
+ *
+ * Record i is pk_i || sk_i at offset i * RECORD_BYTES. The buffer is wiped
+ * when the batch is cleared or destroyed.
+ *
+ * @tparam Mode Dilithium mode (2, 3 or 5)
+ */
+template <int Mode>
+class DilithiumKeyBatch {
+public:
+    static constexpr size_t PUBLIC_KEY_BYTES = DilithiumParams<Mode>::PUBLIC_KEY_BYTES;
+    static constexpr size_t SECRET_KEY_BYTES = DilithiumParams<Mode>::SECRET_KEY_BYTES;
+    static constexpr size_t RECORD_BYTES = PUBLIC_KEY_BYTES + SECRET_KEY_BYTES;
+
+    DilithiumKeyBatch() = default;
+
+    /**
+     * @brief Destructor - securely wipes the secret keys
+     */
+    ~DilithiumKeyBatch();
+
+    DilithiumKeyBatch(const DilithiumKeyBatch&) = delete;
+    DilithiumKeyBatch& operator=(const DilithiumKeyBatch&) = delete;
+    DilithiumKeyBatch(DilithiumKeyBatch&& other) noexcept;
+    DilithiumKeyBatch& operator=(DilithiumKeyBatch&& other) noexcept;
+
+    /**
+     * @brief Generate key pairs from fresh randomness
+     *
+     * All count seeds are read with a single randombytes() call and wiped
+     * once the keys are expanded.
+     *
+     * @param count Number of key pairs
+     * @param threads Worker threads (0: hardware threads)
+     * @return true if successful; on failure the batch is empty
+     */
+    bool generate(size_t count, size_t threads = 0);
+
+    /**
+     * @brief Generate key pairs from caller-supplied seeds
+     * @param seeds count * DILITHIUM_SEED_BYTES bytes, seed i for key pair i
+     * @param count Number of key pairs
+     * @param threads Worker threads (0: hardware threads)
+     * @return true if successful; on failure the batch is empty
+     */
+    bool generateFromSeeds(const uint8_t* seeds, size_t count, size_t threads = 0);
+
+    /**
+     * @brief Derive one key pair from a seed
+     * @param seed DILITHIUM_SEED_BYTES bytes ξ
+     * @param publicKey Output buffer of PUBLIC_KEY_BYTES
+     * @param secretKey Output buffer of SECRET_KEY_BYTES
+     * @return true if successful
+     */
+    static bool keyPairFromSeed(const uint8_t* seed, uint8_t* publicKey, uint8_t* secretKey);
+
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+
+    const uint8_t* publicKey(size_t index) const { return keys_.data() + index * RECORD_BYTES; }
+    const uint8_t* secretKey(size_t index) const {
+        return keys_.data() + index * RECORD_BYTES + PUBLIC_KEY_BYTES;
+    }
+
+    /**
+     * @brief The whole buffer, size() * RECORD_BYTES bytes
+     */
+    const uint8_t* data() const { return keys_.data(); }
+    size_t bytes() const { return keys_.size(); }
+
+    /**
+     * @brief Securely wipe and release all keys
+     */
+    void clear();
+
+private:
+    std::vector<uint8_t> keys_;
+    size_t count_ = 0;
+};
+
+// Instantiated in DilithiumKeyGen.cpp, once per separately compiled mode
+extern template class DilithiumKeyBatch<2>;
+extern template class DilithiumKeyBatch<3>;
+extern template class DilithiumKeyBatch<5>;
+
+#endif // DILITHIUM_KEYGEN_HPP
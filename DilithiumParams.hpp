@@ -0,0 +1,190 @@
+/**
+ * @file DilithiumParams.hpp
+ * @brief Compile-time parameters of the three Dilithium security levels
+ *
+ * The reference implementation selects its parameter set with the
+ * DILITHIUM_MODE preprocessor macro, one mode per compilation. The C++ side
+ * instead uses DilithiumParams<Mode> so that all three levels can be used in
+ * one binary; each mode links its own separately compiled library.
+ *
+ * | Mode | NIST level | (k, l) | η | pk (B) | sk (B) | σ (B) |
+ * |------|------------|--------|---|--------|--------|-------|
+ * | 2    | 2          | (4, 4) | 2 | 1312   | 2560   | 2420  |
+ * | 3    | 3          | (6, 5) | 4 | 1952   | 4032   | 3309  |
+ * | 5    | 5          | (8, 7) | 2 | 2592   | 4896   | 4627  |
+ *
+ * @author Student Project - Cryptographic Systems Course
+ * @date December 2025
+ */
+
+#ifndef DILITHIUM_PARAMS_HPP
+#define DILITHIUM_PARAMS_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Sizes and dimensions of a Dilithium parameter set
+ * @tparam Mode Dilithium mode (2, 3 or 5)
+ */
+template <int Mode>
+struct DilithiumParams;
+
+/**
+ * @brief Length of μ = CRH(tr || M'), the message representative that the
+ * signing and verification cores operate on (same for all modes)
+ */
+constexpr size_t DILITHIUM_MU_BYTES = 64;
+
+/**
+ * @brief Length of the key generation seed ξ (same for all modes)
+ */
+constexpr size_t DILITHIUM_SEED_BYTES = 32;
+
+template <>
+struct DilithiumParams<2> {
+    static constexpr const char* NAME = "Dilithium2";
+    static constexpr int NIST_LEVEL = 2;
+    static constexpr size_t K = 4;                      // Rows of A
+    static constexpr size_t L = 4;                      // Columns of A
+    static constexpr size_t PUBLIC_KEY_BYTES = 1312;
+    static constexpr size_t SECRET_KEY_BYTES = 2560;
+    static constexpr size_t SIGNATURE_BYTES = 2420;
+};
+
+template <>
+struct DilithiumParams<3> {
+    static constexpr const char* NAME = "Dilithium3";
+    static constexpr int NIST_LEVEL = 3;
+    static constexpr size_t K = 6;
+    static constexpr size_t L = 5;
+    static constexpr size_t PUBLIC_KEY_BYTES = 1952;
+    static constexpr size_t SECRET_KEY_BYTES = 4032;
+    static constexpr size_t SIGNATURE_BYTES = 3309;
+};
+
+template <>
+struct DilithiumParams<5> {
+    static constexpr const char* NAME = "Dilithium5";
+    static constexpr int NIST_LEVEL = 5;
+    static constexpr size_t K = 8;
+    static constexpr size_t L = 7;
+    static constexpr size_t PUBLIC_KEY_BYTES = 2592;
+    static constexpr size_t SECRET_KEY_BYTES = 4896;
+    static constexpr size_t SIGNATURE_BYTES = 4627;
+};
+
+/**
+ * @brief Implementation backing keypair/sign/verify calls
+ *
+ * Prepared keys always use the reference polynomial layout, so the
+ * prepared-key paths are unaffected by this selection.
+ */
+enum class DilithiumBackend {
+    Reference,  // Portable C implementation (dilithium/ref)
+    AVX2        // Vectorized NTT and 4-way Keccak (dilithium/avx2)
+};
+
+/**
+ * @brief How much of the expanded public key a PreparedPublicKey keeps
+ *
+ * | Mode         | Kept                 | Per verification         | Dilithium3 |
+ * |--------------|----------------------|--------------------------|------------|
+ * | Full         | Â, t̂1, tr            | -                        | ~37 KB     |
+ * | RowStreaming | ρ, t̂1, tr            | ExpandA, one poly live   | ~6 KB      |
+ * | None         | ρ, packed t1, tr     | ExpandA, unpack+NTT(t1)  | ~2 KB      |
+ */
+enum class DilithiumKeyMemory {
+    Full,           // Cache the whole matrix A in NTT domain
+    RowStreaming,   // Regenerate A one polynomial at a time inside A·z
+    None            // Keep no expanded material beyond tr
+};
+
+/**
+ * @brief Where sign/verify keep their temporary polynomial state
+ *
+ * See ScratchArena.hpp.
+ */
+enum class DilithiumScratch {
+    Stack,      // Reference behaviour: A and all temporaries on the stack
+    Arena       // Per-thread reused arena; a few KB of stack per call
+};
+
+/**
+ * @brief Where secret key material (packed and prepared) is allocated
+ *
+ * See SecureMemory.hpp.
+ */
+enum class DilithiumKeyStorage {
+    Heap,       // operator new, wiped on release
+    SecurePool  // mlock'ed, guard-paged slots of a per-type slab pool
+};
+
+/**
+ * @brief Source of the randombytes() calls of the Dilithium libraries
+ *
+ * Key generation draws 32 bytes per key and randomized signing 32 bytes per
+ * signature. See RandomSource.hpp.
+ */
+enum class DilithiumRandomness {
+    System,     // One getrandom() system call per request
+    Buffered    // Per-thread SHAKE256 DRBG, seeded and periodically reseeded from getrandom()
+};
+
+/**
+ * @brief Digest used by the pre-hash (HashML-DSA, FIPS 204 §5.4) mode
+ *
+ * The digest's DER-encoded OID is bound into the signed data, so a
+ * signature made over a SHA-256 digest never verifies as SHA-512 or as a
+ * plain (pure) signature.
+ */
+enum class DilithiumPreHash {
+    SHA256,     // 32-byte digest, OID 2.16.840.1.101.3.4.2.1
+    SHA384,     // 48-byte digest, OID 2.16.840.1.101.3.4.2.2
+    SHA512      // 64-byte digest, OID 2.16.840.1.101.3.4.2.3
+};
+
+/**
+ * @brief Counters of the signing rejection loop (DILITHIUM_INSTRUMENTATION builds)
+ *
+ * Collected per thread and per mode by the prepared-key signing code, which
+ * DilithiumWrapper::sign() also uses when instrumentation is compiled in.
+ * All fields stay zero otherwise. Phase times are in nanoseconds; the
+ * remainder of totalNs is spent in reductions, norm checks and hints.
+ */
+struct DilithiumSignStats {
+    static constexpr size_t HISTOGRAM_BINS = 16;
+
+    uint64_t signatures;        // Completed signatures
+    uint64_t iterations;        // Rejection-loop passes over all signatures
+    uint64_t maxIterations;     // Most passes a single signature needed
+    uint64_t rejectedZ;         // ||z|| >= γ1 - β
+    uint64_t rejectedLowBits;   // ||r0|| >= γ2 - β
+    uint64_t rejectedCt0;       // ||c·t0|| >= γ2
+    uint64_t rejectedHints;     // More than ω hint bits
+    uint64_t iterationHistogram[HISTOGRAM_BINS]; // [i]: signatures that took i + 1 passes (last: or more)
+
+    uint64_t expandMatrixNs;    // ExpandA(ρ)
+    uint64_t nttNs;             // Forward NTTs
+    uint64_t invnttNs;          // Inverse NTTs
+    uint64_t pointwiseNs;       // NTT-domain products (A·y, c·s1, c·s2, c·t0)
+    uint64_t shakeNs;           // SHAKE256 absorb/squeeze of μ, ρ' and c̃
+    uint64_t samplingNs;        // y = ExpandMask(ρ', κ) and c = SampleInBall(c̃)
+    uint64_t packingNs;         // Key unpacking, w1 and signature packing
+    uint64_t totalNs;           // Whole signing call
+};
+
+/**
+ * @brief One (message, signature) pair of a batch verification request
+ *
+ * Only pointers are stored, the caller keeps ownership of the buffers.
+ */
+struct DilithiumVerifyItem {
+    const uint8_t* message;
+    size_t messageLength;
+    const uint8_t* signature;
+    size_t signatureLength;
+};
+
+#endif // DILITHIUM_PARAMS_HPP
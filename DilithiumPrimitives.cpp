@@ -0,0 +1,222 @@
+/**
+ * @file DilithiumPrimitives.cpp
+ * @brief Primitive table of one Dilithium mode for the micro benchmark
+ *
+ * Compiled once per parameter set with DILITHIUM_MODE set to 2, 3 or 5.
+ * With DILITHIUM_HAVE_AVX2 the same primitives of the AVX2 library are
+ * listed as well; like in Dilithiumwrapper.cpp they are declared here
+ * because the avx2 headers share their include guards with the ref ones.
+ */
+
+#include "DilithiumPrimitives.hpp"
+#include "Dilithiumwrapper.hpp"
+#include <cstring>
+
+extern "C" {
+#include "params.h"
+#include "poly.h"
+#include "reduce.h"
+
+#ifdef DILITHIUM_HAVE_AVX2
+// The underscore is pasted first so that s is not expanded through the ref
+// macros of poly.h (poly_ntt -> pqcrystals_dilithium<mode>_ref_poly_ntt)
+#define DILITHIUM_AVX2_CONCAT(mode, s) pqcrystals_dilithium##mode##_avx2##s
+#define DILITHIUM_AVX2_EXPAND(mode, s) DILITHIUM_AVX2_CONCAT(mode, s)
+#define DILITHIUM_AVX2_NAMESPACE(s) DILITHIUM_AVX2_EXPAND(DILITHIUM_MODE, _##s)
+
+// The avx2 poly is a 32-byte aligned union over the same 256 coefficients
+void DILITHIUM_AVX2_NAMESPACE(poly_ntt)(poly *a);
+void DILITHIUM_AVX2_NAMESPACE(poly_invntt_tomont)(poly *a);
+void DILITHIUM_AVX2_NAMESPACE(poly_pointwise_montgomery)(poly *c, const poly *a, const poly *b);
+void DILITHIUM_AVX2_NAMESPACE(poly_uniform)(poly *a, const uint8_t seed[SEEDBYTES],
+                                            uint16_t nonce);
+void DILITHIUM_AVX2_NAMESPACE(poly_challenge)(poly *c, const uint8_t seed[CTILDEBYTES]);
+void DILITHIUM_AVX2_NAMESPACE(polyz_pack)(uint8_t *r, const poly *a);
+void DILITHIUM_AVX2_NAMESPACE(polyz_unpack)(poly *r, const uint8_t *a);
+#endif
+}
+
+namespace {
+
+/**
+ * @brief Working set of every primitive
+ *
+ * ntt transforms a fresh copy of input on each call: its output grows by
+ * up to 8q, so it cannot be applied to the same polynomial repeatedly. The
+ * numbers therefore include one 1 KB copy. invntt_tomont ends with
+ * coefficients below q and runs in place.
+ */
+struct alignas(64) State {
+    poly input;                     // Coefficients in (-q, q)
+    poly work;                      // ntt / invntt_tomont operand
+    poly a;                         // Pointwise operands
+    poly b;
+    poly product;                   // Output of pointwise, uniform, challenge
+    poly z;                         // Coefficients in (-γ1, γ1]
+    uint8_t packedZ[POLYZ_PACKEDBYTES];
+    uint8_t seed[SEEDBYTES];
+    uint8_t challengeSeed[CTILDEBYTES];
+    uint16_t nonce;
+    int64_t wide;
+    int32_t narrow;
+};
+
+State& as(void* state) {
+    return *static_cast<State*>(state);
+}
+
+/**
+ * @brief xorshift64* - fast, deterministic input data
+ */
+uint64_t nextRandom(uint64_t& x) {
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+void refNtt(void* state) {
+    State& s = as(state);
+    std::memcpy(&s.work, &s.input, sizeof(poly));
+    poly_ntt(&s.work);
+}
+
+void refInvntt(void* state) {
+    poly_invntt_tomont(&as(state).work);
+}
+
+void refPointwise(void* state) {
+    State& s = as(state);
+    poly_pointwise_montgomery(&s.product, &s.a, &s.b);
+}
+
+void refMontgomery(void* state) {
+    State& s = as(state);
+    s.narrow = montgomery_reduce(s.wide);
+}
+
+void refUniform(void* state) {
+    State& s = as(state);
+    poly_uniform(&s.product, s.seed, s.nonce++);
+}
+
+void refChallenge(void* state) {
+    State& s = as(state);
+    ++s.challengeSeed[0];
+    poly_challenge(&s.product, s.challengeSeed);
+}
+
+void refPack(void* state) {
+    State& s = as(state);
+    polyz_pack(s.packedZ, &s.z);
+}
+
+void refUnpack(void* state) {
+    State& s = as(state);
+    polyz_unpack(&s.product, s.packedZ);
+}
+
+#ifdef DILITHIUM_HAVE_AVX2
+void avx2Ntt(void* state) {
+    State& s = as(state);
+    std::memcpy(&s.work, &s.input, sizeof(poly));
+    DILITHIUM_AVX2_NAMESPACE(poly_ntt)(&s.work);
+}
+
+void avx2Invntt(void* state) {
+    DILITHIUM_AVX2_NAMESPACE(poly_invntt_tomont)(&as(state).work);
+}
+
+void avx2Pointwise(void* state) {
+    State& s = as(state);
+    DILITHIUM_AVX2_NAMESPACE(poly_pointwise_montgomery)(&s.product, &s.a, &s.b);
+}
+
+void avx2Uniform(void* state) {
+    State& s = as(state);
+    DILITHIUM_AVX2_NAMESPACE(poly_uniform)(&s.product, s.seed, s.nonce++);
+}
+
+void avx2Challenge(void* state) {
+    State& s = as(state);
+    ++s.challengeSeed[0];
+    DILITHIUM_AVX2_NAMESPACE(poly_challenge)(&s.product, s.challengeSeed);
+}
+
+void avx2Pack(void* state) {
+    State& s = as(state);
+    DILITHIUM_AVX2_NAMESPACE(polyz_pack)(s.packedZ, &s.z);
+}
+
+void avx2Unpack(void* state) {
+    State& s = as(state);
+    DILITHIUM_AVX2_NAMESPACE(polyz_unpack)(&s.product, s.packedZ);
+}
+#endif
+
+} // namespace
+
+template <int Mode>
+std::vector<DilithiumPrimitive> DilithiumPrimitives<Mode>::list(DilithiumBackend backend) {
+    if (!DilithiumWrapper<Mode>::isBackendAvailable(backend)) {
+        return {};
+    }
+    if (backend == DilithiumBackend::Reference) {
+        return {
+            {"ntt", refNtt},
+            {"invntt_tomont", refInvntt},
+            {"poly_pointwise_montgomery", refPointwise},
+            {"montgomery_reduce", refMontgomery},
+            {"poly_uniform", refUniform},
+            {"poly_challenge", refChallenge},
+            {"polyz_pack", refPack},
+            {"polyz_unpack", refUnpack},
+        };
+    }
+#ifdef DILITHIUM_HAVE_AVX2
+    // The avx2 library reduces inside its assembly kernels and exports no
+    // scalar montgomery_reduce
+    if (backend == DilithiumBackend::AVX2) {
+        return {
+            {"ntt", avx2Ntt},
+            {"invntt_tomont", avx2Invntt},
+            {"poly_pointwise_montgomery", avx2Pointwise},
+            {"poly_uniform", avx2Uniform},
+            {"poly_challenge", avx2Challenge},
+            {"polyz_pack", avx2Pack},
+            {"polyz_unpack", avx2Unpack},
+        };
+    }
+#endif
+    return {};
+}
+
+template <int Mode>
+size_t DilithiumPrimitives<Mode>::stateBytes() {
+    return sizeof(State);
+}
+
+template <int Mode>
+void DilithiumPrimitives<Mode>::prepare(void* state, uint64_t seed) {
+    State& s = as(state);
+    std::memset(&s, 0, sizeof(State));
+    uint64_t x = seed * 0x9E3779B97F4A7C15ULL + 1;
+
+    for (size_t i = 0; i < N; ++i) {
+        s.input.coeffs[i] = static_cast<int32_t>(nextRandom(x) % (2 * Q - 1)) - (Q - 1);
+        s.work.coeffs[i] = s.input.coeffs[i];
+        s.a.coeffs[i] = static_cast<int32_t>(nextRandom(x) % Q);
+        s.b.coeffs[i] = static_cast<int32_t>(nextRandom(x) % Q);
+        s.z.coeffs[i] = GAMMA1 - static_cast<int32_t>(nextRandom(x) % (2 * GAMMA1));
+    }
+    polyz_pack(s.packedZ, &s.z);
+    for (uint8_t& byte : s.seed) {
+        byte = static_cast<uint8_t>(nextRandom(x));
+    }
+    for (uint8_t& byte : s.challengeSeed) {
+        byte = static_cast<uint8_t>(nextRandom(x));
+    }
+    s.wide = static_cast<int64_t>(s.a.coeffs[0]) * s.b.coeffs[0];
+}
+
+template class DilithiumPrimitives<DILITHIUM_MODE>;
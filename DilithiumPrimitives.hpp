@@ -0,0 +1,73 @@
+/**
+ * @file DilithiumPrimitives.hpp
+ * @brief Individual arithmetic and sampling primitives of the Dilithium libraries
+ *
+ * The end-to-end benchmark only shows that keygen, sign or verify got
+ * slower. This table exposes the primitives those operations are built
+ * from - NTT, inverse NTT, pointwise multiplication, Montgomery reduction,
+ * rejection sampling of A, the challenge and the z packing - so that
+ * dilithium_microbench can time each of them on its own, per mode and per
+ * backend.
+ *
+ * Every primitive works on one State: a 64-byte aligned, self-contained
+ * working set of polynomials, seeds and packed bytes. The micro benchmark
+ * reuses one State for warm-cache runs and walks through a pool of States
+ * larger than the last-level cache for cold-cache runs.
+ *
+ * Like the wrapper, the table is a template over the mode that is compiled
+ * once per mode in DilithiumPrimitives.cpp and explicitly instantiated.
+ *
+ * @author Student Project - Cryptographic Systems Course
+ * @date December 2025
+ */
+
+#ifndef DILITHIUM_PRIMITIVES_HPP
+#define DILITHIUM_PRIMITIVES_HPP
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "DilithiumParams.hpp"
+
+/**
+ * @brief One primitive bound to a backend
+ */
+struct DilithiumPrimitive {
+    const char* name;               // Name of the C function, e.g. "ntt", "polyz_pack"
+    void (*run)(void* state);       // One call on one State
+};
+
+/**
+ * @brief Primitives of one Dilithium mode
+ * @tparam Mode Dilithium mode (2, 3 or 5)
+ */
+template <int Mode>
+class DilithiumPrimitives {
+public:
+    /**
+     * @brief Primitives of a backend
+     * @param backend Implementation to call
+     * @return The primitives, or an empty list if the backend was not built
+     *         or the CPU does not support it
+     */
+    static std::vector<DilithiumPrimitive> list(DilithiumBackend backend);
+
+    /**
+     * @brief Size of one State in bytes (a multiple of the 64-byte alignment)
+     */
+    static size_t stateBytes();
+
+    /**
+     * @brief Fill a State with valid pseudo-random inputs
+     * @param state stateBytes() bytes, 64-byte aligned
+     * @param seed Selects the inputs; different seeds give different States
+     */
+    static void prepare(void* state, uint64_t seed);
+};
+
+// Instantiated in DilithiumPrimitives.cpp, once per separately compiled mode
+extern template class DilithiumPrimitives<2>;
+extern template class DilithiumPrimitives<3>;
+extern template class DilithiumPrimitives<5>;
+
+#endif // DILITHIUM_PRIMITIVES_HPP
@@ -0,0 +1,243 @@
+/**
+ * @file DilithiumService.cpp
+ * @brief Implementation of the batching Dilithium service
+ */
+
+#include "DilithiumService.hpp"
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+namespace {
+
+size_t depthBin(size_t depth) {
+    size_t bin = 0;
+    while (depth > 1 && bin + 1 < DilithiumServiceStats::DEPTH_BINS) {
+        depth >>= 1;
+        ++bin;
+    }
+    return bin;
+}
+
+} // namespace
+
+template <int Mode>
+DilithiumService<Mode>::DilithiumService(const DilithiumWrapper<Mode>& keys, const Config& config)
+    : config_(config)
+    , signingKey_(keys.prepareSigningKey())
+    , publicKey_(keys.preparePublicKey())
+    , outstanding_(0)
+    , runningBatches_(0)
+    , stopping_(false)
+    , stats_()
+    , pool_(config.threads) {
+    config_.maxBatch = std::max<size_t>(1, config_.maxBatch);
+    config_.queueCapacity = std::max<size_t>(1, config_.queueCapacity);
+    stats_.batchSizes.assign(config_.maxBatch + 1, 0);
+    dispatcher_ = std::thread(&DilithiumService::dispatchLoop, this);
+}
+
+template <int Mode>
+DilithiumService<Mode>::~DilithiumService() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_.notify_all();
+    room_.notify_all();
+    dispatcher_.join();
+    pool_.waitIdle();
+}
+
+template <int Mode>
+bool DilithiumService<Mode>::submitSign(std::vector<uint8_t> message, SignCallback done) {
+    return enqueue({true, std::move(message), {}, std::move(done), nullptr, {}}, true);
+}
+
+template <int Mode>
+bool DilithiumService<Mode>::trySubmitSign(std::vector<uint8_t> message, SignCallback done) {
+    return enqueue({true, std::move(message), {}, std::move(done), nullptr, {}}, false);
+}
+
+template <int Mode>
+bool DilithiumService<Mode>::submitVerify(std::vector<uint8_t> message,
+                                          std::vector<uint8_t> signature, VerifyCallback done) {
+    return enqueue({false, std::move(message), std::move(signature), nullptr, std::move(done), {}},
+                   true);
+}
+
+template <int Mode>
+bool DilithiumService<Mode>::trySubmitVerify(std::vector<uint8_t> message,
+                                             std::vector<uint8_t> signature, VerifyCallback done) {
+    return enqueue({false, std::move(message), std::move(signature), nullptr, std::move(done), {}},
+                   false);
+}
+
+template <int Mode>
+bool DilithiumService<Mode>::enqueue(Request request, bool wait) {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (wait) {
+            room_.wait(lock, [this]() {
+                return stopping_ || outstanding_ < config_.queueCapacity;
+            });
+        } else if (outstanding_ >= config_.queueCapacity) {
+            ++stats_.rejected;
+            return false;
+        }
+        if (stopping_) {
+            return false;
+        }
+
+        request.queuedAt = std::chrono::steady_clock::now();
+        queue_.push_back(std::move(request));
+        ++outstanding_;
+        ++stats_.submitted;
+        ++stats_.queueDepthHistogram[depthBin(queue_.size())];
+        stats_.maxQueued = std::max(stats_.maxQueued, queue_.size());
+    }
+    work_.notify_one();
+    return true;
+}
+
+/**
+ * @brief Close and dispatch batches until shutdown
+ *
+ * A batch is only opened while a worker is free, so under load the queue
+ * fills up and the next batch leaves full.
+ */
+template <int Mode>
+void DilithiumService<Mode>::dispatchLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        work_.wait(lock, [this]() {
+            return stopping_ || (!queue_.empty() && runningBatches_ < pool_.size());
+        });
+        if (queue_.empty()) {
+            return;     // Stopping and drained
+        }
+
+        // Wait for a full batch or the oldest request's deadline
+        const auto deadline = queue_.front().queuedAt + config_.maxDelay;
+        work_.wait_until(lock, deadline, [this]() {
+            return stopping_ || queue_.size() >= config_.maxBatch;
+        });
+
+        const size_t size = std::min(queue_.size(), config_.maxBatch);
+        auto batch = std::make_shared<std::vector<Request>>();
+        try {
+            batch->reserve(size);
+            for (size_t i = 0; i < size; ++i) {
+                batch->push_back(std::move(queue_.front()));
+                queue_.pop_front();
+            }
+        } catch (...) {
+            // Out of memory: leave the remaining requests for the next round
+        }
+        if (batch->empty()) {
+            continue;
+        }
+
+        ++stats_.batches;
+        ++stats_.batchSizes[batch->size()];
+        ++(batch->size() == config_.maxBatch ? stats_.fullBatches : stats_.deadlineBatches);
+        ++runningBatches_;
+
+        lock.unlock();
+        pool_.submit([this, batch]() {
+            runBatch(*batch);
+            finishBatch(batch->size());
+        });
+        lock.lock();
+    }
+}
+
+/**
+ * @brief Run one batch on the calling worker, callbacks in arrival order
+ *
+ * The verify requests of the batch are checked together first, through
+ * DilithiumWrapper::verifyBatch() on the prepared key, so that μ is hashed
+ * for up to eight messages at once on the multi-lane Keccak. If the item
+ * list cannot be allocated, each request is verified on its own instead.
+ */
+template <int Mode>
+void DilithiumService<Mode>::runBatch(std::vector<Request>& batch) {
+    std::vector<DilithiumVerifyItem> items;
+    std::unique_ptr<bool[]> results;
+    try {
+        items.reserve(batch.size());
+        for (const Request& request : batch) {
+            if (!request.sign) {
+                items.push_back({request.message.data(), request.message.size(),
+                                 request.signature.data(), request.signature.size()});
+            }
+        }
+        results.reset(new bool[items.size()]);
+        DilithiumWrapper<Mode>::verifyBatch(publicKey_, items.data(), items.size(), results.get());
+    } catch (...) {
+        results.reset();
+    }
+
+    size_t verified = 0;
+    for (Request& request : batch) {
+        try {
+            if (request.sign) {
+                std::vector<uint8_t> signature = DilithiumWrapper<Mode>::sign(signingKey_,
+                                                                              request.message);
+                if (request.signDone) {
+                    request.signDone(std::move(signature));
+                }
+            } else {
+                const bool valid = results ? results[verified++]
+                                 : publicKey_.verify(request.message.data(), request.message.size(),
+                                                     request.signature.data(),
+                                                     request.signature.size());
+                if (request.verifyDone) {
+                    request.verifyDone(valid);
+                }
+            }
+        } catch (...) {
+            // A throwing callback must not take the other requests of the batch with it
+        }
+    }
+}
+
+template <int Mode>
+void DilithiumService<Mode>::finishBatch(size_t size) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        outstanding_ -= size;
+        stats_.completed += size;
+        --runningBatches_;
+    }
+    work_.notify_one();
+    room_.notify_all();
+}
+
+template <int Mode>
+void DilithiumService<Mode>::waitIdle() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    room_.wait(lock, [this]() { return outstanding_ == 0; });
+}
+
+template <int Mode>
+typename DilithiumService<Mode>::Stats DilithiumService<Mode>::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats = stats_;
+    stats.queued = queue_.size();
+    stats.outstanding = outstanding_;
+    return stats;
+}
+
+template <int Mode>
+void DilithiumService<Mode>::resetStats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const size_t bins = stats_.batchSizes.size();
+    stats_ = Stats();
+    stats_.batchSizes.assign(bins, 0);
+}
+
+// Mode-independent code: all three modes are instantiated in this one file
+template class DilithiumService<2>;
+template class DilithiumService<3>;
+template class DilithiumService<5>;
@@ -0,0 +1,211 @@
+/**
+ * @file DilithiumService.hpp
+ * @brief Asynchronous sign/verify service with micro-batching and backpressure
+ *
+ * DilithiumEngine hands every job to the pool on its own. A server driven by
+ * an event loop needs to submit without blocking, to be told when it has to
+ * back off, and, under load, to have requests grouped so that one worker
+ * runs many operations on the same (prepared, cache-warm) key in a row.
+ *
+ * Requests go into one bounded queue. A dispatcher thread takes them out in
+ * micro-batches of up to maxBatch requests and hands each batch to a free
+ * ThreadPool worker. A batch is closed when it is full or when its oldest
+ * request has waited maxDelay; while all workers are busy requests keep
+ * queueing, so batches grow with the load. queueCapacity bounds the number
+ * of outstanding (queued or running) requests: trySubmit*() refuses new
+ * work beyond it, submit*() blocks until there is room.
+ *
+ * Results are delivered through callbacks on a worker thread. Callbacks must
+ * not call the blocking submit*() of the same service (the worker they run on
+ * may be the one that has to make room); trySubmit*() is safe.
+ *
+ * @code
+ * DilithiumService<3> service(dilithium, {32, std::chrono::microseconds(200), 4096, 0});
+ * if (!service.trySubmitVerify(message, signature, [](bool ok) { ... })) {
+ *     // Queue full: shed the request or retry later
+ * }
+ * @endcode
+ *
+ * @author Student Project - Cryptographic Systems Course
+ * @date December 2025
+ */
+
+#ifndef DILITHIUM_SERVICE_HPP
+#define DILITHIUM_SERVICE_HPP
+
+#include "Dilithiumwrapper.hpp"
+#include "PreparedKeys.hpp"
+#include "ThreadPool.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief Batching and queueing limits of a DilithiumService
+ */
+struct DilithiumServiceConfig {
+    size_t maxBatch = 32;                           // Requests per batch at most
+    std::chrono::microseconds maxDelay{200};        // Oldest request's wait before a partial batch is sent
+    size_t queueCapacity = 1024;                    // Outstanding (queued + running) requests at most
+    size_t threads = 0;                             // Workers, 0 selects the hardware threads
+};
+
+/**
+ * @brief Counters of a DilithiumService
+ */
+struct DilithiumServiceStats {
+    static constexpr size_t DEPTH_BINS = 16;
+
+    uint64_t submitted;         // Requests accepted
+    uint64_t rejected;          // trySubmit*() calls refused because the queue was full
+    uint64_t completed;         // Requests whose callback has returned
+    uint64_t batches;           // Batches dispatched
+    uint64_t fullBatches;       // ... of which closed at maxBatch
+    uint64_t deadlineBatches;   // ... of which closed by maxDelay (or shutdown)
+    size_t queued;              // Requests waiting for a batch right now
+    size_t outstanding;         // Queued plus running right now
+    size_t maxQueued;           // Highest queue depth seen
+    std::vector<uint64_t> batchSizes;   // batchSizes[n]: batches of n requests, n = 0..maxBatch
+    uint64_t queueDepthHistogram[DEPTH_BINS]; // Bin b: submits that found 2^b..2^(b+1)-1 queued,
+                                              // counting themselves (last bin open-ended)
+
+    double averageBatchSize() const {
+        uint64_t requests = 0;
+        for (size_t size = 0; size < batchSizes.size(); ++size) {
+            requests += size * batchSizes[size];
+        }
+        return batches ? static_cast<double>(requests) / batches : 0.0;
+    }
+};
+
+/**
+ * @brief Callback-based front-end that coalesces requests into micro-batches
+ * @tparam Mode Dilithium mode (2, 3 or 5)
+ */
+template <int Mode>
+class DilithiumService {
+public:
+    using SignCallback = std::function<void(std::vector<uint8_t> signature)>;
+    using VerifyCallback = std::function<void(bool valid)>;
+    using Config = DilithiumServiceConfig;
+    using Stats = DilithiumServiceStats;
+
+    /**
+     * @brief Constructor - prepares the keys of a wrapper and starts the workers
+     * @param keys Wrapper holding the key pair (generateKeys() or setSecretKey())
+     * @param config Batch size, deadline, queue capacity and worker count
+     */
+    explicit DilithiumService(const DilithiumWrapper<Mode>& keys, const Config& config = Config());
+
+    /**
+     * @brief Destructor - runs all accepted requests before returning
+     */
+    ~DilithiumService();
+
+    DilithiumService(const DilithiumService&) = delete;
+    DilithiumService& operator=(const DilithiumService&) = delete;
+
+    /**
+     * @brief Queue a signing request, waiting while the queue is full
+     * @param message The message to sign (moved into the request)
+     * @param done Invoked on a worker thread with the signature (empty on failure)
+     * @return true if accepted, false if the service is shutting down
+     */
+    bool submitSign(std::vector<uint8_t> message, SignCallback done);
+
+    /**
+     * @brief Queue a signing request unless the queue is full
+     * @return true if accepted; false (without calling done) if full
+     */
+    bool trySubmitSign(std::vector<uint8_t> message, SignCallback done);
+
+    /**
+     * @brief Queue a verification request, waiting while the queue is full
+     * @param message The original message (moved into the request)
+     * @param signature The signature to verify (moved into the request)
+     * @param done Invoked on a worker thread with the verification result
+     * @return true if accepted, false if the service is shutting down
+     */
+    bool submitVerify(std::vector<uint8_t> message, std::vector<uint8_t> signature,
+                      VerifyCallback done);
+
+    /**
+     * @brief Queue a verification request unless the queue is full
+     * @return true if accepted; false (without calling done) if full
+     */
+    bool trySubmitVerify(std::vector<uint8_t> message, std::vector<uint8_t> signature,
+                         VerifyCallback done);
+
+    /**
+     * @brief Block until every accepted request has completed
+     */
+    void waitIdle();
+
+    /**
+     * @brief Snapshot of the counters and histograms
+     */
+    Stats stats() const;
+
+    /**
+     * @brief Zero the counters and histograms (current depths are kept)
+     */
+    void resetStats();
+
+    const Config& config() const { return config_; }
+
+    /**
+     * @brief Get the number of worker threads
+     */
+    size_t threadCount() const { return pool_.size(); }
+
+    /**
+     * @brief Check if the service has usable keys
+     * @return true if both prepared keys were built
+     */
+    bool isReady() const {
+        return signingKey_.isValid() && publicKey_.isValid();
+    }
+
+private:
+    struct Request {
+        bool sign;
+        std::vector<uint8_t> message;
+        std::vector<uint8_t> signature;
+        SignCallback signDone;
+        VerifyCallback verifyDone;
+        std::chrono::steady_clock::time_point queuedAt;
+    };
+
+    Config config_;
+    PreparedSigningKey<Mode> signingKey_;
+    PreparedPublicKey<Mode> publicKey_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable work_;      // Dispatcher: requests arrived or a worker is free
+    std::condition_variable room_;      // Producers and waitIdle(): requests completed
+    std::deque<Request> queue_;
+    size_t outstanding_;
+    size_t runningBatches_;
+    bool stopping_;
+    Stats stats_;
+
+    ThreadPool pool_;
+    std::thread dispatcher_;            // Declared last: started after, joined before the rest
+
+    bool enqueue(Request request, bool wait);
+    void dispatchLoop();
+    void runBatch(std::vector<Request>& batch);
+    void finishBatch(size_t size);
+};
+
+extern template class DilithiumService<2>;
+extern template class DilithiumService<3>;
+extern template class DilithiumService<5>;
+
+#endif // DILITHIUM_SERVICE_HPP
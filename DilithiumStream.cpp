@@ -0,0 +1,250 @@
+/**
+ * @file DilithiumStream.cpp
+ * @brief Implementation of incremental Dilithium signing and verification
+ *
+ * μ = CRH(tr || pre || M) is computed exactly as in the reference
+ * signature()/verify() (pre = (0, 0) for the empty context string), but the
+ * SHAKE256 absorb of M is split across update() calls. This file is
+ * compiled once per parameter set with DILITHIUM_MODE set to 2, 3 or 5.
+ */
+
+#include "DilithiumStream.hpp"
+#include "MappedFile.hpp"
+#include <cstdio>
+#include <algorithm>
+
+extern "C" {
+#include "fips202.h"
+}
+
+namespace {
+
+// Slice size for absorbing mapped files and buffer size for chunked reads
+constexpr size_t FILE_CHUNK_BYTES = 1 << 20;
+
+/**
+ * @brief Start μ = CRH(tr || pre || ...) with an empty context string
+ */
+void startMu(keccak_state* state, const uint8_t* tr) {
+    const uint8_t pre[2] = {0, 0};
+    shake256_init(state);
+    shake256_absorb(state, tr, DILITHIUM_MU_BYTES);
+    shake256_absorb(state, pre, sizeof(pre));
+}
+
+/**
+ * @brief Feed a file to absorb(data, length) in order, without buffering it whole
+ */
+template <typename Absorb>
+bool readFileChunks(const std::string& path, Absorb absorb) {
+    MappedFile mapped;
+    if (mapped.map(path, MappedFile::Access::Sequential)) {
+        for (size_t offset = 0; offset < mapped.size(); offset += FILE_CHUNK_BYTES) {
+            const size_t length = std::min(FILE_CHUNK_BYTES, mapped.size() - offset);
+            absorb(mapped.data() + offset, length);
+            // Drop hashed pages from the mapping to keep the footprint constant
+            mapped.dontNeed(offset, length);
+        }
+        return true;
+    }
+
+    // Empty or special files (pipes) or no mmap(): plain chunked reads
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+
+    std::vector<uint8_t> buffer(FILE_CHUNK_BYTES);
+    size_t read = 0;
+    while ((read = std::fread(buffer.data(), 1, buffer.size(), file)) > 0) {
+        absorb(buffer.data(), read);
+    }
+    bool ok = !std::ferror(file);
+    std::fclose(file);
+    return ok;
+}
+
+} // namespace
+
+template <int Mode>
+struct SignStream<Mode>::State {
+    keccak_state keccak;
+};
+
+template <int Mode>
+SignStream<Mode>::SignStream(const PreparedSigningKey<Mode>& key)
+    : key_(key)
+    , state_(new State)
+    , failed_(false) {
+    reset();
+}
+
+template <int Mode>
+SignStream<Mode>::~SignStream() = default;
+
+template <int Mode>
+void SignStream<Mode>::update(const uint8_t* data, size_t length) {
+    if (data && length > 0) {
+        shake256_absorb(&state_->keccak, data, length);
+    }
+}
+
+template <int Mode>
+bool SignStream<Mode>::updateFile(const std::string& path) {
+    bool ok = readFileChunks(path, [this](const uint8_t* data, size_t length) {
+        update(data, length);
+    });
+    failed_ = failed_ || !ok;
+    return ok;
+}
+
+/**
+ * @brief Squeeze μ and run the prepared key's rejection loop on it
+ */
+template <int Mode>
+bool SignStream<Mode>::final(uint8_t* signature, size_t* signatureLength) {
+    if (failed_ || !key_.isValid()) {
+        reset();
+        return false;
+    }
+
+    uint8_t mu[DILITHIUM_MU_BYTES];
+    shake256_finalize(&state_->keccak);
+    shake256_squeeze(mu, DILITHIUM_MU_BYTES, &state_->keccak);
+
+    bool ok = key_.signMu(mu, signature, signatureLength);
+    reset();
+    return ok;
+}
+
+template <int Mode>
+bool SignStream<Mode>::finalMu(uint8_t* mu) {
+    if (failed_ || !key_.isValid() || !mu) {
+        reset();
+        return false;
+    }
+
+    shake256_finalize(&state_->keccak);
+    shake256_squeeze(mu, DILITHIUM_MU_BYTES, &state_->keccak);
+    reset();
+    return true;
+}
+
+template <int Mode>
+std::vector<uint8_t> SignStream<Mode>::final() {
+    try {
+        std::vector<uint8_t> signature(DilithiumParams<Mode>::SIGNATURE_BYTES);
+        size_t signatureLength = 0;
+
+        if (!final(signature.data(), &signatureLength)) {
+            return {};
+        }
+
+        signature.resize(signatureLength);
+        return signature;
+    } catch (...) {
+        return {};
+    }
+}
+
+template <int Mode>
+void SignStream<Mode>::reset() {
+    failed_ = false;
+    if (key_.isValid()) {
+        startMu(&state_->keccak, key_.tr());
+    } else {
+        shake256_init(&state_->keccak);
+    }
+}
+
+template <int Mode>
+std::vector<uint8_t> SignStream<Mode>::signFile(const PreparedSigningKey<Mode>& key,
+                                                const std::string& path) {
+    try {
+        SignStream stream(key);
+        if (!stream.updateFile(path)) {
+            return {};
+        }
+        return stream.final();
+    } catch (...) {
+        return {};
+    }
+}
+
+template <int Mode>
+struct VerifyStream<Mode>::State {
+    keccak_state keccak;
+};
+
+template <int Mode>
+VerifyStream<Mode>::VerifyStream(const PreparedPublicKey<Mode>& key)
+    : key_(key)
+    , state_(new State)
+    , failed_(false) {
+    reset();
+}
+
+template <int Mode>
+VerifyStream<Mode>::~VerifyStream() = default;
+
+template <int Mode>
+void VerifyStream<Mode>::update(const uint8_t* data, size_t length) {
+    if (data && length > 0) {
+        shake256_absorb(&state_->keccak, data, length);
+    }
+}
+
+template <int Mode>
+bool VerifyStream<Mode>::updateFile(const std::string& path) {
+    bool ok = readFileChunks(path, [this](const uint8_t* data, size_t length) {
+        update(data, length);
+    });
+    failed_ = failed_ || !ok;
+    return ok;
+}
+
+/**
+ * @brief Squeeze μ and run the prepared key's verification core on it
+ */
+template <int Mode>
+bool VerifyStream<Mode>::final(const uint8_t* signature, size_t signatureLength) {
+    if (failed_ || !key_.isValid()) {
+        reset();
+        return false;
+    }
+
+    uint8_t mu[DILITHIUM_MU_BYTES];
+    shake256_finalize(&state_->keccak);
+    shake256_squeeze(mu, DILITHIUM_MU_BYTES, &state_->keccak);
+
+    bool valid = key_.verifyMu(mu, signature, signatureLength);
+    reset();
+    return valid;
+}
+
+template <int Mode>
+void VerifyStream<Mode>::reset() {
+    failed_ = false;
+    if (key_.isValid()) {
+        startMu(&state_->keccak, key_.tr());
+    } else {
+        shake256_init(&state_->keccak);
+    }
+}
+
+template <int Mode>
+bool VerifyStream<Mode>::verifyFile(const PreparedPublicKey<Mode>& key, const std::string& path,
+                                    const std::vector<uint8_t>& signature) {
+    try {
+        VerifyStream stream(key);
+        if (!stream.updateFile(path)) {
+            return false;
+        }
+        return stream.final(signature);
+    } catch (...) {
+        return false;
+    }
+}
+
+template class SignStream<DILITHIUM_MODE>;
+template class VerifyStream<DILITHIUM_MODE>;
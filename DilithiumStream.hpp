@@ -0,0 +1,228 @@
+/**
+ * @file DilithiumStream.hpp
+ * @brief Incremental (init/update/final) Dilithium signing and verification
+ *
+ * Dilithium touches the message exactly once: it is absorbed into SHAKE256
+ * to form μ = CRH(tr || M'), and every later step works on the 64-byte μ.
+ * SignStream and VerifyStream keep that Keccak state open across update()
+ * calls, so a message can be fed in chunks of any size and never needs to
+ * be held in memory as a whole. final() squeezes μ and runs the normal
+ * signing or verification core on the prepared key.
+ *
+ * Signatures are byte-identical to signing the concatenated chunks in one
+ * call, and are verified by the plain verify() functions.
+ *
+ * @author Student Project - Cryptographic Systems Course
+ * @date December 2025
+ */
+
+#ifndef DILITHIUM_STREAM_HPP
+#define DILITHIUM_STREAM_HPP
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include "DilithiumParams.hpp"
+#include "PreparedKeys.hpp"
+
+/**
+ * @brief Sign a message that is supplied in pieces
+ *
+ * The prepared key is referenced, not copied, and must outlive the stream.
+ *
+ * @tparam Mode Dilithium mode (2, 3 or 5)
+ */
+template <int Mode>
+class SignStream {
+public:
+    /**
+     * @brief Constructor - starts a new message
+     * @param key Prepared signing key (see DilithiumWrapper::prepareSigningKey())
+     */
+    explicit SignStream(const PreparedSigningKey<Mode>& key);
+
+    /**
+     * @brief Destructor
+     */
+    ~SignStream();
+
+    SignStream(const SignStream&) = delete;
+    SignStream& operator=(const SignStream&) = delete;
+
+    /**
+     * @brief Absorb the next piece of the message
+     * @param data Pointer to the chunk
+     * @param length Chunk length in bytes
+     */
+    void update(const uint8_t* data, size_t length);
+
+    /**
+     * @brief Absorb the next piece of the message
+     * @param data The chunk
+     */
+    void update(const std::vector<uint8_t>& data) {
+        update(data.data(), data.size());
+    }
+
+    /**
+     * @brief Absorb the contents of a file
+     *
+     * The file is memory-mapped (MappedFile) with sequential read-ahead, so
+     * the kernel reads the next pages while the current ones are hashed.
+     * Files that cannot be mapped, such as pipes, are read in fixed-size
+     * chunks instead.
+     *
+     * @param path Path of the file
+     * @return true if the whole file was read
+     */
+    bool updateFile(const std::string& path);
+
+    /**
+     * @brief Finish the message and produce the signature
+     *
+     * The stream is reset afterwards and can be reused for a new message.
+     *
+     * @param signature Output buffer of at least the mode's signature size
+     * @param signatureLength Receives the number of bytes written
+     * @return true if successful, false otherwise
+     */
+    bool final(uint8_t* signature, size_t* signatureLength);
+
+    /**
+     * @brief Finish the message and produce the signature
+     * @return The signature bytes, or empty vector on failure
+     */
+    std::vector<uint8_t> final();
+
+    /**
+     * @brief Finish the message and output μ instead of signing it
+     *
+     * For pipelines that hash on one thread and sign on another: passing μ
+     * to PreparedSigningKey::signMu() gives the signature final() would.
+     * The stream is reset afterwards.
+     *
+     * @param mu Output, DILITHIUM_MU_BYTES bytes
+     * @return true if successful, false after a read error or without a key
+     */
+    bool finalMu(uint8_t* mu);
+
+    /**
+     * @brief Discard the absorbed data and start a new message
+     */
+    void reset();
+
+    /**
+     * @brief Sign a file without loading it into memory
+     * @param key Prepared signing key
+     * @param path Path of the file
+     * @return The signature bytes, or empty vector on failure
+     */
+    static std::vector<uint8_t> signFile(const PreparedSigningKey<Mode>& key,
+                                         const std::string& path);
+
+private:
+    struct State;
+    const PreparedSigningKey<Mode>& key_;
+    std::unique_ptr<State> state_;
+    bool failed_;   // Set when updateFile() hit a read error
+};
+
+/**
+ * @brief Verify a signature over a message that is supplied in pieces
+ *
+ * The prepared key is referenced, not copied, and must outlive the stream.
+ *
+ * @tparam Mode Dilithium mode (2, 3 or 5)
+ */
+template <int Mode>
+class VerifyStream {
+public:
+    /**
+     * @brief Constructor - starts a new message
+     * @param key Prepared public key of the signer
+     */
+    explicit VerifyStream(const PreparedPublicKey<Mode>& key);
+
+    /**
+     * @brief Destructor
+     */
+    ~VerifyStream();
+
+    VerifyStream(const VerifyStream&) = delete;
+    VerifyStream& operator=(const VerifyStream&) = delete;
+
+    /**
+     * @brief Absorb the next piece of the message
+     * @param data Pointer to the chunk
+     * @param length Chunk length in bytes
+     */
+    void update(const uint8_t* data, size_t length);
+
+    /**
+     * @brief Absorb the next piece of the message
+     * @param data The chunk
+     */
+    void update(const std::vector<uint8_t>& data) {
+        update(data.data(), data.size());
+    }
+
+    /**
+     * @brief Absorb the contents of a file (see SignStream::updateFile())
+     * @param path Path of the file
+     * @return true if the whole file was read
+     */
+    bool updateFile(const std::string& path);
+
+    /**
+     * @brief Finish the message and check the signature
+     *
+     * The stream is reset afterwards and can be reused for a new message.
+     *
+     * @param signature Pointer to the signature
+     * @param signatureLength Signature length in bytes
+     * @return true if signature is valid, false otherwise
+     */
+    bool final(const uint8_t* signature, size_t signatureLength);
+
+    /**
+     * @brief Finish the message and check the signature
+     * @param signature The signature to verify
+     * @return true if signature is valid, false otherwise
+     */
+    bool final(const std::vector<uint8_t>& signature) {
+        return final(signature.data(), signature.size());
+    }
+
+    /**
+     * @brief Discard the absorbed data and start a new message
+     */
+    void reset();
+
+    /**
+     * @brief Verify the signature of a file without loading it into memory
+     * @param key Prepared public key of the signer
+     * @param path Path of the file
+     * @param signature The signature to verify
+     * @return true if the file was read and the signature is valid
+     */
+    static bool verifyFile(const PreparedPublicKey<Mode>& key, const std::string& path,
+                           const std::vector<uint8_t>& signature);
+
+private:
+    struct State;
+    const PreparedPublicKey<Mode>& key_;
+    std::unique_ptr<State> state_;
+    bool failed_;   // Set when updateFile() hit a read error
+};
+
+// Instantiated in DilithiumStream.cpp, once per separately compiled mode
+extern template class SignStream<2>;
+extern template class SignStream<3>;
+extern template class SignStream<5>;
+extern template class VerifyStream<2>;
+extern template class VerifyStream<3>;
+extern template class VerifyStream<5>;
+
+#endif // DILITHIUM_STREAM_HPP
@@ -4,42 +4,251 @@
  * 
  * This implementation wraps the pq-crystals reference implementation of Dilithium.
  * The reference implementation is written in C and provides functions for:
- * - Key generation: pqcrystals_dilithium3_ref_keypair()
- * - Signing: pqcrystals_dilithium3_ref_signature()
- * - Verification: pqcrystals_dilithium3_ref_verify()
+ * - Key generation: pqcrystals_dilithium{2,3,5}_ref_keypair()
+ * - Signing: pqcrystals_dilithium{2,3,5}_ref_signature()
+ * - Verification: pqcrystals_dilithium{2,3,5}_ref_verify()
+ *
+ * The file is compiled once per mode with DILITHIUM_MODE set (see
+ * CMakeLists.txt) and instantiates DilithiumWrapper<DILITHIUM_MODE> only,
+ * binding it to that mode's functions through DILITHIUM_NAMESPACE().
+ *
+ * When built with -DDILITHIUM_AVX2=ON the pqcrystals_dilithium*_avx2_*
+ * functions are linked as well and chosen at runtime on CPUs with AVX2.
  */
 
 #include "Dilithiumwrapper.hpp"
+#include "RandomSource.hpp"
+#include "ScratchArena.hpp"
+#include "KeccakLanes.hpp"
+#include <algorithm>
 #include <cstring>
 #include <stdexcept>
+#include <memory>
+#include <atomic>
+#include <openssl/evp.h>
 
 // Include Dilithium reference implementation header
 // extern "C" is required because the reference implementation is in C
 extern "C" {
+#include "config.h"
 #include "api.h"
+#include "randombytes.h"
+
+// The *_internal entry points take the prepared M' prefix directly and are
+// declared in sign.h, which would also pull the single-letter parameter
+// macros of params.h into this file
+int DILITHIUM_NAMESPACE(signature_internal)(uint8_t *sig, size_t *siglen,
+                                            const uint8_t *m, size_t mlen,
+                                            const uint8_t *pre, size_t prelen,
+                                            const uint8_t *rnd, const uint8_t *sk);
+int DILITHIUM_NAMESPACE(verify_internal)(const uint8_t *sig, size_t siglen,
+                                         const uint8_t *m, size_t mlen,
+                                         const uint8_t *pre, size_t prelen,
+                                         const uint8_t *pk);
+
+#ifdef DILITHIUM_HAVE_AVX2
+// avx2/api.h shares the API_H include guard with ref/api.h, so the
+// entry points of this mode are declared here instead
+#define DILITHIUM_AVX2_CONCAT(mode, s) pqcrystals_dilithium##mode##_avx2_##s
+#define DILITHIUM_AVX2_EXPAND(mode, s) DILITHIUM_AVX2_CONCAT(mode, s)
+#define DILITHIUM_AVX2_NAMESPACE(s) DILITHIUM_AVX2_EXPAND(DILITHIUM_MODE, s)
+
+int DILITHIUM_AVX2_NAMESPACE(keypair)(uint8_t *pk, uint8_t *sk);
+int DILITHIUM_AVX2_NAMESPACE(signature)(uint8_t *sig, size_t *siglen,
+                                        const uint8_t *m, size_t mlen,
+                                        const uint8_t *ctx, size_t ctxlen,
+                                        const uint8_t *sk);
+int DILITHIUM_AVX2_NAMESPACE(verify)(const uint8_t *sig, size_t siglen,
+                                     const uint8_t *m, size_t mlen,
+                                     const uint8_t *ctx, size_t ctxlen,
+                                     const uint8_t *pk);
+int DILITHIUM_AVX2_NAMESPACE(signature_internal)(uint8_t *sig, size_t *siglen,
+                                                 const uint8_t *m, size_t mlen,
+                                                 const uint8_t *pre, size_t prelen,
+                                                 const uint8_t *rnd, const uint8_t *sk);
+int DILITHIUM_AVX2_NAMESPACE(verify_internal)(const uint8_t *sig, size_t siglen,
+                                              const uint8_t *m, size_t mlen,
+                                              const uint8_t *pre, size_t prelen,
+                                              const uint8_t *pk);
+#endif
+}
+
+using Wrapper = DilithiumWrapper<DILITHIUM_MODE>;
+
+static_assert(Wrapper::PUBLIC_KEY_BYTES == DILITHIUM_NAMESPACE(PUBLICKEYBYTES),
+              "DilithiumParams public key size does not match api.h");
+static_assert(Wrapper::SECRET_KEY_BYTES == DILITHIUM_NAMESPACE(SECRETKEYBYTES),
+              "DilithiumParams secret key size does not match api.h");
+static_assert(Wrapper::SIGNATURE_BYTES == DILITHIUM_NAMESPACE(BYTES),
+              "DilithiumParams signature size does not match api.h");
+
+namespace {
+
+/**
+ * @brief Entry points of one compiled Dilithium implementation
+ */
+struct BackendOps {
+    DilithiumBackend id;
+    int (*keypair)(uint8_t* pk, uint8_t* sk);
+    int (*signature)(uint8_t* sig, size_t* siglen,
+                     const uint8_t* m, size_t mlen,
+                     const uint8_t* ctx, size_t ctxlen,
+                     const uint8_t* sk);
+    int (*verify)(const uint8_t* sig, size_t siglen,
+                  const uint8_t* m, size_t mlen,
+                  const uint8_t* ctx, size_t ctxlen,
+                  const uint8_t* pk);
+    int (*signatureInternal)(uint8_t* sig, size_t* siglen,
+                             const uint8_t* m, size_t mlen,
+                             const uint8_t* pre, size_t prelen,
+                             const uint8_t* rnd, const uint8_t* sk);
+    int (*verifyInternal)(const uint8_t* sig, size_t siglen,
+                          const uint8_t* m, size_t mlen,
+                          const uint8_t* pre, size_t prelen,
+                          const uint8_t* pk);
+};
+
+const BackendOps referenceOps = {
+    DilithiumBackend::Reference,
+    DILITHIUM_NAMESPACE(keypair),
+    DILITHIUM_NAMESPACE(signature),
+    DILITHIUM_NAMESPACE(verify),
+    DILITHIUM_NAMESPACE(signature_internal),
+    DILITHIUM_NAMESPACE(verify_internal)
+};
+
+#ifdef DILITHIUM_HAVE_AVX2
+const BackendOps avx2Ops = {
+    DilithiumBackend::AVX2,
+    DILITHIUM_AVX2_NAMESPACE(keypair),
+    DILITHIUM_AVX2_NAMESPACE(signature),
+    DILITHIUM_AVX2_NAMESPACE(verify),
+    DILITHIUM_AVX2_NAMESPACE(signature_internal),
+    DILITHIUM_AVX2_NAMESPACE(verify_internal)
+};
+
+/**
+ * @brief Runtime check for the instruction set extensions the avx2 code uses
+ */
+bool cpuSupportsAvx2() {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi2")
+        && __builtin_cpu_supports("popcnt");
+#else
+    return false;
+#endif
+}
+#endif
+
+const BackendOps* opsFor(DilithiumBackend backend) {
+#ifdef DILITHIUM_HAVE_AVX2
+    if (backend == DilithiumBackend::AVX2) {
+        return cpuSupportsAvx2() ? &avx2Ops : nullptr;
+    }
+#endif
+    if (backend == DilithiumBackend::Reference) {
+        return &referenceOps;
+    }
+    return nullptr;
 }
 
+/**
+ * @brief Currently selected implementation, detected on first use
+ */
+std::atomic<const BackendOps*>& activeOps() {
+    static std::atomic<const BackendOps*> ops(
+        opsFor(DilithiumBackend::AVX2) ? opsFor(DilithiumBackend::AVX2) : &referenceOps);
+    return ops;
+}
+
+// RNDBYTES of params.h: randomness input of signature_internal()
+constexpr size_t SIGNING_RND_BYTES = 32;
+
+// Longest M' prefix: 1 || |ctx| || ctx (255 bytes) || 11-byte digest OID
+constexpr size_t MAX_PREHASH_PREFIX_BYTES = 2 + 255 + 11;
+
+/**
+ * @brief DER encoding of the NIST hash algorithm OID (06 09 60 86 48 01 65 03 04 02 xx)
+ */
+void preHashOid(DilithiumPreHash hash, uint8_t oid[11]) {
+    static const uint8_t prefix[10] = {0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02};
+    std::memcpy(oid, prefix, sizeof(prefix));
+    switch (hash) {
+        case DilithiumPreHash::SHA256: oid[10] = 0x01; break;
+        case DilithiumPreHash::SHA384: oid[10] = 0x02; break;
+        case DilithiumPreHash::SHA512: oid[10] = 0x03; break;
+    }
+}
+
+const EVP_MD* preHashDigest(DilithiumPreHash hash) {
+    switch (hash) {
+        case DilithiumPreHash::SHA256: return EVP_sha256();
+        case DilithiumPreHash::SHA384: return EVP_sha384();
+        case DilithiumPreHash::SHA512: return EVP_sha512();
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Build the HashML-DSA prefix 1 || |ctx| || ctx || OID(hash)
+ * @return Prefix length, or 0 if the context string is too long
+ */
+size_t buildPreHashPrefix(DilithiumPreHash hash, const uint8_t* context, size_t contextLength,
+                          uint8_t prefix[MAX_PREHASH_PREFIX_BYTES]) {
+    if (contextLength > 255 || (contextLength > 0 && !context)) {
+        return 0;
+    }
+    prefix[0] = 1;
+    prefix[1] = static_cast<uint8_t>(contextLength);
+    if (contextLength > 0) {
+        std::memcpy(prefix + 2, context, contextLength);
+    }
+    preHashOid(hash, prefix + 2 + contextLength);
+    return 2 + contextLength + 11;
+}
+
+/**
+ * @brief Hash a whole message with OpenSSL
+ * @return true if the digest was written to digest
+ */
+bool computePreHash(DilithiumPreHash hash, const uint8_t* message, size_t messageLength,
+                    uint8_t* digest) {
+    unsigned int digestLength = 0;
+    return EVP_Digest(message, messageLength, digest, &digestLength,
+                      preHashDigest(hash), nullptr) == 1;
+}
+
+} // namespace
+
 /**
  * @brief Constructor - initializes key storage buffers
  * 
- * Allocates memory for public and secret keys with appropriate sizes
- * for Dilithium3 security level.
+ * The public key is sized by the mode at compile time and zero-initialized;
+ * the secret key slot is only taken once a key is generated or set.
  */
-DilithiumWrapper::DilithiumWrapper() 
-    : publicKey_(PUBLIC_KEY_BYTES, 0)
-    , secretKey_(SECRET_KEY_BYTES, 0)
-    , keysGenerated_(false) {
+template <int Mode>
+DilithiumWrapper<Mode>::DilithiumWrapper()
+    : publicKey_()
+    , secretKey_()
+    , keysGenerated_(false)
+    , hasPublicKey_(false) {
 }
 
 /**
  * @brief Destructor - ensures secure cleanup of cryptographic material
  * 
- * Uses volatile pointer to prevent compiler optimization from
- * removing the memory wiping operation.
+ * The SecureBox wipes the secret key and returns its slot to the pool.
  */
-DilithiumWrapper::~DilithiumWrapper() {
-    // Securely wipe secret key from memory to prevent key extraction
-    secureWipe(secretKey_.data(), secretKey_.size());
+template <int Mode>
+DilithiumWrapper<Mode>::~DilithiumWrapper() = default;
+
+template <int Mode>
+typename DilithiumWrapper<Mode>::SecretKey* DilithiumWrapper<Mode>::secretKeyStorage() {
+    if (!secretKey_) {
+        secretKey_ = SecureBox<SecretKey>::create();
+    }
+    return secretKey_.get();
 }
 
 /**
@@ -55,13 +264,19 @@ DilithiumWrapper::~DilithiumWrapper() {
  * 
  * @return true if key generation successful, false otherwise
  */
-bool DilithiumWrapper::generateKeys() {
+template <int Mode>
+bool DilithiumWrapper<Mode>::generateKeys() {
     try {
-        // Call Dilithium reference implementation keypair function
+        SecretKey* secretKey = secretKeyStorage();
+        if (!secretKey) {
+            return false;
+        }
+
+        // Call the selected backend's keypair function
         // This generates both public and secret keys atomically
-        int result = pqcrystals_dilithium3_ref_keypair(
+        int result = activeOps().load(std::memory_order_relaxed)->keypair(
             publicKey_.data(),
-            secretKey_.data()
+            secretKey->data()
         );
 
         if (result != 0) {
@@ -69,12 +284,37 @@ bool DilithiumWrapper::generateKeys() {
         }
 
         keysGenerated_ = true;
+        hasPublicKey_ = true;
+        preparedPublicKey_.clear();
         return true;
     } catch (...) {
         return false;
     }
 }
 
+template <int Mode>
+bool DilithiumWrapper<Mode>::generateKeysFromSeed(const uint8_t* seed, size_t length) {
+    if (!seed || length != DILITHIUM_SEED_BYTES) {
+        return false;
+    }
+    SecretKey* secretKey = secretKeyStorage();
+    if (!secretKey
+        || !DilithiumKeyBatch<Mode>::keyPairFromSeed(seed, publicKey_.data(), secretKey->data())) {
+        return false;
+    }
+    keysGenerated_ = true;
+    hasPublicKey_ = true;
+    preparedPublicKey_.clear();
+    return true;
+}
+
+template <int Mode>
+DilithiumKeyBatch<Mode> DilithiumWrapper<Mode>::generateKeyBatch(size_t count, size_t threads) {
+    DilithiumKeyBatch<Mode> batch;
+    batch.generate(count, threads);
+    return batch;
+}
+
 /**
  * @brief Sign a message using Dilithium
  * 
@@ -93,7 +333,8 @@ bool DilithiumWrapper::generateKeys() {
  * @param message The message to sign
  * @return Signature vector, or empty vector on failure
  */
-std::vector<uint8_t> DilithiumWrapper::sign(const std::vector<uint8_t>& message) {
+template <int Mode>
+std::vector<uint8_t> DilithiumWrapper<Mode>::sign(const std::vector<uint8_t>& message) {
     if (!keysGenerated_) {
         return {};
     }
@@ -102,19 +343,7 @@ std::vector<uint8_t> DilithiumWrapper::sign(const std::vector<uint8_t>& message)
         std::vector<uint8_t> signature(SIGNATURE_BYTES);
         size_t signatureLength = 0;
 
-        // Call Dilithium signing function (new API with ctx parameter)
-        // ctx is an optional context string, we use nullptr/0 for no context
-        int result = pqcrystals_dilithium3_ref_signature(
-            signature.data(),
-            &signatureLength,
-            message.data(),
-            message.size(),
-            nullptr,  // ctx - context string (optional)
-            0,        // ctxlen - context length
-            secretKey_.data()
-        );
-
-        if (result != 0) {
+        if (!sign(message.data(), message.size(), signature.data(), &signatureLength)) {
             return {};
         }
 
@@ -126,6 +355,104 @@ std::vector<uint8_t> DilithiumWrapper::sign(const std::vector<uint8_t>& message)
     }
 }
 
+/**
+ * @brief Sign a message into caller-owned memory
+ *
+ * The reference implementation keeps all intermediate polynomials on the
+ * stack, so this overload performs no heap allocation. In Scratch::Arena
+ * mode it signs through PreparedSigningKey::signPacked() instead, which keeps
+ * them in the thread's reused arena (reference code on either backend).
+ */
+template <int Mode>
+bool DilithiumWrapper<Mode>::sign(const uint8_t* message, size_t messageLength,
+                                  uint8_t* signature, size_t* signatureLength) const {
+    if (!keysGenerated_ || !signature || !signatureLength) {
+        return false;
+    }
+
+    bool viaPrepared = ScratchArena::mode() == Scratch::Arena;
+#ifdef DILITHIUM_INSTRUMENTATION
+    // Same steps as the reference signature(), but with the phases timed
+    viaPrepared = viaPrepared
+        || activeOps().load(std::memory_order_relaxed)->id == DilithiumBackend::Reference;
+#endif
+    if (viaPrepared) {
+        return PreparedSigningKey<Mode>::signPacked(secretKey_->data(), secretKey_->size(),
+                                                    message, messageLength,
+                                                    signature, signatureLength);
+    }
+
+    // Call Dilithium signing function (new API with ctx parameter)
+    // ctx is an optional context string, we use nullptr/0 for no context
+    int result = activeOps().load(std::memory_order_relaxed)->signature(
+        signature,
+        signatureLength,
+        message,
+        messageLength,
+        nullptr,  // ctx - context string (optional)
+        0,        // ctxlen - context length
+        secretKey_->data()
+    );
+
+    return (result == 0);
+}
+
+template <int Mode>
+bool DilithiumWrapper<Mode>::sign(const uint8_t* message, size_t messageLength,
+                                  Signature& signature) const {
+    size_t signatureLength = 0;
+    return sign(message, messageLength, signature.data(), &signatureLength)
+        && signatureLength == SIGNATURE_BYTES;
+}
+
+/**
+ * @brief Sign a message using a prepared signing key
+ *
+ * Runs the same Fiat-Shamir with Aborts loop as sign(), starting directly
+ * at step 1 with Â, ŝ1, ŝ2 and t̂0 already available.
+ */
+template <int Mode>
+std::vector<uint8_t> DilithiumWrapper<Mode>::sign(const PreparedSigningKey<Mode>& key,
+                                            const std::vector<uint8_t>& message) {
+    if (!key.isValid()) {
+        return {};
+    }
+
+    try {
+        std::vector<uint8_t> signature(SIGNATURE_BYTES);
+        size_t signatureLength = 0;
+
+        if (!key.sign(message.data(), message.size(),
+                      signature.data(), &signatureLength)) {
+            return {};
+        }
+
+        signature.resize(signatureLength);
+        return signature;
+    } catch (...) {
+        return {};
+    }
+}
+
+template <int Mode>
+bool DilithiumWrapper<Mode>::sign(const PreparedSigningKey<Mode>& key,
+                                  const uint8_t* message, size_t messageLength,
+                                  Signature& signature) {
+    size_t signatureLength = 0;
+    return key.isValid()
+        && key.sign(message, messageLength, signature.data(), &signatureLength)
+        && signatureLength == SIGNATURE_BYTES;
+}
+
+template <int Mode>
+PreparedSigningKey<Mode> DilithiumWrapper<Mode>::prepareSigningKey() const {
+    PreparedSigningKey<Mode> prepared;
+    if (keysGenerated_) {
+        prepared.load(secretKey_->data(), secretKey_->size());
+    }
+    return prepared;
+}
+
 /**
  * @brief Verify a Dilithium signature
  * 
@@ -142,60 +469,399 @@ std::vector<uint8_t> DilithiumWrapper::sign(const std::vector<uint8_t>& message)
  * @param signature The signature to verify
  * @return true if signature is valid, false otherwise
  */
-bool DilithiumWrapper::verify(const std::vector<uint8_t>& message,
-                              const std::vector<uint8_t>& signature) {
-    if (!keysGenerated_) {
+template <int Mode>
+bool DilithiumWrapper<Mode>::verify(const std::vector<uint8_t>& message,
+                                    const std::vector<uint8_t>& signature) {
+    return verify(message.data(), message.size(), signature.data(), signature.size());
+}
+
+template <int Mode>
+bool DilithiumWrapper<Mode>::verify(const uint8_t* message, size_t messageLength,
+                                    const uint8_t* signature, size_t signatureLength) const {
+    if (!hasPublicKey_) {
+        return false;
+    }
+
+    if (keyCache_) {
+        return keyCache_->verify(publicKey_.data(), publicKey_.size(),
+                                 message, messageLength, signature, signatureLength);
+    }
+    if (ScratchArena::mode() == Scratch::Arena) {
+        return PreparedPublicKey<Mode>::verifyPacked(publicKey_.data(), publicKey_.size(),
+                                                     message, messageLength,
+                                                     signature, signatureLength);
+    }
+
+    // Call Dilithium verification function (new API with ctx parameter)
+    int result = activeOps().load(std::memory_order_relaxed)->verify(
+        signature,
+        signatureLength,
+        message,
+        messageLength,
+        nullptr,  // ctx - context string (optional)
+        0,        // ctxlen - context length
+        publicKey_.data()
+    );
+
+    return (result == 0);
+}
+
+/**
+ * @brief Sign hash(M) in pre-hash mode
+ *
+ * Same rejection loop as sign(), with M' = 1 || |ctx| || ctx || OID || hash(M)
+ * in place of 0 || |ctx| || ctx || M (FIPS 204, HashML-DSA.Sign).
+ */
+template <int Mode>
+bool DilithiumWrapper<Mode>::signDigest(const uint8_t* digest, size_t digestLength, PreHash hash,
+                                        uint8_t* signature, size_t* signatureLength,
+                                        const uint8_t* context, size_t contextLength) const {
+    if (!keysGenerated_ || !digest || !signature || !signatureLength
+        || digestLength != preHashDigestBytes(hash)) {
+        return false;
+    }
+
+    uint8_t prefix[MAX_PREHASH_PREFIX_BYTES];
+    size_t prefixLength = buildPreHashPrefix(hash, context, contextLength, prefix);
+    if (prefixLength == 0) {
+        return false;
+    }
+
+    // Deterministic signing unless randomized signing is enabled, as in sign()
+    uint8_t rnd[SIGNING_RND_BYTES] = {0};
+#ifdef DILITHIUM_RANDOMIZED_SIGNING
+    randombytes(rnd, SIGNING_RND_BYTES);
+#endif
+
+    int result = activeOps().load(std::memory_order_relaxed)->signatureInternal(
+        signature, signatureLength,
+        digest, digestLength,
+        prefix, prefixLength,
+        rnd,
+        secretKey_->data()
+    );
+
+    return (result == 0);
+}
+
+template <int Mode>
+bool DilithiumWrapper<Mode>::verifyDigest(const uint8_t* digest, size_t digestLength, PreHash hash,
+                                          const uint8_t* signature, size_t signatureLength,
+                                          const uint8_t* context, size_t contextLength) const {
+    if (!hasPublicKey_ || !digest || !signature
+        || digestLength != preHashDigestBytes(hash)) {
+        return false;
+    }
+
+    uint8_t prefix[MAX_PREHASH_PREFIX_BYTES];
+    size_t prefixLength = buildPreHashPrefix(hash, context, contextLength, prefix);
+    if (prefixLength == 0) {
         return false;
     }
 
+    int result = activeOps().load(std::memory_order_relaxed)->verifyInternal(
+        signature, signatureLength,
+        digest, digestLength,
+        prefix, prefixLength,
+        publicKey_.data()
+    );
+
+    return (result == 0);
+}
+
+template <int Mode>
+std::vector<uint8_t> DilithiumWrapper<Mode>::signPreHash(const std::vector<uint8_t>& message,
+                                                         PreHash hash,
+                                                         const std::vector<uint8_t>& context) const {
+    if (!keysGenerated_) {
+        return {};
+    }
+
     try {
-        // Call Dilithium verification function (new API with ctx parameter)
-        int result = pqcrystals_dilithium3_ref_verify(
-            signature.data(),
-            signature.size(),
-            message.data(),
-            message.size(),
-            nullptr,  // ctx - context string (optional)
-            0,        // ctxlen - context length
-            publicKey_.data()
-        );
+        uint8_t digest[EVP_MAX_MD_SIZE];
+        if (!computePreHash(hash, message.data(), message.size(), digest)) {
+            return {};
+        }
+
+        std::vector<uint8_t> signature(SIGNATURE_BYTES);
+        size_t signatureLength = 0;
+        if (!signDigest(digest, preHashDigestBytes(hash), hash,
+                        signature.data(), &signatureLength,
+                        context.data(), context.size())) {
+            return {};
+        }
 
-        return (result == 0);
+        signature.resize(signatureLength);
+        return signature;
     } catch (...) {
+        return {};
+    }
+}
+
+template <int Mode>
+bool DilithiumWrapper<Mode>::verifyPreHash(const std::vector<uint8_t>& message,
+                                           const std::vector<uint8_t>& signature,
+                                           PreHash hash,
+                                           const std::vector<uint8_t>& context) const {
+    if (!hasPublicKey_) {
         return false;
     }
+
+    uint8_t digest[EVP_MAX_MD_SIZE];
+    if (!computePreHash(hash, message.data(), message.size(), digest)) {
+        return false;
+    }
+
+    return verifyDigest(digest, preHashDigestBytes(hash), hash,
+                        signature.data(), signature.size(),
+                        context.data(), context.size());
+}
+
+template <int Mode>
+size_t DilithiumWrapper<Mode>::preHashDigestBytes(PreHash hash) {
+    switch (hash) {
+        case PreHash::SHA256: return 32;
+        case PreHash::SHA384: return 48;
+        case PreHash::SHA512: return 64;
+    }
+    return 0;
 }
 
-std::vector<uint8_t> DilithiumWrapper::getPublicKey() const {
-    return publicKey_;
+template <int Mode>
+const char* DilithiumWrapper<Mode>::preHashName(PreHash hash) {
+    switch (hash) {
+        case PreHash::SHA256: return "SHA-256";
+        case PreHash::SHA384: return "SHA-384";
+        case PreHash::SHA512: return "SHA-512";
+    }
+    return "unknown";
 }
 
-std::vector<uint8_t> DilithiumWrapper::getSecretKey() const {
-    return secretKey_;
+/**
+ * @brief Verify a batch of signatures, amortizing key expansion
+ *
+ * The prepared key is cached in the wrapper and rebuilt only after
+ * generateKeys() or setPublicKey() replaced the public key.
+ */
+template <int Mode>
+size_t DilithiumWrapper<Mode>::verifyBatch(const VerifyItem* items, size_t count, bool* results) {
+    if (!hasPublicKey_) {
+        for (size_t i = 0; i < count; ++i) {
+            results[i] = false;
+        }
+        return 0;
+    }
+
+    try {
+        if (!preparedPublicKey_.isValid()) {
+            preparedPublicKey_.load(publicKey_.data(), publicKey_.size());
+        }
+        return verifyBatch(preparedPublicKey_, items, count, results);
+    } catch (...) {
+        for (size_t i = 0; i < count; ++i) {
+            results[i] = false;
+        }
+        return 0;
+    }
+}
+
+template <int Mode>
+std::vector<bool> DilithiumWrapper<Mode>::verifyBatch(const std::vector<VerifyItem>& items) {
+    std::unique_ptr<bool[]> flags(new bool[items.size()]);
+    verifyBatch(items.data(), items.size(), flags.get());
+    return std::vector<bool>(flags.get(), flags.get() + items.size());
+}
+
+/**
+ * @brief Verify items in groups of eight, hashing each group's μ together
+ */
+template <int Mode>
+size_t DilithiumWrapper<Mode>::verifyBatch(const PreparedPublicKey<Mode>& key,
+                                     const VerifyItem* items, size_t count, bool* results) {
+    const size_t GROUP = 8;
+    size_t valid = 0;
+    for (size_t first = 0; first < count; first += GROUP) {
+        const size_t size = std::min(GROUP, count - first);
+        const uint8_t* messages[GROUP];
+        size_t messageLengths[GROUP];
+        uint8_t mu[GROUP * DILITHIUM_MU_BYTES];
+        for (size_t i = 0; i < size; ++i) {
+            messages[i] = items[first + i].message;
+            messageLengths[i] = items[first + i].messageLength;
+        }
+        const bool hashed = key.computeMu(messages, messageLengths, size, mu);
+
+        for (size_t i = 0; i < size; ++i) {
+            const VerifyItem& item = items[first + i];
+            results[first + i] = hashed && key.verifyMu(mu + i * DILITHIUM_MU_BYTES,
+                                                        item.signature, item.signatureLength);
+            valid += results[first + i] ? 1 : 0;
+        }
+    }
+    return valid;
 }
 
-bool DilithiumWrapper::setPublicKey(const std::vector<uint8_t>& pubkey) {
-    if (pubkey.size() != PUBLIC_KEY_BYTES) {
+template <int Mode>
+PreparedPublicKey<Mode> DilithiumWrapper<Mode>::preparePublicKey() const {
+    PreparedPublicKey<Mode> prepared;
+    if (hasPublicKey_) {
+        prepared.load(publicKey_.data(), publicKey_.size());
+    }
+    return prepared;
+}
+
+template <int Mode>
+typename DilithiumWrapper<Mode>::Backend DilithiumWrapper<Mode>::backend() {
+    return activeOps().load(std::memory_order_relaxed)->id;
+}
+
+template <int Mode>
+bool DilithiumWrapper<Mode>::setBackend(Backend backend) {
+    const BackendOps* ops = opsFor(backend);
+    if (!ops) {
+        return false;
+    }
+    activeOps().store(ops, std::memory_order_relaxed);
+    return true;
+}
+
+template <int Mode>
+bool DilithiumWrapper<Mode>::isBackendAvailable(Backend backend) {
+    return opsFor(backend) != nullptr;
+}
+
+template <int Mode>
+const char* DilithiumWrapper<Mode>::backendName(Backend backend) {
+    switch (backend) {
+        case Backend::Reference: return "ref";
+        case Backend::AVX2:      return "avx2";
+    }
+    return "unknown";
+}
+
+template <int Mode>
+typename DilithiumWrapper<Mode>::Randomness DilithiumWrapper<Mode>::randomness() {
+    return RandomSource::current();
+}
+
+template <int Mode>
+void DilithiumWrapper<Mode>::setRandomness(Randomness randomness) {
+    RandomSource::select(randomness);
+}
+
+template <int Mode>
+const char* DilithiumWrapper<Mode>::randomnessName(Randomness randomness) {
+    return RandomSource::name(randomness);
+}
+
+template <int Mode>
+bool DilithiumWrapper<Mode>::multiLaneKeccak() {
+    return keccakLanesEnabled();
+}
+
+template <int Mode>
+void DilithiumWrapper<Mode>::setMultiLaneKeccak(bool enabled) {
+    setKeccakLanesEnabled(enabled);
+}
+
+template <int Mode>
+typename DilithiumWrapper<Mode>::Scratch DilithiumWrapper<Mode>::scratchMode() {
+    return ScratchArena::mode();
+}
+
+template <int Mode>
+void DilithiumWrapper<Mode>::setScratchMode(Scratch scratch) {
+    ScratchArena::setMode(scratch);
+}
+
+template <int Mode>
+const char* DilithiumWrapper<Mode>::scratchName(Scratch scratch) {
+    return ScratchArena::modeName(scratch);
+}
+
+template <int Mode>
+std::vector<uint8_t> DilithiumWrapper<Mode>::getPublicKey() const {
+    return std::vector<uint8_t>(publicKey_.begin(), publicKey_.end());
+}
+
+template <int Mode>
+std::vector<uint8_t> DilithiumWrapper<Mode>::getSecretKey() const {
+    const SecretKey& key = secretKey();
+    return std::vector<uint8_t>(key.begin(), key.end());
+}
+
+template <int Mode>
+SecureBox<typename DilithiumWrapper<Mode>::SecretKey> DilithiumWrapper<Mode>::copySecretKey() const {
+    SecureBox<SecretKey> copy;
+    if (keysGenerated_ && secretKey_) {
+        copy = SecureBox<SecretKey>::create();
+        if (copy) {
+            *copy = *secretKey_;
+        }
+    }
+    return copy;
+}
+
+template <int Mode>
+bool DilithiumWrapper<Mode>::setPublicKey(const std::vector<uint8_t>& pubkey) {
+    return setPublicKey(pubkey.data(), pubkey.size());
+}
+
+template <int Mode>
+bool DilithiumWrapper<Mode>::setPublicKey(const uint8_t* pubkey, size_t length) {
+    if (!pubkey || length != PUBLIC_KEY_BYTES) {
         return false;
     }
-    publicKey_ = pubkey;
+    std::memcpy(publicKey_.data(), pubkey, PUBLIC_KEY_BYTES);
+    hasPublicKey_ = true;
+    preparedPublicKey_.clear();
     return true;
 }
 
-bool DilithiumWrapper::setSecretKey(const std::vector<uint8_t>& seckey) {
-    if (seckey.size() != SECRET_KEY_BYTES) {
+template <int Mode>
+bool DilithiumWrapper<Mode>::setSecretKey(const std::vector<uint8_t>& seckey) {
+    return setSecretKey(seckey.data(), seckey.size());
+}
+
+template <int Mode>
+bool DilithiumWrapper<Mode>::setSecretKey(const uint8_t* seckey, size_t length) {
+    if (!seckey || length != SECRET_KEY_BYTES) {
         return false;
     }
-    secretKey_ = seckey;
+    SecretKey* secretKey = secretKeyStorage();
+    if (!secretKey) {
+        return false;
+    }
+    std::memcpy(secretKey->data(), seckey, SECRET_KEY_BYTES);
     keysGenerated_ = true;
+    hasPublicKey_ = true;
     return true;
 }
 
-void DilithiumWrapper::secureWipe(void* data, size_t size) {
-    if (data && size > 0) {
-        volatile uint8_t* p = static_cast<volatile uint8_t*>(data);
-        for (size_t i = 0; i < size; ++i) {
-            p[i] = 0;
-        }
-    }
-}
\ No newline at end of file
+template <int Mode>
+const typename DilithiumWrapper<Mode>::SecretKey& DilithiumWrapper<Mode>::secretKey() const {
+    static const SecretKey empty{};
+    return secretKey_ ? *secretKey_ : empty;
+}
+
+template <int Mode>
+typename DilithiumWrapper<Mode>::KeyStorage DilithiumWrapper<Mode>::keyStorage() {
+    return SecureKeyPool::storage();
+}
+
+template <int Mode>
+void DilithiumWrapper<Mode>::setKeyStorage(KeyStorage storage) {
+    SecureKeyPool::setStorage(storage);
+}
+
+template <int Mode>
+const char* DilithiumWrapper<Mode>::keyStorageName(KeyStorage storage) {
+    return SecureKeyPool::storageName(storage);
+}
+
+template <int Mode>
+SecureKeyPool::Stats DilithiumWrapper<Mode>::secretKeyPoolStats() {
+    return securePoolFor<SecretKey>().stats();
+}
+
+template class DilithiumWrapper<DILITHIUM_MODE>;
@@ -10,16 +10,22 @@
  * - Security basis: Module-Learning With Errors (MLWE) and Module-Short Integer 
  *   Solution (MSIS) problems
  * - Signature technique: Fiat-Shamir with Aborts paradigm
- * - This implementation uses Dilithium3 (NIST Security Level 3)
+ * - Dilithium2, Dilithium3 and Dilithium5 are selected at compile time through
+ *   the Mode template parameter (see DilithiumParams.hpp)
  * 
  * Mathematical Foundation:
  * - Works in polynomial ring R_q = Z_q[X]/(X^256 + 1) where q = 8380417
  * - Uses rejection sampling to ensure signature security
  * - Number-Theoretic Transform (NTT) for efficient polynomial multiplication
  * 
- * Security Level (Dilithium3):
- * - Equivalent to ~128-bit security against quantum adversaries
- * - Parameters: k=6, l=5, η=4, β=196, ω=55
+ * Security Levels:
+ * - Dilithium2: NIST level 2, k=4, l=4, η=2
+ * - Dilithium3: NIST level 3 (~128-bit quantum security), k=6, l=5, η=4
+ * - Dilithium5: NIST level 5, k=8, l=7, η=2
+ *
+ * Every mode links its own separately compiled reference library
+ * (libdilithium2/3/5), so each DilithiumWrapper<Mode> calls fully
+ * specialized code with the parameters fixed at compile time.
  * 
  * @author Student Project - Cryptographic Systems Course
  * @date December 2025
@@ -28,23 +34,55 @@
 #ifndef DILITHIUM_WRAPPER_HPP
 #define DILITHIUM_WRAPPER_HPP
 
+#include <array>
 #include <vector>
+#include <memory>
 #include <string>
 #include <cstdint>
+#include "DilithiumParams.hpp"
+#include "SecureMemory.hpp"
+#include "PreparedKeys.hpp"
+#include "DilithiumKeyGen.hpp"
+#include "PublicKeyCache.hpp"
 
 /**
  * @brief C++ wrapper for CRYSTALS-Dilithium post-quantum signature scheme
  * 
- * This class wraps the reference implementation of Dilithium3 (NIST security level 3)
+ * This class wraps the reference implementation of one Dilithium parameter set
  * providing a clean C++ interface for key generation, signing, and verification.
+ *
+ * @tparam Mode Dilithium mode (2, 3 or 5)
  */
+template <int Mode>
 class DilithiumWrapper {
 public:
-    // Dilithium3 parameters (from api.h)
-    // These values are determined by the security level and mathematical structure
-    static constexpr size_t PUBLIC_KEY_BYTES = 1952;   // pk = (ρ, t1) encoded
-    static constexpr size_t SECRET_KEY_BYTES = 4032;   // sk = (ρ, K, tr, s1, s2, t0)
-    static constexpr size_t SIGNATURE_BYTES = 3309;    // σ = (c̃, z, h) encoded
+    using Params = DilithiumParams<Mode>;
+
+    // Parameters of the selected mode (match CRYPTO_* in the mode's api.h)
+    static constexpr int MODE = Mode;
+    static constexpr size_t PUBLIC_KEY_BYTES = Params::PUBLIC_KEY_BYTES;   // pk = (ρ, t1) encoded
+    static constexpr size_t SECRET_KEY_BYTES = Params::SECRET_KEY_BYTES;   // sk = (ρ, K, tr, s1, s2, t0)
+    static constexpr size_t SIGNATURE_BYTES = Params::SIGNATURE_BYTES;     // σ = (c̃, z, h) encoded
+
+    // Fixed-size key and signature types of the selected mode
+    using PublicKey = std::array<uint8_t, PUBLIC_KEY_BYTES>;
+    using SecretKey = std::array<uint8_t, SECRET_KEY_BYTES>;
+    using Signature = std::array<uint8_t, SIGNATURE_BYTES>;
+
+    using Backend = DilithiumBackend;
+    using VerifyItem = DilithiumVerifyItem;
+    using PreHash = DilithiumPreHash;
+    using Randomness = DilithiumRandomness;
+    using Scratch = DilithiumScratch;
+    using KeyStorage = DilithiumKeyStorage;
+
+    // Longest context string accepted by FIPS 204 (length is encoded in one byte)
+    static constexpr size_t MAX_CONTEXT_BYTES = 255;
+
+    /**
+     * @brief Get the printable name of the parameter set ("Dilithium3")
+     */
+    static constexpr const char* name() { return Params::NAME; }
 
     /**
      * @brief Constructor - initializes empty key pair
@@ -62,6 +100,35 @@ public:
      */
     bool generateKeys();
 
+    /**
+     * @brief Derive the key pair deterministically from a seed
+     *
+     * The same seed always gives the same keys (those the reference
+     * keypair() returns when randombytes() yields that seed).
+     *
+     * @param seed DILITHIUM_SEED_BYTES bytes ξ
+     * @param length Length of the seed, must equal DILITHIUM_SEED_BYTES
+     * @return true if successful, false otherwise
+     */
+    bool generateKeysFromSeed(const uint8_t* seed, size_t length);
+
+    /**
+     * @brief Derive the key pair deterministically from a seed
+     * @param seed DILITHIUM_SEED_BYTES bytes ξ
+     * @return true if successful, false otherwise
+     */
+    bool generateKeysFromSeed(const std::vector<uint8_t>& seed) {
+        return generateKeysFromSeed(seed.data(), seed.size());
+    }
+
+    /**
+     * @brief Generate many key pairs with one bulk entropy read
+     * @param count Number of key pairs
+     * @param threads Worker threads (0: hardware threads)
+     * @return The key pairs, or an empty batch on failure
+     */
+    static DilithiumKeyBatch<Mode> generateKeyBatch(size_t count, size_t threads = 0);
+
     /**
      * @brief Sign a message with the secret key
      * @param message The message to sign
@@ -69,6 +136,61 @@ public:
      */
     std::vector<uint8_t> sign(const std::vector<uint8_t>& message);
 
+    /**
+     * @brief Sign a message into a caller-provided buffer (no heap allocation)
+     * @param message Pointer to the message
+     * @param messageLength Message length in bytes
+     * @param signature Output buffer of at least SIGNATURE_BYTES bytes
+     * @param signatureLength Receives the number of bytes written
+     * @return true if successful, false otherwise
+     */
+    bool sign(const uint8_t* message, size_t messageLength,
+              uint8_t* signature, size_t* signatureLength) const;
+
+    /**
+     * @brief Sign a message into a fixed-size signature (no heap allocation)
+     * @param message Pointer to the message
+     * @param messageLength Message length in bytes
+     * @param signature Receives the signature
+     * @return true if successful, false otherwise
+     */
+    bool sign(const uint8_t* message, size_t messageLength, Signature& signature) const;
+
+    /**
+     * @brief Sign a message with a prepared signing key
+     *
+     * Skips unpack_sk(), the expansion of A and the NTTs of s1, s2, t0 that
+     * sign() repeats on every call.
+     *
+     * @param key Prepared signing key (see prepareSigningKey())
+     * @param message The message to sign
+     * @return The signature bytes, or empty vector on failure
+     */
+    static std::vector<uint8_t> sign(const PreparedSigningKey<Mode>& key,
+                                     const std::vector<uint8_t>& message);
+
+    /**
+     * @brief Sign with a prepared signing key into a fixed-size signature
+     * @param key Prepared signing key (see prepareSigningKey())
+     * @param message Pointer to the message
+     * @param messageLength Message length in bytes
+     * @param signature Receives the signature
+     * @return true if successful, false otherwise
+     */
+    static bool sign(const PreparedSigningKey<Mode>& key,
+                     const uint8_t* message, size_t messageLength,
+                     Signature& signature);
+
+    /**
+     * @brief Build a prepared (unpacked, A-expanded, NTT-domain) signing key
+     *
+     * Call after generateKeys() or setSecretKey(); the result does not track
+     * later key changes.
+     *
+     * @return Prepared signing key, invalid if no keys are set
+     */
+    PreparedSigningKey<Mode> prepareSigningKey() const;
+
     /**
      * @brief Verify a signature with the public key
      * @param message The original message
@@ -78,6 +200,146 @@ public:
     bool verify(const std::vector<uint8_t>& message, 
                 const std::vector<uint8_t>& signature);
 
+    /**
+     * @brief Route verify() through a shared cache of prepared public keys
+     *
+     * With a cache attached, verify() looks the current public key up by
+     * fingerprint and verifies with the cached expansion instead of unpacking
+     * and expanding the key on every call. Pre-hash verification is not
+     * affected. Pass nullptr to detach.
+     *
+     * @param cache Cache shared with other wrappers and threads
+     */
+    void setPublicKeyCache(std::shared_ptr<PublicKeyCache<Mode>> cache) { keyCache_ = std::move(cache); }
+
+    /**
+     * @brief Get the attached public key cache (nullptr if none)
+     */
+    const std::shared_ptr<PublicKeyCache<Mode>>& publicKeyCache() const { return keyCache_; }
+
+    /**
+     * @brief Verify a signature held in caller-owned buffers (no copies)
+     * @param message Pointer to the original message
+     * @param messageLength Message length in bytes
+     * @param signature Pointer to the signature
+     * @param signatureLength Signature length in bytes
+     * @return true if signature is valid, false otherwise
+     */
+    bool verify(const uint8_t* message, size_t messageLength,
+                const uint8_t* signature, size_t signatureLength) const;
+
+    /**
+     * @brief Sign a message in pre-hash mode (HashML-DSA)
+     *
+     * The message is hashed once with the selected digest (OpenSSL, which
+     * uses SHA extensions where the CPU has them) and only the digest is
+     * signed, with M' = 1 || |ctx| || ctx || OID(hash) || hash(M).
+     *
+     * @param message The message to sign
+     * @param hash Digest algorithm
+     * @param context Optional context string (at most MAX_CONTEXT_BYTES)
+     * @return The signature bytes, or empty vector on failure
+     */
+    std::vector<uint8_t> signPreHash(const std::vector<uint8_t>& message,
+                                     PreHash hash = PreHash::SHA512,
+                                     const std::vector<uint8_t>& context = {}) const;
+
+    /**
+     * @brief Verify a pre-hash mode (HashML-DSA) signature
+     * @param message The original message
+     * @param signature The signature to verify
+     * @param hash Digest algorithm used when signing
+     * @param context Context string used when signing
+     * @return true if signature is valid, false otherwise
+     */
+    bool verifyPreHash(const std::vector<uint8_t>& message,
+                       const std::vector<uint8_t>& signature,
+                       PreHash hash = PreHash::SHA512,
+                       const std::vector<uint8_t>& context = {}) const;
+
+    /**
+     * @brief Sign a digest computed by the caller (HashML-DSA)
+     *
+     * Lets callers hash with their own implementation, e.g. incrementally
+     * or on dedicated hardware, and sign only the result.
+     *
+     * @param digest Pointer to hash(M)
+     * @param digestLength Digest length, must match the algorithm
+     * @param hash Algorithm that produced the digest
+     * @param signature Output buffer of at least SIGNATURE_BYTES bytes
+     * @param signatureLength Receives the number of bytes written
+     * @param context Optional context string
+     * @param contextLength Context length in bytes (at most MAX_CONTEXT_BYTES)
+     * @return true if successful, false otherwise
+     */
+    bool signDigest(const uint8_t* digest, size_t digestLength, PreHash hash,
+                    uint8_t* signature, size_t* signatureLength,
+                    const uint8_t* context = nullptr, size_t contextLength = 0) const;
+
+    /**
+     * @brief Verify a HashML-DSA signature over a digest computed by the caller
+     * @param digest Pointer to hash(M)
+     * @param digestLength Digest length, must match the algorithm
+     * @param hash Algorithm that produced the digest
+     * @param signature Pointer to the signature
+     * @param signatureLength Signature length in bytes
+     * @param context Optional context string
+     * @param contextLength Context length in bytes
+     * @return true if signature is valid, false otherwise
+     */
+    bool verifyDigest(const uint8_t* digest, size_t digestLength, PreHash hash,
+                      const uint8_t* signature, size_t signatureLength,
+                      const uint8_t* context = nullptr, size_t contextLength = 0) const;
+
+    /**
+     * @brief Get the digest length of a pre-hash algorithm in bytes
+     */
+    static size_t preHashDigestBytes(PreHash hash);
+
+    /**
+     * @brief Get a short printable pre-hash name ("SHA-256", ...)
+     */
+    static const char* preHashName(PreHash hash);
+
+    /**
+     * @brief Verify a batch of signatures under this wrapper's public key
+     *
+     * The public key is unpacked and matrix A is expanded once (on the first
+     * batch after the key changes) and reused for every item, so same-key
+     * workloads skip the SHAKE-128 expansion that dominates verify(). The μ
+     * hashes of up to eight items share one multi-lane SHAKE-256.
+     *
+     * @param items Pointer to the first (message, signature) pair
+     * @param count Number of pairs
+     * @param results Output array of count flags, true where the signature is valid
+     * @return Number of valid signatures in the batch
+     */
+    size_t verifyBatch(const VerifyItem* items, size_t count, bool* results);
+
+    /**
+     * @brief Verify a batch of signatures under this wrapper's public key
+     * @param items The (message, signature) pairs
+     * @return One flag per item, true where the signature is valid
+     */
+    std::vector<bool> verifyBatch(const std::vector<VerifyItem>& items);
+
+    /**
+     * @brief Verify a batch of signatures under an already prepared public key
+     * @param key Prepared public key of the signer
+     * @param items Pointer to the first (message, signature) pair
+     * @param count Number of pairs
+     * @param results Output array of count flags, true where the signature is valid
+     * @return Number of valid signatures in the batch
+     */
+    static size_t verifyBatch(const PreparedPublicKey<Mode>& key,
+                              const VerifyItem* items, size_t count, bool* results);
+
+    /**
+     * @brief Build a prepared (unpacked, A-expanded) copy of the public key
+     * @return Prepared public key, invalid if no public key is set
+     */
+    PreparedPublicKey<Mode> preparePublicKey() const;
+
     /**
      * @brief Get the public key
      * @return Public key bytes
@@ -85,11 +347,38 @@ public:
     std::vector<uint8_t> getPublicKey() const;
 
     /**
-     * @brief Get the secret key (use with caution!)
+     * @brief Get a reference to the public key without copying it
+     */
+    const PublicKey& publicKey() const { return publicKey_; }
+
+    /**
+     * @brief Get an unprotected copy of the secret key (use with caution!)
+     *
+     * Export only, e.g. to write the key to a file: the copy is in ordinary
+     * heap memory, neither locked nor wiped when the vector is freed. Prefer
+     * secretKey() or copySecretKey(), and secureWipe() the copy after use.
+     *
      * @return Secret key bytes
      */
     std::vector<uint8_t> getSecretKey() const;
 
+    /**
+     * @brief Copy the secret key into secure key storage
+     *
+     * The copy lives in the storage selected by setKeyStorage() (a locked
+     * pool slot by default) and is wiped when the box is released.
+     *
+     * @return The copy, empty if there is no key or allocation failed
+     */
+    SecureBox<SecretKey> copySecretKey() const;
+
+    /**
+     * @brief Get a reference to the secret key without copying it (use with caution!)
+     *
+     * Refers into the key's secure storage slot; all zero if there is no key.
+     */
+    const SecretKey& secretKey() const;
+
     /**
      * @brief Set public key from bytes
      * @param pubkey Public key bytes
@@ -97,6 +386,14 @@ public:
      */
     bool setPublicKey(const std::vector<uint8_t>& pubkey);
 
+    /**
+     * @brief Set public key from a caller-owned buffer
+     * @param pubkey Pointer to the public key bytes
+     * @param length Length in bytes, must equal PUBLIC_KEY_BYTES
+     * @return true if successful
+     */
+    bool setPublicKey(const uint8_t* pubkey, size_t length);
+
     /**
      * @brief Set secret key from bytes
      * @param seckey Secret key bytes
@@ -104,23 +401,170 @@ public:
      */
     bool setSecretKey(const std::vector<uint8_t>& seckey);
 
+    /**
+     * @brief Set secret key from a caller-owned buffer
+     * @param seckey Pointer to the secret key bytes
+     * @param length Length in bytes, must equal SECRET_KEY_BYTES
+     * @return true if successful
+     */
+    bool setSecretKey(const uint8_t* seckey, size_t length);
+
+    /**
+     * @brief Get the backend currently used by all wrapper instances of this mode
+     *
+     * Defaults to AVX2 when it was compiled in (-DDILITHIUM_AVX2=ON) and the
+     * CPU supports AVX2, otherwise to the reference implementation.
+     */
+    static Backend backend();
+
+    /**
+     * @brief Select the backend for all wrapper instances of this mode
+     * @param backend Requested backend
+     * @return true if the backend is available and now active
+     */
+    static bool setBackend(Backend backend);
+
+    /**
+     * @brief Check if a backend is compiled in and supported by this CPU
+     */
+    static bool isBackendAvailable(Backend backend);
+
+    /**
+     * @brief Get a short printable backend name ("ref", "avx2")
+     */
+    static const char* backendName(Backend backend);
+
+#ifdef DILITHIUM_RANDOMIZED_SIGNING
+    static constexpr bool RANDOMIZED_SIGNING = true;
+#else
+    static constexpr bool RANDOMIZED_SIGNING = false;
+#endif
+
+    /**
+     * @brief Get the randomness source of key generation and randomized signing
+     *
+     * Process-wide and shared by all modes, see RandomSource.hpp.
+     */
+    static Randomness randomness();
+
+    /**
+     * @brief Select the randomness source for all modes
+     */
+    static void setRandomness(Randomness randomness);
+
+    /**
+     * @brief Get a short printable randomness name ("system", "buffered")
+     */
+    static const char* randomnessName(Randomness randomness);
+
+    /**
+     * @brief Check if ExpandA and batch μ use the multi-lane Keccak
+     *
+     * Process-wide; on by default with AVX2 or AVX-512, see KeccakLanes.hpp.
+     * Applies to prepared keys, verifyBatch() and the Scratch::Arena paths.
+     */
+    static bool multiLaneKeccak();
+
+    /**
+     * @brief Switch the multi-lane Keccak on or off for all modes
+     */
+    static void setMultiLaneKeccak(bool enabled);
+
+    /**
+     * @brief Get where sign() and verify() keep their temporaries
+     *
+     * Process-wide and shared by all modes, see ScratchArena.hpp.
+     */
+    static Scratch scratchMode();
+
+    /**
+     * @brief Select Scratch::Stack (reference code) or Scratch::Arena for all modes
+     *
+     * Arena mode applies to sign()/verify() on raw buffers and to the
+     * prepared-key and streaming paths; it always uses the reference code.
+     */
+    static void setScratchMode(Scratch scratch);
+
+    /**
+     * @brief Get a short printable scratch mode name ("stack", "arena")
+     */
+    static const char* scratchName(Scratch scratch);
+
+    /**
+     * @brief Get where secret keys and prepared signing keys are allocated
+     *
+     * Process-wide and shared by all modes, see SecureMemory.hpp. The
+     * default is KeyStorage::SecurePool.
+     */
+    static KeyStorage keyStorage();
+
+    /**
+     * @brief Select KeyStorage::SecurePool or KeyStorage::Heap for keys set from now on
+     */
+    static void setKeyStorage(KeyStorage storage);
+
+    /**
+     * @brief Get a short printable key storage name ("heap", "pool")
+     */
+    static const char* keyStorageName(KeyStorage storage);
+
+    /**
+     * @brief Memory use of the pool of packed secret keys of this mode
+     */
+    static SecureKeyPool::Stats secretKeyPoolStats();
+
+#ifdef DILITHIUM_INSTRUMENTATION
+    static constexpr bool INSTRUMENTED = true;
+#else
+    static constexpr bool INSTRUMENTED = false;
+#endif
+
+    /**
+     * @brief Signing statistics of the calling thread (DILITHIUM_INSTRUMENTATION builds)
+     *
+     * With instrumentation compiled in, sign() on the reference backend runs
+     * through an instrumented PreparedSigningKey, so the statistics cover
+     * sign(), prepared-key signing and SignStream. AVX2 and pre-hash signing
+     * are not instrumented.
+     */
+    static DilithiumSignStats signStats() { return PreparedSigningKey<Mode>::threadStats(); }
+
+    /**
+     * @brief Zero the calling thread's signing statistics
+     */
+    static void resetSignStats() { PreparedSigningKey<Mode>::resetThreadStats(); }
+
     /**
      * @brief Check if keys have been generated
      * @return true if keys exist
      */
     bool hasKeys() const { return keysGenerated_; }
 
+    /**
+     * @brief Check if a public key is present, enough to verify
+     *
+     * Set by generateKeys(), setSecretKey() and setPublicKey().
+     */
+    bool hasPublicKey() const { return hasPublicKey_; }
+
 private:
-    std::vector<uint8_t> publicKey_;
-    std::vector<uint8_t> secretKey_;
-    bool keysGenerated_;
+    PublicKey publicKey_;
+    SecureBox<SecretKey> secretKey_;              // Empty until a key is generated or set
+    bool keysGenerated_;                          // Secret key present, can sign
+    bool hasPublicKey_;                           // Public key present, can verify
+    PreparedPublicKey<Mode> preparedPublicKey_;   // Lazily built by verifyBatch()
+    std::shared_ptr<PublicKeyCache<Mode>> keyCache_;
 
     /**
-     * @brief Securely wipe memory
-     * @param data Pointer to data
-     * @param size Size of data in bytes
+     * @brief Get the secret key slot, allocating it on first use
+     * @return The slot, or nullptr if no storage could be allocated
      */
-    void secureWipe(void* data, size_t size);
+    SecretKey* secretKeyStorage();
 };
 
+// Instantiated in Dilithiumwrapper.cpp, once per separately compiled mode
+extern template class DilithiumWrapper<2>;
+extern template class DilithiumWrapper<3>;
+extern template class DilithiumWrapper<5>;
+
 #endif // DILITHIUM_WRAPPER_HPP
\ No newline at end of file
@@ -0,0 +1,209 @@
+/**
+ * @file ECBenchmark.cpp
+ * @brief Implementation of the OpenSSL elliptic-curve signature wrapper
+ */
+
+#include "ECBenchmark.hpp"
+#include <openssl/ec.h>
+#include <openssl/obj_mac.h>
+#include <memory>
+
+namespace {
+
+struct MdCtxDeleter {
+    void operator()(EVP_MD_CTX* ctx) const { EVP_MD_CTX_free(ctx); }
+};
+
+/**
+ * @brief Working digest context of the calling thread (see RSABenchmark.cpp)
+ */
+EVP_MD_CTX* threadWorkContext() {
+    thread_local std::unique_ptr<EVP_MD_CTX, MdCtxDeleter> ctx(EVP_MD_CTX_new());
+    return ctx.get();
+}
+
+} // namespace
+
+ECBenchmark::ECBenchmark(Curve curve)
+    : curve_(curve)
+    , pkey_(nullptr)
+    , signCtx_(nullptr)
+    , verifyCtx_(nullptr) {
+}
+
+ECBenchmark::~ECBenchmark() {
+    cleanup();
+}
+
+void ECBenchmark::cleanup() {
+    if (signCtx_) {
+        EVP_MD_CTX_free(signCtx_);
+        signCtx_ = nullptr;
+    }
+    if (verifyCtx_) {
+        EVP_MD_CTX_free(verifyCtx_);
+        verifyCtx_ = nullptr;
+    }
+    if (pkey_) {
+        EVP_PKEY_free(pkey_);
+        pkey_ = nullptr;
+    }
+}
+
+const EVP_MD* ECBenchmark::digest() const {
+    // Ed25519 hashes internally with SHA-512 and takes no digest
+    return curve_ == Curve::P256 ? EVP_sha256() : nullptr;
+}
+
+bool ECBenchmark::generateKeys() {
+    cleanup();
+
+    EVP_PKEY_CTX* ctx = EVP_PKEY_CTX_new_id(
+        curve_ == Curve::P256 ? EVP_PKEY_EC : EVP_PKEY_ED25519, nullptr);
+    if (!ctx) {
+        return false;
+    }
+
+    if (EVP_PKEY_keygen_init(ctx) <= 0) {
+        EVP_PKEY_CTX_free(ctx);
+        return false;
+    }
+
+    if (curve_ == Curve::P256 &&
+        EVP_PKEY_CTX_set_ec_paramgen_curve_nid(ctx, NID_X9_62_prime256v1) <= 0) {
+        EVP_PKEY_CTX_free(ctx);
+        return false;
+    }
+
+    if (EVP_PKEY_keygen(ctx, &pkey_) <= 0) {
+        EVP_PKEY_CTX_free(ctx);
+        return false;
+    }
+
+    EVP_PKEY_CTX_free(ctx);
+    return prepareContexts();
+}
+
+bool ECBenchmark::prepareContexts() {
+    signCtx_ = EVP_MD_CTX_new();
+    verifyCtx_ = EVP_MD_CTX_new();
+    if (!signCtx_ || !verifyCtx_) {
+        cleanup();
+        return false;
+    }
+
+    if (EVP_DigestSignInit(signCtx_, nullptr, digest(), nullptr, pkey_) <= 0 ||
+        EVP_DigestVerifyInit(verifyCtx_, nullptr, digest(), nullptr, pkey_) <= 0) {
+        cleanup();
+        return false;
+    }
+    return true;
+}
+
+std::vector<uint8_t> ECBenchmark::sign(const std::vector<uint8_t>& message) {
+    if (!pkey_ || !signCtx_) {
+        return {};
+    }
+
+    // Reset the working context to the prepared state
+    EVP_MD_CTX* mdctx = threadWorkContext();
+    if (!mdctx || EVP_MD_CTX_copy_ex(mdctx, signCtx_) <= 0) {
+        return {};
+    }
+
+    size_t sigLen = getSignatureSize();
+    std::vector<uint8_t> signature(sigLen);
+
+    if (EVP_DigestSign(mdctx, signature.data(), &sigLen,
+                       message.data(), message.size()) <= 0) {
+        return {};
+    }
+
+    // ECDSA signatures are DER-encoded and usually a few bytes shorter
+    signature.resize(sigLen);
+    return signature;
+}
+
+bool ECBenchmark::verify(const std::vector<uint8_t>& message,
+                         const std::vector<uint8_t>& signature) {
+    if (!pkey_ || !verifyCtx_) {
+        return false;
+    }
+
+    // Reset the working context to the prepared state
+    EVP_MD_CTX* mdctx = threadWorkContext();
+    if (!mdctx || EVP_MD_CTX_copy_ex(mdctx, verifyCtx_) <= 0) {
+        return false;
+    }
+
+    int result = EVP_DigestVerify(mdctx, signature.data(), signature.size(),
+                                  message.data(), message.size());
+    return (result == 1);
+}
+
+std::vector<uint8_t> ECBenchmark::signCold(const std::vector<uint8_t>& message) {
+    if (!pkey_) {
+        return {};
+    }
+
+    EVP_MD_CTX* mdctx = EVP_MD_CTX_new();
+    if (!mdctx) {
+        return {};
+    }
+
+    if (EVP_DigestSignInit(mdctx, nullptr, digest(), nullptr, pkey_) <= 0) {
+        EVP_MD_CTX_free(mdctx);
+        return {};
+    }
+
+    size_t sigLen = 0;
+    if (EVP_DigestSign(mdctx, nullptr, &sigLen, message.data(), message.size()) <= 0) {
+        EVP_MD_CTX_free(mdctx);
+        return {};
+    }
+
+    std::vector<uint8_t> signature(sigLen);
+
+    if (EVP_DigestSign(mdctx, signature.data(), &sigLen,
+                       message.data(), message.size()) <= 0) {
+        EVP_MD_CTX_free(mdctx);
+        return {};
+    }
+
+    EVP_MD_CTX_free(mdctx);
+    signature.resize(sigLen);
+    return signature;
+}
+
+bool ECBenchmark::verifyCold(const std::vector<uint8_t>& message,
+                             const std::vector<uint8_t>& signature) {
+    if (!pkey_) {
+        return false;
+    }
+
+    EVP_MD_CTX* mdctx = EVP_MD_CTX_new();
+    if (!mdctx) {
+        return false;
+    }
+
+    if (EVP_DigestVerifyInit(mdctx, nullptr, digest(), nullptr, pkey_) <= 0) {
+        EVP_MD_CTX_free(mdctx);
+        return false;
+    }
+
+    int result = EVP_DigestVerify(mdctx, signature.data(), signature.size(),
+                                  message.data(), message.size());
+
+    EVP_MD_CTX_free(mdctx);
+    return (result == 1);
+}
+
+size_t ECBenchmark::getPublicKeySize() const {
+    // 0x04 || X || Y for P-256, the encoded point for Ed25519
+    return curve_ == Curve::P256 ? 65 : 32;
+}
+
+size_t ECBenchmark::getSignatureSize() const {
+    // DER SEQUENCE of two INTEGERs of up to 33 bytes each for P-256, R || S for Ed25519
+    return curve_ == Curve::P256 ? 72 : 64;
+}
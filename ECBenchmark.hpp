@@ -0,0 +1,112 @@
+/**
+ * @file ECBenchmark.hpp
+ * @brief Elliptic-curve signatures (ECDSA P-256, Ed25519) using OpenSSL
+ *
+ * Counterpart of RSABenchmark for the classical curve-based schemes, with
+ * the same prepared-context sign()/verify() and per-call signCold()/
+ * verifyCold() paths.
+ *
+ * @author Student Project - Cryptographic Systems Course
+ * @date December 2025
+ */
+
+#ifndef EC_BENCHMARK_HPP
+#define EC_BENCHMARK_HPP
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <openssl/evp.h>
+
+/**
+ * @brief Wrapper for elliptic-curve signatures using OpenSSL
+ */
+class ECBenchmark {
+public:
+    /**
+     * @brief Supported curves
+     */
+    enum class Curve {
+        P256,       // ECDSA over NIST P-256 with SHA-256
+        Ed25519     // EdDSA over Curve25519 (PureEdDSA, no separate digest)
+    };
+
+    /**
+     * @brief Constructor
+     * @param curve Curve and signature algorithm
+     */
+    explicit ECBenchmark(Curve curve = Curve::P256);
+
+    /**
+     * @brief Destructor - cleans up OpenSSL resources
+     */
+    ~ECBenchmark();
+
+    ECBenchmark(const ECBenchmark&) = delete;
+    ECBenchmark& operator=(const ECBenchmark&) = delete;
+
+    /**
+     * @brief Generate a key pair on the curve
+     * @return true if successful
+     */
+    bool generateKeys();
+
+    /**
+     * @brief Sign a message with the context prepared by generateKeys()
+     * @param message The message to sign
+     * @return Signature bytes, or empty on failure
+     */
+    std::vector<uint8_t> sign(const std::vector<uint8_t>& message);
+
+    /**
+     * @brief Verify a signature with the context prepared by generateKeys()
+     * @param message The original message
+     * @param signature The signature to verify
+     * @return true if valid
+     */
+    bool verify(const std::vector<uint8_t>& message,
+                const std::vector<uint8_t>& signature);
+
+    /**
+     * @brief Sign with a digest context created and initialized for this call
+     * @param message The message to sign
+     * @return Signature bytes, or empty on failure
+     */
+    std::vector<uint8_t> signCold(const std::vector<uint8_t>& message);
+
+    /**
+     * @brief Verify with a digest context created and initialized for this call
+     * @param message The original message
+     * @param signature The signature to verify
+     * @return true if valid
+     */
+    bool verifyCold(const std::vector<uint8_t>& message,
+                    const std::vector<uint8_t>& signature);
+
+    /**
+     * @brief Get public key size in bytes (uncompressed point for P-256)
+     */
+    size_t getPublicKeySize() const;
+
+    /**
+     * @brief Get maximum signature size in bytes (DER-encoded for ECDSA)
+     */
+    size_t getSignatureSize() const;
+
+    /**
+     * @brief Check if keys are generated
+     */
+    bool hasKeys() const { return pkey_ != nullptr; }
+
+private:
+    Curve curve_;
+    EVP_PKEY* pkey_;
+    EVP_MD_CTX* signCtx_;       // Initialized for signing, only ever copied from
+    EVP_MD_CTX* verifyCtx_;     // Initialized for verification, only ever copied from
+
+    void cleanup();
+    bool prepareContexts();
+    const EVP_MD* digest() const;
+};
+
+#endif // EC_BENCHMARK_HPP
@@ -0,0 +1,333 @@
+/**
+ * @file KeccakLanes.cpp
+ * @brief Multi-lane Keccak-f[1600] with run-time selected vector builds
+ *
+ * Compiled into dilithium_common. permuteLanes() follows the reference
+ * KeccakF1600_StatePermute() step by step with an inner loop over the lanes;
+ * the x86 wrappers below compile it with AVX2 or AVX-512 enabled.
+ */
+
+#include "KeccakLanes.hpp"
+#include <atomic>
+
+namespace {
+
+const uint64_t ROUND_CONSTANTS[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+    0x000000000000808bULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008aULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+};
+
+constexpr unsigned int RHO_OFFSETS[25] = {
+     0,  1, 62, 28, 27,
+    36, 44,  6, 55, 20,
+     3, 10, 43, 25, 39,
+    41, 45, 15, 21,  8,
+    18,  2, 61, 56, 14
+};
+
+#if defined(__GNUC__) || defined(__clang__)
+#define KECCAK_INLINE inline __attribute__((always_inline))
+#else
+#define KECCAK_INLINE inline
+#endif
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define KECCAK_X86_DISPATCH 1
+#endif
+
+template <unsigned int Offset>
+KECCAK_INLINE uint64_t rotl(uint64_t value) {
+    return Offset ? (value << Offset) | (value >> ((64 - Offset) % 64)) : value;
+}
+
+// ρ and π of word x + 5y, with the rotation as a template argument so that
+// every lane loop gets an immediate rotate
+template <size_t Lanes, unsigned int X, unsigned int Y>
+KECCAK_INLINE void rhoPi(uint64_t (*state)[Lanes], uint64_t (*b)[Lanes]) {
+    constexpr unsigned int source = X + 5 * Y;
+    constexpr unsigned int target = Y + 5 * ((2 * X + 3 * Y) % 5);
+    for (size_t lane = 0; lane < Lanes; ++lane) {
+        b[target][lane] = rotl<RHO_OFFSETS[source]>(state[source][lane]);
+    }
+}
+
+template <size_t Lanes, unsigned int X>
+KECCAK_INLINE void rhoPiColumn(uint64_t (*state)[Lanes], uint64_t (*b)[Lanes]) {
+    rhoPi<Lanes, X, 0>(state, b);
+    rhoPi<Lanes, X, 1>(state, b);
+    rhoPi<Lanes, X, 2>(state, b);
+    rhoPi<Lanes, X, 3>(state, b);
+    rhoPi<Lanes, X, 4>(state, b);
+}
+
+template <size_t Lanes>
+KECCAK_INLINE void permuteLanes(uint64_t (*state)[Lanes]) {
+    alignas(64) uint64_t c[5][Lanes];
+    alignas(64) uint64_t d[5][Lanes];
+    alignas(64) uint64_t b[25][Lanes];
+
+    for (unsigned int round = 0; round < 24; ++round) {
+        // θ
+        for (unsigned int x = 0; x < 5; ++x) {
+            for (size_t lane = 0; lane < Lanes; ++lane) {
+                c[x][lane] = state[x][lane] ^ state[x + 5][lane] ^ state[x + 10][lane]
+                           ^ state[x + 15][lane] ^ state[x + 20][lane];
+            }
+        }
+        for (unsigned int x = 0; x < 5; ++x) {
+            for (size_t lane = 0; lane < Lanes; ++lane) {
+                d[x][lane] = c[(x + 4) % 5][lane] ^ rotl<1>(c[(x + 1) % 5][lane]);
+            }
+        }
+        for (unsigned int i = 0; i < 25; ++i) {
+            for (size_t lane = 0; lane < Lanes; ++lane) {
+                state[i][lane] ^= d[i % 5][lane];
+            }
+        }
+
+        // ρ and π
+        rhoPiColumn<Lanes, 0>(state, b);
+        rhoPiColumn<Lanes, 1>(state, b);
+        rhoPiColumn<Lanes, 2>(state, b);
+        rhoPiColumn<Lanes, 3>(state, b);
+        rhoPiColumn<Lanes, 4>(state, b);
+
+        // χ
+        for (unsigned int y = 0; y < 25; y += 5) {
+            for (unsigned int x = 0; x < 5; ++x) {
+                for (size_t lane = 0; lane < Lanes; ++lane) {
+                    state[x + y][lane] = b[x + y][lane]
+                                       ^ (~b[(x + 1) % 5 + y][lane] & b[(x + 2) % 5 + y][lane]);
+                }
+            }
+        }
+
+        // ι
+        for (size_t lane = 0; lane < Lanes; ++lane) {
+            state[0][lane] ^= ROUND_CONSTANTS[round];
+        }
+    }
+}
+
+template <size_t Lanes>
+using PermuteFunction = void (*)(uint64_t (*)[Lanes]);
+
+template <size_t Lanes>
+void permutePortable(uint64_t (*state)[Lanes]) {
+    permuteLanes<Lanes>(state);
+}
+
+#ifdef KECCAK_X86_DISPATCH
+template <size_t Lanes>
+__attribute__((target("avx2"))) void permuteAvx2(uint64_t (*state)[Lanes]) {
+    permuteLanes<Lanes>(state);
+}
+
+template <size_t Lanes>
+__attribute__((target("avx512f,avx512vl"))) void permuteAvx512(uint64_t (*state)[Lanes]) {
+    permuteLanes<Lanes>(state);
+}
+#endif
+
+// Four lanes fill one 256-bit register: GCC's AVX-512VL build of the 4-lane
+// loops was measured slower than its AVX2 build, so only 8 lanes use AVX-512
+KeccakIsa selectIsa(size_t lanes) {
+#ifdef KECCAK_X86_DISPATCH
+    if (lanes < 4) {
+        return KeccakIsa::Portable;
+    }
+    __builtin_cpu_init();
+    if (lanes >= 8 && __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl")) {
+        return KeccakIsa::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return KeccakIsa::AVX2;
+    }
+#endif
+    return KeccakIsa::Portable;
+}
+
+template <size_t Lanes>
+PermuteFunction<Lanes> selectPermute() {
+    switch (selectIsa(Lanes)) {
+#ifdef KECCAK_X86_DISPATCH
+        case KeccakIsa::AVX512: return permuteAvx512<Lanes>;
+        case KeccakIsa::AVX2:   return permuteAvx2<Lanes>;
+#endif
+        default:                return permutePortable<Lanes>;
+    }
+}
+
+std::atomic<bool>& lanesEnabled() {
+    static std::atomic<bool> enabled(selectIsa(4) != KeccakIsa::Portable);
+    return enabled;
+}
+
+uint64_t load64(const uint8_t* bytes) {
+    uint64_t value = 0;
+    for (unsigned int i = 0; i < 8; ++i) {
+        value |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+    }
+    return value;
+}
+
+} // namespace
+
+const char* keccakIsaName(KeccakIsa isa) {
+    switch (isa) {
+        case KeccakIsa::Portable: return "portable";
+        case KeccakIsa::AVX2:     return "avx2";
+        case KeccakIsa::AVX512:   return "avx512";
+    }
+    return "unknown";
+}
+
+size_t keccakPreferredLanes() {
+    return selectIsa(8) == KeccakIsa::AVX512 ? 8 : 4;
+}
+
+bool keccakLanesEnabled() {
+    return lanesEnabled().load(std::memory_order_relaxed);
+}
+
+void setKeccakLanesEnabled(bool enabled) {
+    lanesEnabled().store(enabled, std::memory_order_relaxed);
+}
+
+template <size_t Lanes>
+void KeccakLanes<Lanes>::reset() {
+    for (unsigned int i = 0; i < 25; ++i) {
+        for (size_t lane = 0; lane < Lanes; ++lane) {
+            s_[i][lane] = 0;
+        }
+    }
+    pos_ = 0;
+}
+
+/**
+ * @brief XOR bytes from..to-1 of the block, read from in[lane] + offset
+ */
+template <size_t Lanes>
+void KeccakLanes<Lanes>::xorBytes(const uint8_t* const in[Lanes], size_t offset,
+                                  unsigned int from, unsigned int to) {
+    for (size_t lane = 0; lane < Lanes; ++lane) {
+        const uint8_t* bytes = in[lane] + offset;
+        unsigned int i = from;
+        for (; i < to && i % 8 != 0; ++i) {
+            s_[i / 8][lane] ^= static_cast<uint64_t>(*bytes++) << (8 * (i % 8));
+        }
+        for (; i + 8 <= to; i += 8, bytes += 8) {
+            s_[i / 8][lane] ^= load64(bytes);
+        }
+        for (; i < to; ++i) {
+            s_[i / 8][lane] ^= static_cast<uint64_t>(*bytes++) << (8 * (i % 8));
+        }
+    }
+}
+
+// Same block and position handling as keccak_absorb() in fips202.c
+template <size_t Lanes>
+void KeccakLanes<Lanes>::absorb(const uint8_t* const in[Lanes], size_t length, size_t rate) {
+    size_t offset = 0;
+    while (pos_ + length >= rate) {
+        xorBytes(in, offset, pos_, static_cast<unsigned int>(rate));
+        offset += rate - pos_;
+        length -= rate - pos_;
+        permute(s_);
+        pos_ = 0;
+    }
+    xorBytes(in, offset, pos_, static_cast<unsigned int>(pos_ + length));
+    pos_ += static_cast<unsigned int>(length);
+}
+
+template <size_t Lanes>
+void KeccakLanes<Lanes>::finalize(uint8_t suffix, size_t rate) {
+    for (size_t lane = 0; lane < Lanes; ++lane) {
+        s_[pos_ / 8][lane] ^= static_cast<uint64_t>(suffix) << (8 * (pos_ % 8));
+        s_[rate / 8 - 1][lane] ^= 1ULL << 63;
+    }
+    pos_ = static_cast<unsigned int>(rate);
+}
+
+template <size_t Lanes>
+void KeccakLanes<Lanes>::squeezeBlocks(uint8_t* const out[Lanes], size_t blocks, size_t rate) {
+    for (size_t block = 0; block < blocks; ++block) {
+        permute(s_);
+        for (size_t lane = 0; lane < Lanes; ++lane) {
+            uint8_t* bytes = out[lane] + block * rate;
+            for (size_t word = 0; word < rate / 8; ++word) {
+                const uint64_t value = s_[word][lane];
+                for (unsigned int i = 0; i < 8; ++i) {
+                    *bytes++ = static_cast<uint8_t>(value >> (8 * i));
+                }
+            }
+        }
+    }
+}
+
+// Same as keccak_squeeze() in fips202.c
+template <size_t Lanes>
+void KeccakLanes<Lanes>::squeeze(uint8_t* const out[Lanes], size_t length, size_t rate) {
+    size_t offset = 0;
+    while (length > 0) {
+        if (pos_ == rate) {
+            permute(s_);
+            pos_ = 0;
+        }
+        const size_t take = rate - pos_ < length ? rate - pos_ : length;
+        for (size_t lane = 0; lane < Lanes; ++lane) {
+            for (size_t i = 0; i < take; ++i) {
+                const size_t index = pos_ + i;
+                out[lane][offset + i] = static_cast<uint8_t>(s_[index / 8][lane] >> (8 * (index % 8)));
+            }
+        }
+        offset += take;
+        length -= take;
+        pos_ += static_cast<unsigned int>(take);
+    }
+}
+
+template <size_t Lanes>
+void KeccakLanes<Lanes>::extractLane(size_t lane, uint64_t state[25]) const {
+    for (unsigned int i = 0; i < 25; ++i) {
+        state[i] = s_[i][lane];
+    }
+}
+
+template <size_t Lanes>
+void KeccakLanes<Lanes>::shake128Many(uint8_t* const out[Lanes], size_t outLength,
+                                      const uint8_t* const in[Lanes], size_t inLength) {
+    KeccakLanes sponge;
+    sponge.absorb(in, inLength, SHAKE128_BLOCK_BYTES);
+    sponge.finalize(SHAKE_SUFFIX, SHAKE128_BLOCK_BYTES);
+    sponge.squeeze(out, outLength, SHAKE128_BLOCK_BYTES);
+}
+
+template <size_t Lanes>
+void KeccakLanes<Lanes>::shake256Many(uint8_t* const out[Lanes], size_t outLength,
+                                      const uint8_t* const in[Lanes], size_t inLength) {
+    KeccakLanes sponge;
+    sponge.absorb(in, inLength, SHAKE256_BLOCK_BYTES);
+    sponge.finalize(SHAKE_SUFFIX, SHAKE256_BLOCK_BYTES);
+    sponge.squeeze(out, outLength, SHAKE256_BLOCK_BYTES);
+}
+
+template <size_t Lanes>
+KeccakIsa KeccakLanes<Lanes>::isa() {
+    static const KeccakIsa selected = selectIsa(Lanes);
+    return selected;
+}
+
+template <size_t Lanes>
+void KeccakLanes<Lanes>::permute(uint64_t state[25][Lanes]) {
+    static const PermuteFunction<Lanes> function = selectPermute<Lanes>();
+    function(state);
+}
+
+template class KeccakLanes<1>;
+template class KeccakLanes<4>;
+template class KeccakLanes<8>;
@@ -0,0 +1,143 @@
+/**
+ * @file KeccakLanes.hpp
+ * @brief Keccak-f[1600] sponge running 4 or 8 independent states in lockstep
+ *
+ * The reference fips202.c hashes one state at a time, so the 30 SHAKE-128
+ * streams of ExpandA (Dilithium3) and the μ hashes of a verification batch
+ * run strictly one after another. KeccakLanes<N> keeps N states interleaved
+ * word by word (s[word][lane]) so that one pass of the permutation updates
+ * all of them with vector instructions. The permutation is written once as
+ * plain lane loops and compiled three times: AVX-512 (native 64-bit
+ * rotates, 8 lanes only), AVX2 and the portable baseline, chosen at run time
+ * by CPUID.
+ *
+ * Every lane produces exactly the bytes of the reference SHAKE on its own
+ * input. absorb() takes the same number of bytes for every lane; inputs of
+ * different lengths absorb their common part here and continue from
+ * extractLane() with the single-state reference functions.
+ *
+ * fips202.h defines shake128, shake256 and SHAKE128_RATE/SHAKE256_RATE as
+ * macros, hence the names shake128Many(), shake256Many() and *_BLOCK_BYTES.
+ *
+ * @author Student Project - Cryptographic Systems Course
+ * @date December 2025
+ */
+
+#ifndef KECCAK_LANES_HPP
+#define KECCAK_LANES_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief Instruction set a KeccakLanes permutation was compiled for
+ */
+enum class KeccakIsa {
+    Portable,   // Baseline compiler output (SSE2 on x86-64)
+    AVX2,
+    AVX512
+};
+
+/**
+ * @brief Get a short printable name ("portable", "avx2", "avx512")
+ */
+const char* keccakIsaName(KeccakIsa isa);
+
+/**
+ * @brief Lane count that runs fastest on this CPU: 8 with AVX-512, else 4
+ */
+size_t keccakPreferredLanes();
+
+/**
+ * @brief Check whether the multi-lane paths are used by the Dilithium code
+ *
+ * Defaults to true when a vector permutation (AVX2 or AVX-512) is available;
+ * the portable build is slower than the reference single-state code.
+ */
+bool keccakLanesEnabled();
+
+/**
+ * @brief Switch the multi-lane matrix expansion and batch μ on or off
+ */
+void setKeccakLanesEnabled(bool enabled);
+
+/**
+ * @brief N parallel SHAKE sponges
+ * @tparam Lanes Number of states: 4 or 8 (1 is the scalar baseline)
+ */
+template <size_t Lanes>
+class KeccakLanes {
+public:
+    static constexpr size_t LANES = Lanes;
+    static constexpr size_t SHAKE128_BLOCK_BYTES = 168;
+    static constexpr size_t SHAKE256_BLOCK_BYTES = 136;
+    static constexpr uint8_t SHAKE_SUFFIX = 0x1F;
+
+    KeccakLanes() { reset(); }
+
+    /**
+     * @brief Zero all states
+     */
+    void reset();
+
+    /**
+     * @brief Absorb length bytes from each in[lane]; may be called repeatedly
+     * @param rate SHAKE128_BLOCK_BYTES or SHAKE256_BLOCK_BYTES
+     */
+    void absorb(const uint8_t* const in[Lanes], size_t length, size_t rate);
+
+    /**
+     * @brief Pad all states; squeezing starts with a permutation
+     */
+    void finalize(uint8_t suffix, size_t rate);
+
+    /**
+     * @brief Squeeze whole blocks (rate bytes each) into every out[lane]
+     */
+    void squeezeBlocks(uint8_t* const out[Lanes], size_t blocks, size_t rate);
+
+    /**
+     * @brief Squeeze length bytes into every out[lane]
+     */
+    void squeeze(uint8_t* const out[Lanes], size_t length, size_t rate);
+
+    /**
+     * @brief Copy one lane's state words, e.g. into a reference keccak_state
+     *
+     * The byte position within the block is position(), the same for all lanes.
+     */
+    void extractLane(size_t lane, uint64_t state[25]) const;
+
+    unsigned int position() const { return pos_; }
+
+    /**
+     * @brief One-shot SHAKE128 of Lanes equally long inputs
+     */
+    static void shake128Many(uint8_t* const out[Lanes], size_t outLength,
+                             const uint8_t* const in[Lanes], size_t inLength);
+
+    /**
+     * @brief One-shot SHAKE256 of Lanes equally long inputs
+     */
+    static void shake256Many(uint8_t* const out[Lanes], size_t outLength,
+                             const uint8_t* const in[Lanes], size_t inLength);
+
+    /**
+     * @brief Instruction set of the permutation selected on this CPU
+     */
+    static KeccakIsa isa();
+
+private:
+    alignas(64) uint64_t s_[25][Lanes];
+    unsigned int pos_;
+
+    void xorBytes(const uint8_t* const in[Lanes], size_t offset, unsigned int from, unsigned int to);
+    static void permute(uint64_t state[25][Lanes]);
+};
+
+// Instantiated in KeccakLanes.cpp
+extern template class KeccakLanes<1>;
+extern template class KeccakLanes<4>;
+extern template class KeccakLanes<8>;
+
+#endif // KECCAK_LANES_HPP
@@ -0,0 +1,189 @@
+/**
+ * @file MappedFile.cpp
+ * @brief Read-only file mapping and the little-endian field helpers
+ */
+
+#include "MappedFile.hpp"
+#include <algorithm>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MAPPED_FILE_HAVE_MMAP 1
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        data_ = std::exchange(other.data_, nullptr);
+        bytes_ = std::exchange(other.bytes_, 0);
+        mapped_ = std::exchange(other.mapped_, false);
+        buffer_ = std::move(other.buffer_);
+        other.buffer_.clear();
+    }
+    return *this;
+}
+
+bool MappedFile::open(const std::string& path, size_t minimumBytes, Access access) {
+    close();
+
+#ifdef MAPPED_FILE_HAVE_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    const bool regular = ::fstat(fd, &info) == 0 && S_ISREG(info.st_mode)
+                         && static_cast<size_t>(info.st_size) >= minimumBytes;
+    const bool mapped = regular && mapDescriptor(fd, static_cast<size_t>(info.st_size), access);
+    ::close(fd);
+    if (!regular) {
+        return false;
+    }
+    if (mapped) {
+        return true;
+    }
+#else
+    (void)access;
+#endif
+
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+    try {
+        uint8_t chunk[1 << 16];
+        size_t read = 0;
+        while ((read = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+            buffer_.insert(buffer_.end(), chunk, chunk + read);
+        }
+    } catch (...) {
+        buffer_.clear();
+    }
+    const bool ok = !std::ferror(file) && buffer_.size() >= minimumBytes && !buffer_.empty();
+    std::fclose(file);
+    if (!ok) {
+        close();
+        return false;
+    }
+    data_ = buffer_.data();
+    bytes_ = buffer_.size();
+    return true;
+}
+
+bool MappedFile::map(const std::string& path, Access access) {
+    close();
+#ifdef MAPPED_FILE_HAVE_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    const bool mapped = ::fstat(fd, &info) == 0 && S_ISREG(info.st_mode)
+                        && mapDescriptor(fd, static_cast<size_t>(info.st_size), access);
+    ::close(fd);
+    return mapped;
+#else
+    (void)path;
+    (void)access;
+    return false;
+#endif
+}
+
+bool MappedFile::mapDescriptor(int fd, size_t bytes, Access access) {
+#ifdef MAPPED_FILE_HAVE_MMAP
+    void* mapped = bytes > 0 ? ::mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+    data_ = static_cast<const uint8_t*>(mapped);
+    bytes_ = bytes;
+    mapped_ = true;
+    if (access == Access::Sequential) {
+        ::madvise(mapped, bytes, MADV_SEQUENTIAL);
+    } else if (access == Access::Random) {
+        ::madvise(mapped, bytes, MADV_RANDOM);
+    }
+    return true;
+#else
+    (void)fd;
+    (void)bytes;
+    (void)access;
+    return false;
+#endif
+}
+
+void MappedFile::close() {
+#ifdef MAPPED_FILE_HAVE_MMAP
+    if (mapped_ && data_) {
+        ::munmap(const_cast<uint8_t*>(data_), bytes_);
+    }
+#endif
+    buffer_.clear();
+    buffer_.shrink_to_fit();
+    data_ = nullptr;
+    bytes_ = 0;
+    mapped_ = false;
+}
+
+void MappedFile::willNeed(size_t offset, size_t length) const {
+#ifdef MAPPED_FILE_HAVE_MMAP
+    if (!mapped_ || length == 0 || offset >= bytes_) {
+        return;
+    }
+    const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    const size_t first = offset / page * page;
+    ::madvise(const_cast<uint8_t*>(data_) + first, offset + length - first, MADV_WILLNEED);
+#else
+    (void)offset;
+    (void)length;
+#endif
+}
+
+void MappedFile::dontNeed(size_t offset, size_t length) const {
+#ifdef MAPPED_FILE_HAVE_MMAP
+    if (!mapped_ || length == 0 || offset >= bytes_) {
+        return;
+    }
+    // Only whole pages inside the range, so neighbouring data stays resident
+    const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    const size_t first = (offset + page - 1) / page * page;
+    const size_t end = std::min(offset + length, bytes_);
+    const size_t last = end == bytes_ ? end : end / page * page;
+    if (last > first) {
+        ::madvise(const_cast<uint8_t*>(data_) + first, last - first, MADV_DONTNEED);
+    }
+#else
+    (void)offset;
+    (void)length;
+#endif
+}
+
+void storeLittleEndian(uint8_t* out, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+uint64_t loadLittleEndian(const uint8_t* in, size_t bytes) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; ++i) {
+        value |= static_cast<uint64_t>(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+bool writeAll(std::FILE* file, const void* data, size_t length) {
+    return length == 0 || std::fwrite(data, 1, length, file) == length;
+}
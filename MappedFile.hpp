@@ -0,0 +1,123 @@
+/**
+ * @file MappedFile.hpp
+ * @brief Read-only file mapping with a read() fallback, and the helpers of the key file formats
+ *
+ * PublicKeyStore and PreparedKeyFile both map a whole file read-only and
+ * check a little-endian header at its start. MappedFile does the mapping:
+ * mmap() where available, otherwise (or if mmap() fails) the file is read
+ * into memory, so the formats behave the same either way. The
+ * little-endian field codecs and writeAll() are shared by the writers.
+ *
+ * @author Student Project - Cryptographic Systems Course
+ * @date December 2025
+ */
+
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+ * @brief A whole file, mapped read-only or copied into memory
+ */
+class MappedFile {
+public:
+    /**
+     * @brief Expected access pattern, passed to madvise() when mapped
+     */
+    enum class Access {
+        Normal,         // Default readahead
+        Sequential,     // Read once front to back, aggressive readahead
+        Random          // Lookups jump around the file, no readahead
+    };
+
+    MappedFile() = default;
+
+    /**
+     * @brief Destructor - unmaps the file
+     */
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /**
+     * @brief Map a regular file read-only, or read it if it cannot be mapped
+     * @param path File to open
+     * @param minimumBytes Smallest acceptable file size (the header)
+     * @param access Access pattern of the mapping
+     * @return true if the file is open and at least minimumBytes long
+     */
+    bool open(const std::string& path, size_t minimumBytes, Access access = Access::Normal);
+
+    /**
+     * @brief Map a regular file read-only, without the read() fallback
+     *
+     * For callers with their own fallback that must not copy the whole file,
+     * such as a chunked read of a pipe.
+     *
+     * @return true if the file is mapped; false also for empty and special files
+     */
+    bool map(const std::string& path, Access access = Access::Normal);
+
+    /**
+     * @brief Unmap the file or free the copy
+     */
+    void close();
+
+    /**
+     * @brief Ask the kernel to start reading a range of a mapped file
+     *
+     * No-op for a file read into memory.
+     */
+    void willNeed(size_t offset, size_t length) const;
+
+    /**
+     * @brief Drop the pages of a range of a mapped file that was consumed
+     *
+     * Keeps the footprint of a front-to-back pass constant. No-op for a
+     * file read into memory.
+     */
+    void dontNeed(size_t offset, size_t length) const;
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return bytes_; }
+    bool isOpen() const { return data_ != nullptr; }
+
+    /**
+     * @brief True if the file is mapped rather than copied into memory
+     */
+    bool isMapped() const { return mapped_; }
+
+private:
+    bool mapDescriptor(int fd, size_t bytes, Access access);
+
+    const uint8_t* data_ = nullptr;
+    size_t bytes_ = 0;
+    bool mapped_ = false;
+    std::vector<uint8_t> buffer_;           // File contents when not mapped
+};
+
+/**
+ * @brief Write the low bytes of value least significant first
+ */
+void storeLittleEndian(uint8_t* out, uint64_t value, size_t bytes);
+
+/**
+ * @brief Read a little-endian field of 1 to 8 bytes
+ */
+uint64_t loadLittleEndian(const uint8_t* in, size_t bytes);
+
+/**
+ * @brief fwrite() all of data
+ * @return true if every byte was written
+ */
+bool writeAll(std::FILE* file, const void* data, size_t length);
+
+#endif // MAPPED_FILE_HPP
@@ -0,0 +1,362 @@
+/**
+ * @file MicroBenchmark.cpp
+ * @brief dilithium_microbench: cycles per call of the Dilithium primitives
+ *
+ * Times every primitive of DilithiumPrimitives<Mode> for each mode and each
+ * backend that is built and supported by the CPU, in two variants:
+ *
+ * - warm: the same working set is reused, each sample runs enough calls
+ *   for about 20 µs and is divided by the call count
+ * - cold: each sample is one call on the next working set of a pool twice
+ *   the size of the last-level cache, walked in order, so the data was
+ *   evicted since it was last touched (the code and constant tables stay
+ *   cached)
+ *
+ * The JSON/CSV reports use the same format as dilithium_benchmark, so two
+ * runs can be compared with dilithium_benchmark --compare.
+ */
+
+#include "DilithiumPrimitives.hpp"
+#include "Benchmark.hpp"
+#include "BenchmarkReport.hpp"
+#include "PerfCounters.hpp"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cstdint>
+#include <unistd.h>
+
+namespace {
+
+struct Options {
+    std::vector<int> modes = {2, 3, 5};
+    std::vector<std::string> backends = {"ref", "avx2"};
+    std::vector<std::string> primitives;    // Empty: all
+    size_t iterations = 1000;
+    int pinCpu = -1;
+    bool perfCounters = true;               // --no-perf
+    std::vector<std::string> reportPaths;
+};
+
+std::vector<std::string> splitList(const std::string& text) {
+    std::vector<std::string> items;
+    std::istringstream in(text);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n\n"
+              << "  --modes <list>            Dilithium modes, e.g. 2,3 (default 2,3,5)\n"
+              << "  --backends <list>         ref, avx2 (default: all available)\n"
+              << "  --primitives <list>       e.g. ntt,poly_uniform (default: all)\n"
+              << "  -n, --iterations <n>      Samples per variant (default 1000)\n"
+              << "  --pin <cpu>               Pin the benchmark thread to one CPU\n"
+              << "  --no-perf                 Do not read the hardware performance counters\n"
+              << "  --json <file>             Also write the report as JSON\n"
+              << "  --csv <file>              Also write the report as CSV\n";
+}
+
+bool parseOptions(int argc, char** argv, Options& options, bool& help, std::string& error) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        std::string value;
+        if (arg == "--help" || arg == "-h") {
+            help = true;
+            continue;
+        }
+        if (arg == "--no-perf") {
+            options.perfCounters = false;
+            continue;
+        }
+        if (arg != "--modes" && arg != "--backends" && arg != "--primitives" && arg != "-n"
+            && arg != "--iterations" && arg != "--pin" && arg != "--json" && arg != "--csv") {
+            error = "unknown option '" + arg + "'";
+            return false;
+        }
+        if (i + 1 >= argc) {
+            error = arg + " needs a value";
+            return false;
+        }
+        value = argv[++i];
+
+        if (arg == "--modes") {
+            options.modes.clear();
+            for (const std::string& mode : splitList(value)) {
+                if (mode != "2" && mode != "3" && mode != "5") {
+                    error = "unknown mode '" + mode + "' (2, 3, 5)";
+                    return false;
+                }
+                options.modes.push_back(std::atoi(mode.c_str()));
+            }
+        } else if (arg == "--backends") {
+            options.backends = splitList(value);
+            for (const std::string& backend : options.backends) {
+                if (backend != "ref" && backend != "avx2") {
+                    error = "unknown backend '" + backend + "' (ref, avx2)";
+                    return false;
+                }
+            }
+        } else if (arg == "--primitives") {
+            options.primitives = splitList(value);
+        } else if (arg == "-n" || arg == "--iterations") {
+            char* end = nullptr;
+            options.iterations = std::strtoull(value.c_str(), &end, 10);
+            if (value.empty() || *end != '\0' || options.iterations == 0) {
+                error = "invalid iteration count '" + value + "'";
+                return false;
+            }
+        } else if (arg == "--pin") {
+            char* end = nullptr;
+            options.pinCpu = static_cast<int>(std::strtol(value.c_str(), &end, 10));
+            if (value.empty() || *end != '\0' || options.pinCpu < 0) {
+                error = "invalid CPU '" + value + "'";
+                return false;
+            }
+        } else {
+            // --json / --csv
+            const std::string extension = "." + arg.substr(2);
+            if (value.size() <= extension.size()
+                || value.compare(value.size() - extension.size(), extension.size(),
+                                 extension) != 0) {
+                value += extension;
+            }
+            options.reportPaths.push_back(value);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Size of the last-level cache in bytes (32 MB if unknown)
+ */
+size_t lastLevelCacheBytes() {
+    long bytes = -1;
+#ifdef _SC_LEVEL3_CACHE_SIZE
+    bytes = sysconf(_SC_LEVEL3_CACHE_SIZE);
+    if (bytes <= 0) {
+        bytes = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    }
+#endif
+    return bytes > 0 ? static_cast<size_t>(bytes) : 32u << 20;
+}
+
+/**
+ * @brief 64-byte aligned array of working sets
+ */
+class StatePool {
+public:
+    StatePool(size_t stateBytes, size_t count)
+        : stateBytes_(stateBytes), count_(count), buffer_(stateBytes * count + 64) {
+        const uintptr_t address = reinterpret_cast<uintptr_t>(buffer_.data());
+        base_ = buffer_.data() + ((64 - address % 64) % 64);
+    }
+
+    void* operator[](size_t index) { return base_ + (index % count_) * stateBytes_; }
+    size_t size() const { return count_; }
+
+private:
+    size_t stateBytes_;
+    size_t count_;
+    std::vector<uint8_t> buffer_;
+    uint8_t* base_;
+};
+
+/**
+ * @brief Turn the statistics of samples of `calls` calls into per-call figures
+ */
+Benchmark::Result perCall(Benchmark::Result result, size_t calls) {
+    const double scale = 1.0 / static_cast<double>(calls);
+    result.averageTime *= scale;
+    result.minTime *= scale;
+    result.maxTime *= scale;
+    result.stdDev *= scale;
+    result.medianTime *= scale;
+    result.p90Time *= scale;
+    result.p99Time *= scale;
+    result.p999Time *= scale;
+    result.averageCycles *= scale;
+    result.medianCycles *= scale;
+    result.coreCycles *= scale;
+    result.instructions *= scale;
+    result.l1dMisses *= scale;
+    result.llcMisses *= scale;
+    result.branchMisses *= scale;
+    result.allocations *= scale;
+    for (double& sample : result.samples) {
+        sample *= scale;
+    }
+    return result;
+}
+
+/**
+ * @brief Calls per warm sample so that one sample takes about 20 µs
+ */
+size_t callsPerSample(const DilithiumPrimitive& primitive, void* state) {
+    const size_t PROBE_CALLS = 1000;
+    for (size_t i = 0; i < PROBE_CALLS / 10; ++i) {
+        primitive.run(state);
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < PROBE_CALLS; ++i) {
+        primitive.run(state);
+    }
+    const double nanoseconds = std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - start).count() / PROBE_CALLS;
+    return std::max<size_t>(1, static_cast<size_t>(20000.0 / std::max(nanoseconds, 1.0)));
+}
+
+void printSeparator() {
+    std::cout << "+" << std::string(6, '-') << "+" << std::string(9, '-')
+              << "+" << std::string(27, '-') << "+" << std::string(13, '-')
+              << "+" << std::string(13, '-') << "+" << std::string(11, '-')
+              << "+" << std::string(11, '-') << "+\n";
+}
+
+template <int Mode>
+void runMode(const Options& options, BenchmarkReport& report) {
+    using Primitives = DilithiumPrimitives<Mode>;
+    const std::string scheme = "Dilithium" + std::to_string(Mode);
+    const std::string parameterSet = "NIST Level " + std::to_string(Mode);
+
+    StatePool warm(Primitives::stateBytes(), 1);
+    Primitives::prepare(warm[0], 0);
+
+    const size_t poolBytes = std::min<size_t>(std::max<size_t>(2 * lastLevelCacheBytes(),
+                                                               8u << 20), 256u << 20);
+    StatePool cold(Primitives::stateBytes(), poolBytes / Primitives::stateBytes());
+
+    // Prepared in order, so the cold walk starts at the least recently touched set
+    for (size_t i = 0; i < cold.size(); ++i) {
+        Primitives::prepare(cold[i], i + 1);
+    }
+    size_t next = 0;
+
+    for (const std::string& backendName : options.backends) {
+        const DilithiumBackend backend = backendName == "avx2" ? DilithiumBackend::AVX2
+                                                               : DilithiumBackend::Reference;
+        const std::vector<DilithiumPrimitive> primitives = Primitives::list(backend);
+        if (primitives.empty()) {
+            std::cout << "| " << std::setw(4) << std::left << Mode
+                      << " | " << std::setw(7) << backendName
+                      << " | not built or not supported by this CPU\n";
+            continue;
+        }
+
+        for (const DilithiumPrimitive& primitive : primitives) {
+            if (!options.primitives.empty()
+                && std::find(options.primitives.begin(), options.primitives.end(),
+                             primitive.name) == options.primitives.end()) {
+                continue;
+            }
+
+            void* state = warm[0];
+            const size_t calls = callsPerSample(primitive, state);
+            const Benchmark::Result warmResult = perCall(Benchmark::run([&]() {
+                for (size_t i = 0; i < calls; ++i) {
+                    primitive.run(state);
+                }
+            }, options.iterations), calls);
+
+            const Benchmark::Result coldResult = Benchmark::run([&]() {
+                primitive.run(cold[next++]);
+            }, options.iterations);
+
+            report.add(scheme, parameterSet, backendName,
+                       std::string(primitive.name) + "-warm", 0, warmResult);
+            report.add(scheme, parameterSet, backendName,
+                       std::string(primitive.name) + "-cold", 0, coldResult);
+
+            std::cout << "| " << std::setw(4) << std::left << Mode
+                      << " | " << std::setw(7) << backendName
+                      << " | " << std::setw(25) << primitive.name
+                      << " | " << std::setw(11) << std::right << std::setprecision(1)
+                      << warmResult.medianCycles
+                      << " | " << std::setw(11) << coldResult.medianCycles
+                      << " | " << std::setw(9) << std::setprecision(1)
+                      << warmResult.medianTime * 1e6
+                      << " | " << std::setw(9) << coldResult.medianTime * 1e6 << " |\n";
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    bool help = false;
+    std::string error;
+    if (!parseOptions(argc, argv, options, help, error)) {
+        std::cerr << "Error: " << error << "\n\n";
+        printUsage(argv[0]);
+        return 2;
+    }
+    if (help) {
+        printUsage(argv[0]);
+        return 0;
+    }
+    if (options.pinCpu >= 0 && !Benchmark::pinCurrentThread(options.pinCpu)) {
+        std::cerr << "Error: cannot pin to CPU " << options.pinCpu << "\n";
+        return 2;
+    }
+    Benchmark::setPerfCounters(options.perfCounters);
+
+    std::cout << "Dilithium primitives, median per call";
+    if (!Benchmark::hasCycleCounter()) {
+        std::cout << " (no cycle counter on this platform)";
+    }
+    std::cout << "\nLast-level cache: " << (lastLevelCacheBytes() >> 20) << " MB\n\n";
+
+    BenchmarkReport report;
+    printSeparator();
+    std::cout << "| " << std::setw(4) << std::left << "Mode"
+              << " | " << std::setw(7) << "Backend"
+              << " | " << std::setw(25) << "Primitive"
+              << " | " << std::setw(11) << std::right << "Warm (cyc)"
+              << " | " << std::setw(11) << "Cold (cyc)"
+              << " | " << std::setw(9) << "Warm (ns)"
+              << " | " << std::setw(9) << "Cold (ns)" << " |\n";
+    printSeparator();
+    std::cout << std::fixed;
+
+    for (int mode : options.modes) {
+        switch (mode) {
+            case 2: runMode<2>(options, report); break;
+            case 3: runMode<3>(options, report); break;
+            case 5: runMode<5>(options, report); break;
+        }
+    }
+    printSeparator();
+
+    if (options.perfCounters && !PerfCounters::available()) {
+        std::cout << "\nHardware counters: " << PerfCounters::unavailableReason() << "\n";
+    } else if (options.perfCounters) {
+        std::cout << "\nHardware counters per call\n";
+        Benchmark::printCounterHeader();
+        for (const BenchmarkRecord& record : report.records()) {
+            Benchmark::printCounterRow(record.scheme + " " + record.backend + " "
+                                       + record.operation, record.result);
+        }
+        Benchmark::printCounterSeparator();
+    }
+
+    for (const std::string& path : options.reportPaths) {
+        auto reporter = BenchmarkReporter::forFormat(path);
+        if (!reporter || !reporter->writeFile(report, path)) {
+            std::cerr << "Error: cannot write " << path << "\n";
+            return 1;
+        }
+        std::cout << "Results written to " << path << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,240 @@
+/**
+ * @file PerfCounters.cpp
+ * @brief perf_event_open() counters, no-ops where unsupported
+ */
+
+#include "PerfCounters.hpp"
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define PERF_COUNTERS_HAVE_PERF_EVENT 1
+#endif
+
+namespace {
+
+#ifdef PERF_COUNTERS_HAVE_PERF_EVENT
+
+constexpr uint64_t cacheConfig(uint64_t cache, uint64_t op, uint64_t result) {
+    return cache | (op << 8) | (result << 16);
+}
+
+/**
+ * @brief Open one user-space counter of the calling thread
+ *
+ * With groupFd -1 the counter leads a group of its own and starts disabled;
+ * otherwise it joins the group of groupFd and follows its enable state. All
+ * counters use the group read format, so reading a leader returns
+ * {nr, time enabled, time running, value[nr]} whether it has members or not.
+ *
+ * @return The file descriptor, or -1 with errno set
+ */
+int openCounter(uint32_t type, uint64_t config, int groupFd) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = groupFd < 0 ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED
+                     | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, groupFd,
+                                      PERF_FLAG_FD_CLOEXEC));
+}
+
+int openEvent(PerfCounters::Event event, int groupFd) {
+    switch (event) {
+        case PerfCounters::CoreCycles:
+            return openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, groupFd);
+        case PerfCounters::Instructions:
+            return openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, groupFd);
+        case PerfCounters::L1DMisses:
+            return openCounter(PERF_TYPE_HW_CACHE,
+                               cacheConfig(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ,
+                                           PERF_COUNT_HW_CACHE_RESULT_MISS),
+                               groupFd);
+        case PerfCounters::LLCMisses: {
+            int fd = openCounter(PERF_TYPE_HW_CACHE,
+                                 cacheConfig(PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_OP_READ,
+                                             PERF_COUNT_HW_CACHE_RESULT_MISS),
+                                 groupFd);
+            // Not mapped on every CPU; the generic event is the last-level cache as well
+            return fd >= 0 ? fd
+                           : openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, groupFd);
+        }
+        case PerfCounters::BranchMisses:
+            return openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, groupFd);
+        default:
+            return -1;
+    }
+}
+
+/**
+ * @brief Check that a group still fits the PMU after its last member joined
+ *
+ * The kernel accepts more members than there are counters, but then never
+ * schedules the group: it shows up as a running time of 0 for a short run.
+ */
+bool groupSchedules(int leader) {
+    ::ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ::ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    volatile uint64_t work = 0;
+    for (int i = 0; i < 1000; ++i) {
+        work = work + static_cast<uint64_t>(i);
+    }
+    ::ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    // nr, time enabled, time running, values
+    uint64_t values[3 + PerfCounters::EVENT_COUNT] = {};
+    return ::read(leader, values, sizeof(values)) > 0 && values[2] > 0;
+}
+
+#endif
+
+struct Probe {
+    bool available = false;
+    std::string reason;
+
+    Probe() {
+#ifdef PERF_COUNTERS_HAVE_PERF_EVENT
+        int fd = openEvent(PerfCounters::CoreCycles, -1);
+        if (fd >= 0) {
+            ::close(fd);
+            available = true;
+        } else if (errno == EACCES || errno == EPERM) {
+            reason = std::string("perf_event_open: ") + std::strerror(errno)
+                   + " (see /proc/sys/kernel/perf_event_paranoid)";
+        } else if (errno == ENOENT || errno == EOPNOTSUPP || errno == ENODEV) {
+            reason = "no hardware counters (virtual machine or container without a PMU?)";
+        } else {
+            reason = std::string("perf_event_open: ") + std::strerror(errno);
+        }
+#else
+        reason = "perf_event_open is Linux only";
+#endif
+    }
+};
+
+const Probe& probe() {
+    static const Probe instance;
+    return instance;
+}
+
+} // namespace
+
+PerfCounters::PerfCounters(bool enabled) {
+    for (int event = 0; event < EVENT_COUNT; ++event) {
+        fds_[event] = -1;
+        grouped_[event] = false;
+        counts_[event] = 0.0;
+    }
+#ifdef PERF_COUNTERS_HAVE_PERF_EVENT
+    if (enabled && available()) {
+        const int leader = openEvent(CoreCycles, -1);
+        fds_[CoreCycles] = leader;
+        for (int event = CoreCycles + 1; event < EVENT_COUNT; ++event) {
+            int fd = leader >= 0 ? openEvent(static_cast<Event>(event), leader) : -1;
+            if (fd >= 0 && !groupSchedules(leader)) {
+                // Closing removes it from the group again
+                ::close(fd);
+                fd = -1;
+            }
+            grouped_[event] = fd >= 0;
+            fds_[event] = fd >= 0 ? fd : openEvent(static_cast<Event>(event), -1);
+        }
+    }
+#else
+    (void)enabled;
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#ifdef PERF_COUNTERS_HAVE_PERF_EVENT
+    for (int fd : fds_) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+#endif
+}
+
+bool PerfCounters::anyOpen() const {
+    for (int fd : fds_) {
+        if (fd >= 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void PerfCounters::start() {
+#ifdef PERF_COUNTERS_HAVE_PERF_EVENT
+    // Members are switched through their leader
+    for (int event = 0; event < EVENT_COUNT; ++event) {
+        if (fds_[event] >= 0 && !grouped_[event]) {
+            ::ioctl(fds_[event], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ::ioctl(fds_[event], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+    }
+#endif
+}
+
+void PerfCounters::stop() {
+#ifdef PERF_COUNTERS_HAVE_PERF_EVENT
+    for (int event = 0; event < EVENT_COUNT; ++event) {
+        if (fds_[event] >= 0 && !grouped_[event]) {
+            ::ioctl(fds_[event], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        }
+        counts_[event] = 0.0;
+    }
+    for (int event = 0; event < EVENT_COUNT; ++event) {
+        if (fds_[event] < 0 || grouped_[event]) {
+            continue;
+        }
+        // nr, time enabled, time running, then the leader and its members
+        // in the order they joined
+        uint64_t values[3 + EVENT_COUNT] = {};
+        const ssize_t read = ::read(fds_[event], values, sizeof(values));
+        if (read < static_cast<ssize_t>(3 * sizeof(uint64_t)) || values[2] == 0
+            || values[0] > EVENT_COUNT
+            || static_cast<size_t>(read) < (3 + values[0]) * sizeof(uint64_t)) {
+            continue;
+        }
+        // Scale up if the kernel multiplexed the group with others
+        const double scale = static_cast<double>(values[1]) / static_cast<double>(values[2]);
+        counts_[event] = static_cast<double>(values[3]) * scale;
+        // Only cycles lead members; they follow in the order they joined
+        uint64_t next = 1;
+        for (int member = event + 1; event == CoreCycles && member < EVENT_COUNT; ++member) {
+            if (grouped_[member] && next < values[0]) {
+                counts_[member] = static_cast<double>(values[3 + next++]) * scale;
+            }
+        }
+    }
+#endif
+}
+
+const char* PerfCounters::eventName(Event event) {
+    switch (event) {
+        case CoreCycles:    return "cycles";
+        case Instructions:  return "instructions";
+        case L1DMisses:     return "l1d-misses";
+        case LLCMisses:     return "llc-misses";
+        case BranchMisses:  return "branch-misses";
+        default:            return "unknown";
+    }
+}
+
+bool PerfCounters::available() {
+    return probe().available;
+}
+
+std::string PerfCounters::unavailableReason() {
+    return probe().reason;
+}
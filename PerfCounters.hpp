@@ -0,0 +1,119 @@
+/**
+ * @file PerfCounters.hpp
+ * @brief Hardware performance counters of the calling thread (Linux perf_event)
+ *
+ * Opens perf_event_open() counters for the calling thread, user space only,
+ * so the counts do not depend on kernel.perf_event_paranoid being below 2
+ * and do not include the kernel's own work. Cycles lead an event group and
+ * the other events join it, so start() and stop() switch them all at once
+ * and a ratio such as instructions per cycle covers exactly the same
+ * instructions. An event the group cannot hold - one the CPU or VM lacks
+ * (e.g. LLC read misses on older AMD kernels), or one more than the PMU has
+ * counters for - is opened on its own instead, and the kernel may multiplex
+ * those. Counts are scaled by enabled / running time for that case.
+ *
+ * | Event        | perf event                                  |
+ * |--------------|---------------------------------------------|
+ * | CoreCycles   | cycles (core clock, unlike the TSC)         |
+ * | Instructions | instructions                                |
+ * | L1DMisses    | L1-dcache-load-misses                       |
+ * | LLCMisses    | LLC-load-misses, else cache-misses          |
+ * | BranchMisses | branch-misses                               |
+ *
+ * Without perf events (non-Linux, containers without a PMU, a seccomp
+ * filter, perf_event_paranoid 3) nothing opens, every count is 0 and
+ * unavailableReason() says why.
+ *
+ * @code
+ * PerfCounters counters;
+ * counters.start();
+ * sign();
+ * counters.stop();
+ * double ipc = counters.count(PerfCounters::Instructions)
+ *            / counters.count(PerfCounters::CoreCycles);
+ * @endcode
+ *
+ * @author Student Project - Cryptographic Systems Course
+ * @date December 2025
+ */
+
+#ifndef PERF_COUNTERS_HPP
+#define PERF_COUNTERS_HPP
+
+#include <string>
+
+class PerfCounters {
+public:
+    enum Event {
+        CoreCycles,
+        Instructions,
+        L1DMisses,
+        LLCMisses,
+        BranchMisses,
+        EVENT_COUNT
+    };
+
+    /**
+     * @brief Open the counters of the calling thread, stopped
+     * @param enabled false opens nothing (all counts stay 0)
+     */
+    explicit PerfCounters(bool enabled = true);
+
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    /**
+     * @brief Check if an event was opened
+     */
+    bool isOpen(Event event) const { return fds_[event] >= 0; }
+
+    /**
+     * @brief Check if an event counts in the cycles group rather than on its own
+     */
+    bool isGrouped(Event event) const { return grouped_[event]; }
+
+    /**
+     * @brief Check if at least one event was opened
+     */
+    bool anyOpen() const;
+
+    /**
+     * @brief Zero and start all opened counters
+     */
+    void start();
+
+    /**
+     * @brief Stop all opened counters and read them
+     */
+    void stop();
+
+    /**
+     * @brief Count of an event between the last start() and stop()
+     * @return The scaled count, 0 if the event is not open or never ran
+     */
+    double count(Event event) const { return counts_[event]; }
+
+    /**
+     * @brief Short printable event name ("cycles", "instructions", ...)
+     */
+    static const char* eventName(Event event);
+
+    /**
+     * @brief Check once per process whether core cycles can be counted
+     */
+    static bool available();
+
+    /**
+     * @brief Why no counter could be opened, empty if available()
+     */
+    static std::string unavailableReason();
+
+private:
+    int fds_[EVENT_COUNT];
+    bool grouped_[EVENT_COUNT];             // Member of the group led by fds_[CoreCycles]
+    double counts_[EVENT_COUNT];
+};
+
+#endif // PERF_COUNTERS_HPP
@@ -0,0 +1,172 @@
+/**
+ * @file PreparedKeyFile.cpp
+ * @brief Implementation of the memory-mapped prepared key file
+ *
+ * Compiled once per parameter set with DILITHIUM_MODE set to 2, 3 or 5.
+ */
+
+#include "PreparedKeyFile.hpp"
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+const char MAGIC[8] = {'D', 'L', 'T', 'H', 'P', 'K', 'E', 'Y'};
+
+// Header field offsets
+constexpr size_t VERSION_OFFSET = 8;
+constexpr size_t MODE_OFFSET = 12;
+constexpr size_t COUNT_OFFSET = 16;
+constexpr size_t MEMORY_OFFSET = 24;
+constexpr size_t BLOB_BYTES_OFFSET = 28;
+constexpr size_t BLOBS_OFFSET_OFFSET = 32;
+constexpr size_t FILE_BYTES_OFFSET = 40;
+
+const DilithiumKeyMemory MEMORY_MODES[] = {
+    DilithiumKeyMemory::Full, DilithiumKeyMemory::RowStreaming, DilithiumKeyMemory::None
+};
+
+uint32_t memoryCode(DilithiumKeyMemory memory) {
+    for (uint32_t code = 0; code < 3; ++code) {
+        if (MEMORY_MODES[code] == memory) {
+            return code;
+        }
+    }
+    return 0;
+}
+
+} // namespace
+
+template <int Mode>
+bool PreparedKeyFile<Mode>::write(const std::string& path, const PreparedPublicKey<Mode>* keys,
+                                  size_t count) {
+    if (count > 0 && !keys) {
+        return false;
+    }
+    const DilithiumKeyMemory memory = count > 0 ? keys[0].memory() : DilithiumKeyMemory::Full;
+    for (size_t i = 0; i < count; ++i) {
+        if (!keys[i].isValid() || keys[i].memory() != memory) {
+            return false;
+        }
+    }
+
+    try {
+        const size_t blobBytes = PreparedPublicKey<Mode>::serializedBytes(memory);
+        const size_t blobsOffset = BLOBS_ALIGNMENT;
+        const size_t fileBytes = blobsOffset + count * blobBytes;
+
+        std::vector<uint8_t> header(blobsOffset, 0);
+        std::memcpy(header.data(), MAGIC, sizeof(MAGIC));
+        storeLittleEndian(header.data() + VERSION_OFFSET, FORMAT_VERSION, 4);
+        storeLittleEndian(header.data() + MODE_OFFSET, Mode, 4);
+        storeLittleEndian(header.data() + COUNT_OFFSET, count, 8);
+        storeLittleEndian(header.data() + MEMORY_OFFSET, memoryCode(memory), 4);
+        storeLittleEndian(header.data() + BLOB_BYTES_OFFSET, blobBytes, 4);
+        storeLittleEndian(header.data() + BLOBS_OFFSET_OFFSET, blobsOffset, 8);
+        storeLittleEndian(header.data() + FILE_BYTES_OFFSET, fileBytes, 8);
+
+        const std::string temporary = path + ".tmp";
+        std::FILE* file = std::fopen(temporary.c_str(), "wb");
+        if (!file) {
+            return false;
+        }
+
+        std::vector<uint8_t> blob(blobBytes);
+        bool ok = writeAll(file, header.data(), header.size());
+        for (size_t i = 0; ok && i < count; ++i) {
+            ok = keys[i].serialize(blob.data(), blob.size())
+                 && writeAll(file, blob.data(), blob.size());
+        }
+        ok = std::fclose(file) == 0 && ok;
+
+        if (!ok || std::rename(temporary.c_str(), path.c_str()) != 0) {
+            std::remove(temporary.c_str());
+            return false;
+        }
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+template <int Mode>
+PreparedKeyFile<Mode>::~PreparedKeyFile() {
+    close();
+}
+
+template <int Mode>
+PreparedKeyFile<Mode>::PreparedKeyFile(PreparedKeyFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+template <int Mode>
+PreparedKeyFile<Mode>& PreparedKeyFile<Mode>::operator=(PreparedKeyFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        file_ = std::move(other.file_);
+        blobs_ = other.blobs_;
+        blobBytes_ = other.blobBytes_;
+        count_ = other.count_;
+        memory_ = other.memory_;
+        other.blobs_ = nullptr;
+        other.blobBytes_ = other.count_ = 0;
+    }
+    return *this;
+}
+
+template <int Mode>
+bool PreparedKeyFile<Mode>::open(const std::string& path) {
+    close();
+    if (!file_.open(path, HEADER_BYTES)) {
+        return false;
+    }
+    const uint8_t* data = file_.data();
+    const size_t bytes = file_.size();
+
+    const uint64_t count = loadLittleEndian(data + COUNT_OFFSET, 8);
+    const uint64_t memory = loadLittleEndian(data + MEMORY_OFFSET, 4);
+    const uint64_t blobBytes = loadLittleEndian(data + BLOB_BYTES_OFFSET, 4);
+    const uint64_t blobsOffset = loadLittleEndian(data + BLOBS_OFFSET_OFFSET, 8);
+    const bool valid =
+        std::memcmp(data, MAGIC, sizeof(MAGIC)) == 0
+        && loadLittleEndian(data + VERSION_OFFSET, 4) == FORMAT_VERSION
+        && loadLittleEndian(data + MODE_OFFSET, 4) == static_cast<uint64_t>(Mode)
+        && memory < 3
+        && blobBytes == PreparedPublicKey<Mode>::serializedBytes(MEMORY_MODES[memory])
+        && loadLittleEndian(data + FILE_BYTES_OFFSET, 8) == bytes
+        && blobsOffset >= HEADER_BYTES && blobsOffset % BLOBS_ALIGNMENT == 0
+        && blobsOffset <= bytes
+        && count == (bytes - blobsOffset) / blobBytes
+        && blobsOffset + count * blobBytes == bytes;
+    if (!valid) {
+        close();
+        return false;
+    }
+
+    count_ = static_cast<size_t>(count);
+    memory_ = MEMORY_MODES[memory];
+    blobBytes_ = static_cast<size_t>(blobBytes);
+    blobs_ = data + blobsOffset;
+    return true;
+}
+
+template <int Mode>
+void PreparedKeyFile<Mode>::close() {
+    file_.close();
+    blobs_ = nullptr;
+    blobBytes_ = count_ = 0;
+    memory_ = DilithiumKeyMemory::Full;
+}
+
+template <int Mode>
+bool PreparedKeyFile<Mode>::load(size_t index, PreparedPublicKey<Mode>& key) const {
+    if (index >= count_) {
+        return false;
+    }
+    // A copied file lives in a vector whose data is not guaranteed to be
+    // 64-byte aligned, so its blobs are deserialized instead
+    return file_.isMapped() ? key.attach(blob(index), blobBytes_)
+                            : key.deserialize(blob(index), blobBytes_);
+}
+
+template class PreparedKeyFile<DILITHIUM_MODE>;
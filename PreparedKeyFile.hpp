@@ -0,0 +1,163 @@
+/**
+ * @file PreparedKeyFile.hpp
+ * @brief Memory-mapped file of serialized prepared Dilithium public keys
+ *
+ * A verifier that starts with thousands of hot keys spends its warm-up in
+ * ExpandA: every PreparedPublicKey::load() samples k·l polynomials with
+ * SHAKE-128. A prepared key file stores the result of that work, so after
+ * open() each key is attach()ed in place and its matrix is read from the
+ * page cache on first use. Like PublicKeyStore, every process mapping the
+ * file shares the same pages.
+ *
+ * File layout (version 1, header integers little-endian):
+ *
+ * | Offset      | Size          | Contents                                   |
+ * |-------------|---------------|--------------------------------------------|
+ * | 0           | 64            | Header, see below                          |
+ * | blobsOffset | blobBytes · n | PreparedPublicKey::serialize() blobs       |
+ *
+ * Header: magic "DLTHPKEY", u32 version, u32 mode, u64 n, u32 memory mode
+ * (0 full, 1 row-streaming, 2 none), u32 blob bytes, u64 blobs offset
+ * (4096-byte aligned) and u64 file size. All keys share one memory mode,
+ * so blob i starts at blobsOffset + i · blobBytes and stays 64-byte aligned.
+ *
+ * The blobs hold native-endian polynomials and are only meant to be read on
+ * the kind of machine that wrote them; see PreparedKeys.hpp.
+ *
+ * @code
+ * PreparedKeyFile<3>::write("signers.dpk", preparedKeys);
+ *
+ * PreparedKeyFile<3> file;
+ * file.open("signers.dpk");             // mmap, no parsing
+ * PreparedPublicKey<3> key;
+ * file.load(i, key);                    // attach in place, no SHAKE
+ * @endcode
+ *
+ * @author Student Project - Cryptographic Systems Course
+ * @date December 2025
+ */
+
+#ifndef PREPARED_KEY_FILE_HPP
+#define PREPARED_KEY_FILE_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "DilithiumParams.hpp"
+#include "MappedFile.hpp"
+#include "PreparedKeys.hpp"
+
+/**
+ * @brief Read-only view of a prepared key file
+ *
+ * Keys attached by load() point into the mapping; they must be cleared or
+ * destroyed before the file is closed, moved from or destroyed.
+ *
+ * @tparam Mode Dilithium mode (2, 3 or 5)
+ */
+template <int Mode>
+class PreparedKeyFile {
+public:
+    static constexpr uint32_t FORMAT_VERSION = 1;
+    static constexpr size_t HEADER_BYTES = 64;
+    static constexpr size_t BLOBS_ALIGNMENT = 4096;
+
+    /**
+     * @brief Write prepared public keys as a prepared key file
+     *
+     * All keys must be valid and use the same memory mode. The file is
+     * written next to path and renamed over it.
+     *
+     * @param path Output file
+     * @param keys Keys in the order load() will return them
+     * @param count Number of keys
+     * @return true if the file was written
+     */
+    static bool write(const std::string& path, const PreparedPublicKey<Mode>* keys, size_t count);
+
+    static bool write(const std::string& path, const std::vector<PreparedPublicKey<Mode>>& keys) {
+        return write(path, keys.data(), keys.size());
+    }
+
+    PreparedKeyFile() = default;
+
+    /**
+     * @brief Destructor - unmaps the file
+     */
+    ~PreparedKeyFile();
+
+    PreparedKeyFile(const PreparedKeyFile&) = delete;
+    PreparedKeyFile& operator=(const PreparedKeyFile&) = delete;
+    PreparedKeyFile(PreparedKeyFile&& other) noexcept;
+    PreparedKeyFile& operator=(PreparedKeyFile&& other) noexcept;
+
+    /**
+     * @brief Map a prepared key file read-only
+     *
+     * Checks the header against the file size and this mode; the blobs are
+     * not read. Without mmap() the file is read into memory.
+     *
+     * @param path Prepared key file
+     * @return true if the file is a valid prepared key file of this mode
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Unmap the file
+     */
+    void close();
+
+    bool isOpen() const { return file_.isOpen(); }
+
+    /**
+     * @brief True if the file is mapped rather than copied into memory
+     */
+    bool isMapped() const { return file_.isMapped(); }
+
+    /**
+     * @brief Number of keys in the file
+     */
+    size_t size() const { return count_; }
+
+    /**
+     * @brief Size of the file in bytes
+     */
+    size_t fileBytes() const { return file_.size(); }
+
+    /**
+     * @brief Memory mode shared by all keys of the file
+     */
+    DilithiumKeyMemory memory() const { return memory_; }
+
+    /**
+     * @brief Serialized key index (0 <= index < size()), blobBytes() bytes
+     */
+    const uint8_t* blob(size_t index) const { return blobs_ + index * blobBytes_; }
+
+    size_t blobBytes() const { return blobBytes_; }
+
+    /**
+     * @brief Make key index usable for verification
+     *
+     * Attaches the key to its blob in the mapping; when the file was copied
+     * into memory instead, the blob is deserialized into the key.
+     *
+     * @return true if index is in range and the blob is valid
+     */
+    bool load(size_t index, PreparedPublicKey<Mode>& key) const;
+
+private:
+    MappedFile file_;
+    const uint8_t* blobs_ = nullptr;
+    size_t blobBytes_ = 0;
+    size_t count_ = 0;
+    DilithiumKeyMemory memory_ = DilithiumKeyMemory::Full;
+};
+
+// Instantiated in PreparedKeyFile.cpp, once per separately compiled mode
+extern template class PreparedKeyFile<2>;
+extern template class PreparedKeyFile<3>;
+extern template class PreparedKeyFile<5>;
+
+#endif // PREPARED_KEY_FILE_HPP
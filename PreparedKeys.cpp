@@ -0,0 +1,1256 @@
+/**
+ * @file PreparedKeys.cpp
+ * @brief Implementation of pre-expanded Dilithium key material
+ *
+ * The verification and signing routines below follow
+ * crypto_sign_verify_internal() and crypto_sign_signature_internal() from the
+ * reference sign.c step by step; the only difference is that unpacking, the
+ * tr hash, polyvec_matrix_expand() and the NTTs of the key vectors happen
+ * once in load() instead of on every call.
+ *
+ * This file is compiled once per parameter set with DILITHIUM_MODE set to 2,
+ * 3 or 5 and instantiates the templates for that mode only.
+ *
+ * ExpandA and the μ of verification batches run on KeccakLanes (4 or 8
+ * SHAKE states per permutation) when keccakLanesEnabled(); the lane results
+ * are identical to poly_uniform() and shake256() on each entry.
+ *
+ * The temporaries of both loops live in a Scratch struct that comes from the
+ * thread's ScratchArena in DilithiumScratch::Arena mode and from the stack of
+ * a separate non-inlined frame otherwise.
+ *
+ * serialize() writes the expanded parts byte for byte; an attached public key
+ * points its matrix and t̂1 into the caller's blob instead of owning copies.
+ *
+ * With DILITHIUM_INSTRUMENTATION defined, the signing path records per-phase
+ * times and rejection counters in a thread_local DilithiumSignStats. Without
+ * it the SIGN_* macros expand to the bare statements.
+ */
+
+#include "PreparedKeys.hpp"
+#include "ScratchArena.hpp"
+#include "SecureMemory.hpp"
+#include "KeccakLanes.hpp"
+#include "MappedFile.hpp"
+#include <algorithm>
+#include <cstring>
+#ifdef DILITHIUM_INSTRUMENTATION
+#include <chrono>
+#endif
+
+// The reference headers define short macros (N, K, L, Q, D, ...), so they are
+// included after all C++ standard headers.
+extern "C" {
+#include "params.h"
+#include "packing.h"
+#include "polyvec.h"
+#include "poly.h"
+#include "fips202.h"
+#include "randombytes.h"
+}
+
+namespace {
+
+#ifdef DILITHIUM_INSTRUMENTATION
+
+DilithiumSignStats& signStats() {
+    thread_local DilithiumSignStats stats{};
+    return stats;
+}
+
+/**
+ * @brief Adds the lifetime of the timer to a nanosecond counter
+ */
+class SignPhaseTimer {
+public:
+    explicit SignPhaseTimer(uint64_t& counter)
+        : counter_(counter), start_(std::chrono::steady_clock::now()) {}
+
+    ~SignPhaseTimer() {
+        counter_ += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start_).count());
+    }
+
+    SignPhaseTimer(const SignPhaseTimer&) = delete;
+    SignPhaseTimer& operator=(const SignPhaseTimer&) = delete;
+
+private:
+    uint64_t& counter_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+void recordSignature(uint64_t passes) {
+    DilithiumSignStats& stats = signStats();
+    ++stats.signatures;
+    stats.iterations += passes;
+    stats.maxIterations = std::max(stats.maxIterations, passes);
+    const uint64_t bin = std::min<uint64_t>(passes, DilithiumSignStats::HISTOGRAM_BINS) - 1;
+    ++stats.iterationHistogram[bin];
+}
+
+// Time the statements as one phase / the rest of the enclosing scope
+#define SIGN_PHASE(phase, ...) do { SignPhaseTimer phaseTimer(signStats().phase##Ns); __VA_ARGS__; } while (0)
+#define SIGN_SCOPE(phase) SignPhaseTimer phase##ScopeTimer(signStats().phase##Ns)
+#define SIGN_COUNT(...) do { __VA_ARGS__; } while (0)
+
+#else
+
+#define SIGN_PHASE(phase, ...) do { __VA_ARGS__; } while (0)
+#define SIGN_SCOPE(phase) do {} while (0)
+#define SIGN_COUNT(...) do {} while (0)
+
+#endif
+
+// Keeps the stack-mode scratch out of the frame of the arena-mode caller
+#if defined(__GNUC__) || defined(__clang__)
+#define SCRATCH_NOINLINE __attribute__((noinline))
+#else
+#define SCRATCH_NOINLINE
+#endif
+
+} // namespace
+
+static_assert(DilithiumParams<DILITHIUM_MODE>::PUBLIC_KEY_BYTES == CRYPTO_PUBLICKEYBYTES,
+              "DilithiumParams does not match params.h");
+static_assert(DilithiumParams<DILITHIUM_MODE>::SECRET_KEY_BYTES == CRYPTO_SECRETKEYBYTES,
+              "DilithiumParams does not match params.h");
+static_assert(DilithiumParams<DILITHIUM_MODE>::SIGNATURE_BYTES == CRYPTO_BYTES,
+              "DilithiumParams does not match params.h");
+static_assert(DILITHIUM_MU_BYTES == CRHBYTES && DILITHIUM_MU_BYTES == TRBYTES,
+              "DILITHIUM_MU_BYTES does not match params.h");
+
+namespace {
+
+// Separately allocated parts of a prepared public key, cache-line aligned
+struct alignas(64) ExpandedMatrix {
+    polyvecl rows[K];           // A in NTT domain
+};
+
+struct alignas(64) ExpandedT1 {
+    polyveck t1;                // 2^d · t1 in NTT domain
+};
+
+struct PackedT1 {
+    uint8_t bytes[K * POLYT1_PACKEDBYTES];
+};
+
+static_assert(sizeof(ExpandedMatrix) == sizeof(polyvecl) * K
+              && sizeof(ExpandedT1) == sizeof(polyveck),
+              "prepared key parts must not contain padding");
+
+// Serialized prepared keys, see the format in PreparedKeys.hpp
+const char BLOB_MAGIC[8] = {'D', 'L', 'T', 'H', 'P', 'R', 'E', 'P'};
+constexpr uint32_t BLOB_PUBLIC = 1;
+constexpr uint32_t BLOB_SIGNING = 2;
+constexpr uint32_t BLOB_BYTE_ORDER = 0x01020304;
+constexpr size_t BLOB_HEADER_BYTES = 64;
+constexpr size_t BLOB_SEEDS_BYTES = 128;                // ρ and tr of a public key, padded
+constexpr size_t BLOB_T1_OFFSET = BLOB_HEADER_BYTES + BLOB_SEEDS_BYTES;
+
+// Header field offsets
+constexpr size_t BLOB_VERSION_OFFSET = 8;
+constexpr size_t BLOB_MODE_OFFSET = 12;
+constexpr size_t BLOB_KIND_OFFSET = 16;
+constexpr size_t BLOB_MEMORY_OFFSET = 20;
+constexpr size_t BLOB_BYTE_ORDER_OFFSET = 24;
+constexpr size_t BLOB_POLY_BYTES_OFFSET = 28;
+constexpr size_t BLOB_BYTES_OFFSET = 32;
+
+static_assert(SEEDBYTES + TRBYTES <= BLOB_SEEDS_BYTES, "ρ and tr do not fit the blob");
+
+constexpr size_t alignBlob(size_t bytes) {
+    return (bytes + DILITHIUM_PREPARED_ALIGNMENT - 1) / DILITHIUM_PREPARED_ALIGNMENT
+           * DILITHIUM_PREPARED_ALIGNMENT;
+}
+
+uint32_t memoryCode(DilithiumKeyMemory memory) {
+    switch (memory) {
+        case DilithiumKeyMemory::Full:         return 0;
+        case DilithiumKeyMemory::RowStreaming: return 1;
+        case DilithiumKeyMemory::None:         return 2;
+    }
+    return 0;
+}
+
+size_t publicT1Bytes(DilithiumKeyMemory memory) {
+    return memory == DilithiumKeyMemory::None ? alignBlob(sizeof(PackedT1)) : sizeof(ExpandedT1);
+}
+
+size_t publicBlobBytes(DilithiumKeyMemory memory) {
+    return BLOB_T1_OFFSET + publicT1Bytes(memory)
+         + (memory == DilithiumKeyMemory::Full ? sizeof(ExpandedMatrix) : 0);
+}
+
+void writeBlobHeader(uint8_t* out, uint32_t kind, uint32_t memory, size_t bytes) {
+    std::memset(out, 0, BLOB_HEADER_BYTES);
+    std::memcpy(out, BLOB_MAGIC, sizeof(BLOB_MAGIC));
+    storeLittleEndian(out + BLOB_VERSION_OFFSET, DILITHIUM_PREPARED_FORMAT_VERSION, 4);
+    storeLittleEndian(out + BLOB_MODE_OFFSET, DILITHIUM_MODE, 4);
+    storeLittleEndian(out + BLOB_KIND_OFFSET, kind, 4);
+    storeLittleEndian(out + BLOB_MEMORY_OFFSET, memory, 4);
+    // Native order on purpose: the polynomials that follow are native too
+    std::memcpy(out + BLOB_BYTE_ORDER_OFFSET, &BLOB_BYTE_ORDER, 4);
+    storeLittleEndian(out + BLOB_POLY_BYTES_OFFSET, sizeof(poly), 4);
+    storeLittleEndian(out + BLOB_BYTES_OFFSET, bytes, 8);
+}
+
+/**
+ * @brief Check a blob header against this mode and kind
+ * @param memory Receives the memory mode field
+ * @return true if the header matches and the blob is exactly length bytes
+ */
+bool readBlobHeader(const uint8_t* blob, size_t length, uint32_t kind, uint32_t& memory) {
+    if (!blob || length < BLOB_HEADER_BYTES) {
+        return false;
+    }
+    uint32_t byteOrder = 0;
+    std::memcpy(&byteOrder, blob + BLOB_BYTE_ORDER_OFFSET, 4);
+    memory = static_cast<uint32_t>(loadLittleEndian(blob + BLOB_MEMORY_OFFSET, 4));
+    return std::memcmp(blob, BLOB_MAGIC, sizeof(BLOB_MAGIC)) == 0
+        && loadLittleEndian(blob + BLOB_VERSION_OFFSET, 4) == DILITHIUM_PREPARED_FORMAT_VERSION
+        && loadLittleEndian(blob + BLOB_MODE_OFFSET, 4) == DILITHIUM_MODE
+        && loadLittleEndian(blob + BLOB_KIND_OFFSET, 4) == kind
+        && byteOrder == BLOB_BYTE_ORDER
+        && loadLittleEndian(blob + BLOB_POLY_BYTES_OFFSET, 4) == sizeof(poly)
+        && loadLittleEndian(blob + BLOB_BYTES_OFFSET, 8) == length;
+}
+
+/**
+ * @brief Sections of a public key blob
+ */
+struct PublicBlob {
+    DilithiumKeyMemory memory;
+    const uint8_t* rho;
+    const uint8_t* tr;
+    const uint8_t* t1;          // t̂1, or packed t1 for None
+    const uint8_t* mat;         // Â, Full only
+};
+
+bool parsePublicBlob(const uint8_t* blob, size_t length, PublicBlob& parsed) {
+    uint32_t memory = 0;
+    if (!readBlobHeader(blob, length, BLOB_PUBLIC, memory) || memory > 2) {
+        return false;
+    }
+    const DilithiumKeyMemory modes[] = {DilithiumKeyMemory::Full, DilithiumKeyMemory::RowStreaming,
+                                        DilithiumKeyMemory::None};
+    parsed.memory = modes[memory];
+    if (length != publicBlobBytes(parsed.memory)) {
+        return false;
+    }
+    parsed.rho = blob + BLOB_HEADER_BYTES;
+    parsed.tr = parsed.rho + SEEDBYTES;
+    parsed.t1 = blob + BLOB_T1_OFFSET;
+    parsed.mat = parsed.memory == DilithiumKeyMemory::Full
+               ? parsed.t1 + publicT1Bytes(parsed.memory) : nullptr;
+    return true;
+}
+
+template <typename T>
+std::unique_ptr<T> clonePart(const std::unique_ptr<T>& part) {
+    return part ? std::unique_ptr<T>(new T(*part)) : nullptr;
+}
+
+/**
+ * @brief μ = CRH(tr || 0 || 0 || M), i.e. M' with an empty context string
+ */
+void hashMu(uint8_t* mu, const uint8_t* tr, const uint8_t* message, size_t messageLength) {
+    const uint8_t pre[2] = {0, 0};
+    keccak_state state;
+
+    shake256_init(&state);
+    shake256_absorb(&state, tr, TRBYTES);
+    shake256_absorb(&state, pre, sizeof(pre));
+    shake256_absorb(&state, message, messageLength);
+    shake256_finalize(&state);
+    shake256_squeeze(mu, CRHBYTES, &state);
+}
+
+// rej_uniform() of the reference poly.c, which is static there
+unsigned int rejectUniform(int32_t* a, unsigned int length, const uint8_t* buf, unsigned int bufLength) {
+    unsigned int count = 0;
+    unsigned int pos = 0;
+    while (count < length && pos + 3 <= bufLength) {
+        uint32_t t = buf[pos++];
+        t |= static_cast<uint32_t>(buf[pos++]) << 8;
+        t |= static_cast<uint32_t>(buf[pos++]) << 16;
+        t &= 0x7FFFFF;
+        if (t < Q) {
+            a[count++] = static_cast<int32_t>(t);
+        }
+    }
+    return count;
+}
+
+// POLY_UNIFORM_NBLOCKS of poly.c
+constexpr unsigned int UNIFORM_BLOCKS = (768 + SHAKE128_RATE - 1) / SHAKE128_RATE;
+
+template <size_t Lanes>
+struct UniformScratch {
+    KeccakLanes<Lanes> sponge;
+    uint8_t seeds[Lanes][SEEDBYTES + 2];
+    uint8_t buf[Lanes][UNIFORM_BLOCKS * SHAKE128_RATE + 2];
+};
+
+/**
+ * @brief poly_uniform() of Lanes matrix entries at once
+ *
+ * All lanes squeeze in lockstep, so buflen and the carried-over bytes are
+ * the same as in a single poly_uniform() call; finished lanes idle along.
+ */
+template <size_t Lanes>
+void uniformLanes(poly* const out[Lanes], const uint8_t rho[SEEDBYTES], const uint16_t nonces[Lanes],
+                  UniformScratch<Lanes>& scratch) {
+    const uint8_t* in[Lanes];
+    uint8_t* blocks[Lanes];
+    for (size_t lane = 0; lane < Lanes; ++lane) {
+        std::memcpy(scratch.seeds[lane], rho, SEEDBYTES);
+        scratch.seeds[lane][SEEDBYTES] = static_cast<uint8_t>(nonces[lane]);
+        scratch.seeds[lane][SEEDBYTES + 1] = static_cast<uint8_t>(nonces[lane] >> 8);
+        in[lane] = scratch.seeds[lane];
+        blocks[lane] = scratch.buf[lane];
+    }
+
+    scratch.sponge.reset();
+    scratch.sponge.absorb(in, SEEDBYTES + 2, SHAKE128_RATE);
+    scratch.sponge.finalize(KeccakLanes<Lanes>::SHAKE_SUFFIX, SHAKE128_RATE);
+    scratch.sponge.squeezeBlocks(blocks, UNIFORM_BLOCKS, SHAKE128_RATE);
+
+    unsigned int bufLength = UNIFORM_BLOCKS * SHAKE128_RATE;
+    unsigned int count[Lanes];
+    bool pending = false;
+    for (size_t lane = 0; lane < Lanes; ++lane) {
+        count[lane] = rejectUniform(out[lane]->coeffs, N, scratch.buf[lane], bufLength);
+        pending = pending || count[lane] < N;
+    }
+
+    while (pending) {
+        const unsigned int off = bufLength % 3;
+        for (size_t lane = 0; lane < Lanes; ++lane) {
+            for (unsigned int i = 0; i < off; ++i) {
+                scratch.buf[lane][i] = scratch.buf[lane][bufLength - off + i];
+            }
+            blocks[lane] = scratch.buf[lane] + off;
+        }
+        scratch.sponge.squeezeBlocks(blocks, 1, SHAKE128_RATE);
+        bufLength = SHAKE128_RATE + off;
+
+        pending = false;
+        for (size_t lane = 0; lane < Lanes; ++lane) {
+            if (count[lane] < N) {
+                count[lane] += rejectUniform(out[lane]->coeffs + count[lane], N - count[lane],
+                                             scratch.buf[lane], bufLength);
+                pending = pending || count[lane] < N;
+            }
+        }
+    }
+}
+
+/**
+ * @brief polyvec_matrix_expand() with Lanes entries per permutation
+ */
+template <size_t Lanes>
+void expandMatrixLanes(polyvecl mat[K], const uint8_t rho[SEEDBYTES], UniformScratch<Lanes>& scratch) {
+    poly* out[Lanes];
+    uint16_t nonces[Lanes];
+    poly unused;
+    size_t filled = 0;
+
+    for (unsigned int i = 0; i < K; ++i) {
+        for (unsigned int j = 0; j < L; ++j) {
+            out[filled] = &mat[i].vec[j];
+            nonces[filled] = static_cast<uint16_t>((i << 8) + j);
+            if (++filled == Lanes) {
+                uniformLanes<Lanes>(out, rho, nonces, scratch);
+                filled = 0;
+            }
+        }
+    }
+    if (filled > 0) {
+        for (size_t lane = filled; lane < Lanes; ++lane) {
+            out[lane] = &unused;
+            nonces[lane] = nonces[0];
+        }
+        uniformLanes<Lanes>(out, rho, nonces, scratch);
+    }
+}
+
+template <size_t Lanes>
+SCRATCH_NOINLINE void expandMatrixOnStack(polyvecl mat[K], const uint8_t rho[SEEDBYTES]) {
+    UniformScratch<Lanes> scratch;
+    expandMatrixLanes<Lanes>(mat, rho, scratch);
+}
+
+template <size_t Lanes>
+void expandMatrixWithScratch(polyvecl mat[K], const uint8_t rho[SEEDBYTES]) {
+    if (ScratchArena::mode() == DilithiumScratch::Arena) {
+        // A is derived from the public ρ
+        ScratchArena& arena = ScratchArena::local();
+        ScratchArena::Scope scope(arena, false);
+        UniformScratch<Lanes>* scratch = arena.create<UniformScratch<Lanes>>();
+        if (scratch) {
+            expandMatrixLanes<Lanes>(mat, rho, *scratch);
+            return;
+        }
+    }
+    expandMatrixOnStack<Lanes>(mat, rho);
+}
+
+/**
+ * @brief Â = ExpandA(ρ), multi-lane when enabled
+ */
+void expandMatrix(polyvecl mat[K], const uint8_t rho[SEEDBYTES]) {
+    if (!keccakLanesEnabled()) {
+        polyvec_matrix_expand(mat, rho);
+    } else if (keccakPreferredLanes() >= 8) {
+        expandMatrixWithScratch<8>(mat, rho);
+    } else {
+        expandMatrixWithScratch<4>(mat, rho);
+    }
+}
+
+/**
+ * @brief hashMu() of Lanes messages at once
+ *
+ * The common prefix of the messages is absorbed in lockstep; a lane with a
+ * longer message continues on its own from extractLane().
+ */
+template <size_t Lanes>
+void hashMuLanes(uint8_t* mu, const uint8_t* tr, const uint8_t* const messages[Lanes],
+                    const size_t messageLengths[Lanes]) {
+    const uint8_t pre[2] = {0, 0};
+    const uint8_t* in[Lanes];
+    uint8_t* out[Lanes];
+    KeccakLanes<Lanes> sponge;
+
+    size_t common = messageLengths[0];
+    for (size_t lane = 0; lane < Lanes; ++lane) {
+        common = std::min(common, messageLengths[lane]);
+        out[lane] = mu + lane * CRHBYTES;
+    }
+
+    for (size_t lane = 0; lane < Lanes; ++lane) {
+        in[lane] = tr;
+    }
+    sponge.absorb(in, TRBYTES, SHAKE256_RATE);
+    for (size_t lane = 0; lane < Lanes; ++lane) {
+        in[lane] = pre;
+    }
+    sponge.absorb(in, sizeof(pre), SHAKE256_RATE);
+    sponge.absorb(messages, common, SHAKE256_RATE);
+
+    if (std::all_of(messageLengths, messageLengths + Lanes,
+                    [common](size_t length) { return length == common; })) {
+        sponge.finalize(KeccakLanes<Lanes>::SHAKE_SUFFIX, SHAKE256_RATE);
+        sponge.squeeze(out, CRHBYTES, SHAKE256_RATE);
+        return;
+    }
+
+    for (size_t lane = 0; lane < Lanes; ++lane) {
+        keccak_state state;
+        sponge.extractLane(lane, state.s);
+        state.pos = sponge.position();
+        shake256_absorb(&state, messages[lane] + common, messageLengths[lane] - common);
+        shake256_finalize(&state);
+        shake256_squeeze(out[lane], CRHBYTES, &state);
+    }
+}
+
+// Public key material of one verification; mat, t1 and packedT1 may be null
+// as described for PreparedPublicKey::State
+struct VerifyKey {
+    const uint8_t* rho;
+    const polyvecl* mat;
+    const polyveck* t1;
+    const uint8_t* packedT1;
+};
+
+struct VerifyScratch {
+    polyvecl z;
+    polyveck w1, h, ct1, t1;
+    poly cp, a, t;
+};
+
+/**
+ * @brief Verification core of the reference verify(), starting from μ
+ */
+bool verifyCore(const VerifyKey& key, const uint8_t* mu, const uint8_t* signature,
+                VerifyScratch& scratch) {
+    uint8_t buf[K * POLYW1_PACKEDBYTES];
+    uint8_t c[CTILDEBYTES];
+    uint8_t c2[CTILDEBYTES];
+    polyvecl& z = scratch.z;
+    polyveck& w1 = scratch.w1;
+    polyveck& h = scratch.h;
+    polyveck& ct1 = scratch.ct1;
+    poly& cp = scratch.cp;
+    keccak_state state;
+
+    if (unpack_sig(c, &z, &h, signature)) {
+        return false;
+    }
+    if (polyvecl_chknorm(&z, GAMMA1 - BETA)) {
+        return false;
+    }
+
+    // w'1 = UseHint(h, Az - c·2^d·t1)
+    poly_challenge(&cp, c);
+    poly_ntt(&cp);
+
+    polyvecl_ntt(&z);
+    if (key.mat) {
+        polyvec_matrix_pointwise_montgomery(&w1, key.mat, &z);
+    } else {
+        // Row i of A·z as in polyvecl_pointwise_acc_montgomery(), with each
+        // A[i][j] sampled right before its product
+        for (unsigned int i = 0; i < K; ++i) {
+            for (unsigned int j = 0; j < L; ++j) {
+                poly_uniform(&scratch.a, key.rho, static_cast<uint16_t>((i << 8) + j));
+                if (j == 0) {
+                    poly_pointwise_montgomery(&w1.vec[i], &scratch.a, &z.vec[j]);
+                } else {
+                    poly_pointwise_montgomery(&scratch.t, &scratch.a, &z.vec[j]);
+                    poly_add(&w1.vec[i], &w1.vec[i], &scratch.t);
+                }
+            }
+        }
+    }
+
+    if (key.t1) {
+        polyveck_pointwise_poly_montgomery(&ct1, &cp, key.t1);
+    } else {
+        for (unsigned int i = 0; i < K; ++i) {
+            polyt1_unpack(&scratch.t1.vec[i], key.packedT1 + i * POLYT1_PACKEDBYTES);
+        }
+        polyveck_shiftl(&scratch.t1);
+        polyveck_ntt(&scratch.t1);
+        polyveck_pointwise_poly_montgomery(&ct1, &cp, &scratch.t1);
+    }
+
+    polyveck_sub(&w1, &w1, &ct1);
+    polyveck_reduce(&w1);
+    polyveck_invntt_tomont(&w1);
+
+    polyveck_caddq(&w1);
+    polyveck_use_hint(&w1, &w1, &h);
+    polyveck_pack_w1(buf, &w1);
+
+    // Accept iff c̃ = H(μ || w'1)
+    shake256_init(&state);
+    shake256_absorb(&state, mu, CRHBYTES);
+    shake256_absorb(&state, buf, K * POLYW1_PACKEDBYTES);
+    shake256_finalize(&state);
+    shake256_squeeze(c2, CTILDEBYTES, &state);
+
+    return std::memcmp(c, c2, CTILDEBYTES) == 0;
+}
+
+SCRATCH_NOINLINE bool verifyOnStack(const VerifyKey& key, const uint8_t* mu,
+                                    const uint8_t* signature) {
+    VerifyScratch scratch;
+    return verifyCore(key, mu, signature, scratch);
+}
+
+bool verifyWithScratch(const VerifyKey& key, const uint8_t* mu, const uint8_t* signature) {
+    if (ScratchArena::mode() == DilithiumScratch::Arena) {
+        // Verification handles public data only
+        ScratchArena& arena = ScratchArena::local();
+        ScratchArena::Scope scope(arena, false);
+        VerifyScratch* scratch = arena.create<VerifyScratch>();
+        if (scratch) {
+            return verifyCore(key, mu, signature, *scratch);
+        }
+    }
+    return verifyOnStack(key, mu, signature);
+}
+
+// Expanded secret key material of one signature
+struct SignKey {
+    const polyvecl* mat;
+    const polyvecl* s1;
+    const polyveck* s2;
+    const polyveck* t0;
+    const uint8_t* key;
+};
+
+struct SignScratch {
+    polyvecl y, z;
+    polyveck w1, w0, h;
+    poly cp;
+};
+
+/**
+ * @brief Rejection loop of the reference signature(), starting from μ
+ */
+void signCore(const SignKey& key, const uint8_t* mu, uint8_t* signature, SignScratch& scratch) {
+    SIGN_SCOPE(total);
+    uint8_t rnd[RNDBYTES] = {0};
+    uint8_t rhoprime[CRHBYTES];
+    uint16_t nonce = 0;
+    unsigned int n;
+    polyvecl& y = scratch.y;
+    polyvecl& z = scratch.z;
+    polyveck& w1 = scratch.w1;
+    polyveck& w0 = scratch.w0;
+    polyveck& h = scratch.h;
+    poly& cp = scratch.cp;
+    keccak_state state;
+
+#ifdef DILITHIUM_RANDOMIZED_SIGNING
+    randombytes(rnd, RNDBYTES);
+#endif
+
+    // ρ' = CRH(K || rnd || μ)
+    SIGN_PHASE(shake,
+        shake256_init(&state);
+        shake256_absorb(&state, key.key, SEEDBYTES);
+        shake256_absorb(&state, rnd, RNDBYTES);
+        shake256_absorb(&state, mu, CRHBYTES);
+        shake256_finalize(&state);
+        shake256_squeeze(rhoprime, CRHBYTES, &state));
+
+    // nonce also counts the passes through the loop
+    for (;;) {
+        // Sample intermediate vector y and compute w = Ay
+        SIGN_PHASE(sampling, polyvecl_uniform_gamma1(&y, rhoprime, nonce++));
+
+        z = y;
+        SIGN_PHASE(ntt, polyvecl_ntt(&z));
+        SIGN_PHASE(pointwise, polyvec_matrix_pointwise_montgomery(&w1, key.mat, &z));
+        polyveck_reduce(&w1);
+        SIGN_PHASE(invntt, polyveck_invntt_tomont(&w1));
+
+        // Decompose w and call the random oracle
+        polyveck_caddq(&w1);
+        polyveck_decompose(&w1, &w0, &w1);
+        SIGN_PHASE(packing, polyveck_pack_w1(signature, &w1));
+
+        SIGN_PHASE(shake,
+            shake256_init(&state);
+            shake256_absorb(&state, mu, CRHBYTES);
+            shake256_absorb(&state, signature, K * POLYW1_PACKEDBYTES);
+            shake256_finalize(&state);
+            shake256_squeeze(signature, CTILDEBYTES, &state));
+        SIGN_PHASE(sampling, poly_challenge(&cp, signature));
+        SIGN_PHASE(ntt, poly_ntt(&cp));
+
+        // z = y + c·s1, reject if it reveals the secret
+        SIGN_PHASE(pointwise, polyvecl_pointwise_poly_montgomery(&z, &cp, key.s1));
+        SIGN_PHASE(invntt, polyvecl_invntt_tomont(&z));
+        polyvecl_add(&z, &z, &y);
+        polyvecl_reduce(&z);
+        if (polyvecl_chknorm(&z, GAMMA1 - BETA)) {
+            SIGN_COUNT(++signStats().rejectedZ);
+            continue;
+        }
+
+        // Subtracting c·s2 must not change the high bits of w
+        SIGN_PHASE(pointwise, polyveck_pointwise_poly_montgomery(&h, &cp, key.s2));
+        SIGN_PHASE(invntt, polyveck_invntt_tomont(&h));
+        polyveck_sub(&w0, &w0, &h);
+        polyveck_reduce(&w0);
+        if (polyveck_chknorm(&w0, GAMMA2 - BETA)) {
+            SIGN_COUNT(++signStats().rejectedLowBits);
+            continue;
+        }
+
+        // Compute hints for w1
+        SIGN_PHASE(pointwise, polyveck_pointwise_poly_montgomery(&h, &cp, key.t0));
+        SIGN_PHASE(invntt, polyveck_invntt_tomont(&h));
+        polyveck_reduce(&h);
+        if (polyveck_chknorm(&h, GAMMA2)) {
+            SIGN_COUNT(++signStats().rejectedCt0);
+            continue;
+        }
+
+        polyveck_add(&w0, &w0, &h);
+        n = polyveck_make_hint(&h, &w0, &w1);
+        if (n > OMEGA) {
+            SIGN_COUNT(++signStats().rejectedHints);
+            continue;
+        }
+        break;
+    }
+
+    SIGN_PHASE(packing, pack_sig(signature, signature, &z, &h));
+    SIGN_COUNT(recordSignature(nonce));
+
+    secureWipe(rhoprime, sizeof(rhoprime));
+    secureWipe(&y, sizeof(y));
+}
+
+SCRATCH_NOINLINE void signOnStack(const SignKey& key, const uint8_t* mu, uint8_t* signature) {
+    SignScratch scratch;
+    signCore(key, mu, signature, scratch);
+}
+
+// The arena scope wipes the scratch on release
+void signWithScratch(const SignKey& key, const uint8_t* mu, uint8_t* signature) {
+    if (ScratchArena::mode() == DilithiumScratch::Arena) {
+        ScratchArena& arena = ScratchArena::local();
+        ScratchArena::Scope scope(arena);
+        SignScratch* scratch = arena.create<SignScratch>();
+        if (scratch) {
+            signCore(key, mu, signature, *scratch);
+            return;
+        }
+    }
+    signOnStack(key, mu, signature);
+}
+
+} // namespace
+
+/**
+ * @brief Prepared public key state
+ *
+ * Only the parts the memory mode keeps are allocated: the matrix (Full),
+ * t̂1 (Full, RowStreaming) or packed t1 (None). The matrix is one block so
+ * that the row-major walk in polyvec_matrix_pointwise_montgomery() streams
+ * through contiguous memory.
+ */
+template <int Mode>
+struct PreparedPublicKey<Mode>::State {
+    DilithiumKeyMemory memory;
+    std::unique_ptr<ExpandedMatrix> mat;        // Owned parts, all null when attached
+    std::unique_ptr<ExpandedT1> t1;
+    std::unique_ptr<PackedT1> packedT1;
+    const polyvecl* matRows = nullptr;          // Parts in use: owned or in the attached blob
+    const polyveck* t1Vector = nullptr;
+    const uint8_t* packedT1Bytes = nullptr;
+    bool attached = false;
+    uint8_t rho[SEEDBYTES];     // Seed of A
+    uint8_t tr[TRBYTES];        // H(pk)
+
+    State() = default;
+
+    State(const State& other)
+        : memory(other.memory), mat(clonePart(other.mat)), t1(clonePart(other.t1)),
+          packedT1(clonePart(other.packedT1)), matRows(other.matRows),
+          t1Vector(other.t1Vector), packedT1Bytes(other.packedT1Bytes),
+          attached(other.attached) {
+        std::memcpy(rho, other.rho, sizeof(rho));
+        std::memcpy(tr, other.tr, sizeof(tr));
+        if (!attached) {
+            useOwnedParts();
+        }
+    }
+
+    void useOwnedParts() {
+        matRows = mat ? mat->rows : nullptr;
+        t1Vector = t1 ? &t1->t1 : nullptr;
+        packedT1Bytes = packedT1 ? packedT1->bytes : nullptr;
+    }
+};
+
+template <int Mode>
+PreparedPublicKey<Mode>::PreparedPublicKey() = default;
+
+template <int Mode>
+PreparedPublicKey<Mode>::~PreparedPublicKey() = default;
+
+template <int Mode>
+PreparedPublicKey<Mode>::PreparedPublicKey(const PreparedPublicKey& other)
+    : state_(other.state_ ? new State(*other.state_) : nullptr) {
+}
+
+template <int Mode>
+PreparedPublicKey<Mode>& PreparedPublicKey<Mode>::operator=(const PreparedPublicKey& other) {
+    if (this != &other) {
+        state_.reset(other.state_ ? new State(*other.state_) : nullptr);
+    }
+    return *this;
+}
+
+template <int Mode>
+PreparedPublicKey<Mode>::PreparedPublicKey(PreparedPublicKey&& other) noexcept = default;
+
+template <int Mode>
+PreparedPublicKey<Mode>& PreparedPublicKey<Mode>::operator=(PreparedPublicKey&& other) noexcept = default;
+
+/**
+ * @brief Unpack pk and precompute everything that does not depend on σ or M
+ *
+ * 1. (ρ, t1) = unpack(pk)
+ * 2. tr = H(pk)
+ * 3. Â = ExpandA(ρ)            (already NTT domain; Full only)
+ * 4. t̂1 = NTT(2^d · t1)        (Full and RowStreaming)
+ */
+template <int Mode>
+bool PreparedPublicKey<Mode>::load(const uint8_t* publicKey, size_t length,
+                                   DilithiumKeyMemory memory) {
+    if (!publicKey || length != CRYPTO_PUBLICKEYBYTES) {
+        return false;
+    }
+
+    std::unique_ptr<State> state(new State);
+    state->memory = memory;
+    std::memcpy(state->rho, publicKey, SEEDBYTES);
+    shake256(state->tr, TRBYTES, publicKey, CRYPTO_PUBLICKEYBYTES);
+
+    if (memory == DilithiumKeyMemory::None) {
+        state->packedT1.reset(new PackedT1);
+        std::memcpy(state->packedT1->bytes, publicKey + SEEDBYTES, sizeof(PackedT1::bytes));
+    } else {
+        state->t1.reset(new ExpandedT1);
+        unpack_pk(state->rho, &state->t1->t1, publicKey);
+        polyveck_shiftl(&state->t1->t1);
+        polyveck_ntt(&state->t1->t1);
+    }
+
+    if (memory == DilithiumKeyMemory::Full) {
+        state->mat.reset(new ExpandedMatrix);
+        expandMatrix(state->mat->rows, state->rho);
+    }
+
+    state->useOwnedParts();
+    state_ = std::move(state);
+    return true;
+}
+
+/**
+ * @brief Verify σ against M using the cached Â, t̂1 and tr
+ *
+ * Uses an empty context string, i.e. M' = (0, 0, M), which matches
+ * crypto_sign_verify(..., nullptr, 0, pk) of the reference library.
+ */
+template <int Mode>
+bool PreparedPublicKey<Mode>::verify(const uint8_t* message, size_t messageLength,
+                               const uint8_t* signature, size_t signatureLength) const {
+    if (!state_ || !signature || signatureLength != CRYPTO_BYTES) {
+        return false;
+    }
+
+    uint8_t mu[CRHBYTES];
+    hashMu(mu, state_->tr, message, messageLength);
+    return verifyMu(mu, signature, signatureLength);
+}
+
+/**
+ * @brief μ of many messages, KeccakLanes at a time
+ *
+ * With 8 preferred lanes a remainder of 4 or more still goes through the
+ * 4-lane sponge; the rest is hashed one message at a time.
+ */
+template <int Mode>
+bool PreparedPublicKey<Mode>::computeMu(const uint8_t* const messages[],
+                                        const size_t messageLengths[], size_t count,
+                                        uint8_t* mu) const {
+    if (!state_ || !mu || (count > 0 && (!messages || !messageLengths))) {
+        return false;
+    }
+
+    size_t done = 0;
+    if (keccakLanesEnabled()) {
+        if (keccakPreferredLanes() >= 8) {
+            for (; count - done >= 8; done += 8) {
+                hashMuLanes<8>(mu + done * CRHBYTES, state_->tr, messages + done,
+                               messageLengths + done);
+            }
+        }
+        for (; count - done >= 4; done += 4) {
+            hashMuLanes<4>(mu + done * CRHBYTES, state_->tr, messages + done,
+                           messageLengths + done);
+        }
+    }
+    for (; done < count; ++done) {
+        hashMu(mu + done * CRHBYTES, state_->tr, messages[done], messageLengths[done]);
+    }
+    return true;
+}
+
+template <int Mode>
+bool PreparedPublicKey<Mode>::verifyMu(const uint8_t* mu, const uint8_t* signature,
+                                       size_t signatureLength) const {
+    if (!state_ || !mu || !signature || signatureLength != CRYPTO_BYTES) {
+        return false;
+    }
+
+    const VerifyKey key = {state_->rho, state_->matRows, state_->t1Vector, state_->packedT1Bytes};
+    return verifyWithScratch(key, mu, signature);
+}
+
+/**
+ * @brief Verify straight from the packed key, like DilithiumKeyMemory::None
+ *
+ * ρ and the packed t1 are read in place, so apart from the scratch this
+ * needs no memory at all.
+ */
+template <int Mode>
+bool PreparedPublicKey<Mode>::verifyPacked(const uint8_t* publicKey, size_t publicKeyLength,
+                                           const uint8_t* message, size_t messageLength,
+                                           const uint8_t* signature, size_t signatureLength) {
+    if (!publicKey || publicKeyLength != CRYPTO_PUBLICKEYBYTES
+        || !signature || signatureLength != CRYPTO_BYTES) {
+        return false;
+    }
+
+    uint8_t tr[TRBYTES];
+    uint8_t mu[CRHBYTES];
+    shake256(tr, TRBYTES, publicKey, CRYPTO_PUBLICKEYBYTES);
+    hashMu(mu, tr, message, messageLength);
+
+    const VerifyKey key = {publicKey, nullptr, nullptr, publicKey + SEEDBYTES};
+    return verifyWithScratch(key, mu, signature);
+}
+
+template <int Mode>
+size_t PreparedPublicKey<Mode>::serializedBytes(DilithiumKeyMemory memory) {
+    return publicBlobBytes(memory);
+}
+
+template <int Mode>
+bool PreparedPublicKey<Mode>::serialize(uint8_t* out, size_t length) const {
+    if (!state_ || !out) {
+        return false;
+    }
+    const DilithiumKeyMemory memory = state_->memory;
+    const size_t bytes = serializedBytes(memory);
+    if (length < bytes) {
+        return false;
+    }
+
+    writeBlobHeader(out, BLOB_PUBLIC, memoryCode(memory), bytes);
+    uint8_t* seeds = out + BLOB_HEADER_BYTES;
+    std::memset(seeds, 0, BLOB_SEEDS_BYTES);
+    std::memcpy(seeds, state_->rho, SEEDBYTES);
+    std::memcpy(seeds + SEEDBYTES, state_->tr, TRBYTES);
+
+    uint8_t* t1 = out + BLOB_T1_OFFSET;
+    if (memory == DilithiumKeyMemory::None) {
+        std::memset(t1, 0, publicT1Bytes(memory));
+        std::memcpy(t1, state_->packedT1Bytes, sizeof(PackedT1::bytes));
+    } else {
+        std::memcpy(t1, state_->t1Vector, sizeof(polyveck));
+    }
+    if (memory == DilithiumKeyMemory::Full) {
+        std::memcpy(t1 + publicT1Bytes(memory), state_->matRows, sizeof(ExpandedMatrix));
+    }
+    return true;
+}
+
+template <int Mode>
+std::vector<uint8_t> PreparedPublicKey<Mode>::serialize() const {
+    if (!state_) {
+        return {};
+    }
+    try {
+        std::vector<uint8_t> blob(serializedBytes(state_->memory));
+        serialize(blob.data(), blob.size());
+        return blob;
+    } catch (...) {
+        return {};
+    }
+}
+
+template <int Mode>
+bool PreparedPublicKey<Mode>::deserialize(const uint8_t* blob, size_t length) {
+    PublicBlob parsed;
+    if (!parsePublicBlob(blob, length, parsed)) {
+        return false;
+    }
+
+    std::unique_ptr<State> state(new State);
+    state->memory = parsed.memory;
+    std::memcpy(state->rho, parsed.rho, SEEDBYTES);
+    std::memcpy(state->tr, parsed.tr, TRBYTES);
+    if (parsed.memory == DilithiumKeyMemory::None) {
+        state->packedT1.reset(new PackedT1);
+        std::memcpy(state->packedT1->bytes, parsed.t1, sizeof(PackedT1::bytes));
+    } else {
+        state->t1.reset(new ExpandedT1);
+        std::memcpy(&state->t1->t1, parsed.t1, sizeof(polyveck));
+    }
+    if (parsed.mat) {
+        state->mat.reset(new ExpandedMatrix);
+        std::memcpy(state->mat->rows, parsed.mat, sizeof(ExpandedMatrix));
+    }
+
+    state->useOwnedParts();
+    state_ = std::move(state);
+    return true;
+}
+
+/**
+ * @brief Point the key at the sections of the blob
+ *
+ * Only the header is read here; t̂1 and Â are first touched by verification,
+ * so for a mapped file the cost of a key moves to its first page faults.
+ */
+template <int Mode>
+bool PreparedPublicKey<Mode>::attach(const uint8_t* blob, size_t length) {
+    PublicBlob parsed;
+    if (reinterpret_cast<uintptr_t>(blob) % DILITHIUM_PREPARED_ALIGNMENT != 0
+        || !parsePublicBlob(blob, length, parsed)) {
+        return false;
+    }
+
+    std::unique_ptr<State> state(new State);
+    state->memory = parsed.memory;
+    state->attached = true;
+    std::memcpy(state->rho, parsed.rho, SEEDBYTES);
+    std::memcpy(state->tr, parsed.tr, TRBYTES);
+    if (parsed.memory == DilithiumKeyMemory::None) {
+        state->packedT1Bytes = parsed.t1;
+    } else {
+        state->t1Vector = reinterpret_cast<const polyveck*>(parsed.t1);
+    }
+    state->matRows = reinterpret_cast<const polyvecl*>(parsed.mat);
+
+    state_ = std::move(state);
+    return true;
+}
+
+template <int Mode>
+bool PreparedPublicKey<Mode>::isAttached() const {
+    return state_ && state_->attached;
+}
+
+template <int Mode>
+const uint8_t* PreparedPublicKey<Mode>::tr() const {
+    return state_ ? state_->tr : nullptr;
+}
+
+template <int Mode>
+void PreparedPublicKey<Mode>::clear() {
+    state_.reset();
+}
+
+template <int Mode>
+DilithiumKeyMemory PreparedPublicKey<Mode>::memory() const {
+    return state_ ? state_->memory : DilithiumKeyMemory::Full;
+}
+
+template <int Mode>
+size_t PreparedPublicKey<Mode>::memoryBytes(DilithiumKeyMemory memory) {
+    switch (memory) {
+        case DilithiumKeyMemory::Full:
+            return sizeof(State) + sizeof(ExpandedMatrix) + sizeof(ExpandedT1);
+        case DilithiumKeyMemory::RowStreaming:
+            return sizeof(State) + sizeof(ExpandedT1);
+        case DilithiumKeyMemory::None:
+            return sizeof(State) + sizeof(PackedT1);
+    }
+    return sizeof(State);
+}
+
+template <int Mode>
+const char* PreparedPublicKey<Mode>::memoryName(DilithiumKeyMemory memory) {
+    switch (memory) {
+        case DilithiumKeyMemory::Full:         return "full";
+        case DilithiumKeyMemory::RowStreaming: return "row-streaming";
+        case DilithiumKeyMemory::None:         return "none";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief Expanded secret key state, one aligned block
+ *
+ * The matrix and the three NTT-domain vectors are contiguous so that the
+ * whole working set of the rejection loop is a single ~45 KB region.
+ */
+template <int Mode>
+struct alignas(64) PreparedSigningKey<Mode>::State {
+    polyvecl mat[K];            // A in NTT domain
+    polyvecl s1;                // ŝ1
+    polyveck s2;                // ŝ2
+    polyveck t0;                // t̂0
+    uint8_t rho[SEEDBYTES];     // Seed of A
+    uint8_t key[SEEDBYTES];     // K, seed for the masking vector
+    uint8_t tr[TRBYTES];        // H(pk)
+};
+
+template <int Mode>
+PreparedSigningKey<Mode>::PreparedSigningKey() = default;
+
+template <int Mode>
+PreparedSigningKey<Mode>::~PreparedSigningKey() = default;
+
+template <int Mode>
+PreparedSigningKey<Mode>::PreparedSigningKey(PreparedSigningKey&& other) noexcept = default;
+
+template <int Mode>
+PreparedSigningKey<Mode>& PreparedSigningKey<Mode>::operator=(PreparedSigningKey&& other) noexcept = default;
+
+/**
+ * @brief Unpack sk and precompute everything that does not depend on M
+ *
+ * 1. (ρ, K, tr, s1, s2, t0) = unpack(sk)
+ * 2. Â = ExpandA(ρ)
+ * 3. ŝ1 = NTT(s1), ŝ2 = NTT(s2), t̂0 = NTT(t0)
+ */
+template <int Mode>
+bool PreparedSigningKey<Mode>::load(const uint8_t* secretKey, size_t length) {
+    if (!secretKey || length != CRYPTO_SECRETKEYBYTES) {
+        return false;
+    }
+
+    SIGN_SCOPE(total);
+    SecureBox<State> state = SecureBox<State>::create();
+    if (!state) {
+        return false;
+    }
+    unpack(*state, secretKey);
+    state_ = std::move(state);
+    return true;
+}
+
+template <int Mode>
+void PreparedSigningKey<Mode>::unpack(State& state, const uint8_t* secretKey) {
+    SIGN_PHASE(packing, unpack_sk(state.rho, state.tr, state.key,
+                                  &state.t0, &state.s1, &state.s2, secretKey));
+
+    SIGN_PHASE(expandMatrix, expandMatrix(state.mat, state.rho));
+    SIGN_PHASE(ntt,
+        polyvecl_ntt(&state.s1);
+        polyveck_ntt(&state.s2);
+        polyveck_ntt(&state.t0));
+}
+
+/**
+ * @brief Fiat-Shamir with Aborts using the cached Â, ŝ1, ŝ2, t̂0
+ *
+ * Uses an empty context string and, like the reference library, a zero rnd
+ * (deterministic signing) unless DILITHIUM_RANDOMIZED_SIGNING is defined.
+ */
+template <int Mode>
+bool PreparedSigningKey<Mode>::sign(const uint8_t* message, size_t messageLength,
+                              uint8_t* signature, size_t* signatureLength) const {
+    if (!state_ || !signature) {
+        return false;
+    }
+
+    uint8_t mu[CRHBYTES];
+
+    // signMu() times itself
+    {
+        SIGN_SCOPE(total);
+        SIGN_PHASE(shake, hashMu(mu, state_->tr, message, messageLength));
+    }
+
+    return signMu(mu, signature, signatureLength);
+}
+
+template <int Mode>
+bool PreparedSigningKey<Mode>::signMu(const uint8_t* mu, uint8_t* signature,
+                                      size_t* signatureLength) const {
+    if (!state_ || !mu || !signature) {
+        return false;
+    }
+
+    const SignKey key = {state_->mat, &state_->s1, &state_->s2, &state_->t0, state_->key};
+    signWithScratch(key, mu, signature);
+    if (signatureLength) {
+        *signatureLength = CRYPTO_BYTES;
+    }
+    return true;
+}
+
+/**
+ * @brief load() and sign() with the expanded key in the thread's arena
+ *
+ * The State is built in the arena whatever the scratch mode and wiped when
+ * the scope ends, so one call costs an ExpandA like the reference sign().
+ */
+template <int Mode>
+bool PreparedSigningKey<Mode>::signPacked(const uint8_t* secretKey, size_t secretKeyLength,
+                                          const uint8_t* message, size_t messageLength,
+                                          uint8_t* signature, size_t* signatureLength) {
+    if (!secretKey || secretKeyLength != CRYPTO_SECRETKEYBYTES || !signature) {
+        return false;
+    }
+
+    ScratchArena& arena = ScratchArena::local();
+    ScratchArena::Scope scope(arena);
+    // The unpacked key is as secret as a prepared one: with pool storage it
+    // goes into a locked pool slot like load() puts it, not the arena
+    SecureBox<State> pooled;
+    if (SecureKeyPool::storage() == DilithiumKeyStorage::SecurePool) {
+        pooled = SecureBox<State>::create();
+    }
+    State* state = pooled ? pooled.get() : arena.create<State>();
+    if (!state) {
+        return false;
+    }
+
+    uint8_t mu[CRHBYTES];
+    {
+        SIGN_SCOPE(total);
+        unpack(*state, secretKey);
+        SIGN_PHASE(shake, hashMu(mu, state->tr, message, messageLength));
+    }
+
+    const SignKey key = {state->mat, &state->s1, &state->s2, &state->t0, state->key};
+    signWithScratch(key, mu, signature);
+    if (signatureLength) {
+        *signatureLength = CRYPTO_BYTES;
+    }
+    return true;
+}
+
+template <int Mode>
+size_t PreparedSigningKey<Mode>::serializedBytes() {
+    static_assert(sizeof(State) % DILITHIUM_PREPARED_ALIGNMENT == 0,
+                  "the signing key block must keep the blob aligned");
+    return BLOB_HEADER_BYTES + sizeof(State);
+}
+
+template <int Mode>
+bool PreparedSigningKey<Mode>::serialize(uint8_t* out, size_t length) const {
+    if (!state_ || !out || length < serializedBytes()) {
+        return false;
+    }
+    writeBlobHeader(out, BLOB_SIGNING, 0, serializedBytes());
+    std::memcpy(out + BLOB_HEADER_BYTES, state_.get(), sizeof(State));
+    return true;
+}
+
+template <int Mode>
+bool PreparedSigningKey<Mode>::deserialize(const uint8_t* blob, size_t length) {
+    uint32_t memory = 0;
+    if (!readBlobHeader(blob, length, BLOB_SIGNING, memory) || memory != 0
+        || length != serializedBytes()) {
+        return false;
+    }
+
+    SecureBox<State> state = SecureBox<State>::create();
+    if (!state) {
+        return false;
+    }
+    std::memcpy(state.get(), blob + BLOB_HEADER_BYTES, sizeof(State));
+    state_ = std::move(state);
+    return true;
+}
+
+template <int Mode>
+const uint8_t* PreparedSigningKey<Mode>::tr() const {
+    return state_ ? state_->tr : nullptr;
+}
+
+template <int Mode>
+void PreparedSigningKey<Mode>::clear() {
+    state_.reset();
+}
+
+template <int Mode>
+SecureKeyPool::Stats PreparedSigningKey<Mode>::poolStats() {
+    return securePoolFor<State>().stats();
+}
+
+template <int Mode>
+DilithiumSignStats PreparedSigningKey<Mode>::threadStats() {
+#ifdef DILITHIUM_INSTRUMENTATION
+    return signStats();
+#else
+    return DilithiumSignStats{};
+#endif
+}
+
+template <int Mode>
+void PreparedSigningKey<Mode>::resetThreadStats() {
+#ifdef DILITHIUM_INSTRUMENTATION
+    signStats() = DilithiumSignStats{};
+#endif
+}
+
+template class PreparedPublicKey<DILITHIUM_MODE>;
+template class PreparedSigningKey<DILITHIUM_MODE>;
@@ -0,0 +1,428 @@
+/**
+ * @file PreparedKeys.hpp
+ * @brief Pre-expanded Dilithium key material for repeated sign/verify calls
+ *
+ * The reference implementation works on packed keys: every call to
+ * pqcrystals_dilithium3_ref_verify() unpacks t1, hashes the public key into
+ * tr and expands the matrix A from ρ with SHAKE-128 before doing any work on
+ * the signature itself. Matrix expansion alone is the largest single cost of
+ * verification. A prepared key performs this work once and keeps the result
+ * in NTT form so it can be reused for any number of signatures.
+ *
+ * Prepared public key contents (DilithiumKeyMemory::Full):
+ * - A ∈ R_q^{k×l} in NTT domain (Dilithium3: k=6, l=5 → 30 polynomials, ~30 KB)
+ * - 2^d · t1 in NTT domain
+ * - tr = H(pk), used as the prefix of μ = H(tr || M')
+ *
+ * The RowStreaming and None memory modes keep ρ instead of A (and None also
+ * keeps t1 packed) and regenerate the rest during verification, trading
+ * CPU time for a smaller footprint when many keys are held at once.
+ *
+ * Prepared signing key contents:
+ * - A in NTT domain, as above
+ * - s1, s2 and t0 in NTT domain
+ * - ρ, K and tr from the packed secret key
+ *
+ * Both kinds of prepared key serialize to a versioned blob whose polynomials
+ * are stored exactly as in memory (native int32 coefficients, NTT domain), in
+ * 64-byte aligned sections:
+ *
+ * | Offset | Size | Contents                                                |
+ * |--------|------|---------------------------------------------------------|
+ * | 0      | 64   | Header: magic "DLTHPREP", u32 version, u32 mode, u32   |
+ * |        |      | kind (1 public, 2 signing), u32 memory mode, u32 byte  |
+ * |        |      | order mark (native), u32 sizeof(poly), u64 blob bytes  |
+ * | 64     | ...  | Public: ρ and tr (128 bytes), then t̂1 or packed t1,     |
+ * |        |      | then Â (Full only). Signing: the expanded State block. |
+ *
+ * The header is little-endian; the byte order mark rejects blobs written on
+ * a machine of the other endianness. A public blob can be attach()ed in
+ * place, so a verifier that maps a file of prepared keys (PreparedKeyFile)
+ * turns the ExpandA of each key into page faults on first use.
+ *
+ * signPacked() and verifyPacked() run the same loops on a packed key without
+ * a prepared object, for one-off operations with little stack; their
+ * temporaries come from the thread's ScratchArena (see ScratchArena.hpp).
+ *
+ * Both classes are templates over the Dilithium mode; their members are
+ * compiled once per mode in PreparedKeys.cpp and explicitly instantiated.
+ *
+ * @author Student Project - Cryptographic Systems Course
+ * @date December 2025
+ */
+
+#ifndef PREPARED_KEYS_HPP
+#define PREPARED_KEYS_HPP
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include "DilithiumParams.hpp"
+#include "SecureMemory.hpp"
+
+/// Version of the serialized prepared key format
+constexpr uint32_t DILITHIUM_PREPARED_FORMAT_VERSION = 1;
+
+/// Alignment of attached blobs and of every section inside a blob
+constexpr size_t DILITHIUM_PREPARED_ALIGNMENT = 64;
+
+/**
+ * @brief Public key unpacked and expanded once for repeated verification
+ *
+ * The internal state is opaque so that the reference implementation headers
+ * (which define single-letter macros such as N, K and L) stay out of the
+ * public interface.
+ *
+ * @tparam Mode Dilithium mode (2, 3 or 5)
+ */
+template <int Mode>
+class PreparedPublicKey {
+public:
+    /**
+     * @brief Constructor - creates an empty (invalid) prepared key
+     */
+    PreparedPublicKey();
+
+    /**
+     * @brief Destructor
+     */
+    ~PreparedPublicKey();
+
+    PreparedPublicKey(const PreparedPublicKey& other);
+    PreparedPublicKey& operator=(const PreparedPublicKey& other);
+    PreparedPublicKey(PreparedPublicKey&& other) noexcept;
+    PreparedPublicKey& operator=(PreparedPublicKey&& other) noexcept;
+
+    /**
+     * @brief Unpack a packed public key and expand its matrix A
+     * @param publicKey Packed public key bytes (pk = (ρ, t1))
+     * @param length Length of the public key in bytes
+     * @param memory How much of the expansion to keep
+     * @return true if successful, false if the key has the wrong size
+     */
+    bool load(const uint8_t* publicKey, size_t length,
+              DilithiumKeyMemory memory = DilithiumKeyMemory::Full);
+
+    /**
+     * @brief Unpack a packed public key and expand its matrix A
+     * @param publicKey Packed public key bytes
+     * @param memory How much of the expansion to keep
+     * @return true if successful
+     */
+    bool load(const std::vector<uint8_t>& publicKey,
+              DilithiumKeyMemory memory = DilithiumKeyMemory::Full) {
+        return load(publicKey.data(), publicKey.size(), memory);
+    }
+
+    /**
+     * @brief Verify a signature using the pre-expanded key material
+     * @param message Pointer to the message
+     * @param messageLength Message length in bytes
+     * @param signature Pointer to the signature
+     * @param signatureLength Signature length in bytes
+     * @return true if signature is valid, false otherwise
+     */
+    bool verify(const uint8_t* message, size_t messageLength,
+                const uint8_t* signature, size_t signatureLength) const;
+
+    /**
+     * @brief Verify a signature against an already computed μ
+     *
+     * Used by VerifyStream, which absorbs the message incrementally.
+     *
+     * @param mu Message representative μ = CRH(tr || M'), DILITHIUM_MU_BYTES bytes
+     * @param signature Pointer to the signature
+     * @param signatureLength Signature length in bytes
+     * @return true if signature is valid, false otherwise
+     */
+    bool verifyMu(const uint8_t* mu, const uint8_t* signature, size_t signatureLength) const;
+
+    /**
+     * @brief Compute μ = CRH(tr || 0 || 0 || M) for a batch of messages
+     *
+     * Hashes up to 8 messages per Keccak permutation (see KeccakLanes.hpp);
+     * equal message lengths let the lanes run together to the end.
+     *
+     * @param messages Message pointers
+     * @param messageLengths Message lengths in bytes
+     * @param count Number of messages
+     * @param mu Output, count * DILITHIUM_MU_BYTES bytes
+     * @return true if successful, false if no key is loaded
+     */
+    bool computeMu(const uint8_t* const messages[], const size_t messageLengths[],
+                   size_t count, uint8_t* mu) const;
+
+    /**
+     * @brief Verify a signature against a packed public key without preparing it
+     *
+     * Reads ρ and t1 in place and samples A row by row, so the call allocates
+     * nothing and, in DilithiumScratch::Arena mode, uses a few KB of stack.
+     *
+     * @param publicKey Packed public key bytes
+     * @param publicKeyLength Length of the public key in bytes
+     * @param message Pointer to the message
+     * @param messageLength Message length in bytes
+     * @param signature Pointer to the signature
+     * @param signatureLength Signature length in bytes
+     * @return true if signature is valid, false otherwise
+     */
+    static bool verifyPacked(const uint8_t* publicKey, size_t publicKeyLength,
+                             const uint8_t* message, size_t messageLength,
+                             const uint8_t* signature, size_t signatureLength);
+
+    /**
+     * @brief Size of the serialized form of a key with the given memory mode
+     */
+    static size_t serializedBytes(DilithiumKeyMemory memory = DilithiumKeyMemory::Full);
+
+    /**
+     * @brief Write the prepared state as a blob (see the file comment)
+     * @param out Output buffer
+     * @param length Size of out, at least serializedBytes(memory())
+     * @return true if written, false if no key is loaded or out is too small
+     */
+    bool serialize(uint8_t* out, size_t length) const;
+
+    /**
+     * @brief Write the prepared state as a blob
+     * @return The blob, or an empty vector if no key is loaded
+     */
+    std::vector<uint8_t> serialize() const;
+
+    /**
+     * @brief Load a serialized key by copying its sections
+     *
+     * Costs a few memcpy() calls instead of the SHAKE-128 expansion of A. The
+     * blob is trusted: only its header and size are checked, not that the
+     * polynomials belong to a real public key.
+     *
+     * @param blob Blob written by serialize() for this mode
+     * @param length Length of the blob in bytes
+     * @return true if the blob is a public key blob of this mode
+     */
+    bool deserialize(const uint8_t* blob, size_t length);
+
+    /**
+     * @brief Use a serialized key in place, without copying t̂1 and Â
+     *
+     * The key references the blob, which must be DILITHIUM_PREPARED_ALIGNMENT
+     * aligned and stay valid and unchanged until the key (and every copy of
+     * it) is cleared, reloaded or destroyed.
+     *
+     * @param blob Blob written by serialize() for this mode
+     * @param length Length of the blob in bytes
+     * @return true if attached, false if the blob is invalid or misaligned
+     */
+    bool attach(const uint8_t* blob, size_t length);
+
+    /**
+     * @brief True if the key references an attached blob
+     */
+    bool isAttached() const;
+
+    /**
+     * @brief Get tr = H(pk), the prefix of μ
+     * @return Pointer to DILITHIUM_MU_BYTES bytes, or nullptr if no key is loaded
+     */
+    const uint8_t* tr() const;
+
+    /**
+     * @brief Check if a key has been loaded
+     * @return true if the prepared key can be used
+     */
+    bool isValid() const { return state_ != nullptr; }
+
+    /**
+     * @brief Release the expanded key material
+     */
+    void clear();
+
+    /**
+     * @brief Memory mode the key was loaded with
+     */
+    DilithiumKeyMemory memory() const;
+
+    /**
+     * @brief Heap memory held by one key loaded with the given mode, in bytes
+     */
+    static size_t memoryBytes(DilithiumKeyMemory memory = DilithiumKeyMemory::Full);
+
+    /**
+     * @brief Get a short printable memory mode name ("full", "row-streaming", "none")
+     */
+    static const char* memoryName(DilithiumKeyMemory memory);
+
+private:
+    struct State;
+    std::unique_ptr<State> state_;
+};
+
+/**
+ * @brief Secret key unpacked and expanded once for repeated signing
+ *
+ * All expanded material lives in a single cache-line aligned block that is
+ * securely wiped when the key is cleared or destroyed. The block is a slot
+ * of the locked, guard-paged SecureKeyPool unless heap key storage is
+ * selected (see SecureMemory.hpp). The object is move-only so secret state
+ * is never duplicated implicitly.
+ *
+ * @tparam Mode Dilithium mode (2, 3 or 5)
+ */
+template <int Mode>
+class PreparedSigningKey {
+public:
+    /**
+     * @brief Constructor - creates an empty (invalid) prepared key
+     */
+    PreparedSigningKey();
+
+    /**
+     * @brief Destructor - securely wipes the expanded secret material
+     */
+    ~PreparedSigningKey();
+
+    PreparedSigningKey(const PreparedSigningKey&) = delete;
+    PreparedSigningKey& operator=(const PreparedSigningKey&) = delete;
+    PreparedSigningKey(PreparedSigningKey&& other) noexcept;
+    PreparedSigningKey& operator=(PreparedSigningKey&& other) noexcept;
+
+    /**
+     * @brief Unpack a packed secret key, expand A and transform s1, s2, t0
+     * @param secretKey Packed secret key bytes (sk = (ρ, K, tr, s1, s2, t0))
+     * @param length Length of the secret key in bytes
+     * @return true if successful, false if the key has the wrong size
+     */
+    bool load(const uint8_t* secretKey, size_t length);
+
+    /**
+     * @brief Unpack a packed secret key, expand A and transform s1, s2, t0
+     * @param secretKey Packed secret key bytes
+     * @return true if successful
+     */
+    bool load(const std::vector<uint8_t>& secretKey) {
+        return load(secretKey.data(), secretKey.size());
+    }
+
+    /**
+     * @brief Sign a message using the pre-expanded key material
+     * @param message Pointer to the message
+     * @param messageLength Message length in bytes
+     * @param signature Output buffer of at least the scheme's signature size
+     * @param signatureLength Receives the number of bytes written
+     * @return true if successful, false otherwise
+     */
+    bool sign(const uint8_t* message, size_t messageLength,
+              uint8_t* signature, size_t* signatureLength) const;
+
+    /**
+     * @brief Sign an already computed μ
+     *
+     * Used by SignStream, which absorbs the message incrementally.
+     *
+     * @param mu Message representative μ = CRH(tr || M'), DILITHIUM_MU_BYTES bytes
+     * @param signature Output buffer of at least the scheme's signature size
+     * @param signatureLength Receives the number of bytes written
+     * @return true if successful, false otherwise
+     */
+    bool signMu(const uint8_t* mu, uint8_t* signature, size_t* signatureLength) const;
+
+    /**
+     * @brief Sign with a packed secret key without preparing it
+     *
+     * The expanded key is built in the calling thread's ScratchArena and
+     * wiped afterwards; the output is identical to load() followed by sign().
+     *
+     * @param secretKey Packed secret key bytes
+     * @param secretKeyLength Length of the secret key in bytes
+     * @param message Pointer to the message
+     * @param messageLength Message length in bytes
+     * @param signature Output buffer of at least the scheme's signature size
+     * @param signatureLength Receives the number of bytes written
+     * @return true if successful, false otherwise
+     */
+    static bool signPacked(const uint8_t* secretKey, size_t secretKeyLength,
+                           const uint8_t* message, size_t messageLength,
+                           uint8_t* signature, size_t* signatureLength);
+
+    /**
+     * @brief Size of the serialized form of a signing key
+     */
+    static size_t serializedBytes();
+
+    /**
+     * @brief Write the expanded secret state as a blob (see the file comment)
+     *
+     * The blob is as secret as the packed key; the caller wipes it.
+     *
+     * @param out Output buffer
+     * @param length Size of out, at least serializedBytes()
+     * @return true if written, false if no key is loaded or out is too small
+     */
+    bool serialize(uint8_t* out, size_t length) const;
+
+    /**
+     * @brief Load a serialized signing key without ExpandA or NTTs
+     *
+     * Signing keys are always copied into the private wiped block, never
+     * attached: secret state should not live in shared file pages.
+     *
+     * @param blob Blob written by serialize() for this mode
+     * @param length Length of the blob in bytes
+     * @return true if the blob is a signing key blob of this mode
+     */
+    bool deserialize(const uint8_t* blob, size_t length);
+
+    /**
+     * @brief Get tr = H(pk), the prefix of μ
+     * @return Pointer to DILITHIUM_MU_BYTES bytes, or nullptr if no key is loaded
+     */
+    const uint8_t* tr() const;
+
+    /**
+     * @brief Check if a key has been loaded
+     * @return true if the prepared key can be used
+     */
+    bool isValid() const { return static_cast<bool>(state_); }
+
+    /**
+     * @brief Securely wipe and release the expanded key material
+     */
+    void clear();
+
+    /**
+     * @brief Memory use of the pool of expanded signing keys of this mode
+     *
+     * Covers keys loaded with KeyStorage::SecurePool selected.
+     */
+    static SecureKeyPool::Stats poolStats();
+
+    /**
+     * @brief Signing statistics of the calling thread for this mode
+     *
+     * Covers load(), sign() and signMu(). Always zero unless the library was
+     * built with DILITHIUM_INSTRUMENTATION.
+     */
+    static DilithiumSignStats threadStats();
+
+    /**
+     * @brief Zero the calling thread's signing statistics
+     */
+    static void resetThreadStats();
+
+private:
+    struct State;
+    SecureBox<State> state_;
+
+    static void unpack(State& state, const uint8_t* secretKey);
+};
+
+// Instantiated in PreparedKeys.cpp, once per separately compiled mode
+extern template class PreparedPublicKey<2>;
+extern template class PreparedPublicKey<3>;
+extern template class PreparedPublicKey<5>;
+extern template class PreparedSigningKey<2>;
+extern template class PreparedSigningKey<3>;
+extern template class PreparedSigningKey<5>;
+
+#endif // PREPARED_KEYS_HPP
@@ -0,0 +1,212 @@
+/**
+ * @file PublicKeyCache.cpp
+ * @brief Implementation of the prepared public key LRU cache
+ *
+ * Compiled once per parameter set with DILITHIUM_MODE set to 2, 3 or 5.
+ */
+
+#include "PublicKeyCache.hpp"
+#include <cstring>
+
+extern "C" {
+#include "params.h"
+#include "fips202.h"
+}
+
+template <int Mode>
+size_t PublicKeyCache<Mode>::FingerprintHash::operator()(const Fingerprint& fingerprint) const {
+    // The fingerprint is already uniformly distributed
+    size_t hash;
+    std::memcpy(&hash, fingerprint.data() + 8, sizeof(hash));
+    return hash;
+}
+
+template <int Mode>
+PublicKeyCache<Mode>::PublicKeyCache(size_t budgetBytes, size_t shards, DilithiumKeyMemory memory)
+    : budgetBytes_(budgetBytes), entryBytes_(entryBytes(memory)), memory_(memory), bytes_(0) {
+    if (shards == 0) {
+        shards = 1;
+    }
+    shards_.reserve(shards);
+    for (size_t i = 0; i < shards; ++i) {
+        shards_.push_back(std::unique_ptr<Shard>(new Shard));
+    }
+}
+
+template <int Mode>
+PublicKeyCache<Mode>::~PublicKeyCache() = default;
+
+template <int Mode>
+size_t PublicKeyCache<Mode>::entryBytes(DilithiumKeyMemory memory) {
+    // Expanded key plus list node, index node and shared_ptr control block
+    return PreparedPublicKey<Mode>::memoryBytes(memory) + sizeof(PreparedPublicKey<Mode>)
+         + sizeof(Entry) + 4 * sizeof(void*) + 64;
+}
+
+template <int Mode>
+typename PublicKeyCache<Mode>::Fingerprint
+PublicKeyCache<Mode>::fingerprint(const uint8_t* publicKey, size_t length) {
+    Fingerprint fingerprint;
+    shake256(fingerprint.data(), fingerprint.size(), publicKey, length);
+    return fingerprint;
+}
+
+template <int Mode>
+bool PublicKeyCache<Mode>::reserve() {
+    size_t bytes = bytes_.load(std::memory_order_relaxed);
+    do {
+        if (bytes + entryBytes_ > budgetBytes_) {
+            return false;
+        }
+    } while (!bytes_.compare_exchange_weak(bytes, bytes + entryBytes_, std::memory_order_relaxed));
+    return true;
+}
+
+template <int Mode>
+void PublicKeyCache<Mode>::evictOldest(Shard& shard) {
+    shard.index.erase(shard.lru.back().fingerprint);
+    shard.lru.pop_back();
+    shard.bytes -= entryBytes_;
+    bytes_.fetch_sub(entryBytes_, std::memory_order_relaxed);
+    ++shard.evictions;
+}
+
+template <int Mode>
+typename PublicKeyCache<Mode>::Shard& PublicKeyCache<Mode>::shardFor(const Fingerprint& fingerprint) {
+    size_t selector;
+    std::memcpy(&selector, fingerprint.data(), sizeof(selector));
+    return *shards_[selector % shards_.size()];
+}
+
+/**
+ * @brief Look up or expand a key
+ *
+ * On a miss the key is expanded without holding the shard lock. If another
+ * thread inserted the same key in the meantime, its entry wins and the
+ * local copy is dropped.
+ *
+ * The budget is global. Room for a new entry is made by evicting the
+ * least recently used entries of its own shard first, then those of the
+ * other shards. Other shards are only try-locked, one at a time and after
+ * the own lock is released, so two inserting threads never wait for each
+ * other; if all are busy the key is returned uncached.
+ */
+template <int Mode>
+typename PublicKeyCache<Mode>::KeyPtr
+PublicKeyCache<Mode>::get(const uint8_t* publicKey, size_t length) {
+    if (!publicKey || length != CRYPTO_PUBLICKEYBYTES) {
+        return nullptr;
+    }
+
+    try {
+        const Fingerprint key = fingerprint(publicKey, length);
+        Shard& shard = shardFor(key);
+
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto found = shard.index.find(key);
+            if (found != shard.index.end()) {
+                shard.lru.splice(shard.lru.begin(), shard.lru, found->second);
+                ++shard.hits;
+                return found->second->key;
+            }
+            ++shard.misses;
+        }
+
+        std::shared_ptr<PreparedPublicKey<Mode>> prepared = std::make_shared<PreparedPublicKey<Mode>>();
+        if (!prepared->load(publicKey, length, memory_)) {
+            return nullptr;
+        }
+
+        if (entryBytes_ > budgetBytes_) {
+            return prepared;    // Budget too small to hold even one key, see capacity()
+        }
+
+        std::unique_lock<std::mutex> lock(shard.mutex);
+        auto found = shard.index.find(key);
+        if (found != shard.index.end()) {
+            shard.lru.splice(shard.lru.begin(), shard.lru, found->second);
+            return found->second->key;
+        }
+
+        bool reserved = reserve();
+        while (!reserved && !shard.lru.empty()) {
+            evictOldest(shard);
+            reserved = reserve();
+        }
+        if (!reserved) {
+            lock.unlock();
+            for (auto& other : shards_) {
+                if (reserved) {
+                    break;
+                }
+                if (other.get() == &shard) {
+                    continue;
+                }
+                std::unique_lock<std::mutex> otherLock(other->mutex, std::try_to_lock);
+                while (otherLock.owns_lock() && !reserved && !other->lru.empty()) {
+                    evictOldest(*other);
+                    reserved = reserve();
+                }
+            }
+            if (!reserved) {
+                return prepared;
+            }
+            lock.lock();
+            found = shard.index.find(key);
+            if (found != shard.index.end()) {
+                bytes_.fetch_sub(entryBytes_, std::memory_order_relaxed);
+                shard.lru.splice(shard.lru.begin(), shard.lru, found->second);
+                return found->second->key;
+            }
+        }
+
+        try {
+            shard.lru.push_front(Entry{key, prepared});
+        } catch (...) {
+            bytes_.fetch_sub(entryBytes_, std::memory_order_relaxed);
+            throw;
+        }
+        shard.index.emplace(key, shard.lru.begin());
+        shard.bytes += entryBytes_;
+        return prepared;
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+template <int Mode>
+bool PublicKeyCache<Mode>::verify(const uint8_t* publicKey, size_t publicKeyLength,
+                                  const uint8_t* message, size_t messageLength,
+                                  const uint8_t* signature, size_t signatureLength) {
+    KeyPtr key = get(publicKey, publicKeyLength);
+    return key && key->verify(message, messageLength, signature, signatureLength);
+}
+
+template <int Mode>
+void PublicKeyCache<Mode>::clear() {
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        shard->index.clear();
+        shard->lru.clear();
+        bytes_.fetch_sub(shard->bytes, std::memory_order_relaxed);
+        shard->bytes = 0;
+    }
+}
+
+template <int Mode>
+PublicKeyCacheStats PublicKeyCache<Mode>::stats() const {
+    PublicKeyCacheStats stats{};
+    stats.budgetBytes = budgetBytes_;
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        stats.hits += shard->hits;
+        stats.misses += shard->misses;
+        stats.evictions += shard->evictions;
+        stats.entries += shard->lru.size();
+        stats.bytes += shard->bytes;
+    }
+    return stats;
+}
+
+template class PublicKeyCache<DILITHIUM_MODE>;
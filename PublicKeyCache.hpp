@@ -0,0 +1,183 @@
+/**
+ * @file PublicKeyCache.hpp
+ * @brief Bounded, thread-safe LRU cache of prepared Dilithium public keys
+ *
+ * Verifying under a packed public key means unpacking t1, hashing pk into
+ * tr and expanding A from ρ on every call. Services that see the same
+ * signers again and again can keep the PreparedPublicKey instead. The cache
+ * is keyed by a 256-bit SHAKE256 fingerprint of the packed key, holds at
+ * most a configured number of bytes of expanded keys and evicts the least
+ * recently used key when a new one does not fit.
+ *
+ * Lookups lock one of several shards, chosen by the fingerprint, so
+ * verifier threads rarely contend. Keys are expanded outside the lock.
+ * Entries are handed out as shared_ptr and stay valid while in use even if
+ * they are evicted meanwhile. A compact DilithiumKeyMemory mode fits several
+ * times more keys into the same budget at a higher cost per verification.
+ *
+ * @code
+ * auto cache = std::make_shared<PublicKeyCache<3>>(256 << 20);
+ * DilithiumWrapper<3> verifier;
+ * verifier.setPublicKeyCache(cache);
+ * verifier.setPublicKey(signerKey);   // Cheap: verify() looks the key up
+ * verifier.verify(message, signature);
+ * @endcode
+ *
+ * @author Student Project - Cryptographic Systems Course
+ * @date December 2025
+ */
+
+#ifndef PUBLIC_KEY_CACHE_HPP
+#define PUBLIC_KEY_CACHE_HPP
+
+#include <array>
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "DilithiumParams.hpp"
+#include "PreparedKeys.hpp"
+
+/**
+ * @brief Counters of a PublicKeyCache
+ */
+struct PublicKeyCacheStats {
+    uint64_t hits;
+    uint64_t misses;            // Lookups that expanded the key
+    uint64_t evictions;
+    size_t entries;
+    size_t bytes;               // Memory charged to the cached keys
+    size_t budgetBytes;
+
+    double hitRate() const {
+        return hits + misses > 0 ? static_cast<double>(hits) / static_cast<double>(hits + misses) : 0.0;
+    }
+};
+
+/**
+ * @brief LRU cache of prepared public keys under a memory budget
+ * @tparam Mode Dilithium mode (2, 3 or 5)
+ */
+template <int Mode>
+class PublicKeyCache {
+public:
+    using Fingerprint = std::array<uint8_t, 32>;
+    using KeyPtr = std::shared_ptr<const PreparedPublicKey<Mode>>;
+
+    static constexpr size_t DEFAULT_BUDGET_BYTES = 64 << 20;
+    static constexpr size_t DEFAULT_SHARDS = 16;
+
+    /**
+     * @brief Constructor
+     * @param budgetBytes Memory for expanded keys, shared by all shards; below
+     *                    entryBytes(memory) nothing is cached, see capacity()
+     * @param shards Number of independently locked partitions (at least 1)
+     * @param memory Memory mode the keys are loaded with
+     */
+    explicit PublicKeyCache(size_t budgetBytes = DEFAULT_BUDGET_BYTES,
+                            size_t shards = DEFAULT_SHARDS,
+                            DilithiumKeyMemory memory = DilithiumKeyMemory::Full);
+
+    ~PublicKeyCache();
+
+    PublicKeyCache(const PublicKeyCache&) = delete;
+    PublicKeyCache& operator=(const PublicKeyCache&) = delete;
+
+    /**
+     * @brief Get the prepared key for a packed public key, expanding it on a miss
+     * @param publicKey Packed public key
+     * @param length Length in bytes, must equal the mode's public key size
+     * @return The prepared key, or nullptr if the key has the wrong size
+     */
+    KeyPtr get(const uint8_t* publicKey, size_t length);
+
+    /**
+     * @brief Verify a signature under a packed public key through the cache
+     * @return true if the signature is valid
+     */
+    bool verify(const uint8_t* publicKey, size_t publicKeyLength,
+                const uint8_t* message, size_t messageLength,
+                const uint8_t* signature, size_t signatureLength);
+
+    /**
+     * @brief Remove all keys; the counters are kept
+     */
+    void clear();
+
+    /**
+     * @brief Snapshot of the counters, summed over all shards
+     */
+    PublicKeyCacheStats stats() const;
+
+    /**
+     * @brief Number of keys the budget holds
+     *
+     * 0 if the budget is smaller than one entry: every lookup then expands
+     * the key and counts as a miss.
+     */
+    size_t capacity() const { return budgetBytes_ / entryBytes_; }
+
+    /**
+     * @brief Memory mode of the cached keys
+     */
+    DilithiumKeyMemory memory() const { return memory_; }
+
+    /**
+     * @brief Memory charged for one cached key
+     */
+    static size_t entryBytes(DilithiumKeyMemory memory = DilithiumKeyMemory::Full);
+
+    /**
+     * @brief SHAKE256 fingerprint of a packed public key
+     */
+    static Fingerprint fingerprint(const uint8_t* publicKey, size_t length);
+
+private:
+    struct FingerprintHash {
+        size_t operator()(const Fingerprint& fingerprint) const;
+    };
+
+    struct Entry {
+        Fingerprint fingerprint;
+        KeyPtr key;
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::list<Entry> lru;       // Most recently used first
+        std::unordered_map<Fingerprint, typename std::list<Entry>::iterator, FingerprintHash> index;
+        size_t bytes = 0;
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+    };
+
+    Shard& shardFor(const Fingerprint& fingerprint);
+
+    /**
+     * @brief Charge one entry to the budget if it fits
+     */
+    bool reserve();
+
+    /**
+     * @brief Drop the least recently used entry of a locked, non-empty shard
+     */
+    void evictOldest(Shard& shard);
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+    size_t budgetBytes_;
+    size_t entryBytes_;
+    DilithiumKeyMemory memory_;
+    std::atomic<size_t> bytes_;     // Charged to all shards together
+};
+
+// Instantiated in PublicKeyCache.cpp, once per separately compiled mode
+extern template class PublicKeyCache<2>;
+extern template class PublicKeyCache<3>;
+extern template class PublicKeyCache<5>;
+
+#endif // PUBLIC_KEY_CACHE_HPP
@@ -0,0 +1,253 @@
+/**
+ * @file PublicKeyStore.cpp
+ * @brief Implementation of the memory-mapped public keystore
+ *
+ * Compiled once per parameter set with DILITHIUM_MODE set to 2, 3 or 5.
+ */
+
+#include "PublicKeyStore.hpp"
+#include "PreparedKeys.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <numeric>
+
+namespace {
+
+const char MAGIC[8] = {'D', 'L', 'T', 'H', 'K', 'E', 'Y', 'S'};
+
+// Header field offsets
+constexpr size_t VERSION_OFFSET = 8;
+constexpr size_t MODE_OFFSET = 12;
+constexpr size_t COUNT_OFFSET = 16;
+constexpr size_t RECORD_BYTES_OFFSET = 24;
+constexpr size_t FINGERPRINT_BYTES_OFFSET = 28;
+constexpr size_t INDEX_OFFSET_OFFSET = 32;
+constexpr size_t RECORDS_OFFSET_OFFSET = 40;
+constexpr size_t FILE_BYTES_OFFSET = 48;
+
+size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// PublicKeyStoreWriter
+// ---------------------------------------------------------------------------
+
+template <int Mode>
+bool PublicKeyStoreWriter<Mode>::add(const uint8_t* publicKey, size_t length) {
+    if (!publicKey || length != PublicKeyStore<Mode>::RECORD_BYTES) {
+        return false;
+    }
+    const Fingerprint fingerprint = PublicKeyCache<Mode>::fingerprint(publicKey, length);
+    try {
+        keys_.insert(keys_.end(), publicKey, publicKey + length);
+        try {
+            fingerprints_.push_back(fingerprint);
+        } catch (...) {
+            keys_.resize(keys_.size() - length);
+            return false;
+        }
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+template <int Mode>
+bool PublicKeyStoreWriter<Mode>::write(const std::string& path) const {
+    using Store = PublicKeyStore<Mode>;
+    try {
+        std::vector<size_t> order(fingerprints_.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+            return fingerprints_[a] < fingerprints_[b];
+        });
+        order.erase(std::unique(order.begin(), order.end(), [this](size_t a, size_t b) {
+            return fingerprints_[a] == fingerprints_[b];
+        }), order.end());
+
+        const size_t count = order.size();
+        const size_t indexOffset = Store::HEADER_BYTES;
+        const size_t recordsOffset = alignUp(indexOffset + count * Store::FINGERPRINT_BYTES,
+                                             Store::RECORDS_ALIGNMENT);
+        const size_t fileBytes = recordsOffset + count * Store::RECORD_BYTES;
+
+        uint8_t header[Store::HEADER_BYTES] = {};
+        std::memcpy(header, MAGIC, sizeof(MAGIC));
+        storeLittleEndian(header + VERSION_OFFSET, Store::FORMAT_VERSION, 4);
+        storeLittleEndian(header + MODE_OFFSET, Mode, 4);
+        storeLittleEndian(header + COUNT_OFFSET, count, 8);
+        storeLittleEndian(header + RECORD_BYTES_OFFSET, Store::RECORD_BYTES, 4);
+        storeLittleEndian(header + FINGERPRINT_BYTES_OFFSET, Store::FINGERPRINT_BYTES, 4);
+        storeLittleEndian(header + INDEX_OFFSET_OFFSET, indexOffset, 8);
+        storeLittleEndian(header + RECORDS_OFFSET_OFFSET, recordsOffset, 8);
+        storeLittleEndian(header + FILE_BYTES_OFFSET, fileBytes, 8);
+
+        const std::string temporary = path + ".tmp";
+        std::FILE* file = std::fopen(temporary.c_str(), "wb");
+        if (!file) {
+            return false;
+        }
+
+        bool ok = writeAll(file, header, sizeof(header));
+        for (size_t i = 0; ok && i < count; ++i) {
+            ok = writeAll(file, fingerprints_[order[i]].data(), Store::FINGERPRINT_BYTES);
+        }
+        const std::vector<uint8_t> padding(recordsOffset - indexOffset
+                                           - count * Store::FINGERPRINT_BYTES, 0);
+        ok = ok && writeAll(file, padding.data(), padding.size());
+        for (size_t i = 0; ok && i < count; ++i) {
+            ok = writeAll(file, keys_.data() + order[i] * Store::RECORD_BYTES, Store::RECORD_BYTES);
+        }
+        ok = std::fclose(file) == 0 && ok;
+
+        if (!ok || std::rename(temporary.c_str(), path.c_str()) != 0) {
+            std::remove(temporary.c_str());
+            return false;
+        }
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+template <int Mode>
+void PublicKeyStoreWriter<Mode>::clear() {
+    keys_.clear();
+    fingerprints_.clear();
+}
+
+// ---------------------------------------------------------------------------
+// PublicKeyStore
+// ---------------------------------------------------------------------------
+
+template <int Mode>
+PublicKeyStore<Mode>::~PublicKeyStore() {
+    close();
+}
+
+template <int Mode>
+PublicKeyStore<Mode>::PublicKeyStore(PublicKeyStore&& other) noexcept {
+    *this = std::move(other);
+}
+
+template <int Mode>
+PublicKeyStore<Mode>& PublicKeyStore<Mode>::operator=(PublicKeyStore&& other) noexcept {
+    if (this != &other) {
+        close();
+        file_ = std::move(other.file_);
+        index_ = other.index_;
+        records_ = other.records_;
+        count_ = other.count_;
+        other.index_ = other.records_ = nullptr;
+        other.count_ = 0;
+    }
+    return *this;
+}
+
+template <int Mode>
+bool PublicKeyStore<Mode>::open(const std::string& path) {
+    close();
+    // Lookups jump around the file; readahead would only pull in unused keys
+    if (!file_.open(path, HEADER_BYTES, MappedFile::Access::Random)) {
+        return false;
+    }
+    const uint8_t* data = file_.data();
+    const size_t bytes = file_.size();
+
+    const uint64_t count = loadLittleEndian(data + COUNT_OFFSET, 8);
+    const uint64_t indexOffset = loadLittleEndian(data + INDEX_OFFSET_OFFSET, 8);
+    const uint64_t recordsOffset = loadLittleEndian(data + RECORDS_OFFSET_OFFSET, 8);
+    const bool valid =
+        std::memcmp(data, MAGIC, sizeof(MAGIC)) == 0
+        && loadLittleEndian(data + VERSION_OFFSET, 4) == FORMAT_VERSION
+        && loadLittleEndian(data + MODE_OFFSET, 4) == static_cast<uint64_t>(Mode)
+        && loadLittleEndian(data + RECORD_BYTES_OFFSET, 4) == RECORD_BYTES
+        && loadLittleEndian(data + FINGERPRINT_BYTES_OFFSET, 4) == FINGERPRINT_BYTES
+        && loadLittleEndian(data + FILE_BYTES_OFFSET, 8) == bytes
+        && count <= bytes / RECORD_BYTES
+        && indexOffset >= HEADER_BYTES && indexOffset <= bytes && recordsOffset <= bytes
+        && indexOffset + count * FINGERPRINT_BYTES <= recordsOffset
+        && recordsOffset + count * RECORD_BYTES == bytes;
+    if (!valid) {
+        close();
+        return false;
+    }
+
+    count_ = static_cast<size_t>(count);
+    index_ = data + indexOffset;
+    records_ = data + recordsOffset;
+    if (count_ > 0) {
+        // The index is what every lookup searches; start reading it now
+        file_.willNeed(indexOffset, count_ * FINGERPRINT_BYTES);
+    }
+    return true;
+}
+
+template <int Mode>
+void PublicKeyStore<Mode>::close() {
+    file_.close();
+    index_ = records_ = nullptr;
+    count_ = 0;
+}
+
+template <int Mode>
+const uint8_t* PublicKeyStore<Mode>::find(const Fingerprint& fingerprint) const {
+    size_t low = 0;
+    size_t high = count_;
+    while (low < high) {
+        const size_t middle = low + (high - low) / 2;
+        const int order = std::memcmp(index_ + middle * FINGERPRINT_BYTES, fingerprint.data(),
+                                      FINGERPRINT_BYTES);
+        if (order == 0) {
+            return publicKey(middle);
+        }
+        if (order < 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return nullptr;
+}
+
+template <int Mode>
+const uint8_t* PublicKeyStore<Mode>::find(const uint8_t* publicKey, size_t length) const {
+    if (!publicKey || length != RECORD_BYTES) {
+        return nullptr;
+    }
+    const uint8_t* stored = find(PublicKeyCache<Mode>::fingerprint(publicKey, length));
+    return stored && std::memcmp(stored, publicKey, RECORD_BYTES) == 0 ? stored : nullptr;
+}
+
+template <int Mode>
+bool PublicKeyStore<Mode>::verify(const Fingerprint& signer,
+                                  const uint8_t* message, size_t messageLength,
+                                  const uint8_t* signature, size_t signatureLength) const {
+    const uint8_t* key = find(signer);
+    return key && PreparedPublicKey<Mode>::verifyPacked(key, RECORD_BYTES, message, messageLength,
+                                                        signature, signatureLength);
+}
+
+template <int Mode>
+bool PublicKeyStore<Mode>::validate() const {
+    if (!isOpen()) {
+        return false;
+    }
+    for (size_t i = 0; i < count_; ++i) {
+        if (i > 0 && std::memcmp(fingerprint(i - 1), fingerprint(i), FINGERPRINT_BYTES) >= 0) {
+            return false;
+        }
+        const Fingerprint expected = PublicKeyCache<Mode>::fingerprint(publicKey(i), RECORD_BYTES);
+        if (std::memcmp(expected.data(), fingerprint(i), FINGERPRINT_BYTES) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template class PublicKeyStoreWriter<DILITHIUM_MODE>;
+template class PublicKeyStore<DILITHIUM_MODE>;
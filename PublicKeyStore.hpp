@@ -0,0 +1,214 @@
+/**
+ * @file PublicKeyStore.hpp
+ * @brief Memory-mapped file of many packed Dilithium public keys
+ *
+ * Verifier processes that know a large, fixed population of signers keep
+ * their packed public keys in one keystore file instead of loading them
+ * key by key. The file is mapped read-only, so opening it costs a few
+ * system calls regardless of its size. Every worker process that maps it
+ * shares the same page cache pages, and a lookup touches only the index
+ * pages it binary-searches plus one key record.
+ *
+ * File layout (version 1, all integers little-endian):
+ *
+ * | Offset        | Size          | Contents                                   |
+ * |---------------|---------------|--------------------------------------------|
+ * | 0             | 64            | Header, see below                          |
+ * | 64            | 32 · n        | Index: SHAKE256 fingerprints, ascending    |
+ * | recordsOffset | PK_BYTES · n  | Packed public keys, record i ↔ index i     |
+ *
+ * Header: magic "DLTHKEYS", u32 version, u32 mode, u64 n, u32 record bytes,
+ * u32 fingerprint bytes, u64 index offset, u64 records offset (4096-byte
+ * aligned) and u64 file size. The fingerprint is the one PublicKeyCache
+ * uses, so a key found here can be handed to the cache without rehashing.
+ *
+ * @code
+ * PublicKeyStoreWriter<3> writer;
+ * for (const auto& key : signerKeys) writer.add(key);
+ * writer.write("signers.dks");
+ *
+ * PublicKeyStore<3> store;
+ * store.open("signers.dks");            // mmap, no parsing
+ * store.verify(signer, message, length, signature, signatureLength);
+ * @endcode
+ *
+ * @author Student Project - Cryptographic Systems Course
+ * @date December 2025
+ */
+
+#ifndef PUBLIC_KEY_STORE_HPP
+#define PUBLIC_KEY_STORE_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "DilithiumParams.hpp"
+#include "MappedFile.hpp"
+#include "PublicKeyCache.hpp"
+
+/**
+ * @brief Collects packed public keys and writes them as a keystore file
+ * @tparam Mode Dilithium mode (2, 3 or 5)
+ */
+template <int Mode>
+class PublicKeyStoreWriter {
+public:
+    using Fingerprint = typename PublicKeyCache<Mode>::Fingerprint;
+
+    /**
+     * @brief Add a packed public key
+     * @param publicKey Packed public key bytes
+     * @param length Length in bytes, must equal the mode's public key size
+     * @return true if added, false if the key has the wrong size
+     */
+    bool add(const uint8_t* publicKey, size_t length);
+
+    bool add(const std::vector<uint8_t>& publicKey) {
+        return add(publicKey.data(), publicKey.size());
+    }
+
+    /**
+     * @brief Write all keys added so far, sorted by fingerprint
+     *
+     * Duplicate keys are stored once. The file is written next to path and
+     * renamed over it, so readers never map a partially written store.
+     *
+     * @param path Output file
+     * @return true if the file was written
+     */
+    bool write(const std::string& path) const;
+
+    /**
+     * @brief Number of keys added (duplicates included)
+     */
+    size_t size() const { return fingerprints_.size(); }
+
+    void clear();
+
+private:
+    std::vector<uint8_t> keys_;             // Packed keys in insertion order
+    std::vector<Fingerprint> fingerprints_;
+};
+
+/**
+ * @brief Read-only view of a keystore file
+ *
+ * All returned pointers point into the mapping and stay valid until the
+ * store is closed, moved from or destroyed.
+ *
+ * @tparam Mode Dilithium mode (2, 3 or 5)
+ */
+template <int Mode>
+class PublicKeyStore {
+public:
+    using Fingerprint = typename PublicKeyCache<Mode>::Fingerprint;
+
+    static constexpr uint32_t FORMAT_VERSION = 1;
+    static constexpr size_t HEADER_BYTES = 64;
+    static constexpr size_t FINGERPRINT_BYTES = 32;
+    static constexpr size_t RECORD_BYTES = DilithiumParams<Mode>::PUBLIC_KEY_BYTES;
+    static constexpr size_t RECORDS_ALIGNMENT = 4096;
+
+    PublicKeyStore() = default;
+
+    /**
+     * @brief Destructor - unmaps the file
+     */
+    ~PublicKeyStore();
+
+    PublicKeyStore(const PublicKeyStore&) = delete;
+    PublicKeyStore& operator=(const PublicKeyStore&) = delete;
+    PublicKeyStore(PublicKeyStore&& other) noexcept;
+    PublicKeyStore& operator=(PublicKeyStore&& other) noexcept;
+
+    /**
+     * @brief Map a keystore file read-only
+     *
+     * Checks the header against the file size and this mode; the index and
+     * the records are not read. Without mmap() the file is read into memory.
+     *
+     * @param path Keystore file
+     * @return true if the file is a valid keystore of this mode
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Unmap the file
+     */
+    void close();
+
+    bool isOpen() const { return file_.isOpen(); }
+
+    /**
+     * @brief True if the file is mapped rather than copied into memory
+     */
+    bool isMapped() const { return file_.isMapped(); }
+
+    /**
+     * @brief Number of keys in the store
+     */
+    size_t size() const { return count_; }
+
+    /**
+     * @brief Size of the file in bytes
+     */
+    size_t fileBytes() const { return file_.size(); }
+
+    /**
+     * @brief Binary-search the index
+     * @param fingerprint Fingerprint of the wanted key
+     * @return The packed public key (RECORD_BYTES), or nullptr if not stored
+     */
+    const uint8_t* find(const Fingerprint& fingerprint) const;
+
+    /**
+     * @brief Look up a packed public key by its contents
+     * @return The stored copy, or nullptr if this key is not stored
+     */
+    const uint8_t* find(const uint8_t* publicKey, size_t length) const;
+
+    /**
+     * @brief Packed public key of record index (0 <= index < size())
+     */
+    const uint8_t* publicKey(size_t index) const { return records_ + index * RECORD_BYTES; }
+
+    /**
+     * @brief Fingerprint of record index, FINGERPRINT_BYTES bytes
+     */
+    const uint8_t* fingerprint(size_t index) const { return index_ + index * FINGERPRINT_BYTES; }
+
+    /**
+     * @brief Verify a signature under a stored key, reading the key in place
+     * @param signer Fingerprint of the signer's public key
+     * @return true if the key is stored and the signature is valid
+     */
+    bool verify(const Fingerprint& signer, const uint8_t* message, size_t messageLength,
+                const uint8_t* signature, size_t signatureLength) const;
+
+    /**
+     * @brief Check every record: ascending index and matching fingerprints
+     *
+     * Reads the whole file, so it is meant for tools and tests rather than
+     * for every open().
+     *
+     * @return true if the store is consistent
+     */
+    bool validate() const;
+
+private:
+    MappedFile file_;
+    const uint8_t* index_ = nullptr;
+    const uint8_t* records_ = nullptr;
+    size_t count_ = 0;
+};
+
+// Instantiated in PublicKeyStore.cpp, once per separately compiled mode
+extern template class PublicKeyStoreWriter<2>;
+extern template class PublicKeyStoreWriter<3>;
+extern template class PublicKeyStoreWriter<5>;
+extern template class PublicKeyStore<2>;
+extern template class PublicKeyStore<3>;
+extern template class PublicKeyStore<5>;
+
+#endif // PUBLIC_KEY_STORE_HPP
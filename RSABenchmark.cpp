@@ -3,7 +3,29 @@
 #include <openssl/bn.h>
 #include <openssl/rsa.h>
 #include <openssl/pem.h>
+#include <openssl/x509.h>
 #include <cstring>
+#include <memory>
+
+namespace {
+
+struct MdCtxDeleter {
+    void operator()(EVP_MD_CTX* ctx) const { EVP_MD_CTX_free(ctx); }
+};
+
+/**
+ * @brief Working digest context of the calling thread
+ *
+ * Every warm sign()/verify() overwrites it with a copy of the prepared
+ * context, so one per thread is enough for all RSABenchmark objects and
+ * concurrent callers never share mutable OpenSSL state.
+ */
+EVP_MD_CTX* threadWorkContext() {
+    thread_local std::unique_ptr<EVP_MD_CTX, MdCtxDeleter> ctx(EVP_MD_CTX_new());
+    return ctx.get();
+}
+
+} // namespace
 
 RSABenchmark::RSABenchmark(int keySize)
     : keySize_(keySize)
@@ -18,11 +40,11 @@ RSABenchmark::~RSABenchmark() {
 
 void RSABenchmark::cleanup() {
     if (signCtx_) {
-        EVP_PKEY_CTX_free(signCtx_);
+        EVP_MD_CTX_free(signCtx_);
         signCtx_ = nullptr;
     }
     if (verifyCtx_) {
-        EVP_PKEY_CTX_free(verifyCtx_);
+        EVP_MD_CTX_free(verifyCtx_);
         verifyCtx_ = nullptr;
     }
     if (pkey_) {
@@ -59,13 +81,105 @@ bool RSABenchmark::generateKeys() {
     }
 
     EVP_PKEY_CTX_free(ctx);
+    return prepareContexts(true);
+}
+
+bool RSABenchmark::prepareContexts(bool signing) {
+    signCtx_ = signing ? EVP_MD_CTX_new() : nullptr;
+    verifyCtx_ = EVP_MD_CTX_new();
+    if ((signing && !signCtx_) || !verifyCtx_) {
+        cleanup();
+        return false;
+    }
+
+    // Key, digest and signature algorithm are set up once here
+    if ((signing && EVP_DigestSignInit(signCtx_, nullptr, EVP_sha256(), nullptr, pkey_) <= 0) ||
+        EVP_DigestVerifyInit(verifyCtx_, nullptr, EVP_sha256(), nullptr, pkey_) <= 0) {
+        cleanup();
+        return false;
+    }
     return true;
 }
 
-std::vector<uint8_t> RSABenchmark::sign(const std::vector<uint8_t>& message) {
+std::vector<uint8_t> RSABenchmark::getPublicKey() const {
     if (!pkey_) {
         return {};
     }
+    const int length = i2d_PUBKEY(pkey_, nullptr);
+    if (length <= 0) {
+        return {};
+    }
+    std::vector<uint8_t> encoded(static_cast<size_t>(length));
+    unsigned char* out = encoded.data();
+    if (i2d_PUBKEY(pkey_, &out) != length) {
+        return {};
+    }
+    return encoded;
+}
+
+bool RSABenchmark::setPublicKey(const std::vector<uint8_t>& publicKey) {
+    cleanup();
+
+    const unsigned char* in = publicKey.data();
+    EVP_PKEY* key = d2i_PUBKEY(nullptr, &in, static_cast<long>(publicKey.size()));
+    if (!key) {
+        return false;
+    }
+    // The whole buffer must be one RSA key of the configured size
+    if (in != publicKey.data() + publicKey.size() || EVP_PKEY_base_id(key) != EVP_PKEY_RSA
+        || EVP_PKEY_bits(key) != keySize_) {
+        EVP_PKEY_free(key);
+        return false;
+    }
+    pkey_ = key;
+    return prepareContexts(false);
+}
+
+std::vector<uint8_t> RSABenchmark::sign(const std::vector<uint8_t>& message) {
+    if (!pkey_ || !signCtx_) {
+        return {};
+    }
+
+    // Reset the working context to the prepared state
+    EVP_MD_CTX* mdctx = threadWorkContext();
+    if (!mdctx || EVP_MD_CTX_copy_ex(mdctx, signCtx_) <= 0) {
+        return {};
+    }
+
+    // The signature length is the modulus size
+    size_t sigLen = static_cast<size_t>(EVP_PKEY_size(pkey_));
+    std::vector<uint8_t> signature(sigLen);
+
+    if (EVP_DigestSign(mdctx, signature.data(), &sigLen,
+                       message.data(), message.size()) <= 0) {
+        return {};
+    }
+
+    signature.resize(sigLen);
+    return signature;
+}
+
+bool RSABenchmark::verify(const std::vector<uint8_t>& message,
+                          const std::vector<uint8_t>& signature) {
+    if (!pkey_ || !verifyCtx_) {
+        return false;
+    }
+
+    // Reset the working context to the prepared state
+    EVP_MD_CTX* mdctx = threadWorkContext();
+    if (!mdctx || EVP_MD_CTX_copy_ex(mdctx, verifyCtx_) <= 0) {
+        return false;
+    }
+
+    int result = EVP_DigestVerify(mdctx, signature.data(), signature.size(),
+                                  message.data(), message.size());
+    return (result == 1);
+}
+
+std::vector<uint8_t> RSABenchmark::signCold(const std::vector<uint8_t>& message) {
+    if (!hasKeys()) {
+        return {};
+    }
 
     // Create signing context
     EVP_MD_CTX* mdctx = EVP_MD_CTX_new();
@@ -101,8 +215,8 @@ std::vector<uint8_t> RSABenchmark::sign(const std::vector<uint8_t>& message) {
     return signature;
 }
 
-bool RSABenchmark::verify(const std::vector<uint8_t>& message,
-                          const std::vector<uint8_t>& signature) {
+bool RSABenchmark::verifyCold(const std::vector<uint8_t>& message,
+                              const std::vector<uint8_t>& signature) {
     if (!pkey_) {
         return false;
     }
@@ -33,13 +33,18 @@ public:
 
     /**
      * @brief Sign a message with RSA-PSS
+     *
+     * Uses the digest context prepared by generateKeys(): each call copies
+     * it into a per-thread working context instead of fetching the digest and
+     * signature algorithm and setting up the key again.
+     *
      * @param message The message to sign
      * @return Signature bytes, or empty on failure
      */
     std::vector<uint8_t> sign(const std::vector<uint8_t>& message);
 
     /**
-     * @brief Verify an RSA-PSS signature
+     * @brief Verify an RSA-PSS signature (with the prepared context, see sign())
      * @param message The original message
      * @param signature The signature to verify
      * @return true if valid
@@ -47,6 +52,38 @@ public:
     bool verify(const std::vector<uint8_t>& message,
                 const std::vector<uint8_t>& signature);
 
+    /**
+     * @brief Sign with a digest context created and initialized for this call
+     *
+     * Same result as sign(); kept to measure the per-call setup cost.
+     *
+     * @param message The message to sign
+     * @return Signature bytes, or empty on failure
+     */
+    std::vector<uint8_t> signCold(const std::vector<uint8_t>& message);
+
+    /**
+     * @brief Verify with a digest context created and initialized for this call
+     * @param message The original message
+     * @param signature The signature to verify
+     * @return true if valid
+     */
+    bool verifyCold(const std::vector<uint8_t>& message,
+                    const std::vector<uint8_t>& signature);
+
+    /**
+     * @brief Export the public key as a DER SubjectPublicKeyInfo
+     * @return The encoded key, or empty if there is none
+     */
+    std::vector<uint8_t> getPublicKey() const;
+
+    /**
+     * @brief Load a public key for verification only, replacing any key pair
+     * @param publicKey DER SubjectPublicKeyInfo of an RSA key of keySize bits
+     * @return true if the key was loaded
+     */
+    bool setPublicKey(const std::vector<uint8_t>& publicKey);
+
     /**
      * @brief Get public key size in bytes
      */
@@ -63,17 +100,23 @@ public:
     size_t getSignatureSize() const;
 
     /**
-     * @brief Check if keys are generated
+     * @brief Check if keys are generated (the key pair, needed to sign)
+     */
+    bool hasKeys() const { return signCtx_ != nullptr; }
+
+    /**
+     * @brief Check if a public key is loaded, generated or from setPublicKey()
      */
-    bool hasKeys() const { return pkey_ != nullptr; }
+    bool hasPublicKey() const { return verifyCtx_ != nullptr; }
 
 private:
     int keySize_;
     EVP_PKEY* pkey_;
-    EVP_PKEY_CTX* signCtx_;
-    EVP_PKEY_CTX* verifyCtx_;
+    EVP_MD_CTX* signCtx_;       // Initialized for signing, only ever copied from
+    EVP_MD_CTX* verifyCtx_;     // Initialized for verification, only ever copied from
 
     void cleanup();
+    bool prepareContexts(bool signing);
 };
 
 #endif // RSA_BENCHMARK_HPP
\ No newline at end of file
@@ -0,0 +1,151 @@
+/**
+ * @file RandomSource.cpp
+ * @brief randombytes() with a selectable system or buffered source
+ *
+ * Compiled into dilithium_common in place of the reference randombytes.c.
+ */
+
+#include "RandomSource.hpp"
+#include "SecureMemory.hpp"
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+extern "C" {
+#include "fips202.h"
+#include "randombytes.h"
+}
+
+namespace {
+
+std::atomic<DilithiumRandomness> selectedSource(DilithiumRandomness::System);
+
+// Incremented in the child after fork() so that no two processes share a DRBG state
+std::atomic<uint64_t> forkGeneration(0);
+std::once_flag forkHandlerOnce;
+
+void onFork() {
+    forkGeneration.fetch_add(1, std::memory_order_relaxed);
+}
+
+void registerForkHandler() {
+    std::call_once(forkHandlerOnce, []() { pthread_atfork(nullptr, nullptr, onFork); });
+}
+
+// Registered before any DRBG exists; select() registers again in case a
+// static initializer of another translation unit already drew bytes
+const bool forkHandlerRegistered = (registerForkHandler(), true);
+
+/**
+ * @brief Per-thread fast-key-erasure DRBG over SHAKE256
+ */
+class BufferedDrbg {
+public:
+    ~BufferedDrbg() {
+        secureWipe(key_, sizeof(key_));
+        secureWipe(buffer_, sizeof(buffer_));
+    }
+
+    void fill(uint8_t* out, size_t length) {
+        // A forked child must not hand out the bytes left over from its
+        // parent's buffer: drop them and reseed before the first byte
+        if (forkGeneration.load(std::memory_order_relaxed) != generation_) {
+            secureWipe(buffer_, sizeof(buffer_));
+            available_ = 0;
+            seeded_ = false;
+        }
+        while (length > 0) {
+            if (available_ == 0) {
+                refill();
+            }
+            const size_t offset = RandomSource::BUFFER_BYTES - available_;
+            const size_t take = length < available_ ? length : available_;
+            std::memcpy(out, buffer_ + offset, take);
+            secureWipe(buffer_ + offset, take);
+            available_ -= take;
+            out += take;
+            length -= take;
+        }
+    }
+
+private:
+    void refill() {
+        const uint64_t generation = forkGeneration.load(std::memory_order_relaxed);
+        if (!seeded_ || sinceReseed_ >= RandomSource::RESEED_BYTES || generation != generation_) {
+            RandomSource::systemFill(key_, sizeof(key_));
+            seeded_ = true;
+            sinceReseed_ = 0;
+            generation_ = generation;
+        }
+
+        // (key', output) = SHAKE256(key); the old key is gone after this
+        keccak_state state;
+        shake256_init(&state);
+        shake256_absorb(&state, key_, sizeof(key_));
+        shake256_finalize(&state);
+        shake256_squeeze(key_, sizeof(key_), &state);
+        shake256_squeeze(buffer_, sizeof(buffer_), &state);
+        secureWipe(&state, sizeof(state));
+
+        available_ = RandomSource::BUFFER_BYTES;
+        sinceReseed_ += RandomSource::BUFFER_BYTES;
+    }
+
+    uint8_t key_[32];
+    uint8_t buffer_[RandomSource::BUFFER_BYTES];
+    size_t available_ = 0;
+    size_t sinceReseed_ = 0;
+    uint64_t generation_ = 0;
+    bool seeded_ = false;
+};
+
+} // namespace
+
+DilithiumRandomness RandomSource::current() {
+    return selectedSource.load(std::memory_order_relaxed);
+}
+
+void RandomSource::select(DilithiumRandomness source) {
+    registerForkHandler();
+    selectedSource.store(source, std::memory_order_relaxed);
+}
+
+const char* RandomSource::name(DilithiumRandomness source) {
+    switch (source) {
+        case DilithiumRandomness::System:   return "system";
+        case DilithiumRandomness::Buffered: return "buffered";
+    }
+    return "unknown";
+}
+
+void RandomSource::fill(uint8_t* out, size_t length) {
+    if (current() == DilithiumRandomness::Buffered) {
+        thread_local BufferedDrbg drbg;
+        drbg.fill(out, length);
+    } else {
+        systemFill(out, length);
+    }
+}
+
+void RandomSource::systemFill(uint8_t* out, size_t length) {
+    while (length > 0) {
+        ssize_t ret = syscall(SYS_getrandom, out, length, 0);
+        if (ret == -1 && errno == EINTR) {
+            continue;
+        } else if (ret == -1) {
+            std::abort();
+        }
+        out += ret;
+        length -= static_cast<size_t>(ret);
+    }
+}
+
+// The entry point the reference and AVX2 code call
+extern "C" void randombytes(uint8_t* out, size_t outlen) {
+    RandomSource::fill(out, outlen);
+}
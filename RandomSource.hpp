@@ -0,0 +1,64 @@
+/**
+ * @file RandomSource.hpp
+ * @brief Pluggable implementation of randombytes() for the Dilithium libraries
+ *
+ * The reference randombytes.c issues one getrandom() system call per
+ * request. RandomSource.cpp replaces it and routes every request of the ref
+ * and avx2 code (key generation seeds, randomized signing) to the selected
+ * source:
+ *
+ * - System: getrandom() per request, as upstream
+ * - Buffered: a per-thread DRBG that squeezes BUFFER_BYTES at a time from
+ *   SHAKE256(key) and immediately replaces the key with fresh output
+ *   ("fast key erasure"). Served and unused bytes never outlive the buffer
+ *   they came from. The key is reseeded from getrandom() every
+ *   RESEED_BYTES of output and in the child after fork().
+ *
+ * The selection is process-wide and shared by all modes.
+ *
+ * @author Student Project - Cryptographic Systems Course
+ * @date December 2025
+ */
+
+#ifndef RANDOM_SOURCE_HPP
+#define RANDOM_SOURCE_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include "DilithiumParams.hpp"
+
+/**
+ * @brief Process-wide randomness selection
+ */
+class RandomSource {
+public:
+    static constexpr size_t BUFFER_BYTES = 4096;        // DRBG output per refill
+    static constexpr size_t RESEED_BYTES = 1 << 20;     // DRBG output between OS reseeds
+
+    /**
+     * @brief Get the source used by randombytes() (default: System)
+     */
+    static DilithiumRandomness current();
+
+    /**
+     * @brief Select the source used by randombytes() from now on
+     */
+    static void select(DilithiumRandomness source);
+
+    /**
+     * @brief Get a short printable name ("system", "buffered")
+     */
+    static const char* name(DilithiumRandomness source);
+
+    /**
+     * @brief Fill a buffer from the selected source; aborts if the OS fails
+     */
+    static void fill(uint8_t* out, size_t length);
+
+    /**
+     * @brief Fill a buffer directly with getrandom(); aborts if the OS fails
+     */
+    static void systemFill(uint8_t* out, size_t length);
+};
+
+#endif // RANDOM_SOURCE_HPP
@@ -0,0 +1,80 @@
+/**
+ * @file SchemeRegistry.cpp
+ * @brief Built-in signature schemes and name-based selection
+ */
+
+#include "SchemeRegistry.hpp"
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+
+namespace {
+
+std::string toLower(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return text;
+}
+
+} // namespace
+
+const SchemeInfo* SchemeRegistry::find(const std::string& name) const {
+    const std::string wanted = toLower(name);
+    for (const SchemeInfo& scheme : schemes_) {
+        if (toLower(scheme.name) == wanted) {
+            return &scheme;
+        }
+    }
+    return nullptr;
+}
+
+bool SchemeRegistry::select(const std::string& selection,
+                            std::vector<const SchemeInfo*>& selected,
+                            std::string& unknown) const {
+    std::vector<bool> chosen(schemes_.size(), false);
+    std::istringstream items(selection);
+    std::string item;
+
+    while (std::getline(items, item, ',')) {
+        const std::string wanted = toLower(item);
+        if (wanted.empty()) {
+            continue;
+        }
+
+        bool matched = false;
+        for (size_t i = 0; i < schemes_.size(); ++i) {
+            if (wanted == "all" || wanted == toLower(schemes_[i].name)
+                || wanted == schemes_[i].family) {
+                chosen[i] = true;
+                matched = true;
+            }
+        }
+        if (!matched) {
+            unknown = item;
+            return false;
+        }
+    }
+
+    selected.clear();
+    for (size_t i = 0; i < schemes_.size(); ++i) {
+        if (chosen[i]) {
+            selected.push_back(&schemes_[i]);
+        }
+    }
+    return true;
+}
+
+const SchemeRegistry& SchemeRegistry::builtin() {
+    static const SchemeRegistry registry = []() {
+        SchemeRegistry r;
+        r.add<DilithiumScheme<2>>("Dilithium2", "dilithium", "NIST Level 2", true);
+        r.add<DilithiumScheme<3>>("Dilithium3", "dilithium", "NIST Level 3", true);
+        r.add<DilithiumScheme<5>>("Dilithium5", "dilithium", "NIST Level 5", true);
+        r.add<RSAScheme>("RSA-2048", "rsa", "112-bit", false, 2048);
+        r.add<RSAScheme>("RSA-3072", "rsa", "128-bit", false, 3072);
+        r.add<ECScheme>("ECDSA-P256", "ecdsa", "128-bit", false, ECBenchmark::Curve::P256);
+        r.add<ECScheme>("Ed25519", "eddsa", "128-bit", false, ECBenchmark::Curve::Ed25519);
+        return r;
+    }();
+    return registry;
+}
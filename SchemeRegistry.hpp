@@ -0,0 +1,87 @@
+/**
+ * @file SchemeRegistry.hpp
+ * @brief Named list of the signature schemes the benchmark can run
+ *
+ * Each entry type-erases one SignatureScheme adapter behind a std::function
+ * that runs the whole benchmark, so the erasure costs one indirect call per
+ * scheme and none inside the timed loops. A new scheme needs an adapter in
+ * SignatureScheme.hpp and one add() call in SchemeRegistry::builtin().
+ *
+ * @author Student Project - Cryptographic Systems Course
+ * @date December 2025
+ */
+
+#ifndef SCHEME_REGISTRY_HPP
+#define SCHEME_REGISTRY_HPP
+
+#include "SignatureScheme.hpp"
+#include <functional>
+#include <string>
+#include <vector>
+#include <cstddef>
+
+/**
+ * @brief One registered signature scheme
+ */
+struct SchemeInfo {
+    std::string name;           // e.g. "Dilithium3", "RSA-2048"
+    std::string family;         // e.g. "dilithium", "rsa", "ecdsa", "eddsa"
+    std::string securityLevel;  // e.g. "NIST Level 3", "112-bit"
+    bool postQuantum;
+    std::function<SchemeResults(const std::vector<uint8_t>&, const SchemeRunConfig&)> benchmark;
+};
+
+/**
+ * @brief Ordered collection of signature schemes
+ */
+class SchemeRegistry {
+public:
+    /**
+     * @brief Register a scheme
+     * @tparam Scheme SignatureScheme adapter, constructed from args for every run
+     */
+    template <typename Scheme, typename... Args>
+    void add(const std::string& name, const std::string& family,
+             const std::string& securityLevel, bool postQuantum, Args... args) {
+        schemes_.push_back({name, family, securityLevel, postQuantum,
+            [args...](const std::vector<uint8_t>& message, const SchemeRunConfig& config) {
+                Scheme scheme(args...);
+                return scheme.benchmark(message, config);
+            }});
+    }
+
+    /**
+     * @brief All schemes in registration order
+     */
+    const std::vector<SchemeInfo>& schemes() const { return schemes_; }
+
+    /**
+     * @brief Look up a scheme by name (case-insensitive)
+     * @return The scheme, or nullptr if unknown
+     */
+    const SchemeInfo* find(const std::string& name) const;
+
+    /**
+     * @brief Resolve a comma-separated selection
+     *
+     * Every item is a scheme name, a family name (all schemes of the family)
+     * or "all". Matching is case-insensitive; duplicates are dropped.
+     *
+     * @param selection e.g. "dilithium,rsa-2048"
+     * @param selected Receives the schemes in registration order
+     * @param unknown Receives the first item that matched nothing
+     * @return true if every item matched
+     */
+    bool select(const std::string& selection, std::vector<const SchemeInfo*>& selected,
+                std::string& unknown) const;
+
+    /**
+     * @brief The schemes built into the benchmark
+     */
+    static const SchemeRegistry& builtin();
+
+private:
+    std::vector<SchemeInfo> schemes_;
+};
+
+#endif // SCHEME_REGISTRY_HPP
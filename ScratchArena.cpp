@@ -0,0 +1,134 @@
+/**
+ * @file ScratchArena.cpp
+ * @brief Per-thread scratch arena and the process-wide scratch mode
+ */
+
+#include "ScratchArena.hpp"
+#include "SecureMemory.hpp"
+#include <atomic>
+#include <new>
+
+namespace {
+
+std::atomic<DilithiumScratch> selectedMode(DilithiumScratch::Stack);
+
+size_t alignUp(size_t value) {
+    return (value + ScratchArena::ALIGNMENT - 1) & ~(ScratchArena::ALIGNMENT - 1);
+}
+
+} // namespace
+
+ScratchArena::Scope::Scope(ScratchArena& arena, bool wipe)
+    : arena_(arena), block_(arena.block_), offset_(arena.offset_), wipe_(wipe) {}
+
+ScratchArena::Scope::~Scope() {
+    arena_.release(block_, offset_, wipe_);
+}
+
+ScratchArena::~ScratchArena() {
+    release(0, 0, true);
+}
+
+ScratchArena& ScratchArena::local() {
+    thread_local ScratchArena arena;
+    return arena;
+}
+
+void* ScratchArena::allocate(size_t bytes) {
+    bytes = alignUp(bytes);
+
+    // Move on to the next block that fits; blocks too small are skipped, not freed,
+    // so that open scopes keep pointing at valid memory
+    while (blocks_.empty() || offset_ + bytes > blocks_[block_].size) {
+        if (!blocks_.empty() && block_ + 1 < blocks_.size()) {
+            used_ += blocks_[block_].size - offset_;
+            ++block_;
+            offset_ = 0;
+            continue;
+        }
+        const size_t size = bytes > BLOCK_BYTES ? bytes : BLOCK_BYTES;
+        Block block;
+        block.memory.reset(new (std::nothrow) uint8_t[size + ALIGNMENT]);
+        if (!block.memory) {
+            return nullptr;
+        }
+        const uintptr_t address = reinterpret_cast<uintptr_t>(block.memory.get());
+        block.begin = block.memory.get() + (alignUp(address) - address);
+        block.size = size;
+        try {
+            blocks_.push_back(std::move(block));
+        } catch (...) {
+            return nullptr;
+        }
+        if (blocks_.size() > 1) {
+            used_ += blocks_[block_].size - offset_;
+        }
+        block_ = blocks_.size() - 1;
+        offset_ = 0;
+    }
+
+    void* memory = blocks_[block_].begin + offset_;
+    offset_ += bytes;
+    used_ += bytes;
+    if (used_ > peak_) {
+        peak_ = used_;
+    }
+    return memory;
+}
+
+void ScratchArena::release(size_t block, size_t offset, bool wipe) {
+    if (blocks_.empty()) {
+        return;
+    }
+    // Wipe from the current position back to the scope's start, block by block
+    if (wipe) {
+        for (size_t index = block_; index > block; --index) {
+            secureWipe(blocks_[index].begin, index == block_ ? offset_ : blocks_[index].size);
+        }
+        const size_t end = block_ == block ? offset_ : blocks_[block].size;
+        secureWipe(blocks_[block].begin + offset, end - offset);
+    }
+
+    // Once empty, merge the blocks the last calls needed into one so that
+    // the same sequence of allocations fits without skipping block tails
+    if (block == 0 && offset == 0 && blocks_.size() > 1) {
+        const size_t size = capacityBytes();
+        Block merged;
+        merged.memory.reset(new (std::nothrow) uint8_t[size + ALIGNMENT]);
+        if (merged.memory) {
+            const uintptr_t address = reinterpret_cast<uintptr_t>(merged.memory.get());
+            merged.begin = merged.memory.get() + (alignUp(address) - address);
+            merged.size = size;
+            blocks_.clear();
+            blocks_.push_back(std::move(merged));
+        }
+    }
+
+    size_t used = offset;
+    for (size_t index = 0; index < block; ++index) {
+        used += blocks_[index].size;
+    }
+    used_ = used;
+    block_ = block;
+    offset_ = offset;
+}
+
+size_t ScratchArena::capacityBytes() const {
+    size_t bytes = 0;
+    for (const Block& block : blocks_) {
+        bytes += block.size;
+    }
+    return bytes;
+}
+
+DilithiumScratch ScratchArena::mode() {
+    return selectedMode.load(std::memory_order_relaxed);
+}
+
+void ScratchArena::setMode(DilithiumScratch mode) {
+    selectedMode.store(mode, std::memory_order_relaxed);
+}
+
+const char* ScratchArena::modeName(DilithiumScratch mode) {
+    return mode == DilithiumScratch::Arena ? "arena" : "stack";
+}
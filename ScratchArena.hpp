@@ -0,0 +1,128 @@
+/**
+ * @file ScratchArena.hpp
+ * @brief Per-thread arena for the temporary polynomial state of sign/verify
+ *
+ * The reference code keeps the matrix A and every intermediate vector on the
+ * stack: a Dilithium3 signature needs ~80 KB of stack, a verification
+ * ~55 KB. That is too much for servers running many small-stack fibers. In
+ * DilithiumScratch::Arena mode the prepared-key paths take their scratch
+ * vectors from a thread-local arena instead, and DilithiumWrapper's sign()
+ * and verify() run through those paths with the unpacked key in the arena
+ * too (a secret key only with heap key storage; see SecureMemory.hpp).
+ * Arena memory is 64-byte aligned, reused from call to call (no heap
+ * allocation once warm) and, for signing, wiped when the owning scope ends.
+ *
+ * @code
+ * DilithiumWrapper<3>::setScratchMode(DilithiumScratch::Arena);
+ * @endcode
+ *
+ * @author Student Project - Cryptographic Systems Course
+ * @date December 2025
+ */
+
+#ifndef SCRATCH_ARENA_HPP
+#define SCRATCH_ARENA_HPP
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "DilithiumParams.hpp"
+
+/**
+ * @brief Bump allocator with scoped release, one per thread
+ */
+class ScratchArena {
+public:
+    static constexpr size_t ALIGNMENT = 64;
+    static constexpr size_t BLOCK_BYTES = 64 * 1024;    // Minimum block size
+
+    /**
+     * @brief Releases everything allocated during its lifetime
+     *
+     * The memory is wiped unless the scope is told it holds no secrets.
+     */
+    class Scope {
+    public:
+        explicit Scope(ScratchArena& arena, bool wipe = true);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        ScratchArena& arena_;
+        size_t block_;
+        size_t offset_;
+        bool wipe_;
+    };
+
+    ScratchArena() = default;
+    ~ScratchArena();
+
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    /**
+     * @brief Get the calling thread's arena
+     */
+    static ScratchArena& local();
+
+    /**
+     * @brief Allocate ALIGNMENT-aligned memory until the enclosing Scope ends
+     * @return The memory, or nullptr if a new block could not be allocated
+     */
+    void* allocate(size_t bytes);
+
+    /**
+     * @brief Allocate an uninitialized trivially constructible object
+     */
+    template <typename T>
+    T* create() {
+        return static_cast<T*>(allocate(sizeof(T)));
+    }
+
+    /**
+     * @brief Bytes reserved in blocks, kept for reuse
+     */
+    size_t capacityBytes() const;
+
+    /**
+     * @brief Most bytes in use at once since the last resetPeak()
+     */
+    size_t peakBytes() const { return peak_; }
+
+    void resetPeak() { peak_ = used_; }
+
+    /**
+     * @brief Get the process-wide scratch mode (default: Stack)
+     */
+    static DilithiumScratch mode();
+
+    /**
+     * @brief Select where sign/verify keep their temporaries from now on
+     */
+    static void setMode(DilithiumScratch mode);
+
+    /**
+     * @brief Get a short printable mode name ("stack", "arena")
+     */
+    static const char* modeName(DilithiumScratch mode);
+
+private:
+    struct Block {
+        std::unique_ptr<uint8_t[]> memory;
+        uint8_t* begin;         // First ALIGNMENT-aligned byte
+        size_t size;            // Usable bytes from begin
+    };
+
+    void release(size_t block, size_t offset, bool wipe);
+
+    std::vector<Block> blocks_;
+    size_t block_ = 0;          // Block allocated from
+    size_t offset_ = 0;         // Next free byte in blocks_[block_]
+    size_t used_ = 0;
+    size_t peak_ = 0;
+};
+
+#endif // SCRATCH_ARENA_HPP
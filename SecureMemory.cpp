@@ -0,0 +1,186 @@
+/**
+ * @file SecureMemory.cpp
+ * @brief secureWipe(), the secure key slab pool and the key storage selection
+ */
+
+#include "SecureMemory.hpp"
+#include <atomic>
+#include <string.h>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define SECURE_MEMORY_HAVE_MMAN 1
+#endif
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 25))
+#define SECURE_MEMORY_HAVE_EXPLICIT_BZERO 1
+#endif
+
+namespace {
+
+std::atomic<DilithiumKeyStorage> selectedStorage(DilithiumKeyStorage::SecurePool);
+
+size_t roundUp(size_t value, size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+} // namespace
+
+void secureWipe(void* data, size_t size) {
+    if (!data || size == 0) {
+        return;
+    }
+#ifdef SECURE_MEMORY_HAVE_EXPLICIT_BZERO
+    explicit_bzero(data, size);
+#else
+    volatile uint8_t* bytes = static_cast<volatile uint8_t*>(data);
+    size_t i = 0;
+    for (; i < size && reinterpret_cast<uintptr_t>(bytes + i) % sizeof(uint64_t) != 0; ++i) {
+        bytes[i] = 0;
+    }
+    volatile uint64_t* words = reinterpret_cast<volatile uint64_t*>(bytes + i);
+    for (size_t word = 0; word < (size - i) / sizeof(uint64_t); ++word) {
+        words[word] = 0;
+    }
+    for (i += (size - i) / sizeof(uint64_t) * sizeof(uint64_t); i < size; ++i) {
+        bytes[i] = 0;
+    }
+#endif
+}
+
+SecureKeyPool::SecureKeyPool(size_t objectBytes, size_t alignment)
+    : objectBytes_(objectBytes),
+      alignment_(alignment > 0 && alignment <= ALIGNMENT ? alignment : ALIGNMENT) {
+#ifdef SECURE_MEMORY_HAVE_MMAN
+    const long page = ::sysconf(_SC_PAGESIZE);
+    pageBytes_ = page > 0 ? static_cast<size_t>(page) : 4096;
+#else
+    pageBytes_ = ALIGNMENT;
+#endif
+    slotPages_ = roundUp(objectBytes_ > 0 ? objectBytes_ : 1, pageBytes_);
+    // As close to the guard page as the alignment allows
+    objectOffset_ = (slotPages_ - objectBytes_) / alignment_ * alignment_;
+    // Leading guard, then every slot followed by its guard
+    const size_t stride = slotPages_ + pageBytes_;
+    slotsPerSlab_ = SLAB_BYTES > stride ? (SLAB_BYTES - pageBytes_) / stride : 1;
+}
+
+SecureKeyPool::~SecureKeyPool() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const size_t stride = slotPages_ + pageBytes_;
+    for (const Slab& slab : slabs_) {
+        for (size_t slot = 0; slot < slotsPerSlab_; ++slot) {
+            secureWipe(slab.base + pageBytes_ + slot * stride, slotPages_);
+        }
+#ifdef SECURE_MEMORY_HAVE_MMAN
+        ::munmap(slab.base, slab.bytes);
+#else
+        ::operator delete(slab.base, std::align_val_t(ALIGNMENT));
+#endif
+    }
+}
+
+bool SecureKeyPool::addSlab() {
+    const size_t stride = slotPages_ + pageBytes_;
+    const size_t bytes = pageBytes_ + slotsPerSlab_ * stride;
+    free_.reserve(free_.size() + slotsPerSlab_);
+
+#ifdef SECURE_MEMORY_HAVE_MMAN
+    void* mapped = ::mmap(nullptr, bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+    uint8_t* base = static_cast<uint8_t*>(mapped);
+#ifdef MADV_DONTDUMP
+    ::madvise(base, bytes, MADV_DONTDUMP);
+#endif
+    for (size_t slot = 0; slot < slotsPerSlab_; ++slot) {
+        uint8_t* pages = base + pageBytes_ + slot * stride;
+        if (::mprotect(pages, slotPages_, PROT_READ | PROT_WRITE) != 0) {
+            ::munmap(base, bytes);
+            return false;
+        }
+    }
+    // Lock slot by slot: an exhausted RLIMIT_MEMLOCK leaves the rest unlocked
+    for (size_t slot = 0; slot < slotsPerSlab_; ++slot) {
+        uint8_t* pages = base + pageBytes_ + slot * stride;
+        if (::mlock(pages, slotPages_) == 0) {
+            lockedBytes_ += slotPages_;
+        } else {
+            ++unlockedSlots_;
+        }
+    }
+#else
+    uint8_t* base = static_cast<uint8_t*>(
+        ::operator new(bytes, std::align_val_t(ALIGNMENT), std::nothrow));
+    if (!base) {
+        return false;
+    }
+    std::memset(base, 0, bytes);
+    unlockedSlots_ += slotsPerSlab_;
+#endif
+
+    slabs_.push_back({base, bytes});
+    // Pushed in reverse so slot 0 goes first
+    for (size_t slot = slotsPerSlab_; slot-- > 0;) {
+        free_.push_back(base + pageBytes_ + slot * stride + objectOffset_);
+    }
+    return true;
+}
+
+void* SecureKeyPool::allocate() {
+    try {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (free_.empty() && !addSlab()) {
+            return nullptr;
+        }
+        void* slot = free_.back();
+        free_.pop_back();
+        ++inUse_;
+        return slot;
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void SecureKeyPool::deallocate(void* slot) {
+    if (!slot) {
+        return;
+    }
+    secureWipe(slot, objectBytes_);
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Capacity for every slot was reserved in addSlab(), so this cannot throw
+    free_.push_back(slot);
+    --inUse_;
+}
+
+SecureKeyPool::Stats SecureKeyPool::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats;
+    stats.objectBytes = objectBytes_;
+    stats.slotBytes = slotPages_;
+    stats.slotStride = slotPages_ + pageBytes_;
+    stats.slabs = slabs_.size();
+    stats.slots = slabs_.size() * slotsPerSlab_;
+    stats.inUse = inUse_;
+    for (const Slab& slab : slabs_) {
+        stats.mappedBytes += slab.bytes;
+    }
+    stats.readableBytes = stats.slots * slotPages_;
+    stats.lockedBytes = lockedBytes_;
+    stats.unlockedSlots = unlockedSlots_;
+    return stats;
+}
+
+DilithiumKeyStorage SecureKeyPool::storage() {
+    return selectedStorage.load(std::memory_order_relaxed);
+}
+
+void SecureKeyPool::setStorage(DilithiumKeyStorage storage) {
+    selectedStorage.store(storage, std::memory_order_relaxed);
+}
+
+const char* SecureKeyPool::storageName(DilithiumKeyStorage storage) {
+    return storage == DilithiumKeyStorage::SecurePool ? "pool" : "heap";
+}
@@ -0,0 +1,271 @@
+/**
+ * @file SecureMemory.hpp
+ * @brief Wiping and a locked, guard-paged slab pool for secret key material
+ *
+ * A process holding thousands of signing keys should not scatter them over
+ * the general heap, where they can be swapped out, end up in core dumps and
+ * sit next to buffers that might overrun into them. SecureKeyPool hands out
+ * fixed-size slots carved from page-aligned slabs:
+ *
+ *     | guard | slot 0 | guard | slot 1 | guard | ... | slot n-1 | guard |
+ *
+ * - Every slot is mlock()'ed so the key never reaches swap, and the slabs
+ *   are excluded from core dumps (MADV_DONTDUMP).
+ * - PROT_NONE guard pages separate the slots, and each object ends at the
+ *   guard page after its slot (up to the padding its alignment needs), so a
+ *   linear overrun faults instead of reading or writing the neighbouring key.
+ *   The price is address space: a slot takes whole pages plus its guard, 8
+ *   KB for a 4 KB packed Dilithium3 secret key (Stats::slotStride).
+ * - Released slots are wiped and kept on a free list. Loading and dropping
+ *   keys reuses them without a system call and without fragmenting the heap;
+ *   slabs are only returned when the pool is destroyed.
+ *
+ * If RLIMIT_MEMLOCK is exhausted the slots are still handed out, unlocked,
+ * and counted in Stats::unlockedSlots. Without mmap (non-Linux builds) the
+ * pool falls back to aligned heap blocks.
+ *
+ * SecureBox<T> owns one T in the storage selected by
+ * SecureKeyPool::setStorage(): a slot of the pool of T, or a heap block.
+ * DilithiumWrapper keeps its packed secret key and PreparedSigningKey its
+ * expanded state in one. Signing straight from a packed key (sign() in
+ * Arena scratch mode) also unpacks it into a pool slot for the duration of
+ * the call. What the pool does not cover is the per-signature scratch of
+ * the signing loop - the masking vector y and the candidate z - which stays
+ * in the thread's ScratchArena or on the stack: unlocked, but wiped when
+ * the signature is done.
+ *
+ * @code
+ * DilithiumWrapper<3>::setKeyStorage(DilithiumKeyStorage::SecurePool);  // the default
+ * SecureKeyPool::Stats stats = securePoolFor<MyState>().stats();
+ * @endcode
+ *
+ * @author Student Project - Cryptographic Systems Course
+ * @date December 2025
+ */
+
+#ifndef SECURE_MEMORY_HPP
+#define SECURE_MEMORY_HPP
+
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include "DilithiumParams.hpp"
+
+/**
+ * @brief Zero memory in a way the compiler cannot remove
+ *
+ * explicit_bzero() where the C library has it (memset speed), otherwise a
+ * volatile loop of 64-bit stores.
+ */
+void secureWipe(void* data, size_t size);
+
+/**
+ * @brief Slab allocator of wiped, locked, guard-paged fixed-size slots
+ */
+class SecureKeyPool {
+public:
+    static constexpr size_t ALIGNMENT = 64;
+    static constexpr size_t SLAB_BYTES = 1024 * 1024;     // Target slab size
+
+    /**
+     * @brief Memory use of the pool
+     */
+    struct Stats {
+        size_t objectBytes = 0;
+        size_t slotBytes = 0;       // Readable pages per slot, at least one page
+        size_t slotStride = 0;      // Cost of a slot: its pages plus the guard page
+        size_t slabs = 0;
+        size_t slots = 0;           // Slots in all slabs
+        size_t inUse = 0;
+        size_t mappedBytes = 0;     // Address space of all slabs
+        size_t readableBytes = 0;   // Slot pages of all slabs, guards excluded
+        size_t lockedBytes = 0;     // Slot pages mlock() succeeded for
+        size_t unlockedSlots = 0;   // Slots handed out unlocked (RLIMIT_MEMLOCK)
+    };
+
+    /**
+     * @brief Constructor - no memory is mapped until the first allocate()
+     * @param objectBytes Size of one object
+     * @param alignment Alignment of the objects, a power of two up to ALIGNMENT
+     */
+    explicit SecureKeyPool(size_t objectBytes, size_t alignment = ALIGNMENT);
+
+    /**
+     * @brief Destructor - wipes and unmaps every slab, live slots included
+     */
+    ~SecureKeyPool();
+
+    SecureKeyPool(const SecureKeyPool&) = delete;
+    SecureKeyPool& operator=(const SecureKeyPool&) = delete;
+
+    /**
+     * @brief Take a free slot, mapping a new slab if none is left
+     * @return objectBytes of memory with the pool's alignment, ending at a
+     *         guard page, or nullptr if mmap failed
+     */
+    void* allocate();
+
+    /**
+     * @brief Wipe a slot from allocate() and return it to the free list
+     */
+    void deallocate(void* slot);
+
+    /**
+     * @brief Current memory use
+     */
+    Stats stats() const;
+
+    /**
+     * @brief Get the storage SecureBox allocates from (default: SecurePool)
+     *
+     * Process-wide. Boxes created before a change keep their storage.
+     */
+    static DilithiumKeyStorage storage();
+
+    /**
+     * @brief Select the storage of SecureBox objects created from now on
+     */
+    static void setStorage(DilithiumKeyStorage storage);
+
+    /**
+     * @brief Get a short printable storage name ("heap", "pool")
+     */
+    static const char* storageName(DilithiumKeyStorage storage);
+
+private:
+    struct Slab {
+        uint8_t* base;
+        size_t bytes;
+    };
+
+    bool addSlab();
+
+    const size_t objectBytes_;
+    const size_t alignment_;
+    size_t pageBytes_;
+    size_t slotPages_;              // Readable bytes per slot, whole pages
+    size_t objectOffset_;           // Object start within the slot pages
+    size_t slotsPerSlab_;
+    mutable std::mutex mutex_;
+    std::vector<Slab> slabs_;
+    std::vector<void*> free_;
+    size_t inUse_ = 0;
+    size_t lockedBytes_ = 0;
+    size_t unlockedSlots_ = 0;
+};
+
+/**
+ * @brief The process-wide pool for objects of type T
+ *
+ * Created on first use and never destroyed, so keys in static objects can
+ * still be released during exit.
+ */
+template <typename T>
+SecureKeyPool& securePoolFor() {
+    static SecureKeyPool* pool = new SecureKeyPool(sizeof(T), alignof(T));
+    return *pool;
+}
+
+/**
+ * @brief Owning pointer to one T in secure key storage
+ *
+ * T must be trivially copyable with an alignment of at most
+ * SecureKeyPool::ALIGNMENT; the object is default-initialized. Copies are
+ * deep and allocate from the storage selected at the time of the copy.
+ */
+template <typename T>
+class SecureBox {
+public:
+    SecureBox() = default;
+    ~SecureBox() { reset(); }
+
+    SecureBox(const SecureBox& other) : SecureBox() {
+        if (other.object_) {
+            *this = create();
+            if (!object_) {
+                throw std::bad_alloc();
+            }
+            std::memcpy(static_cast<void*>(object_), other.object_, sizeof(T));
+        }
+    }
+
+    SecureBox& operator=(const SecureBox& other) {
+        if (this != &other) {
+            SecureBox copy(other);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    SecureBox(SecureBox&& other) noexcept
+        : object_(std::exchange(other.object_, nullptr)), pool_(std::exchange(other.pool_, nullptr)) {}
+
+    SecureBox& operator=(SecureBox&& other) noexcept {
+        if (this != &other) {
+            reset();
+            object_ = std::exchange(other.object_, nullptr);
+            pool_ = std::exchange(other.pool_, nullptr);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Allocate a T in the current storage
+     * @return The box, empty if the allocation failed
+     */
+    static SecureBox create() {
+        static_assert(alignof(T) <= SecureKeyPool::ALIGNMENT, "over-aligned type");
+        SecureBox box;
+        void* memory = nullptr;
+        if (SecureKeyPool::storage() == DilithiumKeyStorage::SecurePool) {
+            box.pool_ = &securePoolFor<T>();
+            memory = box.pool_->allocate();
+        } else {
+            memory = ::operator new(sizeof(T), std::align_val_t(SecureKeyPool::ALIGNMENT),
+                                    std::nothrow);
+        }
+        if (!memory) {
+            box.pool_ = nullptr;
+            return box;
+        }
+        box.object_ = new (memory) T;
+        return box;
+    }
+
+    /**
+     * @brief Wipe and release the object
+     */
+    void reset() {
+        if (!object_) {
+            return;
+        }
+        if (pool_) {
+            pool_->deallocate(object_);
+        } else {
+            secureWipe(object_, sizeof(T));
+            ::operator delete(object_, std::align_val_t(SecureKeyPool::ALIGNMENT));
+        }
+        object_ = nullptr;
+        pool_ = nullptr;
+    }
+
+    T* get() const { return object_; }
+    T& operator*() const { return *object_; }
+    T* operator->() const { return object_; }
+    explicit operator bool() const { return object_ != nullptr; }
+
+    /**
+     * @brief Check if the object lives in a SecureKeyPool slot
+     */
+    bool pooled() const { return pool_ != nullptr; }
+
+private:
+    T* object_ = nullptr;
+    SecureKeyPool* pool_ = nullptr;     // nullptr for heap storage
+};
+
+#endif // SECURE_MEMORY_HPP
@@ -0,0 +1,236 @@
+/**
+ * @file SignTool.cpp
+ * @brief dilithium_sign: sign files and directory trees into a signature manifest
+ *
+ * Runs a BulkSigner over the given roots and reports the overall files/s
+ * and MB/s together with the busy share and the standalone capacity of
+ * every pipeline stage, so the stage that limits the run stands out.
+ *
+ * Without --key a fresh key pair is generated and its packed public key is
+ * written next to the manifest as <manifest>.pub.
+ */
+
+#include "BenchmarkOptions.hpp"
+#include "BulkSigner.hpp"
+#include "Dilithiumwrapper.hpp"
+#include "SecureMemory.hpp"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <cstdlib>
+
+namespace {
+
+struct Options {
+    int mode = 3;
+    std::string manifestPath = "signatures.manifest";
+    std::string keyPath;                    // Empty: generate a key pair
+    BulkSignerConfig config;
+    std::vector<std::string> roots;
+};
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options] <file or directory>...\n\n"
+              << "  -o, --manifest <file>     Manifest to write (default signatures.manifest)\n"
+              << "  --key <file>              Packed secret key (default: generate a key pair\n"
+              << "                            and write its public key to <manifest>.pub)\n"
+              << "  --mode <2|3|5>            Dilithium mode (default 3)\n"
+              << "  --readers <n>             Read threads (default 2)\n"
+              << "  --hashers <n>             Hash threads (default: hardware threads)\n"
+              << "  --signers <n>             Sign threads (default: hardware threads)\n"
+              << "  --read-size <bytes>       Bytes per read(), e.g. 1M, 1MiB (default 4M)\n"
+              << "  --chunks <n>              Read buffers in flight (default: 2 per read\n"
+              << "                            and hash thread)\n";
+}
+
+bool parseOptions(int argc, char** argv, Options& options, bool& help, std::string& error) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            help = true;
+            continue;
+        }
+        if (arg.empty() || arg[0] != '-') {
+            options.roots.push_back(arg);
+            continue;
+        }
+        if (arg != "-o" && arg != "--manifest" && arg != "--key" && arg != "--mode"
+            && arg != "--readers" && arg != "--hashers" && arg != "--signers"
+            && arg != "--read-size" && arg != "--chunks") {
+            error = "unknown option '" + arg + "'";
+            return false;
+        }
+        if (i + 1 >= argc) {
+            error = arg + " needs a value";
+            return false;
+        }
+        const std::string value = argv[++i];
+
+        bool ok = true;
+        if (arg == "-o" || arg == "--manifest") {
+            options.manifestPath = value;
+        } else if (arg == "--key") {
+            options.keyPath = value;
+        } else if (arg == "--mode") {
+            ok = value == "2" || value == "3" || value == "5";
+            options.mode = std::atoi(value.c_str());
+        } else if (arg == "--readers") {
+            ok = parseCount(value, options.config.readers) && options.config.readers > 0;
+        } else if (arg == "--hashers") {
+            ok = parseCount(value, options.config.hashers) && options.config.hashers > 0;
+        } else if (arg == "--signers") {
+            ok = parseCount(value, options.config.signers) && options.config.signers > 0;
+        } else if (arg == "--read-size") {
+            ok = parseBytes(value, options.config.readBytes) && options.config.readBytes > 0;
+        } else {
+            ok = parseCount(value, options.config.chunks) && options.config.chunks > 0;
+        }
+        if (!ok) {
+            error = "invalid value '" + value + "' for " + arg;
+            return false;
+        }
+    }
+    if (!help && options.roots.empty()) {
+        error = "no files or directories to sign";
+        return false;
+    }
+    return true;
+}
+
+bool readFile(const std::string& path, std::vector<uint8_t>& data) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return !in.bad();
+}
+
+void printSeparator() {
+    std::cout << "+" << std::string(8, '-') << "+" << std::string(9, '-')
+              << "+" << std::string(10, '-') << "+" << std::string(15, '-')
+              << "+" << std::string(15, '-') << "+\n";
+}
+
+void printReport(const BulkSignerStats& stats, const std::string& manifestPath) {
+    const double megabyte = 1024.0 * 1024.0;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Signed " << stats.files << " files, " << stats.bytes / megabyte << " MB in "
+              << std::setprecision(3) << stats.seconds << " s: " << std::setprecision(1)
+              << stats.filesPerSecond() << " files/s, " << stats.bytesPerSecond() / megabyte
+              << " MB/s\n";
+    std::cout << "Manifest: " << manifestPath << "\n\n";
+
+    printSeparator();
+    std::cout << "| " << std::setw(6) << std::left << "Stage"
+              << " | " << std::setw(7) << std::right << "Threads"
+              << " | " << std::setw(8) << "Busy (%)"
+              << " | " << std::setw(13) << "Max files/s"
+              << " | " << std::setw(13) << "Max MB/s" << " |\n";
+    printSeparator();
+    const BulkSignerStage* bottleneck = nullptr;
+    for (const BulkSignerStage& stage : stats.stages) {
+        std::cout << "| " << std::setw(6) << std::left << stage.name
+                  << " | " << std::setw(7) << std::right << stage.threads
+                  << " | " << std::setw(8) << 100.0 * stage.utilization(stats.seconds)
+                  << " | " << std::setw(13) << stage.capacityFilesPerSecond()
+                  << " | " << std::setw(13);
+        if (stage.bytes > 0) {
+            std::cout << stage.capacityBytesPerSecond() / megabyte;
+        } else {
+            std::cout << "-";
+        }
+        std::cout << " |\n";
+        if (!bottleneck || stage.utilization(stats.seconds) > bottleneck->utilization(stats.seconds)) {
+            bottleneck = &stage;
+        }
+    }
+    printSeparator();
+    if (bottleneck && stats.files > 0) {
+        std::cout << "Bottleneck: " << bottleneck->name
+                  << " (busiest stage; add threads there or shrink its work)\n";
+    }
+}
+
+template <int Mode>
+int runTool(const Options& options) {
+    DilithiumWrapper<Mode> keys;
+    std::vector<std::string> outputs = {options.manifestPath};
+    if (options.keyPath.empty()) {
+        const std::string publicKeyPath = options.manifestPath + ".pub";
+        outputs.push_back(publicKeyPath);
+        const std::vector<uint8_t> publicKey = keys.generateKeys() ? keys.getPublicKey()
+                                                                    : std::vector<uint8_t>();
+        std::ofstream out(publicKeyPath, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(publicKey.data()),
+                  static_cast<std::streamsize>(publicKey.size()));
+        if (publicKey.empty() || !out) {
+            std::cerr << "Error: cannot write the public key to " << publicKeyPath << "\n";
+            return 1;
+        }
+        std::cout << "Generated a Dilithium" << Mode << " key pair, public key: "
+                  << publicKeyPath << "\n";
+    } else {
+        // Reserved up front so reading a key of the right size never leaves
+        // an unwiped copy behind in a reallocated buffer
+        std::vector<uint8_t> secretKey;
+        secretKey.reserve(DilithiumWrapper<Mode>::SECRET_KEY_BYTES + 1);
+        const bool loaded = readFile(options.keyPath, secretKey) && keys.setSecretKey(secretKey);
+        secureWipe(secretKey.data(), secretKey.size());
+        if (!loaded) {
+            std::cerr << "Error: " << options.keyPath << " is not a Dilithium" << Mode
+                      << " secret key\n";
+            return 1;
+        }
+    }
+
+    const PreparedSigningKey<Mode> key = keys.prepareSigningKey();
+    std::ofstream manifest(options.manifestPath, std::ios::binary);
+    if (!key.isValid() || !manifest) {
+        std::cerr << "Error: cannot write " << options.manifestPath << "\n";
+        return 1;
+    }
+
+    BulkSigner<Mode> signer(key, options.config);
+    const bool ok = signer.run(options.roots, manifest, outputs);
+    manifest.close();
+    printReport(signer.stats(), options.manifestPath);
+
+    const std::vector<std::string>& failed = signer.stats().failed;
+    for (size_t i = 0; i < failed.size() && i < 10; ++i) {
+        std::cerr << "Error: cannot read " << failed[i] << "\n";
+    }
+    if (failed.size() > 10) {
+        std::cerr << "... and " << failed.size() - 10 << " more\n";
+    }
+    if (!ok && failed.empty()) {
+        std::cerr << "Error: cannot write " << options.manifestPath << "\n";
+    }
+    return ok && manifest ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    bool help = false;
+    std::string error;
+    if (!parseOptions(argc, argv, options, help, error)) {
+        std::cerr << "Error: " << error << "\n\n";
+        printUsage(argv[0]);
+        return 2;
+    }
+    if (help) {
+        printUsage(argv[0]);
+        return 0;
+    }
+
+    switch (options.mode) {
+        case 2: return runTool<2>(options);
+        case 5: return runTool<5>(options);
+        default: return runTool<3>(options);
+    }
+}
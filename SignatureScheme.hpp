@@ -0,0 +1,271 @@
+/**
+ * @file SignatureScheme.hpp
+ * @brief Common benchmark interface for signature schemes (CRTP)
+ *
+ * SignatureScheme<Derived> implements the keygen/sign/verify benchmark once
+ * for every scheme. Derived only has to provide
+ *
+ * @code
+ * bool generateKeys();
+ * std::vector<uint8_t> sign(const std::vector<uint8_t>& message);
+ * bool verify(const std::vector<uint8_t>& message, const std::vector<uint8_t>& signature);
+ * size_t publicKeySize() const;
+ * std::string backendName() const;
+ * @endcode
+ *
+ * and may add signCold()/verifyCold() for a per-call setup path. The calls
+ * are resolved at compile time, so the timed loops contain no virtual
+ * dispatch beyond the std::function in Benchmark::run(). The adapters at the
+ * end of this file connect the existing wrappers; SchemeRegistry makes them
+ * selectable by name.
+ *
+ * @author Student Project - Cryptographic Systems Course
+ * @date December 2025
+ */
+
+#ifndef SIGNATURE_SCHEME_HPP
+#define SIGNATURE_SCHEME_HPP
+
+#include "Benchmark.hpp"
+#include "Dilithiumwrapper.hpp"
+#include "RSABenchmark.hpp"
+#include "ECBenchmark.hpp"
+#include <vector>
+#include <string>
+#include <utility>
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @brief Key generation, signing and verification results of one scheme
+ */
+struct SchemeResults {
+    Benchmark::Result keyGen;
+    Benchmark::Result sign;
+    Benchmark::Result verify;
+    bool hasColdPath;           // signCold/verifyCold were measured
+    Benchmark::Result signCold;
+    Benchmark::Result verifyCold;
+    size_t publicKeySize;
+    size_t signatureSize;
+    bool valid;                 // The last signature verified
+    std::string backend;
+};
+
+/**
+ * @brief Which operations to measure and for how long
+ */
+struct SchemeRunConfig {
+    size_t iterations = 100;        // Timed sign/verify runs
+    size_t keyGenIterations = 10;   // Timed key generation runs
+    double seconds = 0.0;           // Time budget per operation (> 0 replaces the counts)
+    bool keyGen = true;
+    bool sign = true;
+    bool verify = true;
+};
+
+namespace detail {
+
+template <typename T, typename = void>
+struct HasColdPath : std::false_type {};
+
+template <typename T>
+struct HasColdPath<T, std::void_t<
+    decltype(std::declval<T&>().signCold(std::declval<const std::vector<uint8_t>&>())),
+    decltype(std::declval<T&>().verifyCold(std::declval<const std::vector<uint8_t>&>(),
+                                           std::declval<const std::vector<uint8_t>&>()))>>
+    : std::true_type {};
+
+} // namespace detail
+
+/**
+ * @brief CRTP base providing the benchmark for a signature scheme
+ * @tparam Derived The scheme adapter
+ */
+template <typename Derived>
+class SignatureScheme {
+public:
+    /**
+     * @brief Benchmark key generation, signing and verification
+     *
+     * Operations that are switched off in the config are not timed and
+     * keep a zero Result (iterations == 0).
+     *
+     * @param message Message to sign
+     * @param config Operations and iteration counts or time budget
+     * @return The results
+     */
+    SchemeResults benchmark(const std::vector<uint8_t>& message, const SchemeRunConfig& config) {
+        Derived& scheme = static_cast<Derived&>(*this);
+        std::vector<uint8_t> signature;
+        SchemeResults results{};
+
+        if (config.keyGen) {
+            results.keyGen = measure([&]() {
+                scheme.generateKeys();
+            }, config.keyGenIterations, config.seconds);
+        }
+
+        // Keys for signing/verification
+        scheme.generateKeys();
+
+        if (config.sign) {
+            results.sign = measure([&]() {
+                signature = scheme.sign(message);
+            }, config.iterations, config.seconds);
+        }
+
+        signature = scheme.sign(message);
+
+        if (config.verify) {
+            results.verify = measure([&]() {
+                scheme.verify(message, signature);
+            }, config.iterations, config.seconds);
+        }
+
+        results.hasColdPath = false;
+        benchmarkColdPath(scheme, message, signature, config, results,
+                          detail::HasColdPath<Derived>());
+
+        results.valid = scheme.verify(message, signature);
+        results.publicKeySize = scheme.publicKeySize();
+        results.signatureSize = signature.size();
+        results.backend = scheme.backendName();
+        return results;
+    }
+
+    /**
+     * @brief Benchmark all three operations with fixed iteration counts
+     */
+    SchemeResults benchmark(const std::vector<uint8_t>& message,
+                            size_t iterations, size_t keyGenIterations) {
+        SchemeRunConfig config;
+        config.iterations = iterations;
+        config.keyGenIterations = keyGenIterations;
+        return benchmark(message, config);
+    }
+
+private:
+    template <typename Func>
+    static Benchmark::Result measure(Func func, size_t iterations, double seconds) {
+        return seconds > 0.0 ? Benchmark::runFor(func, seconds) : Benchmark::run(func, iterations);
+    }
+
+    static void benchmarkColdPath(Derived&, const std::vector<uint8_t>&,
+                                  const std::vector<uint8_t>&, const SchemeRunConfig&,
+                                  SchemeResults&, std::false_type) {
+    }
+
+    static void benchmarkColdPath(Derived& scheme, const std::vector<uint8_t>& message,
+                                  const std::vector<uint8_t>& signature,
+                                  const SchemeRunConfig& config,
+                                  SchemeResults& results, std::true_type) {
+        std::vector<uint8_t> coldSignature;
+
+        if (config.sign) {
+            results.signCold = measure([&]() {
+                coldSignature = scheme.signCold(message);
+            }, config.iterations, config.seconds);
+        }
+
+        if (config.verify) {
+            results.verifyCold = measure([&]() {
+                scheme.verifyCold(message, signature);
+            }, config.iterations, config.seconds);
+        }
+
+        results.hasColdPath = config.sign || config.verify;
+    }
+};
+
+/**
+ * @brief CRYSTALS-Dilithium through DilithiumWrapper
+ * @tparam Mode Dilithium mode (2, 3 or 5)
+ */
+template <int Mode>
+class DilithiumScheme : public SignatureScheme<DilithiumScheme<Mode>> {
+public:
+    bool generateKeys() { return dilithium_.generateKeys(); }
+
+    std::vector<uint8_t> sign(const std::vector<uint8_t>& message) {
+        return dilithium_.sign(message);
+    }
+
+    bool verify(const std::vector<uint8_t>& message, const std::vector<uint8_t>& signature) {
+        return dilithium_.verify(message, signature);
+    }
+
+    size_t publicKeySize() const { return DilithiumWrapper<Mode>::PUBLIC_KEY_BYTES; }
+
+    std::string backendName() const {
+        return DilithiumWrapper<Mode>::backendName(DilithiumWrapper<Mode>::backend());
+    }
+
+private:
+    DilithiumWrapper<Mode> dilithium_;
+};
+
+/**
+ * @brief RSA (SHA-256) through RSABenchmark
+ */
+class RSAScheme : public SignatureScheme<RSAScheme> {
+public:
+    explicit RSAScheme(int keySize) : rsa_(keySize) {}
+
+    bool generateKeys() { return rsa_.generateKeys(); }
+
+    std::vector<uint8_t> sign(const std::vector<uint8_t>& message) { return rsa_.sign(message); }
+
+    bool verify(const std::vector<uint8_t>& message, const std::vector<uint8_t>& signature) {
+        return rsa_.verify(message, signature);
+    }
+
+    std::vector<uint8_t> signCold(const std::vector<uint8_t>& message) {
+        return rsa_.signCold(message);
+    }
+
+    bool verifyCold(const std::vector<uint8_t>& message, const std::vector<uint8_t>& signature) {
+        return rsa_.verifyCold(message, signature);
+    }
+
+    size_t publicKeySize() const { return rsa_.getPublicKeySize(); }
+
+    std::string backendName() const { return "openssl"; }
+
+private:
+    RSABenchmark rsa_;
+};
+
+/**
+ * @brief ECDSA P-256 / Ed25519 through ECBenchmark
+ */
+class ECScheme : public SignatureScheme<ECScheme> {
+public:
+    explicit ECScheme(ECBenchmark::Curve curve) : ec_(curve) {}
+
+    bool generateKeys() { return ec_.generateKeys(); }
+
+    std::vector<uint8_t> sign(const std::vector<uint8_t>& message) { return ec_.sign(message); }
+
+    bool verify(const std::vector<uint8_t>& message, const std::vector<uint8_t>& signature) {
+        return ec_.verify(message, signature);
+    }
+
+    std::vector<uint8_t> signCold(const std::vector<uint8_t>& message) {
+        return ec_.signCold(message);
+    }
+
+    bool verifyCold(const std::vector<uint8_t>& message, const std::vector<uint8_t>& signature) {
+        return ec_.verifyCold(message, signature);
+    }
+
+    size_t publicKeySize() const { return ec_.getPublicKeySize(); }
+
+    std::string backendName() const { return "openssl"; }
+
+private:
+    ECBenchmark ec_;
+};
+
+#endif // SIGNATURE_SCHEME_HPP
@@ -0,0 +1,111 @@
+/**
+ * @file ThreadPool.hpp
+ * @brief Work-stealing thread pool used by DilithiumEngine
+ *
+ * Every worker owns a double-ended task queue. A worker pops new work from
+ * the back of its own queue (LIFO, cache-warm) and, when that queue is
+ * empty, steals from the front of the other workers' queues (FIFO, oldest
+ * first). Tasks submitted from outside the pool are spread round-robin over
+ * the worker queues, tasks submitted by a worker go to its own queue.
+ *
+ * @author Student Project - Cryptographic Systems Course
+ * @date December 2025
+ */
+
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Fixed-size pool of worker threads with per-worker queues
+ */
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    /**
+     * @brief Constructor - starts the worker threads
+     * @param threads Number of workers, 0 selects std::thread::hardware_concurrency()
+     */
+    explicit ThreadPool(size_t threads = 0);
+
+    /**
+     * @brief Destructor - runs all queued tasks, then joins the workers
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Queue a task for execution
+     * @param task The function to run on a worker thread
+     */
+    void submit(Task task);
+
+    /**
+     * @brief Queue a callable and obtain a future for its result
+     * @param func The callable to run on a worker thread
+     * @return Future that becomes ready when func has run
+     */
+    template <typename Func>
+    std::future<std::invoke_result_t<std::decay_t<Func>>> enqueue(Func&& func) {
+        using ResultType = std::invoke_result_t<std::decay_t<Func>>;
+        auto task = std::make_shared<std::packaged_task<ResultType()>>(
+            std::forward<Func>(func));
+        std::future<ResultType> result = task->get_future();
+        submit([task]() { (*task)(); });
+        return result;
+    }
+
+    /**
+     * @brief Block until every submitted task has finished
+     */
+    void waitIdle();
+
+    /**
+     * @brief Get the number of worker threads
+     */
+    size_t size() const { return workers_.size(); }
+
+    /**
+     * @brief Get the number of tasks taken from another worker's queue
+     */
+    size_t stealCount() const { return steals_.load(std::memory_order_relaxed); }
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread> workers_;
+
+    std::atomic<size_t> nextQueue_;   // Round-robin cursor for external submits
+    std::atomic<size_t> queued_;      // Tasks waiting in any queue (updated under the queue lock)
+    std::atomic<size_t> active_;      // Tasks queued or running
+    std::atomic<size_t> steals_;
+
+    std::mutex sleepMutex_;
+    std::condition_variable wakeWorkers_;
+    std::condition_variable idle_;
+    bool stopping_;
+
+    void workerLoop(size_t index);
+    bool popLocal(size_t index, Task& task);
+    bool steal(size_t index, Task& task);
+};
+
+#endif // THREAD_POOL_HPP
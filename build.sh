@@ -39,4 +39,8 @@ echo "=========================================="
 echo ""
 echo "Run the benchmark with:"
 echo "  cd build && ./dilithium_benchmark"
+echo "and the per-primitive micro benchmark with:"
+echo "  cd build && ./dilithium_microbench"
+echo "and the bulk file signer with:"
+echo "  cd build && ./dilithium_sign -o signatures.manifest <directory>"
 echo ""
\ No newline at end of file
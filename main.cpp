@@ -1,198 +1,2404 @@
 #include "Dilithiumwrapper.hpp"
 #include "RSABenchmark.hpp"
 #include "Benchmark.hpp"
+#include "DilithiumEngine.hpp"
+#include "DilithiumService.hpp"
+#include "DilithiumStream.hpp"
+#include "BenchmarkReport.hpp"
+#include "SchemeRegistry.hpp"
+#include "BenchmarkOptions.hpp"
+#include "RandomSource.hpp"
+#include "ScratchArena.hpp"
+#include "KeccakLanes.hpp"
+#include "PublicKeyStore.hpp"
+#include "PreparedKeyFile.hpp"
+#include "AllocationCounter.hpp"
+#include "PerfCounters.hpp"
+#include "CompositeSignature.hpp"
 #include <iostream>
+#include <algorithm>
 #include <vector>
 #include <iomanip>
+#include <sstream>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <memory>
+#include <string>
+#include <cstring>
+#include <random>
+#include <cmath>
+#include <type_traits>
+#include <unordered_map>
+#include <cstdlib>
+#include <cstdio>
+
+// Parameter set of the Dilithium-specific benchmarks (API variants, message
+// sizes, pre-hash, engine throughput); the scheme comparison covers all modes
+using Dilithium3 = DilithiumWrapper<3>;
+
+/**
+ * @brief Run the keygen/sign/verify comparison of the selected schemes for one message size
+ * @param schemes Schemes to run, from SchemeRegistry::builtin()
+ * @param config Operations and iteration counts or time budget
+ */
+void runSchemeComparison(BenchmarkReport& report, const std::vector<const SchemeInfo*>& schemes,
+                         size_t messageSize, const SchemeRunConfig& config) {
+    std::cout << "Message size: " << messageSize << " bytes\n\n";
+
+    // Generate test message
+    auto message = Benchmark::generateRandomMessage(messageSize);
+
+    std::vector<SchemeResults> results;
+    for (const SchemeInfo* scheme : schemes) {
+        std::cout << "Testing " << scheme->name << " (" << scheme->securityLevel << ")...\n";
+        results.push_back(scheme->benchmark(message, config));
+        if (!results.back().valid) {
+            std::cerr << "  Warning: " << scheme->name << " signature did not verify\n";
+        }
+        std::cout << "Done!\n\n";
+    }
+
+    // ==================== RESULTS COMPARISON ====================
+    std::cout << "\n";
+    std::cout << "========================================\n";
+    std::cout << "         PERFORMANCE COMPARISON\n";
+    std::cout << "========================================\n\n";
+
+    Benchmark::printTableHeader();
+    for (size_t i = 0; i < schemes.size(); ++i) {
+        const SchemeResults& r = results[i];
+        // The library name is enough for the OpenSSL schemes
+        std::string label = r.backend == "openssl" ? schemes[i]->name
+                                                   : schemes[i]->name + "-" + r.backend;
+        Benchmark::printComparisonRow(label, schemes[i]->securityLevel, r.keyGen, r.sign,
+                                      r.verify, r.publicKeySize, r.signatureSize);
+    }
+    Benchmark::printSeparator();
+
+    // Per-operation hardware counters of the same runs
+    if (Benchmark::perfCounters() && !PerfCounters::available()) {
+        std::cout << "\nHardware counters: " << PerfCounters::unavailableReason() << "\n";
+    } else if (Benchmark::perfCounters()) {
+        std::cout << "\nHardware counters per operation:\n";
+        Benchmark::printCounterHeader();
+        for (size_t i = 0; i < schemes.size(); ++i) {
+            const SchemeResults& r = results[i];
+            const std::string label = schemes[i]->name + " (" + r.backend + ") ";
+            if (config.keyGen) {
+                Benchmark::printCounterRow(label + "keygen", r.keyGen);
+            }
+            if (config.sign) {
+                Benchmark::printCounterRow(label + "sign", r.sign);
+            }
+            if (config.verify) {
+                Benchmark::printCounterRow(label + "verify", r.verify);
+            }
+        }
+        Benchmark::printCounterSeparator();
+    }
+
+    // Record everything for the JSON/CSV reporters
+    for (size_t i = 0; i < schemes.size(); ++i) {
+        const SchemeInfo& s = *schemes[i];
+        const SchemeResults& r = results[i];
+        if (config.keyGen) {
+            report.add(s.name, s.securityLevel, r.backend, "keygen", 0, r.keyGen);
+        }
+        if (config.sign) {
+            report.add(s.name, s.securityLevel, r.backend, "sign", message.size(), r.sign);
+        }
+        if (config.verify) {
+            report.add(s.name, s.securityLevel, r.backend, "verify", message.size(), r.verify);
+        }
+        if (r.hasColdPath && config.sign) {
+            report.add(s.name, s.securityLevel, r.backend, "sign-cold", message.size(), r.signCold);
+        }
+        if (r.hasColdPath && config.verify) {
+            report.add(s.name, s.securityLevel, r.backend, "verify-cold", message.size(), r.verifyCold);
+        }
+    }
+
+    // ==================== DETAILED ANALYSIS ====================
+    std::cout << "\n";
+    std::cout << "========================================\n";
+    std::cout << "          DETAILED ANALYSIS\n";
+    std::cout << "========================================\n\n";
+
+    // Speed comparison against Dilithium3, or the first scheme without it
+    size_t reference = 0;
+    for (size_t i = 0; i < schemes.size(); ++i) {
+        if (schemes[i]->name == "Dilithium3") {
+            reference = i;
+        }
+    }
+    const SchemeResults& ref = results[reference];
+    auto ratio = [](const Benchmark::Result& other, const Benchmark::Result& base) {
+        std::ostringstream text;
+        if (other.iterations == 0 || base.averageTime <= 0.0) {
+            return std::string("-");
+        }
+        text << std::fixed << std::setprecision(2) << (other.averageTime / base.averageTime)
+             << "x " << (other.averageTime > base.averageTime ? "slower" : "faster");
+        return text.str();
+    };
+
+    if (schemes.size() > 1) {
+        std::cout << "Speed Comparison (vs " << schemes[reference]->name << "):\n";
+        for (size_t i = 0; i < schemes.size(); ++i) {
+            if (i == reference) {
+                continue;
+            }
+            std::cout << "  " << std::setw(12) << std::left << schemes[i]->name
+                      << " KeyGen: " << ratio(results[i].keyGen, ref.keyGen)
+                      << ", Signing: " << ratio(results[i].sign, ref.sign)
+                      << ", Verification: " << ratio(results[i].verify, ref.verify) << "\n";
+        }
+        std::cout << "\n";
+    }
+
+    // Schemes with and without the prepared OpenSSL contexts
+    bool anyColdPath = false;
+    for (const SchemeResults& r : results) {
+        anyColdPath = anyColdPath || r.hasColdPath;
+    }
+    if (anyColdPath) {
+        std::cout << "OpenSSL Context Reuse (cold: new EVP_MD_CTX + DigestSign/VerifyInit per call,\n"
+                  << "                       warm: copy of a context prepared at key generation):\n";
+        auto printColdWarm = [](const std::string& label, const Benchmark::Result& cold,
+                                const Benchmark::Result& warm) {
+            std::cout << "  " << std::setw(20) << std::left << label << std::setprecision(4)
+                      << " cold " << cold.averageTime << " ms, warm " << warm.averageTime
+                      << " ms (" << std::setprecision(2)
+                      << (warm.averageTime > 0.0 ? cold.averageTime / warm.averageTime : 0.0)
+                      << "x)\n";
+        };
+        for (size_t i = 0; i < schemes.size(); ++i) {
+            if (results[i].hasColdPath) {
+                printColdWarm(schemes[i]->name + " sign:", results[i].signCold, results[i].sign);
+                printColdWarm(schemes[i]->name + " verify:", results[i].verifyCold, results[i].verify);
+            }
+        }
+        std::cout << "  The comparison table above uses the warm numbers.\n\n";
+    }
+
+    // Size comparison
+    std::cout << "Size Comparison:\n";
+    for (size_t i = 0; i < schemes.size(); ++i) {
+        std::cout << "  " << std::setw(24) << std::left << (schemes[i]->name + " Public Key:")
+                  << results[i].publicKeySize << " bytes\n";
+    }
+    std::cout << "\n";
+    for (size_t i = 0; i < schemes.size(); ++i) {
+        std::cout << "  " << std::setw(24) << std::left << (schemes[i]->name + " Signature:")
+                  << results[i].signatureSize << " bytes\n";
+    }
+    std::cout << "\n";
+
+    // Security analysis
+    std::cout << "Security Level / Post-Quantum Security:\n";
+    for (const SchemeInfo* scheme : schemes) {
+        std::cout << "  " << std::setw(13) << std::left << (scheme->name + ":")
+                  << std::setw(14) << scheme->securityLevel
+                  << (scheme->postQuantum ? "✓ Quantum-resistant (lattice-based)"
+                                          : "✗ Vulnerable to Shor's algorithm")
+                  << "\n";
+    }
+    std::cout << "\n";
+}
+
+/**
+ * @brief Run the scheme comparison for every selected message size
+ */
+void runComprehensiveBenchmark(BenchmarkReport& report,
+                               const std::vector<const SchemeInfo*>& schemes,
+                               const BenchmarkOptions& options) {
+    std::cout << "\n";
+    std::cout << "========================================\n";
+    std::cout << "  SIGNATURE SCHEME BENCHMARK SUITE\n";
+    std::cout << "========================================\n\n";
+
+    SchemeRunConfig config;
+    config.iterations = options.iterations;
+    config.keyGenIterations = options.keyGenIterations;
+    config.seconds = options.seconds;
+    config.sign = options.sign;
+    config.verify = options.verify;
+
+    std::cout << "Configuration:\n";
+    std::cout << "  Message sizes:";
+    for (size_t bytes : options.messageSizes) {
+        std::cout << " " << bytes;
+    }
+    std::cout << " bytes\n";
+    if (options.seconds > 0.0) {
+        std::cout << "  Time budget: " << options.seconds << " s per operation\n";
+    } else {
+        std::cout << "  Sign/Verify iterations: " << options.iterations << "\n";
+        std::cout << "  KeyGen iterations: " << options.keyGenIterations << "\n";
+    }
+    std::cout << "  Operations:" << (options.keyGen ? " keygen" : "") << (options.sign ? " sign" : "")
+              << (options.verify ? " verify" : "") << "\n";
+    std::cout << "  Dilithium backend: " << Dilithium3::backendName(Dilithium3::backend())
+              << (Dilithium3::isBackendAvailable(Dilithium3::Backend::AVX2)
+                      ? " (avx2 available)" : " (avx2 not available)")
+              << "\n\n";
+
+    for (size_t i = 0; i < options.messageSizes.size(); ++i) {
+        // Key generation does not depend on the message, measure it once
+        config.keyGen = options.keyGen && i == 0;
+        runSchemeComparison(report, schemes, options.messageSizes[i], config);
+    }
+}
+
+/**
+ * @brief Compare the plain Dilithium3 API with prepared keys, batch verification
+ *        and the zero-copy overloads
+ */
+void runDilithiumApiBenchmark(BenchmarkReport& report) {
+    std::cout << "\n";
+    std::cout << "========================================\n";
+    std::cout << "       DILITHIUM3 API VARIANTS\n";
+    std::cout << "========================================\n\n";
+
+    const size_t MESSAGE_SIZE = 1024;     // 1 KB message
+    const size_t ITERATIONS = 100;        // Number of iterations for sign/verify
+    const size_t BATCH_SIZE = 64;         // Signatures per verifyBatch() call
+
+    auto message = Benchmark::generateRandomMessage(MESSAGE_SIZE);
+    const std::string backend = Dilithium3::backendName(Dilithium3::backend());
+
+    Dilithium3 dilithium;
+    std::vector<uint8_t> dilithiumSig;
+    dilithium.generateKeys();
+
+    // Benchmark signing
+    auto dilithiumSign = Benchmark::run([&]() {
+        dilithiumSig = dilithium.sign(message);
+    }, ITERATIONS);
+
+    // Benchmark signing with a prepared (pre-expanded) signing key
+    PreparedSigningKey<3> preparedSk = dilithium.prepareSigningKey();
+    auto dilithiumPreparedSign = Benchmark::run([&]() {
+        dilithiumSig = Dilithium3::sign(preparedSk, message);
+    }, ITERATIONS);
+
+    // Sign once for verification benchmark
+    dilithiumSig = dilithium.sign(message);
+
+    // Benchmark verification
+    auto dilithiumVerify = Benchmark::run([&]() {
+        dilithium.verify(message, dilithiumSig);
+    }, ITERATIONS);
+
+    // Benchmark batch verification (same key, prepared once)
+    std::vector<Dilithium3::VerifyItem> batch(BATCH_SIZE, {
+        message.data(), message.size(), dilithiumSig.data(), dilithiumSig.size()
+    });
+    std::vector<bool> batchResults;
+    dilithium.verifyBatch(batch);   // Prepare the public key outside the timed loop
+
+    auto dilithiumBatchVerify = Benchmark::run([&]() {
+        batchResults = dilithium.verifyBatch(batch);
+    }, ITERATIONS / 10);
+
+    // Benchmark the zero-copy overloads (caller-owned buffers)
+    Dilithium3::Signature fixedSig;
+    auto dilithiumBufferSign = Benchmark::run([&]() {
+        dilithium.sign(message.data(), message.size(), fixedSig);
+    }, ITERATIONS);
+
+    auto dilithiumPreparedBufferSign = Benchmark::run([&]() {
+        Dilithium3::sign(preparedSk, message.data(), message.size(), fixedSig);
+    }, ITERATIONS);
+
+    auto dilithiumBufferVerify = Benchmark::run([&]() {
+        dilithium.verify(message.data(), message.size(), fixedSig.data(), fixedSig.size());
+    }, ITERATIONS);
+
+    const size_t bytes = message.size();
+    report.add("Dilithium3", "NIST Level 3", backend, "sign-prepared", bytes, dilithiumPreparedSign);
+    report.add("Dilithium3", "NIST Level 3", backend, "sign-buffer", bytes, dilithiumBufferSign);
+    report.add("Dilithium3", "NIST Level 3", backend, "sign-prepared-buffer", bytes,
+               dilithiumPreparedBufferSign);
+    report.add("Dilithium3", "NIST Level 3", backend, "verify-buffer", bytes, dilithiumBufferVerify);
+    report.add("Dilithium3", "NIST Level 3", backend,
+               "verify-batch" + std::to_string(BATCH_SIZE), bytes, dilithiumBatchVerify);
+
+    // Signing with a prepared signing key
+    std::cout << "Prepared Signing Key (A, s1, s2, t0 expanded once):\n";
+    std::cout << "  Dilithium3 sign() cold:     " << std::fixed << std::setprecision(4)
+              << dilithiumSign.averageTime << " ms (min " << dilithiumSign.minTime
+              << ", max " << dilithiumSign.maxTime << ")\n";
+    std::cout << "  Dilithium3 sign() prepared: " << dilithiumPreparedSign.averageTime
+              << " ms (min " << dilithiumPreparedSign.minTime
+              << ", max " << dilithiumPreparedSign.maxTime << ")\n";
+    std::cout << "  Speedup from key reuse:     " << std::setprecision(2)
+              << (dilithiumSign.averageTime / dilithiumPreparedSign.averageTime) << "x\n\n";
+
+    // Batch verification with a prepared public key
+    double batchPerSig = dilithiumBatchVerify.averageTime / BATCH_SIZE;
+    std::cout << "Batch Verification (prepared public key, " << BATCH_SIZE << " signatures/batch):\n";
+    std::cout << "  Dilithium3 verify():        " << std::setprecision(4)
+              << dilithiumVerify.averageTime << " ms/signature\n";
+    std::cout << "  Dilithium3 verifyBatch():   " << batchPerSig << " ms/signature\n";
+    std::cout << "  Speedup from key reuse:     " << std::setprecision(2)
+              << (dilithiumVerify.averageTime / batchPerSig) << "x\n\n";
+
+    // Heap allocations of the vector and zero-copy overloads
+    std::cout << "Zero-Copy API (Dilithium3, heap allocations per call):\n";
+    Benchmark::printAllocationHeader();
+    Benchmark::printAllocationRow("sign(vector)", dilithiumSign);
+    Benchmark::printAllocationRow("sign(ptr, len, Signature&)", dilithiumBufferSign);
+    Benchmark::printAllocationRow("sign(prepared, vector)", dilithiumPreparedSign);
+    Benchmark::printAllocationRow("sign(prepared, ptr, len, Signature&)", dilithiumPreparedBufferSign);
+    Benchmark::printAllocationRow("verify(vector, vector)", dilithiumVerify);
+    Benchmark::printAllocationRow("verify(ptr, len, ptr, len)", dilithiumBufferVerify);
+    Benchmark::printAllocationSeparator();
+    std::cout << "\n";
+}
+
+/**
+ * @brief Key pairs per second of single, seeded and batched key generation
+ *
+ * generateKeys() reads its seed with one getrandom() per key; the batch
+ * reads all seeds at once and expands them on 1..maxThreads threads.
+ */
+void runKeyGenerationBenchmark(BenchmarkReport& report, size_t maxThreads) {
+    std::cout << "\n";
+    std::cout << "========================================\n";
+    std::cout << "    DILITHIUM3 KEY GENERATION RATE\n";
+    std::cout << "========================================\n\n";
+
+    const size_t ITERATIONS = 100;        // Single key pairs
+    const size_t BATCH_SIZE = 256;        // Key pairs per generateKeyBatch() call
+    const size_t BATCH_RUNS = 5;
+
+    if (maxThreads == 0) {
+        maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    const std::string backend = Dilithium3::backendName(Dilithium3::backend());
+
+    Dilithium3 dilithium;
+    auto single = Benchmark::run([&]() {
+        dilithium.generateKeys();
+    }, ITERATIONS);
+
+    std::vector<uint8_t> seed = Benchmark::generateRandomMessage(DILITHIUM_SEED_BYTES);
+    auto seeded = Benchmark::run([&]() {
+        dilithium.generateKeysFromSeed(seed);
+    }, ITERATIONS);
+
+    report.add("Dilithium3", "NIST Level 3", backend, "keygen", 0, single);
+    report.add("Dilithium3", "NIST Level 3", backend, "keygen-seeded", 0, seeded);
+
+    auto row = [](const std::string& method, double msPerKey) {
+        std::cout << "  " << std::setw(34) << std::left << method << std::right
+                  << std::setw(10) << std::fixed << std::setprecision(0)
+                  << (msPerKey > 0.0 ? 1000.0 / msPerKey : 0.0) << " keys/s"
+                  << std::setw(10) << std::setprecision(1) << msPerKey * 1000.0 << " us/key\n";
+    };
+    row("generateKeys()", single.averageTime);
+    row("generateKeysFromSeed()", seeded.averageTime);
+
+    for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        DilithiumKeyBatch<3> batch;
+        auto batched = Benchmark::run([&]() {
+            batch = Dilithium3::generateKeyBatch(BATCH_SIZE, threads);
+        }, BATCH_RUNS);
+
+        if (batch.size() != BATCH_SIZE) {
+            std::cout << "  generateKeyBatch() failed\n";
+            break;
+        }
+        report.add("Dilithium3", "NIST Level 3", backend,
+                   "keygen-batch" + std::to_string(BATCH_SIZE) + "-t" + std::to_string(threads),
+                   0, batched);
+        row("generateKeyBatch(" + std::to_string(BATCH_SIZE) + ", " + std::to_string(threads)
+            + (threads == 1 ? " thread)" : " threads)"), batched.averageTime / BATCH_SIZE);
+
+        if (threads < maxThreads && threads * 2 > maxThreads) {
+            threads = maxThreads / 2;   // Always finish with maxThreads
+        }
+    }
+
+    // A seeded key must round-trip through the reference verify()
+    dilithium.generateKeysFromSeed(seed);
+    auto message = Benchmark::generateRandomMessage(1024);
+    std::cout << "\n  Seeded key pair signs and verifies: "
+              << (dilithium.verify(message, dilithium.sign(message)) ? "yes" : "NO") << "\n\n";
+}
+
+/**
+ * @brief System vs buffered randomness for seeds, key generation and signing
+ *
+ * Signing only reads randomness in -DDILITHIUM_RANDOMIZED_SIGNING=ON
+ * builds; deterministic builds show the same time for both sources.
+ */
+void runRandomnessBenchmark(BenchmarkReport& report) {
+    std::cout << "\n";
+    std::cout << "========================================\n";
+    std::cout << "   RANDOMNESS SOURCE (system vs DRBG)\n";
+    std::cout << "========================================\n\n";
+
+    const size_t ITERATIONS = 100;
+    const size_t SEEDS_PER_RUN = 1000;    // 32-byte requests per timed run
+
+    const Dilithium3::Randomness previous = Dilithium3::randomness();
+    const Dilithium3::Randomness sources[] = {Dilithium3::Randomness::System,
+                                              Dilithium3::Randomness::Buffered};
+    const std::string backend = Dilithium3::backendName(Dilithium3::backend());
+    auto message = Benchmark::generateRandomMessage(1024);
+
+    Benchmark::Result seeds[2], keyGen[2], sign[2];
+    for (int i = 0; i < 2; ++i) {
+        Dilithium3::setRandomness(sources[i]);
+        const std::string name = Dilithium3::randomnessName(sources[i]);
+
+        uint8_t seed[DILITHIUM_SEED_BYTES];
+        seeds[i] = Benchmark::run([&]() {
+            for (size_t n = 0; n < SEEDS_PER_RUN; ++n) {
+                RandomSource::fill(seed, sizeof(seed));
+            }
+        }, ITERATIONS);
+
+        Dilithium3 dilithium;
+        keyGen[i] = Benchmark::run([&]() {
+            dilithium.generateKeys();
+        }, ITERATIONS / 2);
+
+        std::vector<uint8_t> signature;
+        sign[i] = Benchmark::run([&]() {
+            signature = dilithium.sign(message);
+        }, ITERATIONS);
+
+        report.add("Dilithium3", "NIST Level 3", backend, "keygen-rng-" + name, 0, keyGen[i]);
+        report.add("Dilithium3", "NIST Level 3", backend, "sign-rng-" + name, message.size(), sign[i]);
+    }
+    Dilithium3::setRandomness(previous);
+
+    auto row = [](const std::string& operation, double system, double buffered, const char* unit) {
+        std::cout << "| " << std::setw(26) << std::left << operation
+                  << " | " << std::setw(10) << std::right << std::fixed << std::setprecision(3) << system
+                  << " | " << std::setw(10) << buffered
+                  << " | " << std::setw(5) << std::left << unit
+                  << " | " << std::setw(7) << std::right << std::setprecision(2)
+                  << (buffered > 0.0 ? system / buffered : 0.0) << "x |\n";
+    };
+    const std::string separator = "+" + std::string(28, '-') + "+" + std::string(12, '-')
+                                + "+" + std::string(12, '-') + "+" + std::string(7, '-')
+                                + "+" + std::string(10, '-') + "+\n";
+
+    std::cout << separator;
+    std::cout << "| " << std::setw(26) << std::left << "Operation"
+              << " | " << std::setw(10) << "System" << " | " << std::setw(10) << "Buffered"
+              << " | " << std::setw(5) << "Unit" << " | " << std::setw(8) << "Speedup" << " |\n";
+    std::cout << separator;
+    row("randombytes(32)", seeds[0].averageTime * 1000.0 / SEEDS_PER_RUN,
+        seeds[1].averageTime * 1000.0 / SEEDS_PER_RUN, "us");
+    row("generateKeys()", keyGen[0].averageTime, keyGen[1].averageTime, "ms");
+    row(Dilithium3::RANDOMIZED_SIGNING ? "sign() randomized" : "sign() deterministic",
+        sign[0].averageTime, sign[1].averageTime, "ms");
+    std::cout << separator;
+    if (!Dilithium3::RANDOMIZED_SIGNING) {
+        std::cout << "Signing draws no randomness in this build "
+                  << "(-DDILITHIUM_RANDOMIZED_SIGNING=ON for hedged signing)\n";
+    }
+    std::cout << "\n";
+}
+
+/**
+ * @brief Verification latency and memory per key of the prepared key memory modes
+ *
+ * The heap column is the measured heap growth per key while KEYS keys of one
+ * mode are loaded, including the allocator's per-chunk overhead.
+ */
+void runKeyMemoryBenchmark(BenchmarkReport& report) {
+    std::cout << "\n";
+    std::cout << "========================================\n";
+    std::cout << "   PREPARED KEY MEMORY MODES (Dilithium3)\n";
+    std::cout << "========================================\n\n";
+
+    const size_t ITERATIONS = 100;
+    const size_t KEYS = 1000;             // Keys held at once for the heap measurement
+
+    Dilithium3 dilithium;
+    dilithium.generateKeys();
+    auto message = Benchmark::generateRandomMessage(1024);
+    std::vector<uint8_t> signature = dilithium.sign(message);
+    const std::vector<uint8_t> publicKey = dilithium.getPublicKey();
+    const std::string backend = Dilithium3::backendName(Dilithium3::backend());
+
+    auto reference = Benchmark::run([&]() {
+        dilithium.verify(message, signature);
+    }, ITERATIONS);
+
+    const std::string separator = "+" + std::string(15, '-') + "+" + std::string(11, '-')
+                                + "+" + std::string(13, '-') + "+" + std::string(13, '-')
+                                + "+" + std::string(15, '-') + "+\n";
+    std::cout << separator;
+    std::cout << "| " << std::setw(13) << std::left << "Memory mode"
+              << " | " << std::setw(9) << std::right << "Load (us)"
+              << " | " << std::setw(11) << "Verify (ms)"
+              << " | " << std::setw(11) << "Bytes/key"
+              << " | " << std::setw(13) << "Heap/key" << " |\n";
+    std::cout << separator;
+    std::cout << std::fixed;
+    std::cout << "| " << std::setw(13) << std::left << "reference"
+              << " | " << std::setw(9) << std::right << "-"
+              << " | " << std::setw(11) << std::setprecision(4) << reference.averageTime
+              << " | " << std::setw(11) << Dilithium3::PUBLIC_KEY_BYTES
+              << " | " << std::setw(13) << "-" << " |\n";
+
+    for (DilithiumKeyMemory memory : {DilithiumKeyMemory::Full, DilithiumKeyMemory::RowStreaming,
+                                      DilithiumKeyMemory::None}) {
+        PreparedPublicKey<3> key;
+        auto load = Benchmark::run([&]() {
+            key.load(publicKey, memory);
+        }, ITERATIONS);
+
+        bool valid = false;
+        auto verify = Benchmark::run([&]() {
+            valid = key.verify(message.data(), message.size(), signature.data(), signature.size());
+        }, ITERATIONS);
+
+        size_t heap = 0;
+        {
+            const size_t before = Benchmark::heapBytesInUse();
+            std::vector<PreparedPublicKey<3>> keys(KEYS);
+            for (PreparedPublicKey<3>& held : keys) {
+                held.load(publicKey, memory);
+            }
+            const size_t after = Benchmark::heapBytesInUse();
+            heap = after > before ? (after - before) / KEYS : 0;
+        }
+
+        const std::string name = PreparedPublicKey<3>::memoryName(memory);
+        report.add("Dilithium3", "NIST Level 3", backend, "verify-prepared-" + name,
+                   message.size(), verify);
+        report.add("Dilithium3", "NIST Level 3", backend, "load-prepared-" + name, 0, load);
+
+        std::cout << "| " << std::setw(13) << std::left << name
+                  << " | " << std::setw(9) << std::right << std::setprecision(1)
+                  << load.averageTime * 1000.0
+                  << " | " << std::setw(11) << std::setprecision(4) << verify.averageTime
+                  << " | " << std::setw(11) << PreparedPublicKey<3>::memoryBytes(memory)
+                  << " | " << std::setw(13) << heap << " |"
+                  << (valid ? "" : "  INVALID") << "\n";
+    }
+    std::cout << separator << "\n";
+}
+
+/**
+ * @brief Latency and memory use of sign/verify with stack and arena scratch
+ *
+ * Stack is the deepest stack use of one call, measured on a helper thread.
+ * Heap counts operator new calls and bytes per call; the arena column is the
+ * scratch arena's high-water mark, which is reused rather than allocated.
+ */
+void runScratchBenchmark(BenchmarkReport& report) {
+    std::cout << "\n";
+    std::cout << "========================================\n";
+    std::cout << "   SCRATCH MEMORY: STACK VS ARENA (Dilithium3)\n";
+    std::cout << "========================================\n\n";
+
+    const size_t ITERATIONS = 100;
+
+    Dilithium3 dilithium;
+    dilithium.generateKeys();
+    auto message = Benchmark::generateRandomMessage(1024);
+    const PreparedSigningKey<3> signingKey = dilithium.prepareSigningKey();
+    const PreparedPublicKey<3> publicKey = dilithium.preparePublicKey();
+    const Dilithium3::Scratch previous = Dilithium3::scratchMode();
+
+    Dilithium3::Signature signature{};
+    dilithium.sign(message.data(), message.size(), signature);
+
+    struct Operation {
+        const char* name;
+        std::function<bool()> run;
+    };
+    const Operation operations[] = {
+        {"sign", [&]() {
+            return dilithium.sign(message.data(), message.size(), signature);
+        }},
+        {"verify", [&]() {
+            return dilithium.verify(message.data(), message.size(),
+                                    signature.data(), signature.size());
+        }},
+        {"sign-prepared", [&]() {
+            return Dilithium3::sign(signingKey, message.data(), message.size(), signature);
+        }},
+        {"verify-prepared", [&]() {
+            return publicKey.verify(message.data(), message.size(),
+                                    signature.data(), signature.size());
+        }},
+    };
+
+    const std::string separator = "+" + std::string(17, '-') + "+" + std::string(9, '-')
+                                + "+" + std::string(11, '-') + "+" + std::string(11, '-')
+                                + "+" + std::string(10, '-') + "+" + std::string(12, '-')
+                                + "+" + std::string(11, '-') + "+\n";
+    std::cout << separator;
+    std::cout << "| " << std::setw(15) << std::left << "Operation"
+              << " | " << std::setw(7) << "Scratch"
+              << " | " << std::setw(9) << std::right << "Time (ms)"
+              << " | " << std::setw(9) << "Stack (B)"
+              << " | " << std::setw(8) << "Allocs"
+              << " | " << std::setw(10) << "Heap (B)"
+              << " | " << std::setw(9) << "Arena (B)" << " |\n";
+    std::cout << separator;
+    std::cout << std::fixed;
+
+    for (const Operation& operation : operations) {
+        for (Dilithium3::Scratch scratch : {Dilithium3::Scratch::Stack,
+                                            Dilithium3::Scratch::Arena}) {
+            Dilithium3::setScratchMode(scratch);
+
+            bool valid = true;
+            auto result = Benchmark::run([&]() {
+                valid = operation.run() && valid;
+            }, ITERATIONS);
+
+            const size_t stack = Benchmark::peakStackBytes([&]() { operation.run(); });
+
+            ScratchArena& arena = ScratchArena::local();
+            arena.resetPeak();
+            const size_t bytesBefore = AllocationCounter::bytesAllocated();
+            operation.run();
+            const size_t heap = AllocationCounter::bytesAllocated() - bytesBefore;
+            const size_t arenaPeak = arena.peakBytes();
+
+            const std::string name = std::string(operation.name) + "-"
+                                   + Dilithium3::scratchName(scratch);
+            report.add("Dilithium3", "NIST Level 3", Dilithium3::backendName(Dilithium3::backend()),
+                       name, message.size(), result);
+
+            std::cout << "| " << std::setw(15) << std::left << operation.name
+                      << " | " << std::setw(7) << Dilithium3::scratchName(scratch)
+                      << " | " << std::setw(9) << std::right << std::setprecision(4)
+                      << result.averageTime
+                      << " | " << std::setw(9) << stack
+                      << " | " << std::setw(8) << std::setprecision(1) << result.allocations
+                      << " | " << std::setw(10) << heap
+                      << " | " << std::setw(9) << arenaPeak << " |"
+                      << (valid ? "" : "  INVALID") << "\n";
+        }
+    }
+    std::cout << separator;
+    std::cout << "Arena capacity kept by this thread: " << ScratchArena::local().capacityBytes()
+              << " bytes\n\n";
+
+    Dilithium3::setScratchMode(previous);
+}
+
+/**
+ * @brief SHAKE throughput of the multi-lane Keccak and its effect on key loading
+ *
+ * Throughput counts the input bytes of all lanes. The second table loads
+ * prepared keys (matrix expansion), hashes μ for a batch of messages and
+ * verifies a same-key batch with the multi-lane Keccak switched off and on.
+ */
+void runShakeBenchmark(BenchmarkReport& report) {
+    std::cout << "\n";
+    std::cout << "========================================\n";
+    std::cout << "   MULTI-LANE SHAKE (Dilithium3)\n";
+    std::cout << "========================================\n\n";
+
+    const size_t INPUT_BYTES = 16 * 1024;
+    const size_t ITERATIONS = 50;
+    const size_t BATCH = 64;
+
+    std::vector<uint8_t> input = Benchmark::generateRandomMessage(8 * INPUT_BYTES);
+    std::vector<uint8_t> output(8 * 32);
+
+    auto throughput = [&](auto lanesTag, bool shake256) {
+        constexpr size_t LANES = decltype(lanesTag)::value;
+        const uint8_t* in[LANES];
+        uint8_t* out[LANES];
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            in[lane] = input.data() + lane * INPUT_BYTES;
+            out[lane] = output.data() + lane * 32;
+        }
+        auto result = Benchmark::run([&]() {
+            if (shake256) {
+                KeccakLanes<LANES>::shake256Many(out, 32, in, INPUT_BYTES);
+            } else {
+                KeccakLanes<LANES>::shake128Many(out, 32, in, INPUT_BYTES);
+            }
+        }, ITERATIONS);
+        const double gbps = LANES * INPUT_BYTES / (result.averageTime * 1e6);
+
+        const std::string name = std::string(shake256 ? "shake256" : "shake128") + "-x"
+                               + std::to_string(LANES);
+        report.add("SHAKE", shake256 ? "SHAKE256" : "SHAKE128",
+                   keccakIsaName(KeccakLanes<LANES>::isa()), name, LANES * INPUT_BYTES, result);
+
+        std::cout << "| " << std::setw(8) << std::left << (shake256 ? "SHAKE256" : "SHAKE128")
+                  << " | " << std::setw(5) << std::right << LANES
+                  << " | " << std::setw(8) << std::left << keccakIsaName(KeccakLanes<LANES>::isa())
+                  << " | " << std::setw(9) << std::right << std::setprecision(4) << gbps
+                  << " | " << std::setw(9) << gbps / LANES << " |\n";
+    };
+
+    const std::string separator = "+" + std::string(10, '-') + "+" + std::string(7, '-')
+                                + "+" + std::string(10, '-') + "+" + std::string(11, '-')
+                                + "+" + std::string(11, '-') + "+\n";
+    std::cout << separator;
+    std::cout << "| " << std::setw(8) << std::left << "Function"
+              << " | " << std::setw(5) << std::right << "Lanes"
+              << " | " << std::setw(8) << std::left << "ISA"
+              << " | " << std::setw(9) << std::right << "GB/s"
+              << " | " << std::setw(9) << "GB/s/lane" << " |\n";
+    std::cout << separator;
+    std::cout << std::fixed;
+    for (bool shake256 : {false, true}) {
+        throughput(std::integral_constant<size_t, 1>(), shake256);
+        throughput(std::integral_constant<size_t, 4>(), shake256);
+        throughput(std::integral_constant<size_t, 8>(), shake256);
+    }
+    std::cout << separator << "\n";
+
+    Dilithium3 dilithium;
+    dilithium.generateKeys();
+    const std::vector<uint8_t> publicKey = dilithium.getPublicKey();
+    const std::vector<uint8_t> secretKey = dilithium.getSecretKey();
+
+    std::vector<std::vector<uint8_t>> messages;
+    std::vector<Dilithium3::Signature> signatures(BATCH);
+    std::vector<Dilithium3::VerifyItem> items;
+    for (size_t i = 0; i < BATCH; ++i) {
+        messages.push_back(Benchmark::generateRandomMessage(1024));
+        dilithium.sign(messages[i].data(), messages[i].size(), signatures[i]);
+    }
+    for (size_t i = 0; i < BATCH; ++i) {
+        items.push_back({messages[i].data(), messages[i].size(),
+                         signatures[i].data(), signatures[i].size()});
+    }
+    std::vector<const uint8_t*> messagePointers;
+    std::vector<size_t> messageLengths;
+    for (const std::vector<uint8_t>& message : messages) {
+        messagePointers.push_back(message.data());
+        messageLengths.push_back(message.size());
+    }
+    std::vector<uint8_t> mu(BATCH * DILITHIUM_MU_BYTES);
+    PreparedPublicKey<3> batchKey;
+    batchKey.load(publicKey);
+    std::unique_ptr<bool[]> results(new bool[BATCH]);
+
+    struct Operation {
+        const char* name;
+        size_t messageBytes;
+        std::function<bool()> run;
+    };
+    const Operation operations[] = {
+        {"load-public-key", 0, [&]() {
+            PreparedPublicKey<3> key;
+            return key.load(publicKey);
+        }},
+        {"load-signing-key", 0, [&]() {
+            PreparedSigningKey<3> key;
+            return key.load(secretKey);
+        }},
+        {"mu-batch-64", 1024, [&]() {
+            return batchKey.computeMu(messagePointers.data(), messageLengths.data(), BATCH,
+                                      mu.data());
+        }},
+        {"verify-batch-64", 1024, [&]() {
+            return Dilithium3::verifyBatch(batchKey, items.data(), BATCH, results.get()) == BATCH;
+        }},
+    };
+
+    const bool previous = Dilithium3::multiLaneKeccak();
+    const std::string keySeparator = "+" + std::string(18, '-') + "+" + std::string(13, '-')
+                                   + "+" + std::string(13, '-') + "+" + std::string(9, '-') + "+\n";
+    std::cout << keySeparator;
+    std::cout << "| " << std::setw(16) << std::left << "Operation"
+              << " | " << std::setw(11) << std::right << "Scalar (ms)"
+              << " | " << std::setw(11) << "Lanes (ms)"
+              << " | " << std::setw(7) << "Speedup" << " |\n";
+    std::cout << keySeparator;
+
+    for (const Operation& operation : operations) {
+        double time[2] = {0.0, 0.0};
+        bool valid = true;
+        for (bool lanes : {false, true}) {
+            Dilithium3::setMultiLaneKeccak(lanes);
+            auto result = Benchmark::run([&]() {
+                valid = operation.run() && valid;
+            }, ITERATIONS);
+            time[lanes] = result.averageTime;
+            report.add("Dilithium3", "NIST Level 3", Dilithium3::backendName(Dilithium3::backend()),
+                       std::string(operation.name) + (lanes ? "-lanes" : "-scalar"),
+                       operation.messageBytes, result);
+        }
+        std::cout << "| " << std::setw(16) << std::left << operation.name
+                  << " | " << std::setw(11) << std::right << std::setprecision(4) << time[0]
+                  << " | " << std::setw(11) << time[1]
+                  << " | " << std::setw(6) << std::setprecision(2) << time[0] / time[1] << "x |"
+                  << (valid ? "" : "  INVALID") << "\n";
+    }
+    std::cout << keySeparator;
+    std::cout << "Permutation: " << keccakIsaName(KeccakLanes<4>::isa()) << " x4, "
+              << keccakIsaName(KeccakLanes<8>::isa()) << " x8; batches use "
+              << keccakPreferredLanes() << " lanes\n\n";
+
+    Dilithium3::setMultiLaneKeccak(previous);
+}
+
+/**
+ * @brief Verify rate of a Zipf-distributed signer population with and without the key cache
+ *
+ * Every request switches the verifier to the signer's packed public key, as
+ * a service would. Without a cache each verify() expands that key again.
+ */
+void runPublicKeyCacheBenchmark(BenchmarkReport& report) {
+    std::cout << "\n";
+    std::cout << "========================================\n";
+    std::cout << "  PUBLIC KEY CACHE (Zipf signer mix)\n";
+    std::cout << "========================================\n\n";
+
+    const size_t SIGNERS = 500;
+    const size_t REQUESTS = 5000;
+    const double ZIPF_EXPONENT = 1.0;
+
+    auto keys = Dilithium3::generateKeyBatch(SIGNERS);
+    if (keys.size() != SIGNERS) {
+        std::cout << "Key generation failed\n";
+        return;
+    }
+
+    auto message = Benchmark::generateRandomMessage(1024);
+    std::vector<Dilithium3::Signature> signatures(SIGNERS);
+    for (size_t i = 0; i < SIGNERS; ++i) {
+        Dilithium3 signer;
+        signer.setSecretKey(keys.secretKey(i), Dilithium3::SECRET_KEY_BYTES);
+        signer.sign(message.data(), message.size(), signatures[i]);
+    }
+
+    // Signer of every request, rank r drawn with probability ~ 1 / r^s
+    std::vector<double> weights(SIGNERS);
+    for (size_t i = 0; i < SIGNERS; ++i) {
+        weights[i] = 1.0 / std::pow(static_cast<double>(i + 1), ZIPF_EXPONENT);
+    }
+    std::mt19937 rng(42);
+    std::discrete_distribution<size_t> zipf(weights.begin(), weights.end());
+    std::vector<size_t> requests(REQUESTS);
+    for (size_t& signer : requests) {
+        signer = zipf(rng);
+    }
+
+    const std::string backend = Dilithium3::backendName(Dilithium3::backend());
+    const size_t entryBytes = PublicKeyCache<3>::entryBytes();
+
+    auto runRequests = [&](const std::shared_ptr<PublicKeyCache<3>>& cache, size_t& valid) {
+        Dilithium3 verifier;
+        verifier.setPublicKeyCache(cache);
+        return Benchmark::run([&]() {
+            valid = 0;
+            for (size_t signer : requests) {
+                verifier.setPublicKey(keys.publicKey(signer), Dilithium3::PUBLIC_KEY_BYTES);
+                valid += verifier.verify(message.data(), message.size(),
+                                         signatures[signer].data(), signatures[signer].size());
+            }
+        }, 1, 0);
+    };
+
+    std::cout << "Signers: " << SIGNERS << ", requests: " << REQUESTS << " (Zipf s = "
+              << std::fixed << std::setprecision(1) << ZIPF_EXPONENT << "), "
+              << entryBytes / 1024 << " KB per cached key\n\n";
+    const std::string separator = "+" + std::string(30, '-') + "+" + std::string(12, '-')
+                                + "+" + std::string(10, '-') + "+" + std::string(10, '-')
+                                + "+" + std::string(11, '-') + "+" + std::string(8, '-') + "+\n";
+    std::cout << separator;
+    std::cout << "| " << std::setw(28) << std::left << "Cache budget (keys)"
+              << " | " << std::setw(10) << std::right << "verify/s"
+              << " | " << std::setw(8) << "Speedup"
+              << " | " << std::setw(8) << "Hit rate"
+              << " | " << std::setw(9) << "Evictions"
+              << " | " << std::setw(6) << "Valid" << " |\n";
+    std::cout << separator;
+
+    size_t valid = 0;
+    auto uncached = runRequests(nullptr, valid);
+    const double uncachedRate = REQUESTS * 1000.0 / uncached.averageTime;
+    report.add("Dilithium3", "NIST Level 3", backend, "verify-zipf-uncached", message.size(), uncached);
+    std::cout << "| " << std::setw(28) << std::left << "none"
+              << " | " << std::setw(10) << std::right << std::setprecision(0) << uncachedRate
+              << " | " << std::setw(7) << std::setprecision(2) << 1.0 << "x"
+              << " | " << std::setw(8) << "-" << " | " << std::setw(9) << "-"
+              << " | " << std::setw(6) << valid << " |\n";
+
+    // The same 3.5 MB holds ~6x more keys in RowStreaming mode
+    struct CacheCase {
+        size_t budgetBytes;
+        DilithiumKeyMemory memory;
+    };
+    const CacheCase cases[] = {
+        {SIGNERS / 20 * entryBytes, DilithiumKeyMemory::Full},
+        {SIGNERS / 5 * entryBytes, DilithiumKeyMemory::Full},
+        {SIGNERS * entryBytes, DilithiumKeyMemory::Full},
+        {SIGNERS / 5 * entryBytes, DilithiumKeyMemory::RowStreaming},
+    };
+
+    for (const CacheCase& cacheCase : cases) {
+        // One shard, so the budget is exact
+        auto cache = std::make_shared<PublicKeyCache<3>>(cacheCase.budgetBytes, 1, cacheCase.memory);
+        auto cached = runRequests(cache, valid);
+        const PublicKeyCacheStats stats = cache->stats();
+        const double rate = REQUESTS * 1000.0 / cached.averageTime;
+        const size_t cachedKeys = cacheCase.budgetBytes / PublicKeyCache<3>::entryBytes(cacheCase.memory);
+        const std::string memory = PreparedPublicKey<3>::memoryName(cacheCase.memory);
+        report.add("Dilithium3", "NIST Level 3", backend,
+                   "verify-zipf-cache" + std::to_string(cachedKeys) + "-" + memory,
+                   message.size(), cached);
+
+        std::ostringstream budget;
+        budget << std::fixed << std::setprecision(1) << cacheCase.budgetBytes / (1024.0 * 1024.0)
+               << " MB " << memory << " (" << cachedKeys << ")";
+        std::cout << "| " << std::setw(28) << std::left << budget.str()
+                  << " | " << std::setw(10) << std::right << std::setprecision(0) << rate
+                  << " | " << std::setw(7) << std::setprecision(2) << rate / uncachedRate << "x"
+                  << " | " << std::setw(7) << std::setprecision(1) << stats.hitRate() * 100.0 << "%"
+                  << " | " << std::setw(9) << stats.evictions
+                  << " | " << std::setw(6) << valid << " |\n";
+    }
+    std::cout << separator << "\n";
+}
+/**
+ * @brief Startup and lookup cost of a memory-mapped keystore against loading packed keys
+ *
+ * The baseline reads a file of concatenated packed keys into one vector
+ * per key and builds a fingerprint map, as a verifier without a keystore
+ * would. Both files are in the page cache, so the numbers are warm starts.
+ */
+void runKeyStoreBenchmark(BenchmarkReport& report) {
+    std::cout << "\n";
+    std::cout << "========================================\n";
+    std::cout << "  MEMORY-MAPPED KEYSTORE (Dilithium3)\n";
+    std::cout << "========================================\n\n";
+
+    const size_t KEYS = 10000;
+    const size_t LOOKUPS = 1000;
+    const size_t ITERATIONS = 20;
+    const char* directory = std::getenv("TMPDIR");
+    const std::string storePath = std::string(directory ? directory : "/tmp")
+                                + "/dilithium_benchmark_keys.dks";
+    const std::string packedPath = std::string(directory ? directory : "/tmp")
+                                 + "/dilithium_benchmark_keys.bin";
+
+    auto keys = Dilithium3::generateKeyBatch(KEYS);
+    if (keys.size() != KEYS) {
+        std::cout << "Key generation failed\n";
+        return;
+    }
+
+    PublicKeyStoreWriter<3> writer;
+    std::FILE* packed = std::fopen(packedPath.c_str(), "wb");
+    for (size_t i = 0; i < KEYS; ++i) {
+        writer.add(keys.publicKey(i), Dilithium3::PUBLIC_KEY_BYTES);
+        if (packed) {
+            std::fwrite(keys.publicKey(i), 1, Dilithium3::PUBLIC_KEY_BYTES, packed);
+        }
+    }
+    if (packed) {
+        std::fclose(packed);
+    }
+    bool written = false;
+    auto writeResult = Benchmark::run([&]() { written = writer.write(storePath); }, 1, 0);
+    if (!written || !packed) {
+        std::cout << "Cannot write the keystore to " << storePath << "\n";
+        std::remove(packedPath.c_str());
+        return;
+    }
+
+    // Signer fingerprints in a random order
+    std::vector<PublicKeyStore<3>::Fingerprint> signers(LOOKUPS);
+    std::mt19937 rng(7);
+    for (auto& signer : signers) {
+        signer = PublicKeyCache<3>::fingerprint(keys.publicKey(rng() % KEYS),
+                                                Dilithium3::PUBLIC_KEY_BYTES);
+    }
+
+    size_t loaded = 0;
+    auto packedLoad = Benchmark::run([&]() {
+        std::FILE* file = std::fopen(packedPath.c_str(), "rb");
+        std::vector<std::vector<uint8_t>> loadedKeys;
+        std::unordered_map<std::string, size_t> index;
+        std::vector<uint8_t> key(Dilithium3::PUBLIC_KEY_BYTES);
+        while (file && std::fread(key.data(), 1, key.size(), file) == key.size()) {
+            auto fingerprint = PublicKeyCache<3>::fingerprint(key.data(), key.size());
+            index.emplace(std::string(fingerprint.begin(), fingerprint.end()), loadedKeys.size());
+            loadedKeys.push_back(key);
+        }
+        if (file) {
+            std::fclose(file);
+        }
+        loaded = loadedKeys.size();
+    }, ITERATIONS);
+
+    PublicKeyStore<3> store;
+    auto storeOpen = Benchmark::run([&]() {
+        store.open(storePath);
+    }, ITERATIONS);
+
+    size_t found = 0;
+    auto lookup = Benchmark::run([&]() {
+        found = 0;
+        for (const auto& signer : signers) {
+            found += store.find(signer) != nullptr;
+        }
+    }, ITERATIONS);
+
+    auto message = Benchmark::generateRandomMessage(1024);
+    Dilithium3 signer;
+    signer.setSecretKey(keys.secretKey(0), Dilithium3::SECRET_KEY_BYTES);
+    Dilithium3::Signature signature{};
+    signer.sign(message.data(), message.size(), signature);
+    const auto signerFingerprint = PublicKeyCache<3>::fingerprint(keys.publicKey(0),
+                                                                  Dilithium3::PUBLIC_KEY_BYTES);
+    bool valid = true;
+    auto verify = Benchmark::run([&]() {
+        valid = store.verify(signerFingerprint, message.data(), message.size(),
+                             signature.data(), signature.size()) && valid;
+    }, ITERATIONS * 5);
+
+    const std::string backend = Dilithium3::backendName(Dilithium3::backend());
+    report.add("Dilithium3", "NIST Level 3", backend, "keystore-write-10k", 0, writeResult);
+    report.add("Dilithium3", "NIST Level 3", backend, "packed-load-10k", 0, packedLoad);
+    report.add("Dilithium3", "NIST Level 3", backend, "keystore-open-10k", 0, storeOpen);
+    report.add("Dilithium3", "NIST Level 3", backend, "keystore-find-1k", 0, lookup);
+    report.add("Dilithium3", "NIST Level 3", backend, "keystore-verify", message.size(), verify);
+
+    std::cout << "Keys: " << KEYS << ", keystore file: " << store.fileBytes() / 1024 << " KB ("
+              << (store.isMapped() ? "mapped" : "copied") << ", "
+              << (store.validate() ? "valid" : "INVALID") << ")\n\n";
+    const std::string separator = "+" + std::string(34, '-') + "+" + std::string(13, '-') + "+\n";
+    std::cout << separator;
+    std::cout << "| " << std::setw(32) << std::left << "Operation"
+              << " | " << std::setw(11) << std::right << "Time (ms)" << " |\n";
+    std::cout << separator;
+    std::cout << std::fixed << std::setprecision(6);
+    auto row = [&](const std::string& name, double milliseconds) {
+        std::cout << "| " << std::setw(32) << std::left << name
+                  << " | " << std::setw(11) << std::right << milliseconds << " |\n";
+    };
+    row("Write keystore", writeResult.averageTime);
+    row("Startup: load packed keys + map", packedLoad.averageTime);
+    row("Startup: open keystore (mmap)", storeOpen.averageTime);
+    row("Lookup (per key)", lookup.averageTime / LOOKUPS);
+    row("Verify with stored key", verify.averageTime);
+    std::cout << separator;
+    std::cout << "Loaded " << loaded << " packed keys, found " << found << "/" << LOOKUPS
+              << " signers, startup speedup " << std::setprecision(0)
+              << packedLoad.averageTime / storeOpen.averageTime << "x"
+              << (valid ? "" : ", verify INVALID") << "\n\n";
+
+    store.close();
+    std::remove(storePath.c_str());
+    std::remove(packedPath.c_str());
+}
+
+
+/**
+ * @brief Startup of 10k hot verification keys from packed and from prepared form
+ *
+ * Packed: read the packed keys and PreparedPublicKey::load() each, i.e. one
+ * ExpandA per key. Prepared: open a PreparedKeyFile of the same keys and
+ * either copy every blob (deserialize) or attach it in place. The first
+ * verification pass after startup is timed too, since an attached key pays
+ * for its page faults there. Every key verifies the signature of key 0, so
+ * all but one verifications run to the end and reject. The files are in the
+ * page cache, so the page faults are minor faults (warm start).
+ */
+void runKeyStartupBenchmark(BenchmarkReport& report) {
+    std::cout << "\n";
+    std::cout << "========================================\n";
+    std::cout << "  PREPARED KEY STARTUP (Dilithium3)\n";
+    std::cout << "========================================\n\n";
+
+    const size_t KEYS = 10000;
+    const char* directory = std::getenv("TMPDIR");
+    const std::string packedPath = std::string(directory ? directory : "/tmp")
+                                 + "/dilithium_benchmark_startup.bin";
+    const std::string preparedPath = std::string(directory ? directory : "/tmp")
+                                   + "/dilithium_benchmark_startup.dpk";
+
+    auto keys = Dilithium3::generateKeyBatch(KEYS);
+    if (keys.size() != KEYS) {
+        std::cout << "Key generation failed\n";
+        return;
+    }
+    std::FILE* packed = std::fopen(packedPath.c_str(), "wb");
+    bool written = packed != nullptr;
+    for (size_t i = 0; written && i < KEYS; ++i) {
+        written = std::fwrite(keys.publicKey(i), 1, Dilithium3::PUBLIC_KEY_BYTES, packed)
+                  == Dilithium3::PUBLIC_KEY_BYTES;
+    }
+    if (packed) {
+        written = std::fclose(packed) == 0 && written;
+    }
+
+    auto message = Benchmark::generateRandomMessage(1024);
+    Dilithium3 signer;
+    signer.setSecretKey(keys.secretKey(0), Dilithium3::SECRET_KEY_BYTES);
+    Dilithium3::Signature signature{};
+    signer.sign(message.data(), message.size(), signature);
+
+    struct Row {
+        const char* name;
+        Benchmark::Result startup;
+        Benchmark::Result firstPass;
+        size_t loaded;
+        size_t accepted;
+    };
+    std::vector<Row> rows;
+
+    auto verifyPass = [&](const std::vector<PreparedPublicKey<3>>& prepared, size_t& accepted) {
+        return Benchmark::run([&]() {
+            accepted = 0;
+            for (const auto& key : prepared) {
+                accepted += key.verify(message.data(), message.size(),
+                                       signature.data(), signature.size());
+            }
+        }, 1, 0);
+    };
+
+    // Packed form, then written out as the prepared file the other rows read
+    {
+        std::vector<PreparedPublicKey<3>> prepared;
+        auto startup = Benchmark::run([&]() {
+            std::FILE* file = std::fopen(packedPath.c_str(), "rb");
+            std::vector<uint8_t> key(Dilithium3::PUBLIC_KEY_BYTES);
+            prepared.reserve(KEYS);
+            while (file && std::fread(key.data(), 1, key.size(), file) == key.size()) {
+                prepared.emplace_back();
+                prepared.back().load(key);
+            }
+            if (file) {
+                std::fclose(file);
+            }
+        }, 1, 0);
+        size_t accepted = 0;
+        auto firstPass = verifyPass(prepared, accepted);
+        rows.push_back({"packed (load + ExpandA)", startup, firstPass, prepared.size(), accepted});
+        written = written && prepared.size() == KEYS
+                  && PreparedKeyFile<3>::write(preparedPath, prepared);
+    }
+    if (!written) {
+        std::cout << "Cannot write the key files to " << packedPath << " and "
+                  << preparedPath << "\n";
+        std::remove(packedPath.c_str());
+        std::remove(preparedPath.c_str());
+        return;
+    }
+
+    size_t fileBytes = 0;
+    for (int attach = 0; attach < 2; ++attach) {
+        PreparedKeyFile<3> file;
+        std::vector<PreparedPublicKey<3>> prepared;
+        auto startup = Benchmark::run([&]() {
+            if (!file.open(preparedPath)) {
+                return;
+            }
+            prepared.resize(file.size());
+            for (size_t i = 0; i < file.size(); ++i) {
+                if (attach) {
+                    file.load(i, prepared[i]);
+                } else {
+                    prepared[i].deserialize(file.blob(i), file.blobBytes());
+                }
+            }
+        }, 1, 0);
+        size_t loaded = 0;
+        for (const auto& key : prepared) {
+            loaded += key.isValid();
+        }
+        size_t accepted = 0;
+        auto firstPass = verifyPass(prepared, accepted);
+        fileBytes = file.fileBytes();
+        const char* name = !file.isMapped() ? "prepared (read + copy)"
+                         : attach ? "prepared (mmap + attach)" : "prepared (mmap + copy)";
+        rows.push_back({name, startup, firstPass, loaded, accepted});
+        // Attached keys must go before the mapping
+        prepared.clear();
+    }
+
+    const std::string backend = Dilithium3::backendName(Dilithium3::backend());
+    const char* operations[] = {"packed", "prepared-copy", "prepared-attach"};
+    for (size_t i = 0; i < rows.size(); ++i) {
+        report.add("Dilithium3", "NIST Level 3", backend,
+                   std::string("startup-") + operations[i] + "-10k", 0, rows[i].startup);
+        report.add("Dilithium3", "NIST Level 3", backend,
+                   std::string("first-verify-") + operations[i] + "-10k", message.size(),
+                   rows[i].firstPass);
+    }
+
+    std::cout << "Keys: " << KEYS << ", packed file: "
+              << KEYS * Dilithium3::PUBLIC_KEY_BYTES / 1024 << " KB, prepared file: "
+              << fileBytes / (1024 * 1024) << " MB\n\n";
+    const std::string separator = "+" + std::string(27, '-') + "+" + std::string(14, '-')
+                                + "+" + std::string(18, '-') + "+" + std::string(14, '-')
+                                + "+" + std::string(10, '-') + "+\n";
+    std::cout << separator;
+    std::cout << "| " << std::setw(25) << std::left << "Form"
+              << " | " << std::setw(12) << std::right << "Startup (ms)"
+              << " | " << std::setw(16) << "1st verify (ms)"
+              << " | " << std::setw(12) << "Total (ms)"
+              << " | " << std::setw(8) << "Loaded" << " |\n";
+    std::cout << separator;
+    std::cout << std::fixed << std::setprecision(3);
+    bool valid = true;
+    for (const Row& row : rows) {
+        std::cout << "| " << std::setw(25) << std::left << row.name
+                  << " | " << std::setw(12) << std::right << row.startup.averageTime
+                  << " | " << std::setw(16) << row.firstPass.averageTime
+                  << " | " << std::setw(12) << row.startup.averageTime + row.firstPass.averageTime
+                  << " | " << std::setw(8) << row.loaded << " |\n";
+        valid = valid && row.loaded == KEYS && row.accepted == 1;
+    }
+    std::cout << separator;
+    std::cout << "Startup speedup of attach over packed: " << std::setprecision(0)
+              << rows[0].startup.averageTime / rows.back().startup.averageTime << "x"
+              << (valid ? "" : " (verification results INVALID)") << "\n\n";
+
+    std::remove(packedPath.c_str());
+    std::remove(preparedPath.c_str());
+}
 
 /**
- * @brief Run comprehensive benchmarks comparing Dilithium with RSA
+ * @brief Key-load throughput and memory per key of heap and secure pool storage
+ *
+ * KEYS signing keys are held at once, as packed keys in DilithiumWrapper
+ * objects and as prepared signing keys. The first deserialize is cold (new
+ * heap chunks or new pool slabs); "reload" clears the prepared keys and
+ * deserializes them again into the freed chunks or slots, and
+ * "load + ExpandA" does the same from the packed keys. Heap/key is the heap
+ * growth per key, Pool/key the pool slot pages taken per key, of which
+ * Locked/key are mlock()'ed; guard pages take address space only.
  */
-void runComprehensiveBenchmark() {
+void runSecureKeyPoolBenchmark(BenchmarkReport& report) {
     std::cout << "\n";
     std::cout << "========================================\n";
-    std::cout << "  DILITHIUM vs RSA BENCHMARK SUITE\n";
+    std::cout << "  SECURE KEY STORAGE (Dilithium3)\n";
     std::cout << "========================================\n\n";
 
-    const size_t MESSAGE_SIZE = 1024;     // 1 KB message
-    const size_t ITERATIONS = 100;        // Number of iterations for sign/verify
-    const size_t KEYGEN_ITERATIONS = 10;  // Fewer iterations for slow key generation
+    const size_t KEYS = 1000;
+
+    auto keys = Dilithium3::generateKeyBatch(KEYS);
+    if (keys.size() != KEYS) {
+        std::cout << "Key generation failed\n";
+        return;
+    }
+    const size_t blobBytes = PreparedSigningKey<3>::serializedBytes();
+    std::vector<uint8_t> blobs(KEYS * blobBytes);
+    {
+        PreparedSigningKey<3> key;
+        for (size_t i = 0; i < KEYS; ++i) {
+            key.load(keys.secretKey(i), Dilithium3::SECRET_KEY_BYTES);
+            key.serialize(blobs.data() + i * blobBytes, blobBytes);
+        }
+    }
+
+    const Dilithium3::KeyStorage previous = Dilithium3::keyStorage();
+    const std::string backend = Dilithium3::backendName(Dilithium3::backend());
+    // Slot pages held by keys in use, and the locked share of them
+    auto poolHeld = [](bool locked) {
+        size_t bytes = 0;
+        for (const SecureKeyPool::Stats& stats : {Dilithium3::secretKeyPoolStats(),
+                                                  PreparedSigningKey<3>::poolStats()}) {
+            if (stats.slots > 0) {
+                const size_t slotPages = stats.readableBytes / stats.slots;
+                bytes += locked ? stats.inUse * slotPages * stats.lockedBytes / stats.readableBytes
+                                : stats.inUse * slotPages;
+            }
+        }
+        return bytes;
+    };
+
+    const std::string separator = "+" + std::string(9, '-') + "+" + std::string(20, '-')
+                                + "+" + std::string(10, '-') + "+" + std::string(10, '-')
+                                + "+" + std::string(10, '-') + "+" + std::string(12, '-') + "+\n";
+    std::cout << separator;
+    std::cout << "| " << std::setw(7) << std::left << "Storage"
+              << " | " << std::setw(18) << "Operation"
+              << " | " << std::setw(8) << std::right << "Keys/s"
+              << " | " << std::setw(8) << "Heap/key"
+              << " | " << std::setw(8) << "Pool/key"
+              << " | " << std::setw(10) << "Locked/key" << " |\n";
+    std::cout << separator;
+    std::cout << std::fixed << std::setprecision(0);
+
+    bool valid = true;
+    for (Dilithium3::KeyStorage storage : {Dilithium3::KeyStorage::Heap,
+                                           Dilithium3::KeyStorage::SecurePool}) {
+        Dilithium3::setKeyStorage(storage);
+        const std::string name = Dilithium3::keyStorageName(storage);
+        std::vector<Dilithium3> wrappers(KEYS);
+        std::vector<PreparedSigningKey<3>> prepared(KEYS);
+
+        auto measure = [&](const char* operation, const std::string& reportName,
+                           const std::function<bool(size_t)>& loadKey) {
+            const size_t heapBefore = Benchmark::heapBytesInUse();
+            const size_t poolBefore = poolHeld(false);
+            const size_t lockedBefore = poolHeld(true);
+            size_t loaded = 0;
+            auto result = Benchmark::run([&]() {
+                for (size_t i = 0; i < KEYS; ++i) {
+                    loaded += loadKey(i);
+                }
+            }, 1, 0);
+            const size_t heapAfter = Benchmark::heapBytesInUse();
+            valid = valid && loaded == KEYS;
+            report.add("Dilithium3", "NIST Level 3", backend,
+                       "keys-" + reportName + "-" + name, 0, result);
+
+            std::cout << "| " << std::setw(7) << std::left << name
+                      << " | " << std::setw(18) << operation
+                      << " | " << std::setw(8) << std::right
+                      << (result.averageTime > 0.0 ? KEYS / (result.averageTime / 1000.0) : 0.0)
+                      << " | " << std::setw(8)
+                      << (heapAfter > heapBefore ? (heapAfter - heapBefore) / KEYS : 0)
+                      << " | " << std::setw(8)
+                      << (poolHeld(false) - poolBefore) / KEYS
+                      << " | " << std::setw(10) << (poolHeld(true) - lockedBefore) / KEYS
+                      << " |\n";
+        };
+        auto clearPrepared = [&]() {
+            for (PreparedSigningKey<3>& key : prepared) {
+                key.clear();
+            }
+        };
+
+        measure("set packed key", "set-packed", [&](size_t i) {
+            return wrappers[i].setSecretKey(keys.secretKey(i), Dilithium3::SECRET_KEY_BYTES);
+        });
+        measure("deserialize", "deserialize-cold", [&](size_t i) {
+            return prepared[i].deserialize(blobs.data() + i * blobBytes, blobBytes);
+        });
+        clearPrepared();
+        measure("reload", "deserialize-warm", [&](size_t i) {
+            return prepared[i].deserialize(blobs.data() + i * blobBytes, blobBytes);
+        });
+        clearPrepared();
+        measure("load + ExpandA", "load-prepared", [&](size_t i) {
+            return prepared[i].load(keys.secretKey(i), Dilithium3::SECRET_KEY_BYTES);
+        });
+    }
+    std::cout << separator;
+    Dilithium3::setKeyStorage(previous);
+
+    const SecureKeyPool::Stats packed = Dilithium3::secretKeyPoolStats();
+    const SecureKeyPool::Stats expanded = PreparedSigningKey<3>::poolStats();
+    // A slot costs its pages plus the guard page after it, whatever the key size
+    std::cout << "Pool slots: packed key " << packed.objectBytes << " B in "
+              << packed.slotBytes << " B + guard = " << packed.slotStride / 1024
+              << " KB per key, prepared key " << expanded.objectBytes << " B in "
+              << expanded.slotBytes << " B + guard = " << expanded.slotStride / 1024
+              << " KB per key\n"
+              << "Locked: " << (packed.lockedBytes + expanded.lockedBytes) / 1024 << " KB, "
+              << packed.unlockedSlots + expanded.unlockedSlots
+              << " slots unlocked (RLIMIT_MEMLOCK)"
+              << (valid ? "" : ", key loading FAILED") << "\n\n";
+}
+
+/**
+ * @brief Measure DilithiumEngine throughput while scaling from 1 to N threads
+ *
+ * Each run pushes a fixed number of jobs through the engine and waits for
+ * all futures, so the reported rate includes queueing and hand-off costs.
+ */
+void runThroughputBenchmark(size_t maxThreads) {
+    std::cout << "\n";
+    std::cout << "========================================\n";
+    std::cout << "   MULTI-THREADED THROUGHPUT (ENGINE)\n";
+    std::cout << "========================================\n\n";
+
+    const size_t MESSAGE_SIZE = 1024;   // 1 KB message
+    const size_t JOBS = 200;            // Jobs per operation and thread count
+
+    size_t hardwareThreads = std::thread::hardware_concurrency();
+    if (hardwareThreads == 0) {
+        hardwareThreads = 1;
+    }
+    if (maxThreads == 0) {
+        maxThreads = hardwareThreads;
+    }
+
+    std::vector<size_t> threadCounts;
+    for (size_t t = 1; t < maxThreads; t *= 2) {
+        threadCounts.push_back(t);
+    }
+    threadCounts.push_back(maxThreads);
 
     std::cout << "Configuration:\n";
     std::cout << "  Message size: " << MESSAGE_SIZE << " bytes\n";
-    std::cout << "  Sign/Verify iterations: " << ITERATIONS << "\n";
-    std::cout << "  KeyGen iterations: " << KEYGEN_ITERATIONS << "\n\n";
+    std::cout << "  Jobs per run: " << JOBS << "\n";
+    std::cout << "  Hardware threads: " << hardwareThreads << "\n";
+    std::cout << "  Maximum engine threads: " << maxThreads << "\n\n";
 
-    // Generate test message
+    Dilithium3 keys;
+    keys.generateKeys();
     auto message = Benchmark::generateRandomMessage(MESSAGE_SIZE);
+    auto signature = keys.sign(message);
 
-    // ==================== DILITHIUM3 BENCHMARK ====================
-    std::cout << "Testing CRYSTALS-Dilithium3 (NIST Level 3)...\n";
-    
-    DilithiumWrapper dilithium;
-    std::vector<uint8_t> dilithiumSig;
+    auto opsPerSecond = [](size_t jobs, std::chrono::steady_clock::duration elapsed) {
+        double seconds = std::chrono::duration<double>(elapsed).count();
+        return seconds > 0.0 ? jobs / seconds : 0.0;
+    };
 
-    // Benchmark key generation
-    auto dilithiumKeyGen = Benchmark::run([&]() {
-        dilithium.generateKeys();
-    }, KEYGEN_ITERATIONS);
+    std::cout << "+" << std::string(10, '-') << "+" << std::string(16, '-')
+              << "+" << std::string(16, '-') << "+" << std::string(14, '-')
+              << "+" << std::string(14, '-') << "+\n";
+    std::cout << "| " << std::setw(8) << std::left << "Threads"
+              << " | " << std::setw(14) << "Sign (ops/s)"
+              << " | " << std::setw(14) << "Verify (ops/s)"
+              << " | " << std::setw(12) << "Sign scale"
+              << " | " << std::setw(12) << "Verify scale"
+              << " |\n";
+    std::cout << "+" << std::string(10, '-') << "+" << std::string(16, '-')
+              << "+" << std::string(16, '-') << "+" << std::string(14, '-')
+              << "+" << std::string(14, '-') << "+\n";
+
+    double baseSign = 0.0;
+    double baseVerify = 0.0;
+
+    for (size_t threads : threadCounts) {
+        DilithiumEngine<3> engine(keys, threads);
+
+        std::vector<std::future<std::vector<uint8_t>>> signResults;
+        signResults.reserve(JOBS);
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < JOBS; ++i) {
+            signResults.push_back(engine.submitSign(message));
+        }
+        for (auto& result : signResults) {
+            result.get();
+        }
+        double signRate = opsPerSecond(JOBS, std::chrono::steady_clock::now() - start);
+
+        std::vector<std::future<bool>> verifyResults;
+        verifyResults.reserve(JOBS);
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < JOBS; ++i) {
+            verifyResults.push_back(engine.submitVerify(message, signature));
+        }
+        for (auto& result : verifyResults) {
+            result.get();
+        }
+        double verifyRate = opsPerSecond(JOBS, std::chrono::steady_clock::now() - start);
+
+        if (threads == threadCounts.front()) {
+            baseSign = signRate;
+            baseVerify = verifyRate;
+        }
+
+        std::cout << std::fixed << std::setprecision(1);
+        std::cout << "| " << std::setw(8) << std::left << threads
+                  << " | " << std::setw(14) << signRate
+                  << " | " << std::setw(14) << verifyRate
+                  << " | " << std::setw(12) << std::setprecision(2)
+                  << (baseSign > 0.0 ? signRate / baseSign : 0.0)
+                  << " | " << std::setw(12)
+                  << (baseVerify > 0.0 ? verifyRate / baseVerify : 0.0)
+                  << " |\n";
+    }
+
+    std::cout << "+" << std::string(10, '-') << "+" << std::string(16, '-')
+              << "+" << std::string(16, '-') << "+" << std::string(14, '-')
+              << "+" << std::string(14, '-') << "+\n\n";
+}
+
+/**
+ * @brief Print the non-empty bins of a histogram on one line
+ * @param binsArePowers counts[b] covers 2^b..2^(b+1)-1; otherwise counts[n]
+ *        is the count of value n and values are grouped as 1, 2-3, 4-7, ...
+ */
+void printPowerOfTwoHistogram(const char* label, const uint64_t* counts, size_t bins,
+                              bool binsArePowers) {
+    std::cout << "  " << label << ":";
+    for (size_t bin = binsArePowers ? 0 : 1; bin < bins;) {
+        size_t first = 0;
+        size_t last = 0;
+        uint64_t count = 0;
+        size_t next = 0;
+        if (binsArePowers) {
+            first = size_t(1) << bin;
+            last = 2 * first - 1;
+            count = counts[bin];
+            next = bin + 1;
+        } else {
+            first = bin;
+            last = std::min(bins - 1, 2 * bin - 1);
+            for (size_t value = first; value <= last; ++value) {
+                count += counts[value];
+            }
+            next = last + 1;
+        }
+        if (count > 0) {
+            std::cout << " " << first;
+            if (last > first) {
+                std::cout << "-" << last;
+            }
+            std::cout << ":" << count;
+        }
+        bin = next;
+    }
+    std::cout << "\n";
+}
+
+/**
+ * @brief Mixed sign/verify load from several producers through the engine and the service
+ *
+ * Producers submit with callbacks and never wait for results, as an event
+ * loop would. The engine runs every request as its own pool task; the
+ * service groups them into micro-batches. A last run offers a burst to a
+ * small queue with trySubmitVerify() to show the backpressure.
+ */
+void runServiceBenchmark(size_t maxThreads) {
+    std::cout << "\n";
+    std::cout << "========================================\n";
+    std::cout << "   ASYNC SERVICE: BATCHING AND BACKPRESSURE\n";
+    std::cout << "========================================\n\n";
+
+    const size_t PRODUCERS = 4;
+    const size_t REQUESTS = 4000;       // Per run, over all producers
+    const size_t SIGN_EVERY = 5;        // One sign per four verifies
+
+    Dilithium3 keys;
+    keys.generateKeys();
+    auto message = Benchmark::generateRandomMessage(1024);
+    auto signature = keys.sign(message);
+
+    std::cout << "Producers: " << PRODUCERS << ", requests: " << REQUESTS
+              << " (1 sign : " << SIGN_EVERY - 1 << " verify), workers: "
+              << (maxThreads ? maxThreads : std::thread::hardware_concurrency()) << "\n\n";
+
+    // Runs submit(i) for every request on PRODUCERS threads, then wait()
+    auto runLoad = [&](const std::function<void(size_t)>& submit, const std::function<void()>& wait) {
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> producers;
+        for (size_t p = 0; p < PRODUCERS; ++p) {
+            producers.emplace_back([&, p]() {
+                for (size_t i = p; i < REQUESTS; i += PRODUCERS) {
+                    submit(i);
+                }
+            });
+        }
+        for (std::thread& producer : producers) {
+            producer.join();
+        }
+        wait();
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return seconds > 0.0 ? REQUESTS / seconds : 0.0;
+    };
+
+    const std::string separator = "+" + std::string(22, '-') + "+" + std::string(12, '-')
+                                + "+" + std::string(11, '-') + "+" + std::string(13, '-')
+                                + "+" + std::string(12, '-') + "+" + std::string(8, '-') + "+\n";
+    std::cout << separator;
+    std::cout << "| " << std::setw(20) << std::left << "Front-end"
+              << " | " << std::setw(10) << std::right << "ops/s"
+              << " | " << std::setw(9) << "Avg batch"
+              << " | " << std::setw(11) << "Full/timed"
+              << " | " << std::setw(10) << "Max queued"
+              << " | " << std::setw(6) << "Valid" << " |\n";
+    std::cout << separator;
+    std::cout << std::fixed;
+
+    std::atomic<size_t> valid(0);
+    auto onSigned = [&](std::vector<uint8_t> produced) { valid += !produced.empty(); };
+    auto onVerified = [&](bool ok) { valid += ok; };
+
+    {
+        DilithiumEngine<3> engine(keys, maxThreads);
+        valid = 0;
+        const double rate = runLoad([&](size_t i) {
+            if (i % SIGN_EVERY == 0) {
+                engine.submitSign(message, onSigned);
+            } else {
+                engine.submitVerify(message, signature, onVerified);
+            }
+        }, [&]() { engine.waitIdle(); });
+        std::cout << "| " << std::setw(20) << std::left << "engine (per request)"
+                  << " | " << std::setw(10) << std::right << std::setprecision(0) << rate
+                  << " | " << std::setw(9) << "-" << " | " << std::setw(11) << "-"
+                  << " | " << std::setw(10) << "-" << " | " << std::setw(6) << valid << " |\n";
+    }
+
+    DilithiumServiceStats lastStats{};
+    for (size_t maxBatch : {1, 8, 32}) {
+        DilithiumServiceConfig config;
+        config.maxBatch = maxBatch;
+        config.threads = maxThreads;
+        DilithiumService<3> service(keys, config);
+        valid = 0;
+        const double rate = runLoad([&](size_t i) {
+            if (i % SIGN_EVERY == 0) {
+                service.submitSign(message, onSigned);
+            } else {
+                service.submitVerify(message, signature, onVerified);
+            }
+        }, [&]() { service.waitIdle(); });
 
-    // Generate keys once for signing/verification
+        lastStats = service.stats();
+        const std::string name = "service, batch <= " + std::to_string(maxBatch);
+        std::cout << "| " << std::setw(20) << std::left << name
+                  << " | " << std::setw(10) << std::right << std::setprecision(0) << rate
+                  << " | " << std::setw(9) << std::setprecision(1) << lastStats.averageBatchSize()
+                  << " | " << std::setw(11)
+                  << std::to_string(lastStats.fullBatches) + "/" + std::to_string(lastStats.deadlineBatches)
+                  << " | " << std::setw(10) << lastStats.maxQueued
+                  << " | " << std::setw(6) << valid << " |\n";
+    }
+    std::cout << separator;
+    std::cout << "Last service run:\n";
+    printPowerOfTwoHistogram("batch sizes", lastStats.batchSizes.data(),
+                             lastStats.batchSizes.size(), false);
+    printPowerOfTwoHistogram("queue depth at submit", lastStats.queueDepthHistogram,
+                             DilithiumServiceStats::DEPTH_BINS, true);
+
+    // Burst into a small queue: everything beyond the capacity is refused
+    const size_t BURST = 2000;
+    DilithiumServiceConfig config;
+    config.queueCapacity = 64;
+    config.threads = maxThreads;
+    DilithiumService<3> service(keys, config);
+    size_t accepted = 0;
+    for (size_t i = 0; i < BURST; ++i) {
+        accepted += service.trySubmitVerify(message, signature, onVerified);
+    }
+    service.waitIdle();
+    const DilithiumServiceStats stats = service.stats();
+    std::cout << "\nBackpressure: burst of " << BURST << " trySubmitVerify() into a queue of "
+              << config.queueCapacity << ": " << accepted << " accepted, " << stats.rejected
+              << " rejected\n\n";
+}
+
+/**
+ * @brief Measure Dilithium3 sign/verify throughput with one pinned worker per core
+ *
+ * Every worker builds its own key object and message on its core, so they
+ * live on the core's NUMA node, and then runs for a fixed wall time. The
+ * per-core efficiency is the aggregate rate divided by cores x the
+ * single-core rate.
+ */
+void runPinnedThroughputBenchmark(const std::vector<int>& selectedCpus, double seconds) {
+    std::cout << "\n";
+    std::cout << "========================================\n";
+    std::cout << "   PINNED PER-CORE THROUGHPUT (DILITHIUM3)\n";
+    std::cout << "========================================\n\n";
+
+    const size_t MESSAGE_SIZE = 1024;   // 1 KB message
+
+    std::vector<int> cpus = selectedCpus.empty() ? Benchmark::availableCpus() : selectedCpus;
+    if (seconds <= 0.0) {
+        seconds = 2.0;
+    }
+
+    std::vector<size_t> coreCounts;
+    for (size_t n = 1; n < cpus.size(); n *= 2) {
+        coreCounts.push_back(n);
+    }
+    coreCounts.push_back(cpus.size());
+
+    std::cout << "Configuration:\n";
+    std::cout << "  Message size: " << MESSAGE_SIZE << " bytes\n";
+    std::cout << "  Duration per run: " << seconds << " s\n";
+    std::cout << "  Cores:";
+    for (int cpu : cpus) {
+        std::cout << " " << cpu << "(node " << Benchmark::numaNodeOfCpu(cpu) << ")";
+    }
+    std::cout << "\n\n";
+
+    Dilithium3 keys;
+    keys.generateKeys();
+    const auto message = Benchmark::generateRandomMessage(MESSAGE_SIZE);
+    Dilithium3::Signature signature;
+    keys.sign(message.data(), message.size(), signature);
+
+    // Per-worker state, built on the pinned worker thread
+    struct WorkerState {
+        Dilithium3 dilithium;
+        std::vector<uint8_t> message;
+        Dilithium3::Signature signature;
+    };
+    auto makeState = [&]() {
+        auto state = std::make_shared<WorkerState>();
+        state->dilithium.setPublicKey(keys.publicKey().data(), keys.publicKey().size());
+        state->dilithium.setSecretKey(keys.secretKey().data(), keys.secretKey().size());
+        state->message = message;
+        state->signature = signature;
+        return state;
+    };
+    Benchmark::WorkerSetup signSetup = [&](size_t) -> std::function<void()> {
+        auto state = makeState();
+        return [state]() {
+            state->dilithium.sign(state->message.data(), state->message.size(), state->signature);
+        };
+    };
+    Benchmark::WorkerSetup verifySetup = [&](size_t) -> std::function<void()> {
+        auto state = makeState();
+        return [state]() {
+            state->dilithium.verify(state->message.data(), state->message.size(),
+                                    state->signature.data(), state->signature.size());
+        };
+    };
+
+    auto separator = []() {
+        std::cout << "+" << std::string(8, '-') << "+" << std::string(16, '-')
+                  << "+" << std::string(12, '-') << "+" << std::string(16, '-')
+                  << "+" << std::string(12, '-') << "+\n";
+    };
+    separator();
+    std::cout << "| " << std::setw(6) << std::left << "Cores"
+              << " | " << std::setw(14) << "Sign (ops/s)"
+              << " | " << std::setw(10) << "Sign eff"
+              << " | " << std::setw(14) << "Verify (ops/s)"
+              << " | " << std::setw(10) << "Verify eff"
+              << " |\n";
+    separator();
+
+    double singleSign = 0.0;
+    double singleVerify = 0.0;
+    Benchmark::ThroughputResult lastSign;
+    Benchmark::ThroughputResult lastVerify;
+
+    auto percent = [](double fraction) {
+        std::ostringstream text;
+        text << std::fixed << std::setprecision(0) << fraction * 100.0 << "%";
+        return text.str();
+    };
+
+    for (size_t count : coreCounts) {
+        std::vector<int> subset(cpus.begin(), cpus.begin() + count);
+        lastSign = Benchmark::runThroughput(subset, seconds, signSetup);
+        lastVerify = Benchmark::runThroughput(subset, seconds, verifySetup);
+        if (count == 1) {
+            singleSign = lastSign.opsPerSecond;
+            singleVerify = lastVerify.opsPerSecond;
+        }
+
+        std::cout << std::fixed << std::setprecision(1);
+        std::cout << "| " << std::setw(6) << std::left << count
+                  << " | " << std::setw(14) << lastSign.opsPerSecond
+                  << " | " << std::setw(10) << percent(Benchmark::efficiency(lastSign, singleSign))
+                  << " | " << std::setw(14) << lastVerify.opsPerSecond
+                  << " | " << std::setw(10) << percent(Benchmark::efficiency(lastVerify, singleVerify))
+                  << " |\n";
+    }
+    separator();
+
+    // Per-core breakdown of the largest run
+    std::cout << "\nPer core (" << cpus.size() << " cores):\n";
+    for (size_t i = 0; i < lastSign.workers.size(); ++i) {
+        const Benchmark::WorkerThroughput& sign = lastSign.workers[i];
+        const Benchmark::WorkerThroughput& verify = lastVerify.workers[i];
+        std::cout << "  CPU " << std::setw(4) << std::left << sign.cpu
+                  << " node " << std::setw(3) << sign.numaNode
+                  << std::setprecision(1)
+                  << " sign " << std::setw(10) << sign.opsPerSecond << " ops/s"
+                  << "  verify " << std::setw(10) << verify.opsPerSecond << " ops/s"
+                  << (sign.pinned && verify.pinned ? "" : "  (not pinned)") << "\n";
+    }
+
+    double perCoreVerify = cpus.empty() ? 0.0 : lastVerify.opsPerSecond / cpus.size();
+    std::cout << "\nVerify capacity: " << std::setprecision(1) << perCoreVerify
+              << " ops/s per core at " << cpus.size() << " cores ("
+              << lastVerify.opsPerSecond << " ops/s in total)\n\n";
+}
+
+/**
+ * @brief Sweep Dilithium3 sign/verify latency over message sizes from 32 B to 16 MiB
+ *
+ * Reports the tail of the latency distribution (p90/p99/p99.9) next to the
+ * mean; p99.9 is only meaningful for rows with at least 1000 samples.
+ */
+void runMessageSizeSweep(BenchmarkReport& report) {
+    std::cout << "\n";
+    std::cout << "========================================\n";
+    std::cout << "   MESSAGE SIZE SWEEP (DILITHIUM3)\n";
+    std::cout << "========================================\n\n";
+
+    struct SizeCase {
+        size_t bytes;
+        size_t iterations;
+    };
+    const std::vector<SizeCase> cases = {
+        {32, 1000},
+        {256, 1000},
+        {1024, 1000},
+        {4 * 1024, 500},
+        {64 * 1024, 200},
+        {1024 * 1024, 20},
+        {16 * 1024 * 1024, 5},
+    };
+
+    Dilithium3 dilithium;
     dilithium.generateKeys();
 
-    // Benchmark signing
-    auto dilithiumSign = Benchmark::run([&]() {
-        dilithiumSig = dilithium.sign(message);
-    }, ITERATIONS);
+    std::cout << "Timer: steady_clock (ns)"
+              << (Benchmark::hasCycleCounter() ? ", cycles: rdtsc" : ", cycles: unavailable")
+              << ", warm-up: iterations / 10\n\n";
 
-    // Sign once for verification benchmark
-    dilithiumSig = dilithium.sign(message);
+    Benchmark::printLatencyHeader();
+    for (const SizeCase& sizeCase : cases) {
+        auto message = Benchmark::generateRandomMessage(sizeCase.bytes);
+        Dilithium3::Signature signature;
 
-    // Benchmark verification
-    auto dilithiumVerify = Benchmark::run([&]() {
-        dilithium.verify(message, dilithiumSig);
-    }, ITERATIONS);
+        auto sign = Benchmark::run([&]() {
+            dilithium.sign(message.data(), message.size(), signature);
+        }, sizeCase.iterations);
 
-    std::cout << "Done!\n\n";
+        auto verify = Benchmark::run([&]() {
+            dilithium.verify(message.data(), message.size(), signature.data(), signature.size());
+        }, sizeCase.iterations);
 
-    // ==================== RSA-2048 BENCHMARK ====================
-    std::cout << "Testing RSA-2048 (Traditional)...\n";
-    
-    RSABenchmark rsa2048(2048);
-    std::vector<uint8_t> rsa2048Sig;
+        std::string label = sizeCase.bytes >= 1024 * 1024
+            ? std::to_string(sizeCase.bytes / (1024 * 1024)) + " MiB"
+            : sizeCase.bytes >= 1024 ? std::to_string(sizeCase.bytes / 1024) + " KiB"
+                                     : std::to_string(sizeCase.bytes) + " B";
 
-    auto rsa2048KeyGen = Benchmark::run([&]() {
-        rsa2048.generateKeys();
-    }, KEYGEN_ITERATIONS);
+        Benchmark::printLatencyRow(label, "sign", sign);
+        Benchmark::printLatencyRow("", "verify", verify);
 
-    rsa2048.generateKeys();
+        const std::string backend = Dilithium3::backendName(Dilithium3::backend());
+        report.add("Dilithium3", "NIST Level 3", backend, "sign-sweep", sizeCase.bytes, sign);
+        report.add("Dilithium3", "NIST Level 3", backend, "verify-sweep", sizeCase.bytes, verify);
+    }
+    Benchmark::printLatencySeparator();
+    std::cout << "\n";
+}
 
-    auto rsa2048Sign = Benchmark::run([&]() {
-        rsa2048Sig = rsa2048.sign(message);
-    }, ITERATIONS);
+/**
+ * @brief Composite Dilithium3 + RSA-3072 signatures, parallel against sequential
+ *
+ * Sequential signing runs both components back to back on one thread and
+ * costs their sum; parallel signing runs Dilithium on a helper thread and
+ * approaches the slower component. The reject rows corrupt one component:
+ * checking the cheaper RSA part first rejects a bad RSA signature without
+ * running the Dilithium verification at all.
+ */
+void runCompositeBenchmark(BenchmarkReport& report) {
+    std::cout << "\n";
+    std::cout << "========================================\n";
+    std::cout << "  COMPOSITE SIGNATURES (Dilithium3 + RSA-3072)\n";
+    std::cout << "========================================\n\n";
 
-    rsa2048Sig = rsa2048.sign(message);
+    const size_t ITERATIONS = 100;
+    using Composite = CompositeSigner<3>;
 
-    auto rsa2048Verify = Benchmark::run([&]() {
-        rsa2048.verify(message, rsa2048Sig);
-    }, ITERATIONS);
+    Composite composite(3072);
+    if (!composite.generateKeys()) {
+        std::cout << "Key generation failed\n";
+        return;
+    }
+    auto message = Benchmark::generateRandomMessage(1024);
+    const std::vector<uint8_t> signature = composite.sign(message);
+    if (signature.size() != composite.signatureSize()) {
+        std::cout << "Composite signing failed\n";
+        return;
+    }
+    const PreparedSigningKey<3> signingKey = composite.dilithium().prepareSigningKey();
+    const PreparedPublicKey<3> publicKey = composite.dilithium().preparePublicKey();
+    RSABenchmark& rsa = composite.rsa();
+    const std::vector<uint8_t> rsaSignature = rsa.sign(message);
+
+    // A verifier that only ever sees the exported public keys
+    const std::vector<uint8_t> compositePublicKey = composite.getPublicKey();
+    Composite verifier(3072);
+    if (!verifier.setPublicKey(compositePublicKey)) {
+        std::cout << "Loading the composite public key failed\n";
+        return;
+    }
 
-    std::cout << "Done!\n\n";
+    std::vector<uint8_t> badRsa = signature;
+    badRsa[composite.signatureSize() - 1] ^= 1;
+    std::vector<uint8_t> badDilithium = signature;
+    badDilithium[Dilithium3::SIGNATURE_BYTES / 2] ^= 1;
 
-    // ==================== RSA-3072 BENCHMARK ====================
-    std::cout << "Testing RSA-3072 (128-bit security)...\n";
-    
-    RSABenchmark rsa3072(3072);
-    std::vector<uint8_t> rsa3072Sig;
+    std::cout << "Label: " << composite.label() << "\n"
+              << "Composite signature: " << composite.signatureSize() << " bytes ("
+              << Dilithium3::SIGNATURE_BYTES << " Dilithium3 + "
+              << composite.signatureSize() - Dilithium3::SIGNATURE_BYTES << " RSA)\n"
+              << "Composite public key: " << compositePublicKey.size() << " bytes ("
+              << Dilithium3::PUBLIC_KEY_BYTES << " Dilithium3 + "
+              << compositePublicKey.size() - Dilithium3::PUBLIC_KEY_BYTES
+              << " RSA SubjectPublicKeyInfo)\n";
+    if (std::thread::hardware_concurrency() < 2) {
+        std::cout << "Note: one hardware thread, the parallel rows cannot overlap the components\n";
+    }
+    std::cout << "\n";
 
-    auto rsa3072KeyGen = Benchmark::run([&]() {
-        rsa3072.generateKeys();
-    }, KEYGEN_ITERATIONS);
+    const std::string scheme = "Dilithium3+RSA-3072";
+    const std::string parameterSet = "NIST Level 3 + 128-bit";
+    const std::string backend = std::string(Dilithium3::backendName(Dilithium3::backend()))
+                              + "+openssl";
 
-    rsa3072.generateKeys();
+    const std::string separator = "+" + std::string(34, '-') + "+" + std::string(11, '-')
+                                + "+" + std::string(12, '-') + "+" + std::string(9, '-') + "+\n";
+    std::cout << separator;
+    std::cout << "| " << std::setw(32) << std::left << "Operation"
+              << " | " << std::setw(9) << std::right << "Time (ms)"
+              << " | " << std::setw(10) << "Speedup"
+              << " | " << std::setw(7) << "Result" << " |\n";
+    std::cout << separator;
+    std::cout << std::fixed;
 
-    auto rsa3072Sign = Benchmark::run([&]() {
-        rsa3072Sig = rsa3072.sign(message);
-    }, ITERATIONS);
+    Dilithium3::Signature componentSignature{};
+    struct Operation {
+        const char* name;
+        const char* baseline;    // Earlier row the speedup is relative to, or nullptr
+        std::function<bool()> run;
+        bool expected;
+    };
+    const Operation operations[] = {
+        {"Dilithium3 sign (prepared)", nullptr, [&]() {
+            return Dilithium3::sign(signingKey, message.data(), message.size(),
+                                    componentSignature);
+        }, true},
+        {"RSA-3072 sign", nullptr, [&]() { return !rsa.sign(message).empty(); }, true},
+        {"composite sign, sequential", nullptr, [&]() {
+            return !composite.signSequential(message).empty();
+        }, true},
+        {"composite sign, parallel", "composite sign, sequential", [&]() {
+            return !composite.sign(message).empty();
+        }, true},
+        {"Dilithium3 verify (prepared)", nullptr, [&]() {
+            return publicKey.verify(message.data(), message.size(), componentSignature.data(),
+                                    componentSignature.size());
+        }, true},
+        {"RSA-3072 verify", nullptr, [&]() { return rsa.verify(message, rsaSignature); }, true},
+        {"composite verify, cheaper first", nullptr, [&]() {
+            return composite.verify(message, signature, Composite::VerifyOrder::CheaperFirst);
+        }, true},
+        {"composite verify, parallel", "composite verify, cheaper first", [&]() {
+            return composite.verify(message, signature, Composite::VerifyOrder::Parallel);
+        }, true},
+        {"verify with the public key only", "composite verify, cheaper first", [&]() {
+            return verifier.verify(message, signature, Composite::VerifyOrder::CheaperFirst);
+        }, true},
+        {"reject bad RSA, cheaper first", "composite verify, cheaper first", [&]() {
+            return composite.verify(message, badRsa, Composite::VerifyOrder::CheaperFirst);
+        }, false},
+        {"reject bad RSA, parallel", "composite verify, cheaper first", [&]() {
+            return composite.verify(message, badRsa, Composite::VerifyOrder::Parallel);
+        }, false},
+        {"reject bad Dilithium, RSA first", "composite verify, cheaper first", [&]() {
+            return composite.verify(message, badDilithium, Composite::VerifyOrder::CheaperFirst);
+        }, false},
+    };
 
-    rsa3072Sig = rsa3072.sign(message);
+    std::unordered_map<std::string, double> times;
+    for (const Operation& operation : operations) {
+        bool correct = true;
+        auto result = Benchmark::run([&]() {
+            correct = operation.run() == operation.expected && correct;
+        }, ITERATIONS);
+        times[operation.name] = result.averageTime;
+        report.add(scheme, parameterSet, backend, operation.name, message.size(), result);
 
-    auto rsa3072Verify = Benchmark::run([&]() {
-        rsa3072.verify(message, rsa3072Sig);
-    }, ITERATIONS);
+        std::cout << "| " << std::setw(32) << std::left << operation.name
+                  << " | " << std::setw(9) << std::right << std::setprecision(3)
+                  << result.averageTime << " | " << std::setw(10);
+        if (operation.baseline && result.averageTime > 0.0) {
+            std::ostringstream speedup;
+            speedup << std::fixed << std::setprecision(2)
+                    << times[operation.baseline] / result.averageTime << "x";
+            std::cout << speedup.str();
+        } else {
+            std::cout << "-";
+        }
+        std::cout << " | " << std::setw(7) << (operation.expected ? "valid" : "reject")
+                  << " |" << (correct ? "" : "  WRONG RESULT") << "\n";
+    }
+    std::cout << separator;
+    std::cout << "Speedup: sequential sign or cheaper-first verify of a valid signature\n"
+              << "divided by the row's time.\n\n";
+}
 
-    std::cout << "Done!\n\n";
+/**
+ * @brief Compare pure signing with pre-hash (HashML-DSA) signing across message sizes
+ *
+ * Pure signing absorbs the whole message into SHAKE256; pre-hash signing
+ * hashes it with OpenSSL SHA-256/SHA-512 first and signs the digest, so
+ * the gap grows with the message size.
+ */
+void runPreHashBenchmark(BenchmarkReport& report) {
+    std::cout << "\n";
+    std::cout << "========================================\n";
+    std::cout << "    PRE-HASH (HashML-DSA) vs PURE SIGN\n";
+    std::cout << "========================================\n\n";
 
-    // ==================== RESULTS COMPARISON ====================
+    struct SizeCase {
+        size_t bytes;
+        size_t iterations;
+    };
+    const std::vector<SizeCase> cases = {
+        {1024, 50},
+        {64 * 1024, 50},
+        {1024 * 1024, 10},
+        {16 * 1024 * 1024, 3},
+    };
+
+    Dilithium3 dilithium;
+    dilithium.generateKeys();
+
+    auto separator = []() {
+        std::cout << "+" << std::string(12, '-') << "+" << std::string(14, '-')
+                  << "+" << std::string(14, '-') << "+" << std::string(14, '-')
+                  << "+" << std::string(14, '-') << "+\n";
+    };
+
+    separator();
+    std::cout << "| " << std::setw(10) << std::left << "Message"
+              << " | " << std::setw(12) << "Pure (ms)"
+              << " | " << std::setw(12) << "SHA-256 (ms)"
+              << " | " << std::setw(12) << "SHA-512 (ms)"
+              << " | " << std::setw(12) << "Speedup (x)"
+              << " |\n";
+    separator();
+
+    for (const SizeCase& sizeCase : cases) {
+        auto message = Benchmark::generateRandomMessage(sizeCase.bytes);
+        std::vector<uint8_t> signature;
+
+        auto pure = Benchmark::run([&]() {
+            signature = dilithium.sign(message);
+        }, sizeCase.iterations);
+
+        auto sha256 = Benchmark::run([&]() {
+            signature = dilithium.signPreHash(message, Dilithium3::PreHash::SHA256);
+        }, sizeCase.iterations);
+
+        auto sha512 = Benchmark::run([&]() {
+            signature = dilithium.signPreHash(message, Dilithium3::PreHash::SHA512);
+        }, sizeCase.iterations);
+
+        const std::string backend = Dilithium3::backendName(Dilithium3::backend());
+        report.add("Dilithium3", "NIST Level 3", backend, "sign-pure", sizeCase.bytes, pure);
+        report.add("Dilithium3", "NIST Level 3", backend, "sign-prehash-sha256", sizeCase.bytes, sha256);
+        report.add("Dilithium3", "NIST Level 3", backend, "sign-prehash-sha512", sizeCase.bytes, sha512);
+
+        double best = std::min(sha256.averageTime, sha512.averageTime);
+        std::string label = sizeCase.bytes >= 1024 * 1024
+            ? std::to_string(sizeCase.bytes / (1024 * 1024)) + " MB"
+            : std::to_string(sizeCase.bytes / 1024) + " KB";
+
+        std::cout << std::fixed << std::setprecision(3);
+        std::cout << "| " << std::setw(10) << std::left << label
+                  << " | " << std::setw(12) << pure.averageTime
+                  << " | " << std::setw(12) << sha256.averageTime
+                  << " | " << std::setw(12) << sha512.averageTime
+                  << " | " << std::setw(12) << std::setprecision(2)
+                  << (best > 0.0 ? pure.averageTime / best : 0.0)
+                  << " |\n";
+    }
+
+    separator();
+    std::cout << "\n";
+}
+
+/**
+ * @brief Rejection loop statistics and per-phase time of Dilithium3 signing
+ *
+ * Needs a build with -DDILITHIUM_INSTRUMENTATION=ON; otherwise only prints
+ * how to get one. Signs distinct messages, so every signature takes a fresh
+ * path through the rejection loop.
+ */
+void runSignInstrumentation(size_t signatures) {
     std::cout << "\n";
     std::cout << "========================================\n";
-    std::cout << "         PERFORMANCE COMPARISON\n";
+    std::cout << "    SIGN INSTRUMENTATION (Dilithium3)\n";
     std::cout << "========================================\n\n";
 
-    Benchmark::printTableHeader();
+    if (!Dilithium3::INSTRUMENTED) {
+        std::cout << "Not available: rebuild with -DDILITHIUM_INSTRUMENTATION=ON\n";
+        return;
+    }
 
-    Benchmark::printComparisonRow(
-        "Dilithium3",
-        "NIST Level 3",
-        dilithiumKeyGen,
-        dilithiumSign,
-        dilithiumVerify,
-        DilithiumWrapper::PUBLIC_KEY_BYTES,
-        dilithiumSig.size()
-    );
-
-    Benchmark::printComparisonRow(
-        "RSA-2048",
-        "112-bit",
-        rsa2048KeyGen,
-        rsa2048Sign,
-        rsa2048Verify,
-        rsa2048.getPublicKeySize(),
-        rsa2048Sig.size()
-    );
-
-    Benchmark::printComparisonRow(
-        "RSA-3072",
-        "128-bit",
-        rsa3072KeyGen,
-        rsa3072Sign,
-        rsa3072Verify,
-        rsa3072.getPublicKeySize(),
-        rsa3072Sig.size()
-    );
+    Dilithium3 dilithium;
+    dilithium.generateKeys();
+    auto message = Benchmark::generateRandomMessage(1024);
+    std::vector<uint8_t> signature;
 
-    Benchmark::printSeparator();
+    Dilithium3::resetSignStats();
+    for (size_t i = 0; i < signatures; ++i) {
+        std::memcpy(message.data(), &i, sizeof(i));
+        signature = dilithium.sign(message);
+    }
+    const DilithiumSignStats stats = Dilithium3::signStats();
+    if (stats.signatures == 0) {
+        std::cout << "No instrumented signatures (the " << Dilithium3::backendName(Dilithium3::backend())
+                  << " backend is not instrumented)\n";
+        return;
+    }
 
-    // ==================== DETAILED ANALYSIS ====================
+    const double count = static_cast<double>(stats.signatures);
+    const uint64_t rejections = stats.rejectedZ + stats.rejectedLowBits
+                              + stats.rejectedCt0 + stats.rejectedHints;
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Signatures:            " << stats.signatures << "\n";
+    std::cout << "Loop passes/signature: " << stats.iterations / count
+              << " average, " << stats.maxIterations << " max\n\n";
+
+    std::cout << "Rejections (" << rejections << "):\n";
+    auto reason = [&](const char* name, uint64_t value) {
+        std::cout << "  " << std::setw(24) << std::left << name << std::right << std::setw(8) << value
+                  << "  (" << std::setw(5) << (rejections ? 100.0 * value / rejections : 0.0) << " %)\n";
+    };
+    reason("||z|| >= gamma1 - beta", stats.rejectedZ);
+    reason("||r0|| >= gamma2 - beta", stats.rejectedLowBits);
+    reason("||c*t0|| >= gamma2", stats.rejectedCt0);
+    reason("hints > omega", stats.rejectedHints);
+
+    std::cout << "\nPasses per signature:\n";
+    uint64_t largest = 1;
+    for (uint64_t bin : stats.iterationHistogram) {
+        largest = std::max(largest, bin);
+    }
+    for (size_t bin = 0; bin < DilithiumSignStats::HISTOGRAM_BINS; ++bin) {
+        if (stats.iterationHistogram[bin] == 0) {
+            continue;
+        }
+        std::string label = std::to_string(bin + 1);
+        if (bin + 1 == DilithiumSignStats::HISTOGRAM_BINS) {
+            label += "+";
+        }
+        std::cout << "  " << std::setw(4) << std::right << label
+                  << std::setw(8) << stats.iterationHistogram[bin] << "  "
+                  << std::string(static_cast<size_t>(40 * stats.iterationHistogram[bin] / largest), '#')
+                  << "\n";
+    }
+
+    std::cout << "\nTime per signature:\n";
+    auto phase = [&](const char* name, uint64_t nanoseconds) {
+        std::cout << "  " << std::setw(24) << std::left << name << std::right
+                  << std::setw(9) << std::setprecision(2) << nanoseconds / count / 1000.0 << " us"
+                  << "  (" << std::setw(5) << std::setprecision(1)
+                  << (stats.totalNs ? 100.0 * nanoseconds / stats.totalNs : 0.0) << " %)\n";
+    };
+    const uint64_t measured = stats.expandMatrixNs + stats.nttNs + stats.invnttNs + stats.pointwiseNs
+                            + stats.shakeNs + stats.samplingNs + stats.packingNs;
+    phase("Matrix expansion", stats.expandMatrixNs);
+    phase("NTT", stats.nttNs);
+    phase("Inverse NTT", stats.invnttNs);
+    phase("Pointwise products", stats.pointwiseNs);
+    phase("SHAKE (mu, rho', c~)", stats.shakeNs);
+    phase("Sampling (y, c)", stats.samplingNs);
+    phase("Packing", stats.packingNs);
+    phase("Other", stats.totalNs > measured ? stats.totalNs - measured : 0);
+    phase("Total", stats.totalNs);
+    std::cout << "\n";
+}
+
+/**
+ * @brief Fixed-vs-random timing leakage of Dilithium3 signing per backend
+ *
+ * Runs Benchmark::runLeakageTest() on the ref and AVX2 backends, prepared
+ * keys and arena scratch:
+ * - secret key: a fixed key against random keys, random messages for both.
+ *   Both classes sign from a pool of KEYS key objects (copies of the fixed
+ *   key or distinct keys), so neither class runs with a hotter cache; the
+ *   other tests pool their fixed inputs the same way.
+ * - message: a fixed against random messages under one key. Deterministic
+ *   signing repeats the same rejection loop for a fixed message, so its time
+ *   follows public values of the signature and a difference is expected.
+ *   Instrumented builds draw the random messages from a pool that takes as
+ *   many loop passes as the fixed one, which removes the largest part.
+ * - unpack: PreparedSigningKey::load() of a fixed against random packed keys.
+ */
+void runTimingLeakageBenchmark(size_t samples) {
     std::cout << "\n";
     std::cout << "========================================\n";
-    std::cout << "          DETAILED ANALYSIS\n";
+    std::cout << "   TIMING LEAKAGE: FIXED VS RANDOM (Dilithium3)\n";
     std::cout << "========================================\n\n";
 
-    // Speed comparison
-    std::cout << "Speed Comparison (vs Dilithium3):\n";
-    std::cout << "  RSA-2048 KeyGen: " 
-              << std::fixed << std::setprecision(2)
-              << (rsa2048KeyGen.averageTime / dilithiumKeyGen.averageTime) 
-              << "x slower\n";
-    std::cout << "  RSA-3072 KeyGen: " 
-              << (rsa3072KeyGen.averageTime / dilithiumKeyGen.averageTime) 
-              << "x slower\n\n";
-
-    std::cout << "  RSA-2048 Signing: " 
-              << (rsa2048Sign.averageTime / dilithiumSign.averageTime) 
-              << "x " << (rsa2048Sign.averageTime > dilithiumSign.averageTime ? "slower" : "faster") << "\n";
-    std::cout << "  RSA-3072 Signing: " 
-              << (rsa3072Sign.averageTime / dilithiumSign.averageTime) 
-              << "x " << (rsa3072Sign.averageTime > dilithiumSign.averageTime ? "slower" : "faster") << "\n\n";
-
-    std::cout << "  RSA-2048 Verification: " 
-              << (rsa2048Verify.averageTime / dilithiumVerify.averageTime) 
-              << "x " << (rsa2048Verify.averageTime > dilithiumVerify.averageTime ? "slower" : "faster") << "\n";
-    std::cout << "  RSA-3072 Verification: " 
-              << (rsa3072Verify.averageTime / dilithiumVerify.averageTime) 
-              << "x " << (rsa3072Verify.averageTime > dilithiumVerify.averageTime ? "slower" : "faster") << "\n\n";
+    const size_t KEYS = 16;
+    const size_t MESSAGE_BYTES = 32;
 
-    // Size comparison
-    std::cout << "Size Comparison:\n";
-    std::cout << "  Dilithium3 Public Key: " << DilithiumWrapper::PUBLIC_KEY_BYTES << " bytes\n";
-    std::cout << "  RSA-2048 Public Key:   " << rsa2048.getPublicKeySize() << " bytes\n";
-    std::cout << "  RSA-3072 Public Key:   " << rsa3072.getPublicKeySize() << " bytes\n\n";
+    std::vector<Dilithium3> fixedKeys(KEYS);
+    std::vector<Dilithium3> randomKeys(KEYS);
+    fixedKeys[0].generateKeys();
+    const std::vector<uint8_t> fixedSecretKey = fixedKeys[0].getSecretKey();
+    const std::vector<std::vector<uint8_t>> fixedSecretKeys(KEYS, fixedSecretKey);
+    std::vector<std::vector<uint8_t>> randomSecretKeys;
+    for (size_t i = 0; i < KEYS; ++i) {
+        fixedKeys[i].setSecretKey(fixedSecretKey);
+        randomKeys[i].generateKeys();
+        randomSecretKeys.push_back(randomKeys[i].getSecretKey());
+    }
+    std::vector<PreparedSigningKey<3>> fixedPrepared;
+    std::vector<PreparedSigningKey<3>> randomPrepared;
+    for (size_t i = 0; i < KEYS; ++i) {
+        fixedPrepared.push_back(fixedKeys[i].prepareSigningKey());
+        randomPrepared.push_back(randomKeys[i].prepareSigningKey());
+    }
 
-    std::cout << "  Dilithium3 Signature:  " << dilithiumSig.size() << " bytes\n";
-    std::cout << "  RSA-2048 Signature:    " << rsa2048Sig.size() << " bytes\n";
-    std::cout << "  RSA-3072 Signature:    " << rsa3072Sig.size() << " bytes\n\n";
+    std::mt19937_64 generator(2);
+    std::vector<uint8_t> message(MESSAGE_BYTES);
+    auto randomizeMessage = [&]() {
+        for (size_t i = 0; i < message.size(); i += 8) {
+            const uint64_t word = generator();
+            std::memcpy(message.data() + i, &word, std::min<size_t>(8, message.size() - i));
+        }
+    };
 
-    // Security analysis
-    std::cout << "Security Level:\n";
-    std::cout << "  Dilithium3: NIST Level 3 (~128-bit quantum security)\n";
-    std::cout << "  RSA-2048:   112-bit classical security (broken by quantum)\n";
-    std::cout << "  RSA-3072:   128-bit classical security (broken by quantum)\n\n";
-
-    std::cout << "Post-Quantum Security:\n";
-    std::cout << "  Dilithium3: ✓ Quantum-resistant (lattice-based)\n";
-    std::cout << "  RSA-2048:   ✗ Vulnerable to Shor's algorithm\n";
-    std::cout << "  RSA-3072:   ✗ Vulnerable to Shor's algorithm\n\n";
+    // With instrumentation, find a fixed message with a single loop pass (the
+    // most likely count) and random messages that take one pass as well
+    const bool matchPasses = Dilithium3::INSTRUMENTED && !Dilithium3::RANDOMIZED_SIGNING;
+    const size_t MESSAGES = 256;
+    Dilithium3::Signature signature{};
+    auto passesOf = [&](const std::vector<uint8_t>& candidate) {
+        const uint64_t before = Dilithium3::signStats().iterations;
+        Dilithium3::sign(fixedPrepared[0], candidate.data(), candidate.size(), signature);
+        return Dilithium3::signStats().iterations - before;
+    };
+    std::vector<uint8_t> fixedMessage = Benchmark::generateRandomMessage(MESSAGE_BYTES);
+    std::vector<std::vector<uint8_t>> matchedMessages;
+    if (matchPasses) {
+        while (passesOf(fixedMessage) != 1) {
+            fixedMessage = Benchmark::generateRandomMessage(MESSAGE_BYTES);
+        }
+        while (matchedMessages.size() < MESSAGES) {
+            randomizeMessage();
+            if (passesOf(message) == 1) {
+                matchedMessages.push_back(message);
+            }
+        }
+    }
+    const std::vector<std::vector<uint8_t>> fixedMessages(MESSAGES, fixedMessage);
+
+    const Dilithium3::Backend previousBackend = Dilithium3::backend();
+    const Dilithium3::Scratch previousScratch = Dilithium3::scratchMode();
+
+    struct Configuration {
+        const char* name;
+        Dilithium3::Backend backend;
+        Dilithium3::Scratch scratch;
+        bool prepared;
+    };
+    const Configuration configurations[] = {
+        {"ref", Dilithium3::Backend::Reference, Dilithium3::Scratch::Stack, false},
+        {"avx2", Dilithium3::Backend::AVX2, Dilithium3::Scratch::Stack, false},
+        {"prepared", Dilithium3::Backend::Reference, Dilithium3::Scratch::Stack, true},
+        {"arena", Dilithium3::Backend::Reference, Dilithium3::Scratch::Arena, false},
+    };
+
+    const std::string separator = "+" + std::string(10, '-') + "+" + std::string(12, '-')
+                                + "+" + std::string(9, '-')
+                                + "+" + std::string(11, '-') + "+" + std::string(11, '-')
+                                + "+" + std::string(11, '-') + "+" + std::string(8, '-')
+                                + "+" + std::string(9, '-') + "+" + std::string(9, '-') + "+\n";
+    const char* unit = Benchmark::hasCycleCounter() ? "cyc" : "ns";
+    std::cout << "Samples per test: " << samples << ", unit: " << unit
+              << ", leak threshold: |t| > " << Benchmark::LeakageResult::THRESHOLD << "\n\n";
+    std::cout << separator;
+    std::cout << "| " << std::setw(8) << std::left << "Backend"
+              << " | " << std::setw(10) << "Test"
+              << " | " << std::setw(7) << std::right << "Samples"
+              << " | " << std::setw(9) << "Median"
+              << " | " << std::setw(9) << "Fixed"
+              << " | " << std::setw(9) << "Random"
+              << " | " << std::setw(6) << "t"
+              << " | " << std::setw(7) << "max |t|"
+              << " | " << std::setw(7) << std::left << "Verdict" << " |\n";
+    std::cout << separator;
+    std::cout << std::fixed;
+
+    bool publicFlagged = false;
+    auto printRow = [&](const char* backend, const char* test,
+                        const Benchmark::LeakageResult& result, bool valid, bool publicTiming) {
+        const char* verdict = !result.leaks() ? "ok" : publicTiming ? "public" : "LEAK?";
+        publicFlagged = publicFlagged || (result.leaks() && publicTiming);
+        std::cout << "| " << std::setw(8) << std::left << backend
+                  << " | " << std::setw(10) << test
+                  << " | " << std::setw(7) << std::right << result.samples[0] + result.samples[1]
+                  << " | " << std::setw(9) << std::setprecision(0) << result.median
+                  << " | " << std::setw(9) << result.mean[0]
+                  << " | " << std::setw(9) << result.mean[1]
+                  << " | " << std::setw(6) << std::setprecision(2) << result.t
+                  << " | " << std::setw(7) << result.maxT
+                  << " | " << std::setw(7) << std::left << verdict << " |"
+                  << (valid ? "" : "  INVALID") << "\n";
+    };
+
+    for (const Configuration& configuration : configurations) {
+        if (!Dilithium3::setBackend(configuration.backend)) {
+            continue;
+        }
+        Dilithium3::setScratchMode(configuration.scratch);
+
+        const Dilithium3* wrapper = nullptr;
+        const PreparedSigningKey<3>* prepared = nullptr;
+        const std::vector<uint8_t>* messageToSign = &message;
+        auto selectKey = [&](int inputClass, size_t index) {
+            wrapper = inputClass == 0 ? &fixedKeys[index % KEYS] : &randomKeys[index % KEYS];
+            prepared = inputClass == 0 ? &fixedPrepared[index % KEYS]
+                                       : &randomPrepared[index % KEYS];
+        };
+        bool valid = true;
+        auto sign = [&]() {
+            valid = (configuration.prepared
+                         ? Dilithium3::sign(*prepared, messageToSign->data(),
+                                            messageToSign->size(), signature)
+                         : wrapper->sign(messageToSign->data(), messageToSign->size(),
+                                         signature))
+                    && valid;
+        };
+
+        auto keyResult = Benchmark::runLeakageTest([&](int inputClass, size_t index) {
+            selectKey(inputClass, index);
+            randomizeMessage();
+            messageToSign = &message;
+        }, sign, samples);
+        printRow(configuration.name, "secret key", keyResult, valid, false);
+
+        valid = true;
+        auto messageResult = Benchmark::runLeakageTest([&](int inputClass, size_t index) {
+            selectKey(0, 0);
+            if (inputClass == 0) {
+                messageToSign = &fixedMessages[index % MESSAGES];
+            } else if (matchPasses) {
+                messageToSign = &matchedMessages[index % MESSAGES];
+            } else {
+                randomizeMessage();
+                messageToSign = &message;
+            }
+        }, sign, samples);
+        printRow(configuration.name, "message", messageResult, valid,
+                 !Dilithium3::RANDOMIZED_SIGNING);
+
+        if (configuration.prepared) {
+            PreparedSigningKey<3> loaded;
+            const std::vector<uint8_t>* packed = &fixedSecretKey;
+            valid = true;
+            auto unpackResult = Benchmark::runLeakageTest([&](int inputClass, size_t index) {
+                packed = inputClass == 0 ? &fixedSecretKeys[index % KEYS]
+                                         : &randomSecretKeys[index % KEYS];
+            }, [&]() {
+                valid = loaded.load(*packed) && valid;
+            }, samples);
+            printRow(configuration.name, "unpack", unpackResult, valid, false);
+        }
+    }
+    std::cout << separator;
+
+    if (matchPasses) {
+        std::cout << "message: the fixed and the " << MESSAGES
+                  << " random messages all take one rejection loop pass\n";
+    }
+    if (publicFlagged) {
+        std::cout << "public: deterministic signing of a fixed message repeats the same rejection\n"
+                  << "        loop, and its time follows public values (the number of passes,\n"
+                  << "        SampleInBall on c~, the hints). Rejected attempts are independent\n"
+                  << "        of the key; watch these rows for changes between backends.\n";
+    }
+    std::cout << "\n";
+
+    Dilithium3::setBackend(previousBackend);
+    Dilithium3::setScratchMode(previousScratch);
 }
 
 /**
@@ -205,7 +2411,7 @@ void demonstrateBasicUsage() {
     std::cout << "========================================\n\n";
 
     // Create Dilithium instance
-    DilithiumWrapper dilithium;
+    Dilithium3 dilithium;
 
     // Generate keys
     std::cout << "1. Generating Dilithium key pair...\n";
@@ -241,15 +2447,247 @@ void demonstrateBasicUsage() {
     bool validTampered = dilithium.verify(message, signature);
     std::cout << "   " << (validTampered ? "✗" : "✓") << " Tampered signature is " 
               << (validTampered ? "VALID (ERROR!)" : "INVALID (CORRECT!)") << "\n\n";
+
+    // Sign a large message in chunks without holding it in one buffer
+    const size_t STREAM_CHUNKS = 64;
+    const size_t STREAM_CHUNK_SIZE = 64 * 1024;
+    std::cout << "6. Streaming sign/verify (" << STREAM_CHUNKS << " x "
+              << STREAM_CHUNK_SIZE / 1024 << " KB chunks)...\n";
+    PreparedSigningKey<3> signingKey = dilithium.prepareSigningKey();
+    PreparedPublicKey<3> publicKey = dilithium.preparePublicKey();
+    SignStream<3> signer(signingKey);
+    VerifyStream<3> verifier(publicKey);
+    std::vector<uint8_t> chunk(STREAM_CHUNK_SIZE);
+    for (size_t i = 0; i < STREAM_CHUNKS; ++i) {
+        std::fill(chunk.begin(), chunk.end(), static_cast<uint8_t>(i));
+        signer.update(chunk);
+        verifier.update(chunk);
+    }
+    auto streamSignature = signer.final();
+    bool streamValid = verifier.final(streamSignature);
+    std::cout << "   " << (streamValid ? "✓" : "✗") << " Streamed signature is "
+              << (streamValid ? "VALID" : "INVALID") << " (peak message buffer "
+              << STREAM_CHUNK_SIZE / 1024 << " KB)\n\n";
+}
+
+/**
+ * @brief Compare two saved result files
+ * @return Process exit code (0 = no regression, 1 = regression, 2 = unreadable input)
+ */
+int compareResultFiles(const std::string& baselinePath, const std::string& currentPath,
+                       double thresholdPercent) {
+    BenchmarkReport baseline;
+    BenchmarkReport current;
+    if (!baseline.load(baselinePath)) {
+        std::cerr << "Error: cannot read " << baselinePath << "\n";
+        return 2;
+    }
+    if (!current.load(currentPath)) {
+        std::cerr << "Error: cannot read " << currentPath << "\n";
+        return 2;
+    }
+
+    std::cout << "Baseline: " << baselinePath << " (" << baseline.host().hostname << ", "
+              << baseline.host().timestamp << ")\n";
+    std::cout << "Current:  " << currentPath << " (" << current.host().hostname << ", "
+              << current.host().timestamp << ")\n";
+    std::cout << "Test: one-sided Mann-Whitney U, alpha = 0.01, threshold = "
+              << thresholdPercent << "%\n\n";
+
+    auto entries = compareReports(baseline, current, thresholdPercent);
+    size_t regressions = printComparison(entries, std::cout);
+    std::cout << "\n" << entries.size() << " benchmarks compared, "
+              << regressions << " regression(s)\n";
+    return regressions > 0 ? 1 : 0;
+}
+
+/**
+ * @brief Print the registered schemes
+ */
+void printSchemes(const SchemeRegistry& registry) {
+    std::cout << "Available schemes (select by name or family):\n";
+    for (const SchemeInfo& scheme : registry.schemes()) {
+        std::cout << "  " << std::setw(12) << std::left << scheme.name
+                  << std::setw(11) << scheme.family << scheme.securityLevel
+                  << (scheme.postQuantum ? ", post-quantum" : "") << "\n";
+    }
 }
 
-int main() {
+int main(int argc, char** argv) {
+    BenchmarkOptions options;
+    std::string error;
+    if (!options.parse(argc, argv, error)) {
+        std::cerr << "Error: " << error << "\n\n";
+        BenchmarkOptions::printUsage(argv[0]);
+        return 2;
+    }
+    if (options.help) {
+        BenchmarkOptions::printUsage(argv[0]);
+        return 0;
+    }
+
+    const SchemeRegistry& registry = SchemeRegistry::builtin();
+    if (options.listSchemes) {
+        printSchemes(registry);
+        return 0;
+    }
+
+    if (!options.baselinePath.empty()) {
+        return compareResultFiles(options.baselinePath, options.currentPath,
+                                  options.thresholdPercent);
+    }
+
+    std::vector<const SchemeInfo*> schemes;
+    std::string unknownScheme;
+    if (!registry.select(options.schemes, schemes, unknownScheme) || schemes.empty()) {
+        std::cerr << "Error: unknown scheme '" << unknownScheme << "'\n\n";
+        printSchemes(registry);
+        return 2;
+    }
+    const bool withDilithium3 = std::find(schemes.begin(), schemes.end(),
+                                          registry.find("Dilithium3")) != schemes.end();
+
+    Benchmark::setPerfCounters(options.perfCounters);
+    if (options.pinCpu >= 0 && !Benchmark::pinCurrentThread(options.pinCpu)) {
+        std::cerr << "Error: cannot pin to CPU " << options.pinCpu << "\n";
+        return 2;
+    }
+
+    // With --format json/csv the report is the only thing on stdout
+    std::ostringstream discarded;
+    std::streambuf* console = nullptr;
+    if (options.format != "table" && options.output.empty()) {
+        console = std::cout.rdbuf(discarded.rdbuf());
+    }
+
     try {
+        BenchmarkReport report;
+
+        if (options.pinCpu >= 0) {
+            std::cout << "Pinned to CPU " << options.pinCpu << "\n";
+        }
+
         // Demonstrate basic usage
-        demonstrateBasicUsage();
+        if (withDilithium3 && options.runs("demo")) {
+            demonstrateBasicUsage();
+        }
 
         // Run comprehensive benchmarks
-        runComprehensiveBenchmark();
+        if (options.runs("compare")) {
+            runComprehensiveBenchmark(report, schemes, options);
+        }
+
+        // Prepared keys, batch verification and zero-copy overloads
+        if (withDilithium3 && options.runs("api")) {
+            runDilithiumApiBenchmark(report);
+        }
+
+        // Latency distribution across message sizes
+        if (withDilithium3 && options.runs("sweep")) {
+            runMessageSizeSweep(report);
+        }
+
+        // Single, seeded and batched key generation
+        if (withDilithium3 && options.runs("keygen")) {
+            runKeyGenerationBenchmark(report, options.threads);
+        }
+
+        // Cost of the randomness source in key generation and signing
+        if (withDilithium3 && options.runs("rng")) {
+            runRandomnessBenchmark(report);
+        }
+
+        // Latency and footprint of the prepared public key memory modes
+        if (withDilithium3 && options.runs("keymemory")) {
+            runKeyMemoryBenchmark(report);
+        }
+
+        // Stack, heap and arena use of sign/verify in both scratch modes
+        if (withDilithium3 && options.runs("scratch")) {
+            runScratchBenchmark(report);
+        }
+
+        // SHAKE throughput per lane count and the lanes' effect on key loading
+        if (withDilithium3 && options.runs("shake")) {
+            runShakeBenchmark(report);
+        }
+
+        // Verify-heavy service with many signers and a prepared key cache
+        if (withDilithium3 && options.runs("keycache")) {
+            runPublicKeyCacheBenchmark(report);
+        }
+
+        // Startup and lookups of a memory-mapped file of many public keys
+        if (withDilithium3 && options.runs("keystore")) {
+            runKeyStoreBenchmark(report);
+        }
+
+        // Startup of many verification keys from packed and from prepared form
+        if (withDilithium3 && options.runs("startup")) {
+            runKeyStartupBenchmark(report);
+        }
+
+        // Key-load throughput and memory per key of the key storage modes
+        if (withDilithium3 && options.runs("keypool")) {
+            runSecureKeyPoolBenchmark(report);
+        }
+
+        // Compare pre-hash and pure signing across message sizes
+        if (withDilithium3 && options.runs("prehash")) {
+            runPreHashBenchmark(report);
+        }
+
+        // Hybrid Dilithium3 + RSA signatures, components run concurrently
+        if (withDilithium3 && options.runs("composite")) {
+            runCompositeBenchmark(report);
+        }
+
+        // Measure multi-threaded throughput scaling
+        if (withDilithium3 && options.runs("throughput")) {
+            runThroughputBenchmark(options.threads);
+        }
+
+        // Micro-batching service front-end under a mixed producer load
+        if (withDilithium3 && options.runs("service")) {
+            runServiceBenchmark(options.threads);
+        }
+
+        // Rejection loop and per-phase breakdown of signing
+        if (withDilithium3 && options.runs("instrument")) {
+            runSignInstrumentation(1000);
+        }
+
+        // Fixed-vs-random timing leakage of every signing path
+        if (withDilithium3 && options.runs("ct")) {
+            runTimingLeakageBenchmark(options.leakageSamples);
+        }
+
+        // Fixed-time throughput with one pinned worker per core
+        if (withDilithium3 && options.runs("pinned")) {
+            runPinnedThroughputBenchmark(options.cpus, options.seconds);
+        }
+
+        std::vector<std::string> reportPaths = options.reportPaths;
+        if (options.format != "table" && !options.output.empty()) {
+            reportPaths.push_back(options.output);
+        }
+        for (const std::string& path : reportPaths) {
+            // --output uses --format whatever the file is called
+            auto reporter = path == options.output && options.format != "table"
+                ? BenchmarkReporter::forFormat(options.format)
+                : BenchmarkReporter::forFormat(path);
+            if (!reporter || !reporter->writeFile(report, path)) {
+                std::cerr << "Error: cannot write " << path << "\n";
+                return 1;
+            }
+            std::cout << "Results written to " << path << "\n\n";
+        }
+
+        if (console) {
+            std::cout.rdbuf(console);
+            BenchmarkReporter::forFormat(options.format)->write(report, std::cout);
+            return 0;
+        }
 
         std::cout << "========================================\n";
         std::cout << "      BENCHMARK COMPLETED SUCCESSFULLY\n";
@@ -257,7 +2695,10 @@ int main() {
 
         return 0;
     } catch (const std::exception& e) {
+        if (console) {
+            std::cout.rdbuf(console);
+        }
         std::cerr << "Error: " << e.what() << std::endl;
         return 1;
     }
-}
\ No newline at end of file
+}